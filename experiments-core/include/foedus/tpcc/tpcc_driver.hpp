@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "foedus/fwd.hpp"
+#include "foedus/thread/latency_histogram.hpp"
 #include "foedus/thread/rendezvous_impl.hpp"
 #include "foedus/tpcc/fwd.hpp"
 #include "foedus/tpcc/tpcc.hpp"
@@ -61,7 +62,9 @@ class TpccDriver {
         largereadset_aborts_(0),
         unexpected_aborts_(0),
         snapshot_cache_hits_(0),
-        snapshot_cache_misses_(0) {}
+        snapshot_cache_misses_(0) {
+      latencies_.reset();
+    }
     double   duration_sec_;
     uint32_t worker_count_;
     uint64_t processed_;
@@ -71,6 +74,8 @@ class TpccDriver {
     uint64_t unexpected_aborts_;
     uint64_t snapshot_cache_hits_;
     uint64_t snapshot_cache_misses_;
+    /** Merged latency histograms of all workers since they started the measurement */
+    thread::ThreadLatencyHistograms latencies_;
     WorkerResult workers_[kMaxWorkers];
     std::vector<std::string> papi_results_;
     friend std::ostream& operator<<(std::ostream& o, const Result& v);
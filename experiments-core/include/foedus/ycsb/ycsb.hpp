@@ -40,6 +40,7 @@
 #include "foedus/storage/storage_manager.hpp"
 #include "foedus/storage/hash/hash_storage.hpp"
 #include "foedus/storage/masstree/masstree_storage.hpp"
+#include "foedus/thread/latency_histogram.hpp"
 
 /**
  * @file ycsb.hpp
@@ -516,7 +517,9 @@ class YcsbDriver {
         total_scans_(0),
         unexpected_aborts_(0),
         snapshot_cache_hits_(0),
-        snapshot_cache_misses_(0) {}
+        snapshot_cache_misses_(0) {
+      latencies_.reset();
+    }
     double   duration_sec_;
     uint32_t worker_count_;
     uint64_t processed_;
@@ -529,6 +532,8 @@ class YcsbDriver {
     uint64_t unexpected_aborts_;
     uint64_t snapshot_cache_hits_;
     uint64_t snapshot_cache_misses_;
+    /** Merged latency histograms of all workers since they started the measurement */
+    thread::ThreadLatencyHistograms latencies_;
     WorkerResult workers_[kMaxWorkers];
     std::vector<std::string> papi_results_;
     friend std::ostream& operator<<(std::ostream& o, const Result& v);
@@ -117,6 +117,8 @@ ErrorStack execute(
   storage::Page* root_page = reinterpret_cast<storage::Page*>(root_page_memory.get_block());
   snapshot::SortedBuffer* log_array[1];
   log_array[0] = &buffer;
+  storage::ComposeStatistics statistics;
+  statistics.clear();
   storage::Composer::ComposeArguments args = {
     &writer,
     &dummy_files,
@@ -124,7 +126,8 @@ ErrorStack execute(
     1,
     &work_memory,
     Epoch(1),
-    root_page
+    root_page,
+    &statistics
   };
 
   if (FLAGS_profile) {
@@ -137,7 +140,7 @@ ErrorStack execute(
   CHECK_ERROR(composer.compose(args));
   watch.stop();
   *elapsed_ms = watch.elapsed_ms();
-  LOG(INFO) << "experiment's main part has ended. Took " << *elapsed_ms << "ms";
+  LOG(INFO) << "experiment's main part has ended. Took " << *elapsed_ms << "ms. " << statistics;
 
   if (FLAGS_profile) {
     engine->get_debug()->stop_profile();
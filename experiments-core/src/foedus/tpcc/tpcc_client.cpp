@@ -33,6 +33,7 @@
 #include "foedus/storage/array/array_storage.hpp"
 #include "foedus/storage/masstree/masstree_cursor.hpp"
 #include "foedus/storage/masstree/masstree_storage.hpp"
+#include "foedus/thread/latency_histogram.hpp"
 #include "foedus/thread/thread.hpp"
 #include "foedus/xct/xct_manager.hpp"
 
@@ -112,6 +113,7 @@ ErrorStack TpccClientTask::run_impl(thread::Thread* context) {
     << from_wid_ << "-" << to_wid_;
 
   context->reset_snapshot_cache_counts();
+  context->get_latency_histograms()->reset();
 
   while (!is_stop_requested()) {
     Wid wid = from_wid_;  // home WID. some transaction randomly uses remote WID.
@@ -351,6 +351,7 @@ TpccDriver::Result TpccDriver::run() {
       result.snapshot_cache_hits_ += output->snapshot_cache_hits_;
       result.snapshot_cache_misses_ += output->snapshot_cache_misses_;
     }
+    engine_->get_thread_pool()->get_latency_histograms_sum(&result.latencies_);
     LOG(INFO) << "Intermediate report after " << result.duration_sec_ << " sec";
     LOG(INFO) << result;
     LOG(INFO) << engine_->get_memory_manager()->dump_free_memory_stat();
@@ -389,6 +390,7 @@ TpccDriver::Result TpccDriver::run() {
     result.snapshot_cache_hits_ += output->snapshot_cache_hits_;
     result.snapshot_cache_misses_ += output->snapshot_cache_misses_;
   }
+  engine_->get_thread_pool()->get_latency_histograms_sum(&result.latencies_);
   LOG(INFO) << "Shutting down...";
 
   // output the current memory state at the end
@@ -712,6 +714,7 @@ std::ostream& operator<<(std::ostream& o, const TpccDriver::Result& v) {
     << "<unexpected_aborts_>" << v.unexpected_aborts_ << "</unexpected_aborts_>"
     << "<snapshot_cache_hits_>" << v.snapshot_cache_hits_ << "</snapshot_cache_hits_>"
     << "<snapshot_cache_misses_>" << v.snapshot_cache_misses_ << "</snapshot_cache_misses_>"
+    << "<latencies_>" << v.latencies_ << "</latencies_>"
     << "</total_result>";
   return o;
 }
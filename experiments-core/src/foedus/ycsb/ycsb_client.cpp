@@ -48,6 +48,7 @@
 #include "foedus/storage/masstree/masstree_metadata.hpp"
 #include "foedus/storage/masstree/masstree_page_impl.hpp"
 #include "foedus/storage/masstree/masstree_storage.hpp"
+#include "foedus/thread/latency_histogram.hpp"
 #include "foedus/thread/thread.hpp"
 #include "foedus/xct/xct.hpp"
 #include "foedus/xct/xct_manager.hpp"
@@ -111,6 +112,7 @@ ErrorStack YcsbClientTask::run(thread::Thread* context) {
   channel_->exit_nodes_--;
   ASSERT_ND(channel_->exit_nodes_ <= total_thread_count);
   channel_->start_rendezvous_.wait();
+  context_->get_latency_histograms()->reset();  // exclude loading/warmup from the measurement
   LOG(INFO) << "YCSB Client-" << worker_id_
     << " started working on workload " << workload_.desc_ << "!";
 
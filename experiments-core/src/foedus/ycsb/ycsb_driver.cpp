@@ -692,6 +692,7 @@ ErrorStack YcsbDriver::run() {
       result.snapshot_cache_hits_ += output->snapshot_cache_hits_;
       result.snapshot_cache_misses_ += output->snapshot_cache_misses_;
     }
+    engine_->get_thread_pool()->get_latency_histograms_sum(&result.latencies_);
     LOG(INFO) << "Intermediate report after " << result.duration_sec_ << " sec";
     LOG(INFO) << result;
   }
@@ -745,6 +746,7 @@ ErrorStack YcsbDriver::run() {
       }
     }
   }
+  engine_->get_thread_pool()->get_latency_histograms_sum(&result.latencies_);
 
   LOG(INFO) << "Shutting down...";
 
@@ -912,6 +914,7 @@ std::ostream& operator<<(std::ostream& o, const YcsbDriver::Result& v) {
     << "<unexpected_aborts_>" << v.unexpected_aborts_ << "</unexpected_aborts_>"
     << "<snapshot_cache_hits_>" << v.snapshot_cache_hits_ << "</snapshot_cache_hits_>"
     << "<snapshot_cache_misses_>" << v.snapshot_cache_misses_ << "</snapshot_cache_misses_>"
+    << "<latencies_>" << v.latencies_ << "</latencies_>"
     << "</total_result>";
   return o;
 }
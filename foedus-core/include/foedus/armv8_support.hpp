@@ -88,6 +88,13 @@
  * [Dec14]
  * foedus/debugging/rdtsc.hpp uses x86's rdtsc as a low-overhead high-precision counter.
  * The equivalent on ARMv8 is cntvct_el0, which can be used in user mode unlike earlier ARM ISA.
+ *
+ * @par SIMD
+ * [Oct26]
+ * foedus/storage/masstree/masstree_slice_search.hpp compares key slices with SIMD.
+ * On x86 it uses immintrin.h (SSE2 by default, AVX2/AVX-512 if the compiler is allowed to).
+ * On AArch64 it uses arm_neon.h instead, which is always available in gcc-AArch64.
+ * NEON has vceqq_u64 for 64-bit equality, but no movemask; we extract the two lanes.
  */
 
 #endif  // FOEDUS_ARMV8_SUPPORT_HPP_
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_ASSORTED_RADIX_SORT_HPP_
+#define FOEDUS_ASSORTED_RADIX_SORT_HPP_
+
+#include <stdint.h>
+
+namespace foedus {
+namespace assorted {
+
+/** Inputs smaller than this are sorted with std::stable_sort rather than radix sort. */
+const uint32_t kRadixSortMinCount = 1U << 10;
+/** Inputs smaller than this are sorted by one thread even if more threads are allowed. */
+const uint32_t kRadixSortParallelMinCount = 1U << 20;
+
+/**
+ * @brief Sorts 128-bit integers by their higher bits with radix sort.
+ * @ingroup ASSORTED
+ * @param[in,out] data the integers to sort
+ * @param[in] count number of integers
+ * @param[in] buffer work memory for at least count integers. Garbage afterwards.
+ * @param[in] ignored_low_bits the lowest bits that are not part of the sort key.
+ * @param[in] max_threads up to this many threads sort a large input in parallel.
+ * 1 means the calling thread does everything.
+ * @details
+ * This is a stable sort on the key (data >> ignored_low_bits). Integers with the same key
+ * keep their order in the input.
+ * We use 11-bit digits. The first pass splits the input by the highest 11 bits that
+ * differ among the keys (MSD), then each bucket is sorted by the remaining digits (LSD),
+ * skipping digits in which all integers of the bucket have the same value.
+ * The sort entries of partitioners have mostly-zero higher bits in keys, epochs, and ordinals,
+ * so the actual number of passes is usually much smaller than 128/11, while std::sort needs
+ * log(count) passes. Buckets are usually small enough to fit in CPU caches.
+ *
+ * For large inputs, the MSD pass is parallelized by splitting the input into max_threads
+ * chunks, and the buckets are then sorted by the threads independently.
+ */
+void radix_sort_uint128(
+  __uint128_t* data,
+  uint32_t count,
+  __uint128_t* buffer,
+  uint16_t ignored_low_bits,
+  uint16_t max_threads);
+
+}  // namespace assorted
+}  // namespace foedus
+
+#endif  // FOEDUS_ASSORTED_RADIX_SORT_HPP_
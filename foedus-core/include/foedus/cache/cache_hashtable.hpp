@@ -21,6 +21,7 @@
 #include <stdint.h>
 
 #include <iosfwd>
+#include <vector>
 
 #include "foedus/assert_nd.hpp"
 #include "foedus/compiler.hpp"
@@ -30,6 +31,7 @@
 #include "foedus/assorted/atomic_fences.hpp"
 #include "foedus/assorted/cacheline.hpp"
 #include "foedus/assorted/const_div.hpp"
+#include "foedus/cache/cache_options.hpp"
 #include "foedus/cache/fwd.hpp"
 #include "foedus/memory/aligned_memory.hpp"
 #include "foedus/memory/fwd.hpp"
@@ -159,8 +161,18 @@ struct CacheBucket CXX11_FINAL {
   }
 };
 
-/** A loosely maintained reference count for CLOCK algorithm. */
+/**
+ * @brief A loosely maintained reference count for CLOCK algorithm.
+ * @details
+ * install() sets kProbationCount, and each find() increments it.
+ * Thus, an entry whose count is kProbationCount has not been accessed since it was installed
+ * (or since CLOCK decremented it), which kEvictionPolicyScanResistant evicts first.
+ */
 struct CacheRefCount CXX11_FINAL {
+  enum Constants {
+    /** Count of an entry that has not been accessed since installed. */
+    kProbationCount = 1,
+  };
   uint16_t count_;
 
   void increment() ALWAYS_INLINE {
@@ -241,6 +253,8 @@ class CacheHashtable CXX11_FINAL {
   /**
    * @brief Returns an offset for the given page ID \e opportunistically.
    * @param[in] page_id Page ID to look for
+   * @param[in] promote Whether to increment the refcount of the found entry.
+   * false for large scans that should not make the pages look hot.
    * @return offset that contains the page. 0 if not found.
    * @details
    * This doesn't take a lock, so a concurrent thread might have inserted the wanted page
@@ -256,13 +270,14 @@ class CacheHashtable CXX11_FINAL {
    * Again, no precise concurrency control required. Even for false positives/negatives,
    * we just get a bit slower. No correctness issue.
    */
-  ContentId find(storage::SnapshotPagePointer page_id) const ALWAYS_INLINE;
+  ContentId find(storage::SnapshotPagePointer page_id, bool promote = true) const ALWAYS_INLINE;
 
   /**
    * @brief Batched version of find().
    * @param[in] batch_size Batch size. Must be kMaxFindBatchSize or less.
    * @param[in] page_ids Array of Page IDs to look for, size=batch_size
    * @param[out] out Output
+   * @param[in] promote Same as find()
    * @return Only possible error is kErrorCodeInvalidParameter for too large batch_size
    * @details
    * This might perform much faster because of parallel prefetching, SIMD-ized hash
@@ -271,7 +286,8 @@ class CacheHashtable CXX11_FINAL {
   ErrorCode find_batch(
     uint16_t batch_size,
     const storage::SnapshotPagePointer* page_ids,
-    ContentId* out) const;
+    ContentId* out,
+    bool promote = true) const;
 
   /**
    * @brief Called when a cached page is not found.
@@ -290,6 +306,8 @@ class CacheHashtable CXX11_FINAL {
     uint64_t  evicted_count_;
     /** [Out] Array of ContentId evicted. */
     ContentId* evicted_contents_;
+    /** [In] How to choose entries to evict. kEvictionPolicyClock if not specified. */
+    CacheOptions::EvictionPolicy policy_;
     // probably will add more in/out parameters to fine-tune its behavior later.
 
     void add_evicted(ContentId content) {
@@ -307,6 +325,9 @@ class CacheHashtable CXX11_FINAL {
    * the loose requirements and epoch-based reclamation of the evicted pages.
    * This method only evicts the hashtable entries, so reclaiming the pages pointed from the
    * entries is done by the caller.
+   * With kEvictionPolicyScanResistant, we first evict probationary entries
+   * (see CacheRefCount) up to one round over the table, then do the usual CLOCK sweep
+   * only if it is not enough.
    */
   void evict(EvictArgs* args);
 
@@ -320,6 +341,20 @@ class CacheHashtable CXX11_FINAL {
     return hash_func_.get_bucket_number(page_id);
   }
 
+  /**
+   * @brief Collects contents of the entries whose refcount is min_refcount or more.
+   * @param[in] min_refcount entries with smaller refcounts are ignored
+   * @param[in] max_count at most this number of contents are returned
+   * @param[out] out the contents, larger refcounts first.
+   * @details
+   * This is used to remember hot pages for warming up the cache after restart.
+   * You can call this in a race. The result is just a bit inaccurate.
+   */
+  void get_hot_contents(
+    uint16_t min_refcount,
+    uint32_t max_count,
+    std::vector<ContentId>* out) const;
+
   /** only for debugging. don't call this in a race */
   ErrorStack verify_single_thread() const;
 
@@ -376,8 +411,14 @@ class CacheHashtable CXX11_FINAL {
    * so we don't have a dedicated clock hand for overflow list.
    */
   BucketId                  clockhand_;
+  /**
+   * Same as clockhand_, but for the probationary entries in kEvictionPolicyScanResistant.
+   * Separated from clockhand_ so that the two sweeps don't skip each other's ranges.
+   */
+  BucketId                  probation_clockhand_;
 
   BucketId  evict_main_loop(EvictArgs* args, BucketId cur, uint16_t loop);
+  void      evict_probation_loop(EvictArgs* args);
   void      evict_overflow_loop(EvictArgs* args, uint16_t loop);
 };
 
@@ -412,7 +453,7 @@ inline PageIdTag HashFunc::get_tag(storage::SnapshotPagePointer page_id) {
   return tag;
 }
 
-inline ContentId CacheHashtable::find(storage::SnapshotPagePointer page_id) const {
+inline ContentId CacheHashtable::find(storage::SnapshotPagePointer page_id, bool promote) const {
   ASSERT_ND(page_id > 0);
   BucketId bucket_number = get_bucket_number(page_id);
   ASSERT_ND(bucket_number < get_logical_buckets());
@@ -426,7 +467,9 @@ inline ContentId CacheHashtable::find(storage::SnapshotPagePointer page_id) cons
     const CacheBucket& bucket = buckets_[bucket_number + i];
     if (bucket.get_tag() == tag) {
       // found (probably)!
-      refcounts_[bucket_number + i].increment();
+      if (promote) {
+        refcounts_[bucket_number + i].increment();
+      }
       return bucket.get_content_id();
     }
   }
@@ -435,7 +478,9 @@ inline ContentId CacheHashtable::find(storage::SnapshotPagePointer page_id) cons
   if (overflow_buckets_head_) {
     for (OverflowPointer i = overflow_buckets_head_; i != 0;) {
       if (overflow_buckets_[i].bucket_.get_tag() == tag) {
-        overflow_buckets_[i].refcount_.increment();
+        if (promote) {
+          overflow_buckets_[i].refcount_.increment();
+        }
         return overflow_buckets_[i].bucket_.get_content_id();
       }
       i = overflow_buckets_[i].next_;
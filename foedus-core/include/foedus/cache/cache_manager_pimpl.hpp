@@ -21,12 +21,16 @@
 #include <atomic>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "foedus/fwd.hpp"
 #include "foedus/initializable.hpp"
 #include "foedus/cache/fwd.hpp"
+#include "foedus/debugging/stop_watch.hpp"
 #include "foedus/memory/aligned_memory.hpp"
 #include "foedus/memory/page_pool.hpp"
+#include "foedus/storage/storage_id.hpp"
 
 namespace foedus {
 namespace cache {
@@ -39,7 +43,12 @@ namespace cache {
  *
  * @par Eviction Policy
  * So far we use a simple CLOCK algorithm to minimize the overhead, especially synchronization
- * overhead.
+ * overhead. See CacheOptions::EvictionPolicy for its scan-resistant variant.
+ *
+ * @par Warm-up
+ * If CacheOptions::snapshot_cache_warmup_enabled_, the cleaner thread also periodically
+ * writes the IDs of hot snapshot pages to get_hot_pages_path(). initialize_once() reads them
+ * back into the cache before the cleaner and worker threads start.
  */
 class CacheManagerPimpl final : public DefaultInitializable {
  public:
@@ -60,6 +69,30 @@ class CacheManagerPimpl final : public DefaultInitializable {
 
   ErrorStack  stop_cleaner();
 
+  /** Path of the file that lists hot snapshot pages in this node. */
+  std::string get_hot_pages_path() const;
+  /**
+   * Writes the IDs of hot snapshot pages to get_hot_pages_path().
+   * Failures are just logged because this is only an optimization.
+   */
+  void        persist_hot_pages();
+  /**
+   * Reads the pages listed in get_hot_pages_path() into the cache.
+   * Invalid or missing pages are skipped.
+   */
+  ErrorStack  warmup();
+  /**
+   * Body of the threads in warmup().
+   * Reads runs[worker], runs[worker + threads], ... of page_ids and installs them.
+   * Each run is a [begin, end) range of indexes in page_ids, read from the file in one read.
+   */
+  void        warmup_worker(
+    uint16_t worker,
+    uint16_t threads,
+    const std::vector< storage::SnapshotPagePointer >& page_ids,
+    const std::vector< std::pair<uint32_t, uint32_t> >& runs,
+    std::atomic<uint64_t>* installed_count);
+
   Engine* const     engine_;
 
   /**
@@ -110,6 +143,9 @@ class CacheManagerPimpl final : public DefaultInitializable {
 
   /** Number of pages buffered so far. */
   uint64_t  reclaimed_pages_count_;
+
+  /** Measures the time since persist_hot_pages() was called last time. */
+  debugging::StopWatch  persist_watch_;
 };
 }  // namespace cache
 }  // namespace foedus
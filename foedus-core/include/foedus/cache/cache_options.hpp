@@ -31,6 +31,26 @@ struct CacheOptions CXX11_FINAL : public virtual externalize::Externalizable {
   enum Constants {
     /** Default value for snapshot_cache_size_mb_per_node_. */
     kDefaultSnapshotCacheSizeMbPerNode = 1 << 10,
+    /** Default value for snapshot_cache_warmup_persist_interval_ms_. */
+    kDefaultSnapshotCacheWarmupPersistIntervalMs = 60000,
+    /** Default value for snapshot_cache_warmup_threads_. */
+    kDefaultSnapshotCacheWarmupThreads = 4,
+  };
+
+  /** Values for snapshot_cache_eviction_policy_. */
+  enum EvictionPolicy {
+    /**
+     * Plain CLOCK. Each eviction sweep decrements the refcount of every cached page and
+     * evicts pages whose refcount reaches zero.
+     */
+    kEvictionPolicyClock = 0,
+    /**
+     * 2Q-like variant of CLOCK. Pages that have not been accessed since they were installed
+     * (\e probationary pages) are evicted first without touching the refcounts of other pages.
+     * Only when that is not enough, we fall back to the CLOCK sweep.
+     * A large scan then evicts its own pages rather than the hot pages of other threads.
+     */
+    kEvictionPolicyScanResistant = 1,
   };
 
   /**
@@ -95,6 +115,43 @@ struct CacheOptions CXX11_FINAL : public virtual externalize::Externalizable {
    */
   float       snapshot_cache_urgent_threshold_;
 
+  /**
+   * @brief How the cache cleaner chooses pages to evict.
+   * @details
+   * Default is kEvictionPolicyClock.
+   * Consider kEvictionPolicyScanResistant if the workload mixes large scans (eg MasstreeCursor
+   * over snapshot pages) with OLTP transactions on the same NUMA node. Cursors can also
+   * avoid promoting the pages they read via MasstreeCursor::set_no_cache().
+   */
+  EvictionPolicy snapshot_cache_eviction_policy_;
+
+  /**
+   * @brief Whether to remember hot snapshot pages and read them into the cache after restart.
+   * @details
+   * If true, the cache cleaner of each node periodically writes the IDs of snapshot pages
+   * accessed after they were installed (only IDs, not the page images) to a file in the
+   * snapshot folder of the node. It does the same when the engine shuts down.
+   * When the engine starts up, the cache manager reads the listed pages into the cache before
+   * worker threads start, so that the first transactions after restart don't suffer from
+   * cache misses. Default is false.
+   */
+  bool        snapshot_cache_warmup_enabled_;
+
+  /**
+   * @brief Interval in milliseconds to persist the hot snapshot pages.
+   * @details
+   * Only when snapshot_cache_warmup_enabled_ is true. Default is 60 seconds.
+   */
+  uint32_t    snapshot_cache_warmup_persist_interval_ms_;
+
+  /**
+   * @brief Number of threads in each node that read hot snapshot pages at startup.
+   * @details
+   * Each thread reads a range of contiguous pages in one read.
+   * Only when snapshot_cache_warmup_enabled_ is true. Default is 4.
+   */
+  uint16_t    snapshot_cache_warmup_threads_;
+
   EXTERNALIZABLE(CacheOptions);
 };
 }  // namespace cache
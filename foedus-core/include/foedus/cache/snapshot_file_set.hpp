@@ -18,6 +18,8 @@
 #ifndef FOEDUS_CACHE_SNAPSHOT_FILE_SET_HPP_
 #define FOEDUS_CACHE_SNAPSHOT_FILE_SET_HPP_
 
+#include <stdint.h>
+
 #include <iosfwd>
 #include <map>
 
@@ -77,11 +79,15 @@ class SnapshotFileSet CXX11_FINAL : public DefaultInitializable {
   /** Read contiguous pages in one shot */
   ErrorCode read_pages(storage::SnapshotPagePointer page_id_begin, uint32_t page_count, void* out);
 
+  /** Number of pages read via read_page()/read_pages() so far. */
+  uint64_t  get_read_page_count() const { return read_page_count_; }
+
   friend std::ostream&    operator<<(std::ostream& o, const SnapshotFileSet& v);
 
  private:
   Engine* const engine_;
   std::map<snapshot::SnapshotId, std::map< thread::ThreadGroupId, fs::DirectIoFile* > > files_;
+  uint64_t      read_page_count_;
 };
 }  // namespace cache
 }  // namespace foedus
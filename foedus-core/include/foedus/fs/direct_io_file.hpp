@@ -131,6 +131,29 @@ class DirectIoFile {
   /** A version that receives a raw pointer that has to be aligned (be careful to use this ver). */
   ErrorCode       write_raw(uint64_t desired_bytes, const void* buffer);
 
+  /**
+   * @brief Writes the given amount of contents at the given position, analogous to POSIX pwrite().
+   * @param[in] offset Position in the file to write to. Must be aligned.
+   * @param[in] desired_bytes Number of bytes to write.
+   * @param[in] buffer Memory to read from. As this is Direct-IO, it must be aligned.
+   * @details
+   * This method neither uses nor changes the current position, so multiple threads can
+   * concurrently call this method for disjoint regions to have multiple writes in flight.
+   * The file must be opened without append flag, with which pwrite() ignores the offset.
+   * Use reserve_region() to obtain the region to write to.
+   * @pre is_opened()
+   */
+  ErrorCode       write_raw_at(uint64_t offset, uint64_t desired_bytes, const void* buffer) const;
+
+  /**
+   * @brief Moves the current position forward as if the given bytes were written.
+   * @return the position before the move, which is where the caller should write the bytes
+   * with write_raw_at().
+   * @details
+   * This method does no I/O. It just reserves a region at the current position.
+   */
+  uint64_t        reserve_region(uint64_t bytes);
+
   /**
    * @brief Discard the content of the file after the given offset.
    * @param[in] new_length The size of this file would become this value.
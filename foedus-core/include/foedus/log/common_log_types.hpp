@@ -23,6 +23,7 @@
 #include "foedus/compiler.hpp"
 #include "foedus/cxx11.hpp"
 #include "foedus/epoch.hpp"
+#include "foedus/error_code.hpp"
 #include "foedus/fwd.hpp"
 #include "foedus/assorted/assorted_func.hpp"
 #include "foedus/log/log_type.hpp"
@@ -252,6 +253,75 @@ STATIC_SIZE_CHECK(sizeof(FillerLogType), 16)
 // NOTE: As a class, it's 16 bytes. However, it might be only 8 bytes in actual log.
 // In that case, xct_id is omitted.
 
+/**
+ * @brief A block of record logs compressed by the logger.
+ * @ingroup LOG LOGTYPE
+ * @details
+ * When LogOptions::compress_logs_ is on, the logger compresses consecutive logs of a thread
+ * into this log type, each of which contains at most kMaxUncompressedLength bytes of
+ * whole log entries (a log never spans two blocks).
+ * The compressed bytes follow this header, padded to 8 bytes.
+ * If a block is not compressible, the logger writes the original logs as they are instead,
+ * so a log file might contain both compressed blocks and plain logs.
+ *
+ * This log itself is never applied. Readers of log files (LogMapper and LogReplayer)
+ * decompress the block and process the contained logs as if they were in the file.
+ */
+struct CompressedBlockLogType : public BaseLogType {
+  /** Constant values. */
+  enum Constants {
+    /**
+     * Logs are compressed in blocks of at most this size.
+     * The compressed size must fit in log_length_ (64KB) even if it is not compressible.
+     */
+    kMaxUncompressedLength = 1 << 15,
+  };
+
+  LOG_TYPE_NO_CONSTRUCT(CompressedBlockLogType)
+
+  // like FillerLogType, this is valid and skipped in every context
+  bool    is_engine_log()     const { return true; }
+  bool    is_storage_log()    const { return true; }
+  bool    is_record_log()     const { return true; }
+  void    apply_engine(thread::Thread* /*context*/) {}
+  void    apply_storage(Engine* /*engine*/, storage::StorageId /*storage_id*/) {}
+  void    apply_record(
+    thread::Thread* /*context*/,
+    storage::StorageId /*storage_id*/,
+    xct::RwLockableXctId* /*owner_id*/,
+    char* /*payload*/) {}
+
+  /** Byte size of the contained logs after decompression. */
+  uint32_t  uncompressed_length_;   // +4 => 20
+  /** Byte size of the compressed data, excluding padding. */
+  uint32_t  compressed_length_;     // +4 => 24
+  /** Compressed data. Actually of compressed_length_ bytes. */
+  char      data_[8];               // +8 => 32
+
+  static uint16_t calculate_log_length(uint32_t compressed_length) ALWAYS_INLINE {
+    return static_cast<uint16_t>(
+      assorted::align8(sizeof(CompressedBlockLogType) - 8U + compressed_length));
+  }
+
+  void    populate(uint32_t uncompressed_length, uint32_t compressed_length);
+
+  /**
+   * Decompresses the contained logs to the given buffer of uncompressed_length_ bytes.
+   * @return kErrorCodeLogCorruptedCompressedBlock if the data is corrupted.
+   */
+  ErrorCode decompress(char* buffer) const;
+
+  void    assert_valid() const ALWAYS_INLINE {
+    ASSERT_ND(header_.get_type() == kLogCodeCompressedBlock);
+    ASSERT_ND(header_.log_length_ == calculate_log_length(compressed_length_));
+    ASSERT_ND(header_.storage_id_ == 0);
+    ASSERT_ND(uncompressed_length_ <= kMaxUncompressedLength);
+  }
+
+  friend std::ostream& operator<<(std::ostream& o, const CompressedBlockLogType &v);
+};
+STATIC_SIZE_CHECK(sizeof(CompressedBlockLogType), 32)
+
 /**
  * @brief A log type to declare a switch of epoch in a logger or the engine.
  * @ingroup LOG LOGTYPE
@@ -25,6 +25,7 @@
 namespace foedus {
 namespace log {
 struct  BaseLogType;
+struct  CompressedBlockLogType;
 struct  EngineLogType;
 struct  EpochHistory;
 struct  EpochMarkerLogType;
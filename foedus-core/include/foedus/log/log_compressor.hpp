@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_LOG_LOG_COMPRESSOR_HPP_
+#define FOEDUS_LOG_LOG_COMPRESSOR_HPP_
+#include <stdint.h>
+
+namespace foedus {
+namespace log {
+
+/**
+ * @brief Compresses a block of log entries with a simple LZ77 algorithm.
+ * @ingroup LOG
+ * @param[in] src the bytes to compress. At most 64KB so that match offsets fit in 2 bytes.
+ * @param[in] src_size byte size of src
+ * @param[out] dest the compressed bytes are written here
+ * @param[in] dest_capacity at most this many bytes are written to dest
+ * @return byte size of the compressed data. 0 if it didn't fit in dest_capacity.
+ * @details
+ * The format is a variant of LZ4 block format. Each sequence consists of a token byte
+ * (4 bits of literal length and 4 bits of match length), extended literal length,
+ * literals, 2-byte match offset, and extended match length.
+ * The last sequence has only literals.
+ * Log entries have lots of repetitive headers and XctId, which this algorithm easily catches
+ * with little CPU cost. We don't pursue a high compression ratio because the logger
+ * must keep up with all workers assigned to it.
+ *
+ * Callers are expected to give a dest_capacity smaller than src_size so that an incompressible
+ * block quickly returns 0, in which case the block should be written as is.
+ */
+uint32_t compress_log_block(
+  const char* src,
+  uint32_t src_size,
+  char* dest,
+  uint32_t dest_capacity);
+
+/**
+ * @brief Decompresses a block compressed by compress_log_block().
+ * @ingroup LOG
+ * @param[in] src the compressed bytes
+ * @param[in] src_size byte size of src
+ * @param[out] dest the original bytes are written here
+ * @param[in] dest_size byte size of the original bytes
+ * @return whether the block is decompressed to exactly dest_size bytes.
+ * false if the block is corrupted, in which case dest is garbage.
+ */
+bool decompress_log_block(
+  const char* src,
+  uint32_t src_size,
+  char* dest,
+  uint32_t dest_size);
+
+}  // namespace log
+}  // namespace foedus
+#endif  // FOEDUS_LOG_LOG_COMPRESSOR_HPP_
@@ -100,6 +100,34 @@ struct LogOptions CXX11_FINAL : public virtual externalize::Externalizable {
    */
   bool                        flush_at_shutdown_;
 
+  /**
+   * @brief Whether loggers compress logs before writing them out.
+   * @details
+   * If true, each logger compresses the logs of each thread in each epoch in blocks of
+   * CompressedBlockLogType::kMaxUncompressedLength bytes with an LZ4-like algorithm.
+   * This costs CPU in loggers but reduces the bandwidth to the log device, which is
+   * beneficial when the device is the bottleneck, eg with many loggers per device.
+   * Log mappers and log replayers read both compressed and uncompressed logs regardless of
+   * this setting, so you can change it across restarts.
+   * Default is false.
+   */
+  bool                        compress_logs_;
+
+  /**
+   * @brief Number of helper threads per logger that write out logs in parallel.
+   * @details
+   * If 0, each logger sequentially writes out logs by itself, having only one write in flight.
+   * If more than 0, each logger reserves regions in its file for the logs of an epoch and
+   * lets this many threads write them out to the regions with positional writes, which keeps
+   * multiple writes in flight. This is beneficial for devices that need a deep I/O queue to
+   * saturate, such as NVMe SSDs. The logger still writes epoch markers and fsyncs by itself
+   * after all writes of the epoch complete, so the content of log files is exactly the same
+   * either way. To stripe logs across multiple devices, use loggers_per_node_ and $LOGGER$
+   * in folder_path_pattern_ instead.
+   * Default is 0.
+   */
+  uint16_t                    writers_per_logger_;
+
   /** Settings to emulate slower logging device. */
   foedus::fs::DeviceEmulationOptions emulation_;
 
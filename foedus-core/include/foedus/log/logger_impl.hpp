@@ -20,6 +20,8 @@
 #include <stdint.h>
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <iosfwd>
 #include <mutex>
 #include <string>
@@ -28,6 +30,7 @@
 
 #include "foedus/attachable.hpp"
 #include "foedus/epoch.hpp"
+#include "foedus/error_code.hpp"
 #include "foedus/fwd.hpp"
 #include "foedus/initializable.hpp"
 #include "foedus/fs/fwd.hpp"
@@ -167,6 +170,16 @@ struct LoggerControlBlock {
  */
 class Logger final : public DefaultInitializable, public LoggerRef {
  public:
+  enum Constants {
+    /** Size of compress_buffer_. */
+    kCompressBufferSize = 1 << 22,
+    /**
+     * Max size of one write handed over to writer threads. Larger regions are split
+     * so that even the logs of one thread are written out by multiple writers in parallel.
+     */
+    kMaxAsyncWriteSize = 1 << 20,
+  };
+
   Logger(
     Engine* engine,
     LoggerControlBlock* control_block,
@@ -200,6 +213,33 @@ class Logger final : public DefaultInitializable, public LoggerRef {
    * This method exits when this object's uninitialize() is called.
    */
   void        handle_logger();
+  /**
+   * @brief Main routine for writer_threads_.
+   * @details
+   * Each writer thread keeps taking a write request from write_requests_ and writes it out
+   * to the reserved region with a positional write. Exits when writer_stop_requested_ is set.
+   */
+  void        handle_writer();
+
+  /** Opens current_file_path_ as current_file_, in non-append mode if we have writers. */
+  ErrorStack  open_current_file();
+  /**
+   * @brief Writes out the given bytes to the end of current file.
+   * @param[in] buffer aligned memory to write out
+   * @param[in] bytes aligned bytes to write out
+   * @param[in] asynchronous whether writer threads can write it out later. If true, the caller
+   * must keep the buffer intact until wait_for_writes(). Ignored if we have no writer.
+   * @details
+   * All writes to log files go through this method. Without writer threads, this simply
+   * appends to the file. With writer threads, this reserves the region at the end of
+   * the file, then writes it out synchronously or hands it over to writers.
+   */
+  ErrorStack  write_to_file(const void* buffer, uint64_t bytes, bool asynchronous);
+  /**
+   * Waits until writer threads complete all write requests so far.
+   * @return the first error writer threads observed since the previous call, if any
+   */
+  ErrorStack  wait_for_writes();
 
   /**
    * Check if we can advance the durable epoch of this logger, invoking fsync BEFORE actually
@@ -245,6 +285,13 @@ class Logger final : public DefaultInitializable, public LoggerRef {
   ErrorStack  write_one_epoch(Epoch write_epoch);
   /**
    * Sub-routine of write_one_epoch().
+   * Issues writes of the logs in all buffers for the given epoch, but doesn't wait for them.
+   * @param[in] write_epoch the epoch to write out
+   * @param[out] had_any_log set to true if any buffer had logs in the epoch
+   */
+  ErrorStack  write_one_epoch_buffers(Epoch write_epoch, bool* had_any_log);
+  /**
+   * Sub-routine of write_one_epoch_buffers().
    * Writes out the given piece of the given buffer.
    * This method handles non-aligned starting/ending offsets by padding.
    * @pre from_offset < upto_offset (no wrap around)
@@ -254,6 +301,14 @@ class Logger final : public DefaultInitializable, public LoggerRef {
     Epoch write_epoch,
     uint64_t from_offset,
     uint64_t upto_offset);
+  /**
+   * Sub-routine of write_one_epoch_piece() when LogOptions::compress_logs_ is on.
+   * Compresses the given logs into compress_buffer_ and writes them out.
+   * Unlike the uncompressed case, this always copies the logs, so no need to care alignment.
+   */
+  ErrorStack  write_one_epoch_piece_compressed(const char* logs, uint64_t bytes);
+  /** Pads compress_buffer_ to 4kb and writes out the given bytes in it. */
+  ErrorStack  flush_compress_buffer(uint64_t written);
 
   /** Check invariants. This method is wiped out in NDEBUG. */
   void        assert_consistent();
@@ -280,6 +335,13 @@ class Logger final : public DefaultInitializable, public LoggerRef {
    */
   memory::AlignedMemory           fill_buffer_;
 
+  /**
+   * @brief Output buffer to compress logs into before writing them out.
+   * @details
+   * Allocated only when LogOptions::compress_logs_ is on. Otherwise null.
+   */
+  memory::AlignedMemory           compress_buffer_;
+
   /**
    * @brief The log file this logger is currently appending to.
    */
@@ -291,6 +353,31 @@ class Logger final : public DefaultInitializable, public LoggerRef {
 
   std::vector< thread::Thread* >  assigned_threads_;
 
+  /** A region of the current file a writer thread writes out. */
+  struct WriteRequest {
+    uint64_t    offset_;
+    uint64_t    bytes_;
+    const void* buffer_;
+  };
+  /**
+   * Helper threads to keep multiple writes in flight. Empty if LogOptions::writers_per_logger_
+   * is 0, in which case the logger thread writes out everything by itself.
+   */
+  std::vector< std::thread >      writer_threads_;
+  /** Protects all writer_xxx and write_xxx members below. */
+  std::mutex                      writer_mutex_;
+  /** Notified when a new request is queued or writer_stop_requested_ is set. */
+  std::condition_variable         writer_wakeup_cond_;
+  /** Notified when writes_in_flight_ becomes 0. */
+  std::condition_variable         writer_done_cond_;
+  /** Write requests not taken by writers yet. */
+  std::deque< WriteRequest >      write_requests_;
+  /** Number of write requests queued or being written out. */
+  uint32_t                        writes_in_flight_;
+  /** The first error writers observed since the previous wait_for_writes(). */
+  ErrorCode                       write_error_;
+  bool                            writer_stop_requested_;
+
   /** protects log_epoch_switch() from concurrent accesses. */
   std::mutex                      epoch_switch_mutex_;
 };
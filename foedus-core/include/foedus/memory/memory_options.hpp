@@ -130,6 +130,19 @@ struct MemoryOptions CXX11_FINAL : public virtual externalize::Externalizable {
    */
   uint32_t    private_page_pool_initial_grab_;
 
+  /**
+   * @brief Number of shards the free pool of each volatile/snapshot page pool is split into.
+   * @details
+   * Each shard has its own lock, and threads grab/release pages from/to the shard
+   * determined by the CPU they run on, falling back to other shards only when it runs out.
+   * Default is 1, which is a single free pool with a single lock.
+   * This is enough in most cases because threads exchange many pages at once with the pool.
+   * Consider increasing it only if the pool lock shows up in profiles, for example
+   * split-heavy inserts on machines with many cores per node.
+   * Must be between 1 and PagePoolControlBlock::kMaxFreePoolShards (16).
+   */
+  uint16_t    page_pool_free_pool_shards_;
+
   EXTERNALIZABLE(MemoryOptions);
 };
 }  // namespace memory
@@ -52,6 +52,7 @@ class NumaCoreMemory CXX11_FINAL : public DefaultInitializable {
     char* xct_page_version_memory_;
     char* xct_read_access_memory_;
     char* xct_write_access_memory_;
+    char* xct_write_set_index_memory_;
     char* xct_lock_free_read_access_memory_;
     char* xct_lock_free_write_access_memory_;
   };
@@ -184,7 +184,8 @@ class PagePool CXX11_FINAL : public virtual Initializable {
     void* memory,
     uint64_t memory_size,
     bool owns,
-    bool rigorous_page_boundary_check);
+    bool rigorous_page_boundary_check,
+    uint16_t free_pool_shards = 1);
 
   // Disable default constructors
   PagePool(const PagePool&) CXX11_FUNC_DELETE;
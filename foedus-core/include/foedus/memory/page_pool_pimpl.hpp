@@ -36,32 +36,65 @@
 
 namespace foedus {
 namespace memory {
+/**
+ * One shard of the free pool in PagePoolControlBlock.
+ * Each shard is a circular queue on its own range of the free pool array, protected by
+ * its own lock. Padded to avoid false sharing between shards.
+ */
+struct PagePoolFreePoolShard {
+  PagePoolFreePoolShard() = delete;
+  ~PagePoolFreePoolShard() = delete;
+
+  /** Index of the first free pool entry of this shard. Immutable once initialized. */
+  uint64_t                        begin_;
+  /** Number of free pool entries of this shard. Immutable once initialized. */
+  uint64_t                        capacity_;
+  /** Inclusive head of the circular queue, relative to begin_. Be aware of wrapping around. */
+  uint64_t                        head_;
+  /** Number of free pages in this shard. */
+  uint64_t                        count_;
+  /** grab()/release() on this shard are protected with this lock. */
+  soc::SharedMutex                lock_;
+
+  char                            padding_[128 - sizeof(uint64_t) * 4 - sizeof(soc::SharedMutex)];
+};
+static_assert(sizeof(PagePoolFreePoolShard) == 128, "PagePoolFreePoolShard is not 128 bytes.");
+
 /** Shared data in PagePoolPimpl. */
 struct PagePoolControlBlock {
+  enum Constants {
+    /** Upper limit of MemoryOptions::page_pool_free_pool_shards_. */
+    kMaxFreePoolShards = 16,
+  };
+
   // this is backed by shared memory. not instantiation. just reinterpret_cast.
   PagePoolControlBlock() = delete;
   ~PagePoolControlBlock() = delete;
 
   void initialize() {
-    lock_.initialize();
+    for (uint16_t i = 0; i < free_pool_shards_; ++i) {
+      shards_[i].lock_.initialize();
+    }
   }
   void uninitialize() {
-    lock_.uninitialize();
+    for (uint16_t i = 0; i < free_pool_shards_; ++i) {
+      shards_[i].lock_.uninitialize();
+    }
   }
 
-  /** Inclusive head of the circular queue. Be aware of wrapping around. */
-  uint64_t                        free_pool_head_;
-  /** Number of free pages. */
-  uint64_t                        free_pool_count_;
+  /** @copydoc foedus::memory::MemoryOptions::page_pool_free_pool_shards_ */
+  uint16_t                        free_pool_shards_;
 
   /** just for debugging/logging. concise description of this pool instance. eg "VolatilePool-3". */
   assorted::FixedString<60>       debug_pool_name_;
 
   /**
-   * grab()/release() are protected with this lock.
-   * This lock is not contentious at all because we pack many pointers in a chunk.
+   * The free pool is split into this many shards, each with its own lock.
+   * With one shard (default), the lock is not contentious at all because we pack many pointers
+   * in a chunk. However, when private pools drain under heavy page allocations on many cores,
+   * the single lock shows up. More shards spread the exchanges over multiple locks.
    */
-  soc::SharedMutex                lock_;
+  PagePoolFreePoolShard           shards_[kMaxFreePoolShards];
 };
 
 /**
@@ -79,7 +112,8 @@ class PagePoolPimpl final : public DefaultInitializable {
     void* memory,
     uint64_t memory_size,
     bool owns,
-    bool rigorous_page_boundary_check);
+    bool rigorous_page_boundary_check,
+    uint16_t free_pool_shards);
   ErrorStack  initialize_once() override;
   ErrorStack  uninitialize_once() override;
 
@@ -95,31 +129,62 @@ class PagePoolPimpl final : public DefaultInitializable {
   void                release_one(PagePoolOffset offset);
   const LocalPageResolver& get_resolver() const { return resolver_; }
   PagePool::Stat      get_stat() const;
-  uint64_t&           free_pool_head() { return control_block_->free_pool_head_;}
-  uint64_t            free_pool_head() const { return control_block_->free_pool_head_;}
   uint64_t            get_free_pool_capacity() const { return free_pool_capacity_; }
-  uint64_t  get_free_pool_count() const { return control_block_->free_pool_count_;}
-  void      increase_free_pool_count(uint64_t op) { control_block_->free_pool_count_ += op; }
-  void      decrease_free_pool_count(uint64_t op) {
-    ASSERT_ND(control_block_->free_pool_count_ >= op);
-    control_block_->free_pool_count_ -= op;
+  uint16_t            get_free_pool_shards() const { return control_block_->free_pool_shards_; }
+  PagePoolFreePoolShard* get_shard(uint16_t shard) { return control_block_->shards_ + shard; }
+  const PagePoolFreePoolShard* get_shard(uint16_t shard) const {
+    return control_block_->shards_ + shard;
   }
-  /** Not thread safe. Use it after taking a lock. */
-  void                assert_free_pool() const {
+  /**
+   * The shard the calling thread grabs from and releases to in the first place.
+   * Determined by the CPU the thread is currently running on, so threads on the same
+   * core group tend to share a shard. Other shards are used only when the shard runs out.
+   */
+  uint16_t            choose_home_shard() const;
+  /** Sum of free pages in all shards. Not an atomic snapshot unless all locks are taken. */
+  uint64_t            get_free_pool_count() const {
+    uint64_t total = 0;
+    for (uint16_t i = 0; i < get_free_pool_shards(); ++i) {
+      total += get_shard(i)->count_;
+    }
+    return total;
+  }
+
+  /** Grabs at most desired_grab_count pages from the shard. Returns the number grabbed. */
+  uint32_t            grab_from_shard(
+    PagePoolFreePoolShard* shard,
+    uint32_t desired_grab_count,
+    PagePoolOffsetChunk* chunk);
+  /** Releases at most desired_release_count pages to the shard. Returns the number released. */
+  template <typename CHUNK>
+  uint32_t            release_to_shard(
+    PagePoolFreePoolShard* shard,
+    uint32_t desired_release_count,
+    CHUNK* chunk);
+
+  /** Not thread safe. Use it after taking the lock of the shard. */
+  void                assert_free_pool(const PagePoolFreePoolShard* shard) const {
+    UNUSED_ND(shard);
 #ifndef NDEBUG
-    const uint64_t free_count = get_free_pool_count();
-    const uint64_t free_head = free_pool_head();
-    for (uint64_t i = 0; i < free_count; ++i) {
-      uint64_t index = free_head + i;
-      while (index >= free_pool_capacity_) {
-        index -= free_pool_capacity_;
+    for (uint64_t i = 0; i < shard->count_; ++i) {
+      uint64_t index = shard->head_ + i;
+      while (index >= shard->capacity_) {
+        index -= shard->capacity_;
       }
-      PagePoolOffset* address = free_pool_ + index;
+      PagePoolOffset* address = free_pool_ + shard->begin_ + index;
       ASSERT_ND(*address >= pages_for_free_pool_);
       ASSERT_ND(*address < pool_size_);
     }
 #endif  // NDEBUG
   }
+  /** Not thread safe at all. Use it only when no one else is using this pool. */
+  void                assert_free_pool_all() const {
+#ifndef NDEBUG
+    for (uint16_t i = 0; i < get_free_pool_shards(); ++i) {
+      assert_free_pool(get_shard(i));
+    }
+#endif  // NDEBUG
+  }
 
   std::string         get_debug_pool_name() const {
     if (control_block_) {
@@ -154,6 +219,12 @@ class PagePoolPimpl final : public DefaultInitializable {
   /** @copydoc foedus::memory::MemoryOptions::rigorous_page_boundary_check_ */
   bool                            rigorous_page_boundary_check_;
 
+  /**
+   * Number of free pool shards requested by the owner. Used only in initialize_once().
+   * Others read PagePoolControlBlock::free_pool_shards_ instead.
+   */
+  uint16_t                        free_pool_shards_;
+
   /**
    * An object to resolve an offset in \e this page pool (thus \e local) to an actual
    * pointer and vice versa.
@@ -175,7 +246,7 @@ class PagePoolPimpl final : public DefaultInitializable {
   uint64_t                        pages_for_free_pool_;
 
   /**
-   * We maintain free pages as a simple circular queue.
+   * We maintain free pages as simple circular queues, one for each shard.
    * We append new/released pages to tail while we eat from head.
    */
   PagePoolOffset*                 free_pool_;
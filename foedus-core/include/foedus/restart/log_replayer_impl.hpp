@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_RESTART_LOG_REPLAYER_IMPL_HPP_
+#define FOEDUS_RESTART_LOG_REPLAYER_IMPL_HPP_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "foedus/epoch.hpp"
+#include "foedus/error_stack.hpp"
+#include "foedus/fwd.hpp"
+#include "foedus/log/fwd.hpp"
+#include "foedus/log/log_id.hpp"
+#include "foedus/memory/aligned_memory.hpp"
+#include "foedus/proc/proc_id.hpp"
+#include "foedus/restart/fwd.hpp"
+#include "foedus/storage/storage_id.hpp"
+#include "foedus/thread/fwd.hpp"
+
+namespace foedus {
+namespace restart {
+
+/**
+ * @brief Input of LogReplayer given via impersonation.
+ * @ingroup RESTART
+ * @details
+ * The log ranges are calculated by the master engine and passed to all replayers so that
+ * all of them see exactly the same set of logs.
+ * This is a variable-length struct. Use calculate_size() to get the actual size.
+ */
+struct LogReplayerInput {
+  /** Logs in this epoch or before are already in the snapshot. Might be invalid. */
+  Epoch         snapshot_epoch_;
+  /** Logs after this epoch are not durable and thus ignored. */
+  Epoch         durable_epoch_;
+  /** Storages whose ID modulo partition_count_ is this value are replayed by this replayer. */
+  uint16_t      partition_;
+  uint16_t      partition_count_;
+  uint16_t      logger_count_;
+  uint16_t      loggers_per_node_;
+  /** Range of logs to read in each logger. Actually of logger_count_ entries. */
+  log::LogRange log_ranges_[1];
+
+  static uint32_t calculate_size(uint16_t logger_count) {
+    return sizeof(LogReplayerInput) + sizeof(log::LogRange) * (logger_count - 1U);
+  }
+};
+
+/**
+ * @brief Replays durable record logs into volatile pages during restart.
+ * @ingroup RESTART
+ * @details
+ * When RestartOptions::replay_logs_ is on, RestartManagerPimpl::recover() launches this
+ * in worker threads instead of taking a snapshot of all logs since the previous snapshot.
+ *
+ * @par Partitioning
+ * Each replayer is responsible for a set of storages, partitioned by storage ID.
+ * All logs of one storage are thus applied by one thread, which makes ordering trivial.
+ * Each replayer reads the log files of all loggers by itself into its NUMA-local buffers.
+ *
+ * @par Ordering
+ * Each logger's file is ordered by epoch, but logs of different threads in the same epoch
+ * are not ordered. We thus process one epoch at a time, merging logs of the epoch
+ * from all loggers, and sort them by the in-epoch ordinal of XctId.
+ * The ordinal is strictly increasing for each record, so this gives a correct
+ * serialization order per record. The sort is stable so that multiple logs of one
+ * transaction keep their order.
+ *
+ * @par Applying logs
+ * Each log is re-executed as a transaction of the corresponding storage API, so that
+ * all the physical details (page splits, record expansion, etc) are handled as usual.
+ * Logs generated by these transactions are discarded before commit because the
+ * original logs are still in the log files and will be snapshotted later.
+ */
+class LogReplayer final {
+ public:
+  /** Name of the system procedure that runs a replayer. */
+  static const char* const kProcName;
+  /** The system procedure registered in all SOCs. Input is LogReplayerInput. */
+  static ErrorStack replay_proc(const proc::ProcArguments& args);
+
+  LogReplayer(thread::Thread* context, const LogReplayerInput* input);
+
+  ErrorStack replay();
+
+  uint64_t get_replayed_count() const { return replayed_count_; }
+  uint64_t get_skipped_count() const { return skipped_count_; }
+
+ private:
+  /** Sequentially reads the log files of one logger. */
+  struct LogStream {
+    log::LoggerId         logger_id_;
+    uint16_t              numa_node_;
+    log::LogRange         range_;
+    log::LogFileOrdinal   cur_file_ordinal_;
+    /** Offset in the file that corresponds to the beginning of io_buffer_. Aligned. */
+    uint64_t              buf_infile_aligned_;
+    /** Current position in io_buffer_ */
+    uint64_t              cur_inbuf_;
+    /** Bytes in io_buffer_ that are valid and within the range. */
+    uint64_t              end_inbuf_;
+    /** Where the range ends in the current file. */
+    uint64_t              end_infile_;
+    bool                  ended_;
+    memory::AlignedMemory io_buffer_;
+    /** Current position in block_buffer_. */
+    uint32_t              block_cur_;
+    /** Bytes in block_buffer_. block_cur_ < block_end_ means we are reading a block. */
+    uint32_t              block_end_;
+    /** Logs decompressed from the current log::CompressedBlockLogType. */
+    memory::AlignedMemory block_buffer_;
+  };
+
+  /** A log entry of the current epoch copied to staging_. */
+  struct StagedLog {
+    uint32_t  ordinal_;
+    uint64_t  offset_;
+  };
+
+  ErrorStack  open_stream(LogStream* stream);
+  /** Reads the file of the current ordinal from the given offset into the buffer. */
+  ErrorStack  load_stream(LogStream* stream, uint64_t next_infile);
+  /** Returns the next record log in the stream without consuming it, nullptr if ended. */
+  ErrorStack  peek_stream(LogStream* stream, const log::RecordLogType** out);
+  /** Stages all logs of the given epoch in the stream that belong to this partition. */
+  ErrorStack  stage_epoch(LogStream* stream, Epoch epoch);
+  ErrorStack  replay_staged();
+  ErrorStack  replay_log(const log::RecordLogType* entry);
+  ErrorCode   apply_log(const log::RecordLogType* entry);
+  bool        is_my_storage(storage::StorageId id) const {
+    return id % input_->partition_count_ == input_->partition_;
+  }
+
+  Engine* const                   engine_;
+  thread::Thread* const           context_;
+  const LogReplayerInput* const   input_;
+  std::vector<LogStream>          streams_;
+  /** Copies of logs to replay in the current epoch. */
+  memory::AlignedMemory           staging_;
+  uint64_t                        staging_used_;
+  std::vector<StagedLog>          staged_logs_;
+  /** Work buffer to replay array logs. */
+  memory::AlignedMemory           payload_buffer_;
+  uint64_t                        replayed_count_;
+  uint64_t                        skipped_count_;
+};
+
+}  // namespace restart
+}  // namespace foedus
+#endif  // FOEDUS_RESTART_LOG_REPLAYER_IMPL_HPP_
@@ -58,6 +58,12 @@ class RestartManagerPimpl final : public DefaultInitializable {
    * Essentially this is the only thing the restart manager has to do.
    */
   ErrorStack  redo_meta_logs(Epoch durable_epoch, Epoch snapshot_epoch);
+  /**
+   * Replay record logs since the latest snapshot directly into volatile pages.
+   * Used instead of taking a snapshot during restart when RestartOptions::replay_logs_.
+   * @see LogReplayer
+   */
+  ErrorStack  replay_record_logs(Epoch durable_epoch, Epoch snapshot_epoch);
 
   Engine* const           engine_;
   RestartManagerControlBlock* control_block_;
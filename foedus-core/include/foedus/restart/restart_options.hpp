@@ -17,6 +17,8 @@
  */
 #ifndef FOEDUS_RESTART_RESTART_OPTIONS_HPP_
 #define FOEDUS_RESTART_RESTART_OPTIONS_HPP_
+#include <stdint.h>
+
 #include "foedus/cxx11.hpp"
 #include "foedus/externalize/externalizable.hpp"
 namespace foedus {
@@ -27,11 +29,41 @@ namespace restart {
  * This is a POD struct. Default destructor/copy-constructor/assignment operator work fine.
  */
 struct RestartOptions CXX11_FINAL : public virtual externalize::Externalizable {
+  enum Constants {
+    kDefaultReplayThreadsPerNode = 1,
+    kDefaultReplayIoBufferMb = 4,
+  };
+
   /**
    * Constructs option values with default values.
    */
   RestartOptions();
 
+  /**
+   * @brief Whether to replay durable-but-not-snapshotted record logs into volatile pages
+   * at restart instead of taking a snapshot before accepting transactions.
+   * @details
+   * When false (default), restart invokes a full snapshot of all logs since the previous
+   * snapshot, which might take long after a crash with lots of logs.
+   * When true, worker threads read the log files and re-apply the record logs to
+   * volatile pages, which usually finishes much faster. The logs stay as they are, so
+   * the snapshot thread later picks them up as usual.
+   */
+  bool        replay_logs_;
+
+  /**
+   * Number of worker threads per NUMA node used for log replay.
+   * Storages are partitioned across the threads, so more than the number of
+   * storages doesn't help. Default is 1.
+   */
+  uint16_t    replay_threads_per_node_;
+
+  /**
+   * Size in MB of the IO buffer each replaying thread allocates per logger to read log files.
+   * Default is 4MB.
+   */
+  uint16_t    replay_io_buffer_mb_;
+
   EXTERNALIZABLE(RestartOptions);
 };
 }  // namespace restart
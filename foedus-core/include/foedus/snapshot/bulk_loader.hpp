@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_SNAPSHOT_BULK_LOADER_HPP_
+#define FOEDUS_SNAPSHOT_BULK_LOADER_HPP_
+#include <stdint.h>
+
+#include <memory>
+
+#include "foedus/cxx11.hpp"
+#include "foedus/epoch.hpp"
+#include "foedus/error_code.hpp"
+#include "foedus/error_stack.hpp"
+#include "foedus/fwd.hpp"
+#include "foedus/fs/fwd.hpp"
+#include "foedus/log/fwd.hpp"
+#include "foedus/memory/aligned_memory.hpp"
+#include "foedus/storage/storage_id.hpp"
+
+namespace foedus {
+namespace snapshot {
+/**
+ * @brief Base class of bulk-loaders that load sorted records into an empty storage without
+ * transactions.
+ * @ingroup SNAPSHOT
+ * @details
+ * Loading an initial database via transactions creates volatile pages and log records,
+ * which the log gleaner then has to sort and compose again.
+ * A bulk-loader instead writes the records to a file in the same format as the sorted runs
+ * of LogReducer. The next snapshot merges the file in the reducer of node-0 just like
+ * another sorted run, so the existing composers build snapshot pages from it and install the
+ * new root page. No volatile pages nor transaction logs are made.
+ *
+ * @par Usage
+ * @code{.cpp}
+ * MasstreeBulkLoader loader(engine, storage_id);
+ * CHECK_ERROR(loader.open());
+ * for (...) {  // in key order
+ *   WRAP_ERROR_CODE(loader.append(key, key_length, payload, payload_count));
+ * }
+ * CHECK_ERROR(loader.commit());  // returns after a snapshot composes the records.
+ * @endcode
+ *
+ * @par Restrictions
+ * \li The storage must be empty. Bulk-load is for initial loading, not for merging.
+ * \li The input must be sorted (see the derived classes for the exact order).
+ * \li Nobody should access the storage until commit() returns.
+ * \li Snapshotting is postponed while a bulk-loader is opened.
+ * \li The records are not durable until commit() returns. After a crash, just load again.
+ * \li A thread that holds more than one opened bulk-loader must call commit(false) on all but
+ * the last one. commit(true) waits for a snapshot, which never starts while another bulk-loader
+ * of the same thread is opened, so it would wait forever.
+ *
+ * Bulk-loaders of different storages can run in parallel.
+ * This object is not thread-safe. Use one bulk-loader per storage.
+ */
+class BulkLoader {
+ public:
+  BulkLoader(Engine* engine, storage::StorageId storage_id);
+  /** Aborts the bulk-load if it's still opened. */
+  virtual ~BulkLoader();
+
+  // non-copyable
+  BulkLoader(const BulkLoader& other) CXX11_FUNC_DELETE;
+  BulkLoader& operator=(const BulkLoader& other) CXX11_FUNC_DELETE;
+
+  /**
+   * @brief Starts bulk-loading.
+   * @details
+   * This waits for the currently running snapshot, if any, and then checks that the storage is
+   * empty.
+   */
+  ErrorStack  open();
+  /**
+   * @brief Finishes writing the records and takes a snapshot to compose them.
+   * @details
+   * By default, this returns after the new snapshot is taken, so the records are durable and
+   * visible to transactions when this method returns.
+   * If no record was appended, this just closes the bulk-loader.
+   * @param[in] wait_for_snapshot if false, this only requests the snapshot and returns after
+   * closing the bulk-loader. The records become visible when the snapshot runs, which is after
+   * all other bulk-loaders are closed. Use it when this thread still has other bulk-loaders
+   * opened (see the class comment).
+   */
+  ErrorStack  commit(bool wait_for_snapshot = true);
+  /** Discards all appended records. */
+  ErrorStack  abort();
+
+  bool        is_opened() const { return opened_; }
+  storage::StorageId get_storage_id() const { return storage_id_; }
+  /** Number of records appended so far. */
+  uint64_t    get_record_count() const { return record_count_; }
+
+ protected:
+  /**
+   * @brief Checks if the storage can be bulk-loaded.
+   * @return kErrorCodeSnapshotBulkLoadNotEmpty if the storage already has some record.
+   * @details
+   * Called in open() after no snapshot is running.
+   */
+  virtual ErrorCode check_storage() = 0;
+
+  /**
+   * @brief Reserves a space for a log record in the IO buffer.
+   * @param[in] log_length byte size of the log record. Must be a multiple of 8.
+   * @return the address to write the log record to. Call append_reserved_log() after writing it.
+   * @details
+   * The derived class writes the log record with the usual populate() method of the log type,
+   * then calls append_reserved_log().
+   */
+  char*       reserve_log(uint16_t log_length);
+  /**
+   * @brief Finalizes the log record written to the address returned by reserve_log().
+   * @param[in] key_length key length of the record, to maintain the statistics in the header.
+   * @param[in] ordinal ordinal of the XctId. Records of the same key-order (eg hash bin) must
+   * have increasing ordinals.
+   */
+  ErrorCode   append_reserved_log(uint32_t key_length, uint32_t ordinal);
+
+  Engine* const             engine_;
+  const storage::StorageId  storage_id_;
+
+ private:
+  /** Writes out the IO buffer up to the given position, retaining the fragment after it. */
+  ErrorCode   flush_io_buffer(uint64_t upto);
+  /** Writes out the rest and completes the header of the file. */
+  ErrorCode   close_file();
+  /** Closes the file and unregisters from snapshot manager. */
+  void        release(bool committed);
+
+  bool                      opened_;
+  /** All records are stamped with this epoch, the current global epoch when opened. */
+  Epoch                     epoch_;
+  uint64_t                  record_count_;
+  uint32_t                  shortest_key_length_;
+  uint32_t                  longest_key_length_;
+
+  std::unique_ptr<fs::DirectIoFile> file_;
+  /** Log records are written to the file via this buffer. Starts with FullBlockHeader. */
+  memory::AlignedMemory     io_buffer_;
+  /** Byte position in io_buffer_ up to which we have written log records. */
+  uint64_t                  io_buffer_pos_;
+  /** Bytes written to the file so far. */
+  uint64_t                  written_bytes_;
+  /** The last reserve_log() returned this log length. */
+  uint16_t                  reserved_length_;
+  /**
+   * The first 4kb of the file, which contains FullBlockHeader.
+   * We rewrite it with the final statistics in close_file() if it was already written out.
+   */
+  memory::AlignedMemory     first_page_;
+};
+
+}  // namespace snapshot
+}  // namespace foedus
+#endif  // FOEDUS_SNAPSHOT_BULK_LOADER_HPP_
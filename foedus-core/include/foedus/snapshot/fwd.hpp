@@ -24,6 +24,7 @@
  */
 namespace foedus {
 namespace snapshot {
+class   BulkLoader;
 class   InMemorySortedBuffer;
 class   DumpFileSortedBuffer;
 struct  LogBuffer;
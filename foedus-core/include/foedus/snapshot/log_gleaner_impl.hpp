@@ -36,6 +36,7 @@
 #include "foedus/snapshot/fwd.hpp"
 #include "foedus/snapshot/log_gleaner_ref.hpp"
 #include "foedus/snapshot/snapshot_manager_pimpl.hpp"
+#include "foedus/storage/composer.hpp"
 #include "foedus/storage/fwd.hpp"
 #include "foedus/storage/storage_id.hpp"
 #include "foedus/thread/fwd.hpp"
@@ -133,6 +134,15 @@ class LogGleaner final : public LogGleanerRef {
    */
   std::map<storage::StorageId, storage::SnapshotPagePointer> new_root_page_pointers_;
 
+  /**
+   * Number of root-info pages of each reducer that construct_root_pages() has consumed.
+   * Index is the reducer (node) ID.
+   */
+  std::vector<uint32_t>           root_info_cursors_;
+
+  /** Statistics of the pages written in construct_root_pages(). */
+  storage::ComposeStatistics      root_statistics_;
+
   /** Before starting log gleaner, this method resets all shared memory to initialized state. */
   void      clear_all();
 
@@ -153,12 +163,20 @@ class LogGleaner final : public LogGleanerRef {
   ErrorStack cancel_reducers_mappers();
 
   /**
-   * @brief Final sub-routine of execute()
+   * @brief Sub-routine of execute() to construct new root pages.
+   * @param[in] all_reducers_completed whether all reducers are done. If false, this method
+   * constructs root pages only for storages that every reducer has already composed
+   * (or will never compose), and returns without blocking.
    * @details
    * Collects what each reducer wrote and combines them to be new root page(s) for each storage.
    * This method fills out new_root_page_pointers_ as the result.
+   * While reducers are still running, execute() invokes this method repeatedly
+   * (see SnapshotOptions::pipeline_root_construction_). Reducers compose storages in the order
+   * of storage ID, so a storage is ready once every running reducer has published a root-info
+   * page of the same or a larger storage ID. We append to the node-0 snapshot file, so nothing
+   * is done until the node-0 reducer completes.
    */
-  ErrorStack construct_root_pages();
+  ErrorStack construct_root_pages(bool all_reducers_completed);
 };
 
 }  // namespace snapshot
@@ -193,8 +193,22 @@ class LogMapper final : public MapReduceBase {
     uint64_t to_infile(uint64_t inbuf) const { return inbuf + buf_infile_aligned_; }
   };
 
-  /** buffer to read from file. */
+  /**
+   * buffer to read from file.
+   * The first io_read_size_ bytes are used to read from file. The rest receives logs
+   * decompressed from log::CompressedBlockLogType so that we can bucketize them with
+   * BufferPosition just like logs read from file. Once it receives a compressed block,
+   * uncompressed logs after the block are copied there, too, so that BufferPosition of
+   * logs sent in one flush is always monotonic in log order.
+   */
   memory::AlignedMemory   io_buffer_;
+  /** Byte size of the region in io_buffer_ to read from file. */
+  uint64_t                io_read_size_;
+  /**
+   * Where the next decompressed block goes in io_buffer_.
+   * Reset to io_read_size_ only when all buckets are flushed.
+   */
+  uint64_t                decompressed_inbuf_;
 
   /** memory for Bucket. */
   memory::AlignedMemory   buckets_memory_;
@@ -286,6 +300,25 @@ class LogMapper final : public MapReduceBase {
    * When this returns false, it should be followed by add_new_bucket()
    */
   bool        bucket_log(storage::StorageId storage_id, uint64_t pos) ALWAYS_INLINE;
+  /**
+   * bucket_log() followed by add_new_bucket() and flush_all_buckets() if needed.
+   * This always succeeds.
+   */
+  void        bucket_log_or_flush(storage::StorageId storage_id, uint64_t pos) ALWAYS_INLINE;
+
+  /**
+   * Decompresses the given block to io_buffer_ and bucketizes the logs in it.
+   * Called from handle_process_buffer() for each compressed block.
+   */
+  ErrorStack  handle_compressed_block(
+    const fs::DirectIoFile &file,
+    const log::CompressedBlockLogType* block);
+  /**
+   * Reserves the given bytes in the region for decompressed logs, flushing all buckets if
+   * the region is full.
+   * @return offset of the reserved bytes in io_buffer_
+   */
+  uint64_t    reserve_decompressed_region(uint32_t length);
 
   /**
    * Add a new bucket for the specified storage.
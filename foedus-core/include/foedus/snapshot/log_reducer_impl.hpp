@@ -44,6 +44,7 @@
 #include "foedus/snapshot/snapshot_writer_impl.hpp"
 #include "foedus/soc/shared_cond.hpp"
 #include "foedus/soc/shared_memory_repo.hpp"
+#include "foedus/storage/composer.hpp"
 #include "foedus/storage/fwd.hpp"
 #include "foedus/storage/storage_id.hpp"
 #include "foedus/thread/condition_variable_impl.hpp"
@@ -169,6 +170,8 @@ struct LogReducerControlBlock {
     buffer_status_[0].store(0U);
     buffer_status_[1].store(0U);
     total_storage_count_ = 0;
+    merge_completed_ = false;
+    compose_statistics_.clear();
   }
   void uninitialize() {
   }
@@ -202,12 +205,24 @@ struct LogReducerControlBlock {
   std::atomic<uint32_t> current_buffer_;
 
   /**
-   * Set at the end of merge_sort().
+   * Incremented in merge_sort() each time this reducer finishes composing a storage.
    * Total number of storages this reducer has merged and composed.
    * This is also the number of root-info pages this reducer has produced.
+   * Storages are composed in the order of storage ID, and the root-info page of a storage
+   * is fully written before this value is incremented, so the gleaner can consume the
+   * published root-info pages while this reducer is still merging.
    */
   std::atomic<uint32_t> total_storage_count_;
 
+  /**
+   * Set to true at the end of merge_sort() after closing the snapshot file of this node.
+   * Once this is true, total_storage_count_ is final and nobody writes to the snapshot file.
+   */
+  std::atomic<bool>     merge_completed_;
+
+  /** Sum of the statistics of all compose() this reducer has run in this snapshot. */
+  storage::ComposeStatistics  compose_statistics_;
+
   /** ID of this reducer (or numa node ID). not mutable, just for convenience. */
   uint16_t              id_;
 };
@@ -308,23 +323,36 @@ class LogReducer final : public MapReduceBase {
    * Context object used throughout merge_sort().
    */
   struct MergeContext {
-    explicit MergeContext(uint32_t dumped_files_count_);
+    MergeContext(
+      uint32_t dumped_files_count,
+      const std::vector<storage::StorageId>& bulk_loaded_storages);
     ~MergeContext();
 
     /**
      * Number of sorted runs dumped to files.
-     * After populating sorted_buffers_, this number should be come sorted_buffers_.size() - 1
-     * because of the in-memory sorted buffer.
+     * After populating sorted_buffers_, this number plus bulk-load files should become
+     * sorted_buffers_.size() - 1 because of the in-memory sorted buffer.
      */
     const uint32_t                            dumped_files_count_;
+    /**
+     * Storages whose bulk-load files this reducer reads in addition to the sorted runs.
+     * Only the reducer in the first node reads them. See BulkLoader.
+     */
+    const std::vector<storage::StorageId>     bulk_loaded_storages_;
     memory::AlignedMemory                     io_memory_;
     std::vector< memory::AlignedMemorySlice > io_buffers_;
 
+    /** Number of files we read. Sorted runs and bulk-load files. */
+    uint32_t get_files_count() const {
+      return dumped_files_count_ + bulk_loaded_storages_.size();
+    }
+
     /**
      * @brief stream objects that keep reading storage blocks.
      * @details
      * The first one is always the InMemorySortedBuffer (based on last_buffer_).
-     * Others are DumpFileSortedBuffer for the sorted run files.
+     * Others are DumpFileSortedBuffer for the sorted run files, followed by ones for
+     * bulk-load files.
      * Dummy block is automatically skipped.
      * If storage_id_ is zero, it means that the stream reached the end.
      */
@@ -516,6 +544,11 @@ class LogReducer final : public MapReduceBase {
    * Second sub routine of merge_sort() which allocates I/O buffers to read from sorted run files.
    */
   void        merge_sort_allocate_io_buffers(MergeContext* context) const;
+  /**
+   * Returns the storages whose bulk-load files this reducer should compose.
+   * Empty except the reducer in the first node.
+   */
+  std::vector<storage::StorageId> merge_sort_get_bulk_loaded_storages() const;
   /**
    * Third sub routine that opens the files with the I/O buffers.
    */
@@ -52,6 +52,10 @@ class LogReducerRef {
   std::string to_string() const;
   void        clear();
   uint32_t    get_total_storage_count() const;
+  /** Whether this reducer has composed all storages and closed its snapshot file. */
+  bool        is_merge_completed() const;
+  /** Statistics of the pages this reducer has composed. Final after is_merge_completed(). */
+  const storage::ComposeStatistics& get_compose_statistics() const;
   storage::Page* get_root_info_pages() { return root_info_pages_; }
   friend std::ostream&    operator<<(std::ostream& o, const LogReducerRef& v);
 
@@ -49,6 +49,13 @@ class SnapshotManager CXX11_FINAL : public virtual Initializable {
   Epoch get_snapshot_epoch() const;
   /** Non-atomic version. */
   Epoch get_snapshot_epoch_weak() const;
+  /**
+   * Returns a counter that changes whenever a new snapshot is being installed.
+   * It is odd while root pointers of a new snapshot are being installed and the snapshot
+   * epoch is not yet published. If the value is even and same before and after reading
+   * snapshot pages, all of them were from the snapshot of get_snapshot_epoch().
+   */
+  uint64_t get_snapshot_install_sequence() const;
 
   /** Returns the most recent snapshot's ID. kNullSnapshotId if no snapshot is taken. */
   SnapshotId get_previous_snapshot_id() const;
@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "foedus/epoch.hpp"
+#include "foedus/error_code.hpp"
 #include "foedus/fwd.hpp"
 #include "foedus/initializable.hpp"
 #include "foedus/fs/path.hpp"
@@ -36,6 +37,7 @@
 #include "foedus/soc/shared_memory_repo.hpp"
 #include "foedus/soc/shared_mutex.hpp"
 #include "foedus/soc/shared_polling.hpp"
+#include "foedus/storage/storage_id.hpp"
 #include "foedus/thread/condition_variable_impl.hpp"
 
 namespace foedus {
@@ -122,14 +124,25 @@ struct SnapshotManagerControlBlock {
   SnapshotManagerControlBlock() = delete;
   ~SnapshotManagerControlBlock() = delete;
 
+  enum Constants {
+    /** Max number of bulk-loaded storages waiting for the next snapshot. */
+    kMaxPendingBulkLoads = 256,
+  };
+
   void initialize() {
     snapshot_taken_.initialize();
     snapshot_wakeup_.initialize();
     snapshot_children_wakeup_.initialize();
     gleaner_.initialize();
     requested_snapshot_epoch_.store(Epoch::kEpochInvalid);
+    snapshot_install_sequence_.store(0);
+    snapshot_in_progress_.store(false);
+    active_bulk_loads_.store(0);
+    pending_bulk_loads_mutex_.initialize();
+    pending_bulk_loads_count_ = 0;
   }
   void uninitialize() {
+    pending_bulk_loads_mutex_.uninitialize();
     gleaner_.uninitialize();
   }
 
@@ -142,6 +155,7 @@ struct SnapshotManagerControlBlock {
     return previous_snapshot_id_.load(std::memory_order_relaxed);
   }
   Epoch get_requested_snapshot_epoch() const { return Epoch(requested_snapshot_epoch_.load()); }
+  uint64_t get_snapshot_install_sequence() const { return snapshot_install_sequence_.load(); }
 
   /**
    * Fires snapshot_children_wakeup_.
@@ -167,6 +181,13 @@ struct SnapshotManagerControlBlock {
    */
   std::atomic< Epoch::EpochInteger >  requested_snapshot_epoch_;
 
+  /**
+   * Incremented right before snapshot_thread_ starts installing the root pointers of a new
+   * snapshot and again after it publishes snapshot_epoch_. It is odd while the pointers are
+   * being installed. Readers of snapshot pages use it like a seqlock to make sure that
+   * all storages they read were from the same snapshot.
+   */
+  std::atomic<uint64_t>           snapshot_install_sequence_;
 
   /**
    * ID of previously completed snapshot. kNullSnapshotId if no snapshot has been taken.
@@ -192,6 +213,29 @@ struct SnapshotManagerControlBlock {
 
   /** Gleaner-related variables */
   LogGleanerControlBlock          gleaner_;
+
+  /**
+   * Whether snapshot_thread_ is now taking a snapshot.
+   * BulkLoader::open() waits until this becomes false.
+   */
+  std::atomic<bool>               snapshot_in_progress_;
+
+  /**
+   * Number of BulkLoader objects that are opened and not yet committed/aborted.
+   * While this is not zero, snapshot_thread_ postpones snapshotting so that the epoch of
+   * bulk-loaded records is always newer than the snapshot that composes them.
+   */
+  std::atomic<uint32_t>           active_bulk_loads_;
+
+  /**
+   * Storages whose bulk-load files are committed and will be composed by the next snapshot.
+   * Active bulk-loaders append to it with pending_bulk_loads_mutex_.
+   * snapshot_thread_ reads and clears it without the mutex because it runs only while there is
+   * no active bulk-loader (see active_bulk_loads_).
+   */
+  soc::SharedMutex                pending_bulk_loads_mutex_;
+  uint32_t                        pending_bulk_loads_count_;
+  storage::StorageId              pending_bulk_loads_[kMaxPendingBulkLoads];
 };
 
 /**
@@ -214,6 +258,9 @@ class SnapshotManagerPimpl final : public DefaultInitializable {
 
   Epoch get_snapshot_epoch() const { return control_block_->get_snapshot_epoch(); }
   Epoch get_snapshot_epoch_weak() const  { return control_block_->get_snapshot_epoch_weak(); }
+  uint64_t get_snapshot_install_sequence() const {
+    return control_block_->get_snapshot_install_sequence();
+  }
 
   SnapshotId get_previous_snapshot_id() const { return control_block_->get_previous_snapshot_id(); }
   SnapshotId get_previous_snapshot_id_weak() const  {
@@ -318,6 +365,29 @@ class SnapshotManagerPimpl final : public DefaultInitializable {
    * in first node's first partition folder. */
   fs::Path    get_snapshot_metadata_file_path(SnapshotId snapshot_id) const;
 
+  /**
+   * @brief Registers a new BulkLoader.
+   * @details
+   * This waits for the currently running snapshot, if any, to complete. Snapshotting is then
+   * postponed until end_bulk_load() is called.
+   * @return kErrorCodeSnapshotTooManyBulkLoads if kMaxPendingBulkLoads storages are already
+   * bulk-loaded or being bulk-loaded without a snapshot composing them.
+   */
+  ErrorCode   begin_bulk_load();
+  /**
+   * @brief Unregisters a BulkLoader.
+   * @param[in] committed_storage_id the bulk-loaded storage whose bulk-load file is ready to be
+   * composed by the next snapshot. 0 if the bulk-load was aborted.
+   */
+  void        end_bulk_load(storage::StorageId committed_storage_id);
+  /**
+   * Each bulk-loaded storage has a file "bulk_load_<STORAGE_ID>" in first node's folder until
+   * a snapshot composes it.
+   */
+  fs::Path    get_bulk_load_file_path(storage::StorageId storage_id) const;
+  /** Deletes bulk-load files that are composed in the snapshot just taken. */
+  void        remove_pending_bulk_loads();
+
   Engine* const           engine_;
 
   SnapshotManagerControlBlock*  control_block_;
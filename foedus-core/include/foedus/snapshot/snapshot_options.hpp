@@ -126,6 +126,25 @@ struct SnapshotOptions CXX11_FINAL : public virtual externalize::Externalizable
    */
   uint32_t                            log_reducer_read_io_buffer_kb_;
 
+  /**
+   * Max number of threads each reducer uses to sort a large batch of logs.
+   * Sorting logs of array/hash storages is a radix sort, which is parallelized
+   * when the batch has millions of logs and this value is more than 1.
+   * These threads are spawned in addition to mappers/reducers, so consider how many cores
+   * are idle during snapshot. Default is 1, which means the reducer sorts by itself.
+   */
+  uint16_t                            log_reducer_sort_threads_;
+
+  /**
+   * Whether the gleaner constructs root pages of storages while reducers are still
+   * merge-sorting other storages. Reducers compose storages in the order of storage ID and
+   * publish each root-info page as soon as it is composed, so the gleaner can start on a
+   * storage once all reducers have passed it, rather than waiting for the slowest reducer.
+   * Default is true. False reproduces the original behavior, ie constructing all root pages
+   * after all reducers complete.
+   */
+  bool                                pipeline_root_construction_;
+
   /**
    * The size in MB of one snapshot writer, which holds data pages modified in the snapshot
    * and them sequentially dumps them to a file for each storage.
@@ -411,6 +411,7 @@ struct ThreadMemoryAnchors {
     kThreadMemorySize = 1 << 15,
     kTaskInputMemorySize = 1 << 19,
     kTaskOutputMemorySize = 1 << 19,
+    kTaskQueueMemorySize = 1 << 18,
     kMcsWwLockMemorySize = 1 << 19,
     kMcsRwLockMemorySize = 1 << 19,
     kMcsRwAsyncMappingMemorySize  = 1 << 19,
@@ -440,6 +441,12 @@ struct ThreadMemoryAnchors {
    */
   void*           task_output_memory_;
 
+  /**
+   * Pipelined task submission queue of this thread.
+   * Always 256kb.
+   */
+  thread::TaskQueue*  task_queue_memory_;
+
   /**
     * Pre-allocated MCS block for each thread. Index is node-local thread ordinal.
     * Array of McsWwBlock.
@@ -112,9 +112,21 @@ struct ArrayOverwriteLogType : public ArrayCommonUpdateLogType {
   uint16_t        payload_count_;     // +2 => 28
   char            payload_[4];        // +4 => 32
 
+  enum Constants {
+    /** Byte position of payload_ in this log. */
+    kPayloadPosition = 28,
+  };
+
   static uint16_t calculate_log_length(uint16_t payload_count) ALWAYS_INLINE {
     // we pad to 8 bytes so that we always have a room for FillerLogType to align.
-    return assorted::align8(28 + payload_count);
+    return assorted::align8(kPayloadPosition + payload_count);
+  }
+  /**
+   * payload_ is declared with 4 bytes, but the log has payload_count_ bytes there.
+   * Write longer payloads via this address so that the compiler doesn't assume the 4-byte bound.
+   */
+  char* get_payload_address() ALWAYS_INLINE {
+    return reinterpret_cast<char*>(this) + kPayloadPosition;
   }
 
   void populate(
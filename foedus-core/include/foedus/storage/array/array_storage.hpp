@@ -305,6 +305,56 @@ class ArrayStorage CXX11_FINAL : public Storage<ArrayStorageControlBlock> {
     T value,
     uint16_t payload_offset);
 
+  /**
+   * @brief Increments a \e striped counter, a hot counter spread over multiple records.
+   * @param[in] context Thread context
+   * @param[in] offset The offset of the first record of the counter
+   * @param[in] value addendum
+   * @param[in] payload_offset We write to this byte position of the records.
+   * @param[in] stripes The number of records the counter is spread over.
+   * @tparam T primitive type. All integers and floats are allowed.
+   * @pre payload_offset + sizeof(T) <= get_payload_size()
+   * @return kErrorCodeInvalidParameter if stripes is 0 or offset + stripes > get_array_size()
+   * @details
+   * A single hot counter, such as a per-district order ID or a per-warehouse total, makes all
+   * threads serialize on the lock of one record even with increment_record_oneshot().
+   * Increments are commutative, so a striped counter instead keeps one partial sum (delta)
+   * per stripe in the records [offset, offset + stripes), and each thread adds only to its
+   * own stripe chosen by its global ordinal. With as many stripes as threads that update
+   * the counter, the increments never contend with each other.
+   * The value of the counter is the sum of all stripes, which get_record_primitive_striped()
+   * reads. The stripes are ordinary records updated by increment_record_oneshot(), so
+   * transactions are serializable as usual, and logging, snapshots, and recovery need nothing
+   * special. Reads get more expensive instead, so use this only for counters that are
+   * written far more often than read.
+   */
+  template <typename T>
+  ErrorCode  increment_record_striped(
+    thread::Thread* context,
+    ArrayOffset offset,
+    T value,
+    uint16_t payload_offset,
+    uint16_t stripes);
+
+  /**
+   * @brief Reads a striped counter updated by increment_record_striped().
+   * @param[in] context Thread context
+   * @param[in] offset The offset of the first record of the counter
+   * @param[out] value The value of the counter, the sum of all stripes.
+   * @param[in] payload_offset We read from this byte position of the records.
+   * @param[in] stripes The number of records the counter is spread over.
+   * @tparam T primitive type. All integers and floats are allowed.
+   * @details
+   * This reads all stripes, so it conflicts with concurrent increments on any stripe.
+   */
+  template <typename T>
+  ErrorCode  get_record_primitive_striped(
+    thread::Thread* context,
+    ArrayOffset offset,
+    T* value,
+    uint16_t payload_offset,
+    uint16_t stripes);
+
 
   friend std::ostream& operator<<(std::ostream& o, const ArrayStorage& v);
 
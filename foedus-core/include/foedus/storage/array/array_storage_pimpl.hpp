@@ -190,6 +190,36 @@ class ArrayStoragePimpl final {
     const ArrayOffset* offset_batch,
     Record** record_batch) ALWAYS_INLINE;
 
+  /**
+   * @brief Read-your-own-writes.
+   * @param[in] context Thread context
+   * @param[in] record the record this transaction has written to
+   * @param[in] first_write the first write-set entry of this transaction on the record
+   * @param[out] buffer receives the payload of the record as this transaction will write it
+   * at commit, ie the current payload plus the pending writes. At least get_payload_size() bytes.
+   */
+  void        read_own_writes(
+    thread::Thread* context,
+    const Record* record,
+    const xct::WriteXctAccess* first_write,
+    char* buffer);
+  /** Same as above, but the payload is placed in the local work memory of the transaction. */
+  ErrorCode   read_own_writes_payload(
+    thread::Thread* context,
+    const Record* record,
+    const xct::WriteXctAccess* first_write,
+    const void** payload);
+  /**
+   * If the last write of this transaction on the record is an overwrite log that covers the
+   * new overwrite, we simply modify the payload in the log, which is not published until commit.
+   * @return whether the new overwrite was merged into the log of last_write
+   */
+  static bool coalesce_overwrite(
+    xct::WriteXctAccess* last_write,
+    const void *payload,
+    uint16_t payload_offset,
+    uint16_t payload_count) ALWAYS_INLINE;
+
   ErrorCode   overwrite_record(thread::Thread* context, ArrayOffset offset,
       const void *payload, uint16_t payload_offset, uint16_t payload_count) ALWAYS_INLINE;
   template <typename T>
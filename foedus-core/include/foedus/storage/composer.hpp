@@ -18,6 +18,8 @@
 #ifndef FOEDUS_STORAGE_COMPOSER_HPP_
 #define FOEDUS_STORAGE_COMPOSER_HPP_
 
+#include <stdint.h>
+
 #include <iosfwd>
 #include <string>
 
@@ -36,6 +38,52 @@
 
 namespace foedus {
 namespace storage {
+/**
+ * @brief Statistics of the pages that Composer::compose() and Composer::construct_root()
+ * write out and reuse.
+ * @ingroup STORAGE SNAPSHOT
+ * @details
+ * Composers copy-on-write only the pages on the paths to modified records. Other sub-trees
+ * of the previous snapshot are left as they are and just pointed from the new pages.
+ * Hence pages_written_ and previous_pages_read_ should be proportional to the write-set,
+ * while pages_reused_ tells how much of the previous snapshot we did not have to touch.
+ * pages_written_ and previous_pages_read_ are counted by Composer itself for all storage types.
+ * pages_reused_ is counted by each implementation as it knows the page layout.
+ * So far only masstree and hash storages count it.
+ */
+struct ComposeStatistics {
+  /** Number of new or rewritten pages written out to the new snapshot files. */
+  uint64_t  pages_written_;
+  /** Number of pages read from snapshot files, mostly previous snapshot pages to rewrite. */
+  uint64_t  previous_pages_read_;
+  /**
+   * Number of pointers from the written pages to pages of previous snapshots.
+   * Each of them is an unchanged page (or a sub-tree) reused as it is.
+   */
+  uint64_t  pages_reused_;
+
+  void clear() {
+    pages_written_ = 0;
+    previous_pages_read_ = 0;
+    pages_reused_ = 0;
+  }
+  void add(const ComposeStatistics& other) {
+    pages_written_ += other.pages_written_;
+    previous_pages_read_ += other.previous_pages_read_;
+    pages_reused_ += other.pages_reused_;
+  }
+  /** Call this for each snapshot pointer in a page that is written out to the new snapshot. */
+  void on_pointer_written(
+    SnapshotPagePointer pointer,
+    snapshot::SnapshotId new_snapshot_id) ALWAYS_INLINE {
+    if (pointer != 0 && extract_snapshot_id_from_snapshot_pointer(pointer) != new_snapshot_id) {
+      ++pages_reused_;
+    }
+  }
+
+  friend std::ostream&    operator<<(std::ostream& o, const ComposeStatistics& v);
+};
+
 /**
  * @brief Represents a logic to compose a new version of data pages for one storage.
  * @ingroup STORAGE SNAPSHOT
@@ -114,6 +162,8 @@ class Composer CXX11_FINAL {
      * the information must fit in one page (should be, otherwise we can't have a root page)
      */
     Page*                             root_info_page_;
+    /** [OUT] If not null, statistics of this compose() are added to it. */
+    ComposeStatistics*                statistics_;
   };
   /**
    * @brief Construct snapshot pages from sorted run files of one storage.
@@ -134,6 +184,8 @@ class Composer CXX11_FINAL {
     snapshot::LogGleanerResource*     gleaner_resource_;
     /** [OUT] Returns pointer to new root snapshot page/ */
     SnapshotPagePointer*              new_root_page_pointer_;
+    /** [OUT] If not null, statistics of this construct_root() are added to it. */
+    ComposeStatistics*                statistics_;
   };
 
   /**
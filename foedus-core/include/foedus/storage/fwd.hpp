@@ -25,6 +25,7 @@
 namespace foedus {
 namespace storage {
 class   Composer;
+struct  ComposeStatistics;
 struct  CreateLogType;
 struct  DropLogType;
 struct  DualPagePointer;
@@ -29,10 +29,12 @@ struct  ComposedBins;
 struct  ComposedBinsBuffer;
 struct  ComposedBinsMergedStream;
 struct  DataPageBloomFilter;
+class   HashBulkLoader;
 struct  HashCombo;
 class   HashComposer;
 struct  HashComposedBinsPage;
 struct  HashCreateLogType;
+class   HashCursor;
 class   HashDataPage;
 struct  HashDeleteLogType;
 struct  HashInsertLogType;
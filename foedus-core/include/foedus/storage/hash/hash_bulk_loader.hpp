@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_STORAGE_HASH_HASH_BULK_LOADER_HPP_
+#define FOEDUS_STORAGE_HASH_HASH_BULK_LOADER_HPP_
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "foedus/cxx11.hpp"
+#include "foedus/error_code.hpp"
+#include "foedus/fwd.hpp"
+#include "foedus/snapshot/bulk_loader.hpp"
+#include "foedus/storage/storage_id.hpp"
+#include "foedus/storage/hash/hash_id.hpp"
+
+namespace foedus {
+namespace storage {
+namespace hash {
+/**
+ * @brief Bulk-loads records into an empty hash storage.
+ * @ingroup HASH
+ * @details
+ * Records must be appended in non-decreasing order of hash bins, which is the order
+ * HashComposer consumes them. Records in the same bin can come in any order.
+ * To sort the input, compute HashCombo (or get_bin()) of each key beforehand.
+ * The snapshot taken in commit() builds the data pages and intermediate pages with HashComposer.
+ * @see snapshot::BulkLoader
+ */
+class HashBulkLoader CXX11_FINAL : public snapshot::BulkLoader {
+ public:
+  HashBulkLoader(Engine* engine, StorageId storage_id);
+
+  /**
+   * @brief Appends a record.
+   * @return kErrorCodeSnapshotBulkLoadUnsorted if the key belongs to a smaller hash bin than
+   * the previous key, or if the same key is already appended.
+   */
+  ErrorCode append(
+    const void* key,
+    uint16_t key_length,
+    const void* payload,
+    uint16_t payload_count);
+  /** Returns the hash bin of the key in this storage, which is the order of append(). */
+  HashBin   get_bin(const void* key, uint16_t key_length) const;
+
+ protected:
+  ErrorCode check_storage() CXX11_OVERRIDE;
+
+ private:
+  uint8_t   bin_bits_;
+  HashBin   current_bin_;
+  /** Keys appended to current_bin_ so far, to detect duplicates. Bins are small. */
+  std::vector<std::string> current_bin_keys_;
+};
+
+}  // namespace hash
+}  // namespace storage
+}  // namespace foedus
+#endif  // FOEDUS_STORAGE_HASH_HASH_BULK_LOADER_HPP_
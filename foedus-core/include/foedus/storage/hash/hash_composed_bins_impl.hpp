@@ -218,6 +218,12 @@ struct ComposedBinsMergedStream final {
   /** The pages we are now composing. cur_path_[n] is the level-n intermediate page. */
   PagePtr               cur_path_[kHashMaxLevels];
 
+  /**
+   * Number of pointers to pages of previous snapshots in the pages we have written out since
+   * init(). See ComposeStatistics::pages_reused_.
+   */
+  uint64_t              pages_reused_;
+
   ErrorStack init(
     const HashRootInfoPage* const*  inputs,
     uint32_t                  input_count,
@@ -263,6 +269,9 @@ struct ComposedBinsMergedStream final {
     snapshot::SnapshotWriter* writer,
     uint32_t*                 writer_buffer_pos,
     uint32_t                  writer_higher_buffer_pos);
+
+  /** Call this right before writing out the pages. Adds to pages_reused_. */
+  void      count_reused_pointers(const HashIntermediatePage* pages, uint32_t count);
 };
 
 inline ErrorCode ComposedBinsBuffer::next_bin() {
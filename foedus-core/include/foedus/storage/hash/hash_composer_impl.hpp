@@ -78,8 +78,9 @@ class HashComposer final {
     const Composer::ConstructRootArguments* args,
     uint16_t numa_node,
     HashIntermediatePage* root_page,
+    ComposeStatistics* out_statistics,
     ErrorStack* out_error) {
-    *out_error = pointer->construct_root_multi_level(*args, numa_node, root_page);
+    *out_error = pointer->construct_root_multi_level(*args, numa_node, root_page, out_statistics);
   }
 
  private:
@@ -101,12 +102,20 @@ class HashComposer final {
    * implementation of construct_root when levels > 1. run on its own thread, one per NUMA node.
    * The assignment is round-robin. Suppose there are 4 NUMA nodes.
    * Node-0 takes child-0, child-4, child-8, ... Node-1 takes child-1, child-5,...
+   * Each thread reports what it read and wrote via out_statistics, except the pages written
+   * via args.snapshot_writer_, which Composer counts.
    */
   ErrorStack construct_root_multi_level(
     const Composer::ConstructRootArguments& args,
     uint16_t numa_node,
-    HashIntermediatePage* root_page);
+    HashIntermediatePage* root_page,
+    ComposeStatistics* out_statistics);
 
+  /**
+   * Gives the new snapshot pointers to root children that have no volatile page, such as
+   * bins filled by a BulkLoader. Called from drop_volatiles, so after the savepoint.
+   */
+  ErrorStack install_root_children_pointers();
   void drop_volatiles_child(
     const Composer::DropVolatilesArguments& args,
     DualPagePointer* child_pointer,
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_STORAGE_HASH_HASH_CURSOR_HPP_
+#define FOEDUS_STORAGE_HASH_HASH_CURSOR_HPP_
+
+#include <stdint.h>
+
+#include "foedus/assert_nd.hpp"
+#include "foedus/compiler.hpp"
+#include "foedus/cxx11.hpp"
+#include "foedus/error_code.hpp"
+#include "foedus/fwd.hpp"
+#include "foedus/storage/fwd.hpp"
+#include "foedus/storage/storage_id.hpp"
+#include "foedus/storage/hash/fwd.hpp"
+#include "foedus/storage/hash/hash_id.hpp"
+#include "foedus/storage/hash/hash_record_location.hpp"
+#include "foedus/storage/hash/hash_storage.hpp"
+#include "foedus/thread/fwd.hpp"
+#include "foedus/xct/fwd.hpp"
+
+namespace foedus {
+namespace storage {
+namespace hash {
+/**
+ * @brief Represents a cursor object to iterate over all records in Hash storage.
+ * @ingroup HASH
+ * @details
+ * Hash storage has no order among keys, so this cursor simply visits hash bins in ascending
+ * order, and all records in each bin in the order they are stored in the data pages of the bin.
+ * It reads volatile pages if exist, and snapshot pages otherwise, just like get_record().
+ * This cursor is read-only. To modify the records, use the usual APIs of HashStorage with
+ * the key of the current record.
+ *
+ * @par Cursor Example
+ * @code{.cpp}
+ * ... (begin xct, etc)
+ * HashCursor cursor(accounts, context);
+ * CHECK_ERROR_CODE(cursor.open());
+ * while (cursor.is_valid_record()) {
+ *  const AccountData* payload = reinterpret_cast<const AccountData*>(cursor.get_payload());
+ *  total += payload->balance_;
+ *  CHECK_ERROR_CODE(cursor.next());
+ * }
+ * ... (commit xct, etc)
+ * @endcode
+ *
+ * @par Parallel Scan
+ * open() optionally receives a range of hash bins to scan. Use get_partition() to evenly divide
+ * the bins so that each thread scans its own partition in its own transaction.
+ *
+ * @par Serializability
+ * In serializable transactions, each record we return is added to the read-set, each
+ * non-existing subtree or bin is protected by a pointer set, and the last data page of each
+ * bin is protected by a page-version set so that a new data page in the bin is detected
+ * at pre-commit. A serializable transaction can hold only xct::Xct::kMaxPointerSets of each
+ * of them, so scanning a large storage in one serializable transaction might result in
+ * kErrorCodeXctPointerSetOverflow or kErrorCodeXctPageVersionSetOverflow.
+ * In that case, scan smaller bin ranges in separate transactions or use snapshot isolation.
+ */
+class HashCursor CXX11_FINAL {
+ public:
+  HashCursor(HashStorage storage, thread::Thread* context);
+
+  thread::Thread*   get_context() { return context_; }
+  HashStorage&      get_storage() { return storage_; }
+
+  /**
+   * @brief Opens the cursor to scan the given range of hash bins.
+   * @param[in] begin_bin inclusive beginning of the bins to scan.
+   * @param[in] end_bin exclusive end of the bins to scan. Capped by the number of bins.
+   * @details
+   * After this method, the cursor points to the first record in the range, if any.
+   */
+  ErrorCode   open(HashBin begin_bin = 0, HashBin end_bin = kInvalidHashBin);
+
+  /**
+   * @returns the range of bins for the given partition when the bins are evenly divided
+   * into the given number of partitions.
+   */
+  static HashBinRange get_partition(HashBin bin_count, uint16_t partitions, uint16_t partition);
+
+  bool        is_valid_record() const ALWAYS_INLINE { return !reached_end_; }
+  /** Moves on to the next record. */
+  ErrorCode   next();
+
+  /** Returns the range of bins this cursor scans */
+  const HashBinRange& get_range() const ALWAYS_INLINE { return range_; }
+  /** Returns the hash bin of the current record */
+  HashBin     get_bin() const ALWAYS_INLINE {
+    ASSERT_ND(is_valid_record());
+    return cur_bin_;
+  }
+  /** Returns the full hash value of the current record */
+  HashValue   get_hash() const;
+  const char* get_key() const ALWAYS_INLINE {
+    ASSERT_ND(is_valid_record());
+    return cur_location_.record_;
+  }
+  uint16_t    get_key_length() const ALWAYS_INLINE {
+    ASSERT_ND(is_valid_record());
+    return cur_location_.key_length_;
+  }
+  const char* get_payload() const ALWAYS_INLINE {
+    ASSERT_ND(is_valid_record());
+    return cur_location_.record_ + cur_location_.get_aligned_key_length();
+  }
+  uint16_t    get_payload_length() const ALWAYS_INLINE {
+    ASSERT_ND(is_valid_record());
+    return cur_location_.cur_payload_length_;
+  }
+  /** Returns the XID of the current record as of reading it. */
+  xct::XctId  get_observed_xid() const ALWAYS_INLINE {
+    ASSERT_ND(is_valid_record());
+    return cur_location_.observed_;
+  }
+
+ private:
+  Engine* const       engine_;
+  HashStorage         storage_;
+  thread::Thread* const context_;
+  xct::Xct* const     current_xct_;
+
+  /** The range of bins to scan. */
+  HashBinRange        range_;
+  /** Whether we have no more records to return. */
+  bool                reached_end_;
+  /** Whether cur_page_ is a snapshot page. */
+  bool                cur_page_snapshot_;
+
+  /** The bin we are currently in. */
+  HashBin             cur_bin_;
+  /**
+   * Level-0 intermediate page containing cur_bin_, which we reuse while we are in its range.
+   * null if we haven't reached it yet.
+   */
+  HashIntermediatePage* cur_level0_;
+
+  /** The data page we are currently in. null if the bin is not opened. */
+  HashDataPage*       cur_page_;
+  /** Number of records in cur_page_ as of opening the page. We scan only up to this. */
+  uint16_t            cur_page_record_count_;
+  /** Index of the current record in cur_page_. */
+  DataPageSlotIndex   cur_slot_;
+  /** The current record. */
+  RecordLocation      cur_location_;
+
+  /**
+   * Locates the head page of cur_bin_ and opens it.
+   * If the bin or its ascendants do not exist, we skip to the first bin after them.
+   */
+  ErrorCode   open_bin();
+  /** Prepares to read the records in the page. */
+  ErrorCode   open_page(HashDataPage* page);
+  /** Goes to the next page of cur_page_ in the bin. cur_page_ is null if it was the last. */
+  ErrorCode   next_page();
+  /**
+   * Finds the first valid record at or after cur_slot_, going to following pages and bins
+   * if needed. Sets reached_end_ if there is no such record.
+   */
+  ErrorCode   seek_valid_record();
+};
+}  // namespace hash
+}  // namespace storage
+}  // namespace foedus
+#endif  // FOEDUS_STORAGE_HASH_HASH_CURSOR_HPP_
@@ -311,6 +311,57 @@ class HashStorage CXX11_FINAL : public Storage<HashStorageControlBlock> {
     uint16_t payload_offset,
     bool read_only);
 
+  // batched get_record() methods
+
+  /**
+   * @brief Batched version of get_record() to retrieve many keys at once.
+   * @param[in] context Thread context
+   * @param[in] batch_size Number of keys to retrieve. Any number is allowed, we internally
+   * process them in chunks.
+   * @param[in] key_batch Pointers to the keys.
+   * @param[in] key_length_batch Byte sizes of the keys.
+   * @param[out] payload_batch Buffers to receive the payloads of the records.
+   * @param[in,out] payload_capacity_batch Same as payload_capacity in get_record() for each key.
+   * @param[in] read_only Whether these reads will not be followed by writes.
+   * @param[out] result_batch Result of each key, either kErrorCodeOk,
+   * kErrorCodeStrKeyNotFound, or kErrorCodeStrTooSmallPayloadBuffer.
+   * @return Error that is not specific to a key, such as read-set overflow.
+   * When it's not kErrorCodeOk, result_batch is not reliable and the transaction should abort.
+   * @details
+   * Semantically same as invoking get_record() for each key, but this method
+   * hashinates all keys up front and then walks down the intermediate pages level by level,
+   * prefetching the pages for all keys before following any of them.
+   * This hides the cache miss of each level for all but the first key,
+   * which makes a big difference for multi-get workloads.
+   * Each miss-result is protected by pointer/page-version set as usual.
+   */
+  ErrorCode get_record_batch(
+    thread::Thread* context,
+    uint16_t batch_size,
+    const void* const* key_batch,
+    const uint16_t* key_length_batch,
+    void* const* payload_batch,
+    uint16_t* payload_capacity_batch,
+    bool read_only,
+    ErrorCode* result_batch);
+
+  /**
+   * @brief Batched version of get_record_primitive().
+   * @param[out] result_batch Result of each key, either kErrorCodeOk,
+   * kErrorCodeStrKeyNotFound, or kErrorCodeStrTooShortPayload.
+   * @see get_record_batch()
+   */
+  template <typename PAYLOAD>
+  ErrorCode get_record_primitive_batch(
+    thread::Thread* context,
+    uint16_t payload_offset,
+    uint16_t batch_size,
+    const void* const* key_batch,
+    const uint16_t* key_length_batch,
+    PAYLOAD* payload_batch,
+    bool read_only,
+    ErrorCode* result_batch);
+
   // insert_record() methods
 
   /**
@@ -92,6 +92,11 @@ struct HashStorageControlBlock final {
  */
 class HashStoragePimpl final : public Attachable<HashStorageControlBlock> {
  public:
+  enum Constants {
+    /** If you want more than this, you should loop. HashStorage should take care of it. */
+    kBatchMax = 16,
+  };
+
   HashStoragePimpl() : Attachable<HashStorageControlBlock>() {}
   explicit HashStoragePimpl(HashStorage* storage)
     : Attachable<HashStorageControlBlock>(
@@ -210,6 +215,28 @@ class HashStoragePimpl final : public Attachable<HashStorageControlBlock> {
     uint16_t payload_count,
     bool read_only);
 
+  /** @see foedus::storage::hash::HashStorage::get_record_batch() */
+  ErrorCode   get_record_batch(
+    thread::Thread* context,
+    uint16_t batch_size,
+    const void* const* key_batch,
+    const uint16_t* key_length_batch,
+    void* const* payload_batch,
+    uint16_t* payload_capacity_batch,
+    bool read_only,
+    ErrorCode* result_batch);
+
+  /** @see foedus::storage::hash::HashStorage::get_record_primitive_batch() */
+  template <typename PAYLOAD>
+  ErrorCode   get_record_primitive_batch(
+    thread::Thread* context,
+    uint16_t payload_offset,
+    uint16_t batch_size,
+    const void* const* key_batch,
+    const uint16_t* key_length_batch,
+    PAYLOAD* payload_batch,
+    bool read_only,
+    ErrorCode* result_batch);
 
   /** Used in the following methods */
   ErrorCode register_record_write_log(
@@ -336,6 +363,42 @@ class HashStoragePimpl final : public Attachable<HashStorageControlBlock> {
     const HashCombo& combo,
     HashDataPage** bin_head);
 
+  /**
+   * @brief Batched version of locate_bin().
+   * @param[in] context Thread context
+   * @param[in] for_write Whether we are reading these pages to modify
+   * @param[in] batch_size Number of hashes to locate. Must be kBatchMax or less.
+   * @param[in] combo_batch Hash values.
+   * @param[out] bin_head_batch Pointers to the first data pages of the bins. Might be null.
+   * @details
+   * We walk down the intermediate pages one level at a time for all hashes,
+   * issuing prefetches for the pointers we will follow in the next level before
+   * following any of them. Thus we stall on a cache miss roughly once per level rather than
+   * once per level per key. We also prefetch the header and the first slots of each bin head
+   * so that the following locate_record() calls are likely to hit the cache.
+   */
+  ErrorCode   locate_bin_batch(
+    thread::Thread* context,
+    bool for_write,
+    uint16_t batch_size,
+    const HashCombo* combo_batch,
+    HashDataPage** bin_head_batch);
+
+  /**
+   * @brief locate_bin_batch() followed by locate_record_logical() for each key.
+   * @details
+   * If the bin of a key doesn't exist, the corresponding result is cleared (not found).
+   * Like locate_bin(), the not-found result is protected by pointer set.
+   */
+  ErrorCode   locate_record_batch(
+    thread::Thread* context,
+    bool for_write,
+    uint16_t batch_size,
+    const void* const* key_batch,
+    const uint16_t* key_length_batch,
+    const HashCombo* combo_batch,
+    RecordLocation* result_batch);
+
   /**
    * @brief Usually follows locate_bin to locate the exact physical record for the key, or
    * create a new one if not exists (only when for_write).
@@ -26,6 +26,7 @@ namespace foedus {
 namespace storage {
 namespace masstree {
 class   MasstreeBorderPage;
+class   MasstreeBulkLoader;
 struct  MasstreeCommonLogType;
 struct  MasstreeCreateLogType;
 class   MasstreeCursor;
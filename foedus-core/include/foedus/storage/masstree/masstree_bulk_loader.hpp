@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_STORAGE_MASSTREE_MASSTREE_BULK_LOADER_HPP_
+#define FOEDUS_STORAGE_MASSTREE_MASSTREE_BULK_LOADER_HPP_
+#include <stdint.h>
+
+#include "foedus/cxx11.hpp"
+#include "foedus/error_code.hpp"
+#include "foedus/fwd.hpp"
+#include "foedus/snapshot/bulk_loader.hpp"
+#include "foedus/storage/storage_id.hpp"
+#include "foedus/storage/masstree/masstree_id.hpp"
+
+namespace foedus {
+namespace storage {
+namespace masstree {
+/**
+ * @brief Bulk-loads sorted records into an empty masstree storage.
+ * @ingroup MASSTREE
+ * @details
+ * Records must be appended in strictly increasing order of keys, which is the order
+ * MasstreeCursor returns them (byte-wise comparison, shorter key first if one is a prefix of
+ * another). The snapshot taken in commit() builds the snapshot pages with MasstreeComposer.
+ *
+ * The volatile pages of the empty storage must be dropped after the snapshot, so the storage
+ * must not be configured to keep its root volatile page (the default configuration drops it).
+ * @see snapshot::BulkLoader
+ */
+class MasstreeBulkLoader CXX11_FINAL : public snapshot::BulkLoader {
+ public:
+  MasstreeBulkLoader(Engine* engine, StorageId storage_id);
+
+  /**
+   * @brief Appends a record.
+   * @return kErrorCodeSnapshotBulkLoadUnsorted if the key is not larger than the previous key.
+   */
+  ErrorCode append(
+    const void* key,
+    KeyLength key_length,
+    const void* payload,
+    PayloadLength payload_count);
+  /** Same as append() except this receives a primitive key. */
+  ErrorCode append_normalized(
+    KeySlice key,
+    const void* payload,
+    PayloadLength payload_count);
+
+ protected:
+  ErrorCode check_storage() CXX11_OVERRIDE;
+
+ private:
+  /** Copy of the previous key to check the order. */
+  char      previous_key_[kMaxKeyLength];
+  KeyLength previous_key_length_;
+  bool      has_previous_key_;
+};
+
+}  // namespace masstree
+}  // namespace storage
+}  // namespace foedus
+#endif  // FOEDUS_STORAGE_MASSTREE_MASSTREE_BULK_LOADER_HPP_
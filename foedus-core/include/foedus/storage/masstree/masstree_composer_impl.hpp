@@ -499,6 +499,8 @@ class MasstreeComposeContext {
    * Writing-out and re-reading the tentative pages in pathway shouldn't be a big issue.
    */
   ErrorStack  flush_buffer();
+  /** Adds the pointers in the page to unchanged pages of previous snapshots to statistics. */
+  void        count_reused_pointers(MasstreePage* page) const;
   inline ErrorStack flush_if_nearly_full() {
     uint64_t threshold = max_pages_ * 8ULL / 10ULL;
     if (UNLIKELY(allocated_pages_ >= threshold || allocated_pages_ + 256U >= max_pages_)) {
@@ -187,6 +187,18 @@ class MasstreeCursor CXX11_FINAL {
   MasstreeStorage&  get_storage() { return storage_; }
   bool              is_for_writes() const { return for_writes_; }
   bool              is_forward_cursor() const { return forward_cursor_; }
+  bool              is_no_cache() const { return no_cache_; }
+  /**
+   * @brief Hints that this cursor scans a large range, so its pages should not push
+   * other pages out of the snapshot cache.
+   * @details
+   * While this cursor reads pages in open() and next(), the thread is in
+   * thread::Thread::set_snapshot_cache_scan_mode(). Snapshot pages read by this cursor are
+   * not promoted in the snapshot cache, and those not cached yet stay probationary.
+   * This is effective only with CacheOptions::kEvictionPolicyScanResistant.
+   * Default is false. Can be changed at any time.
+   */
+  void              set_no_cache(bool value) { no_cache_ = value; }
 
   ErrorCode   open(
     const char* begin_key = CXX11_NULLPTR,
@@ -220,6 +232,21 @@ class MasstreeCursor CXX11_FINAL {
       end_inclusive);
   }
 
+  /**
+   * @brief Opens a forward cursor for one of the partitions made by
+   * MasstreeStorage::partition_for_scan().
+   * @param[in] partitions the partitions made by MasstreeStorage::partition_for_scan()
+   * @param[in] partition index of the partition to scan
+   * @param[in] for_writes whether the cursor modifies records
+   * @details
+   * The partitions are disjoint and do not miss any key, including keys longer or
+   * shorter than 8 bytes. So, each thread can scan its own partition with its own cursor.
+   */
+  ErrorCode   open_partition(
+    const MasstreeStorage::ScanPartitions& partitions,
+    uint16_t partition,
+    bool for_writes = false);
+
   bool      is_valid_record() const ALWAYS_INLINE {
     return route_count_ > 0 && !reached_end_ && cur_route()->is_valid_record();
   }
@@ -327,6 +354,8 @@ class MasstreeCursor CXX11_FINAL {
 
   bool        for_writes_;
   bool        forward_cursor_;
+  /** @see set_no_cache() */
+  bool        no_cache_;
   bool        end_inclusive_;
   bool        reached_end_;
 
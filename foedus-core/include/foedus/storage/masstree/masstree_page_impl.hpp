@@ -37,6 +37,7 @@
 #include "foedus/storage/storage_id.hpp"
 #include "foedus/storage/masstree/fwd.hpp"
 #include "foedus/storage/masstree/masstree_id.hpp"
+#include "foedus/storage/masstree/masstree_slice_search.hpp"
 #include "foedus/thread/fwd.hpp"
 #include "foedus/xct/fwd.hpp"
 #include "foedus/xct/xct_id.hpp"
@@ -1026,6 +1027,7 @@ class MasstreeBorderPage final : public MasstreePage {
    * We also considered more complicated schemes to spend the bytes only when we needed,
    * but it's not worth doing. Only 800 out of 4096, rather it is so important to
    * access slices_ efficiently.
+   * Being contiguous, slices_ are also compared with SIMD. See masstree_slice_search.hpp.
    */
   KeySlice    slices_[kBorderPageMaxSlots];
 
@@ -1127,13 +1129,13 @@ inline SlotIndex MasstreeBorderPage::find_key(
   prefetch_additional_if_needed(key_count);
 
   // one slice might be used for up to 10 keys, length 0 to 8 and pointer to next layer.
+  // find_slice() skips records of other slices with SIMD. we check the rest only for matches.
   if (remainder <= sizeof(KeySlice)) {
     // then we are looking for length 0-8 only.
-    for (SlotIndex i = 0; i < key_count; ++i) {
-      const KeySlice rec_slice = get_slice(i);
-      if (LIKELY(slice != rec_slice)) {
-        continue;
-      }
+    for (SlotIndex i = find_slice(slices_, 0, key_count, slice);
+          i < key_count;
+          i = find_slice(slices_, i + 1U, key_count, slice)) {
+      ASSERT_ND(get_slice(i) == slice);
       // no suffix nor next layer, so just compare length. if not match, continue
       const KeyLength klen = get_remainder_length(i);
       if (klen == remainder) {
@@ -1142,12 +1144,10 @@ inline SlotIndex MasstreeBorderPage::find_key(
     }
   } else {
     // then we are only looking for length>8.
-    for (SlotIndex i = 0; i < key_count; ++i) {
-      const KeySlice rec_slice = get_slice(i);
-      if (LIKELY(slice != rec_slice)) {
-        continue;
-      }
-
+    for (SlotIndex i = find_slice(slices_, 0, key_count, slice);
+          i < key_count;
+          i = find_slice(slices_, i + 1U, key_count, slice)) {
+      ASSERT_ND(get_slice(i) == slice);
       if (does_point_to_layer(i)) {
         // as it points to next layer, no need to check suffix. We are sure this is it.
         // so far we don't delete layers, so in this case the record is always valid.
@@ -1185,10 +1185,12 @@ inline SlotIndex MasstreeBorderPage::find_key_normalized(
   if (from_index == 0) {  // we don't need prefetching in second time
     prefetch_additional_if_needed(to_index);
   }
-  for (SlotIndex i = from_index; i < to_index; ++i) {
-    const KeySlice rec_slice = get_slice(i);
+  for (SlotIndex i = find_slice(slices_, from_index, to_index, slice);
+        i < to_index;
+        i = find_slice(slices_, i + 1U, to_index, slice)) {
+    ASSERT_ND(get_slice(i) == slice);
     const KeyLength klen = get_remainder_length(i);
-    if (UNLIKELY(slice == rec_slice && klen == sizeof(KeySlice))) {
+    if (klen == sizeof(KeySlice)) {
       return i;
     }
   }
@@ -1208,11 +1210,10 @@ inline MasstreeBorderPage::FindKeyForReserveResult MasstreeBorderPage::find_key_
     prefetch_additional_if_needed(to_index);
   }
   if (remainder <= sizeof(KeySlice)) {
-    for (SlotIndex i = from_index; i < to_index; ++i) {
-      const KeySlice rec_slice = get_slice(i);
-      if (LIKELY(slice != rec_slice)) {
-        continue;
-      }
+    for (SlotIndex i = find_slice(slices_, from_index, to_index, slice);
+          i < to_index;
+          i = find_slice(slices_, i + 1U, to_index, slice)) {
+      ASSERT_ND(get_slice(i) == slice);
       const KeyLength klen = get_remainder_length(i);
       if (klen == remainder) {
         ASSERT_ND(!does_point_to_layer(i));
@@ -1220,12 +1221,10 @@ inline MasstreeBorderPage::FindKeyForReserveResult MasstreeBorderPage::find_key_
       }
     }
   } else {
-    for (SlotIndex i = from_index; i < to_index; ++i) {
-      const KeySlice rec_slice = get_slice(i);
-      if (LIKELY(slice != rec_slice)) {
-        continue;
-      }
-
+    for (SlotIndex i = find_slice(slices_, from_index, to_index, slice);
+          i < to_index;
+          i = find_slice(slices_, i + 1U, to_index, slice)) {
+      ASSERT_ND(get_slice(i) == slice);
       const bool next_layer = does_point_to_layer(i);
       const KeyLength klen = get_remainder_length(i);
 
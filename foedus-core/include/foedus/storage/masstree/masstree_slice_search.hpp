@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_STORAGE_MASSTREE_MASSTREE_SLICE_SEARCH_HPP_
+#define FOEDUS_STORAGE_MASSTREE_MASSTREE_SLICE_SEARCH_HPP_
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <immintrin.h>
+#endif  // defined(__aarch64__)
+#include <stdint.h>
+
+#include "foedus/compiler.hpp"
+#include "foedus/storage/masstree/masstree_id.hpp"
+
+/**
+ * @file foedus/storage/masstree/masstree_slice_search.hpp
+ * @brief Vectorized search of key slices in MasstreeBorderPage.
+ * @ingroup MASSTREE
+ * @details
+ * Border pages have up to kBorderPageMaxSlots key slices in a contiguous array
+ * (MasstreeBorderPage::slices_), and every point read/insert linearly searches it.
+ * These functions compare kSliceSearchWidth slices at once with SIMD instructions.
+ * We use the widest instruction set the compiler is allowed to emit:
+ * AVX-512F (8 slices), AVX2 (4 slices), SSE2 (2 slices), or NEON on AArch64 (2 slices).
+ * Without any of them, we fall back to the scalar loop.
+ * We don't check CPU features at runtime. Compile with -march=native (or -mavx2 etc) to use
+ * wider instructions. See \ref ARMV8 for AArch64.
+ *
+ * @par Concurrency
+ * Slices below the key count are immutable once the record is made, so it is safe to read
+ * them in one vector load even while other threads insert new records.
+ * We never load slices at or after the given upper bound, which might be being written.
+ */
+namespace foedus {
+namespace storage {
+namespace masstree {
+
+#if defined(__AVX512F__)
+/** Number of slices compared in one SIMD comparison. */
+const SlotIndex kSliceSearchWidth = 8;
+#elif defined(__AVX2__)
+const SlotIndex kSliceSearchWidth = 4;
+#elif defined(__SSE2__) || defined(__aarch64__)
+const SlotIndex kSliceSearchWidth = 2;
+#else  // no SIMD
+const SlotIndex kSliceSearchWidth = 1;
+#endif  // defined(__AVX512F__)
+
+/**
+ * @brief Compares kSliceSearchWidth slices from the given address with the given slice.
+ * @return bitmask of matched slices. i-th bit is on iff slices[i] == slice.
+ */
+inline uint32_t compare_slices(const KeySlice* slices, KeySlice slice) ALWAYS_INLINE;
+inline uint32_t compare_slices(const KeySlice* slices, KeySlice slice) {
+#if defined(__AVX512F__)
+  const __m512i key = _mm512_set1_epi64(static_cast<int64_t>(slice));
+  const __m512i data = _mm512_loadu_si512(slices);
+  return _mm512_cmpeq_epi64_mask(key, data);
+#elif defined(__AVX2__)
+  const __m256i key = _mm256_set1_epi64x(static_cast<int64_t>(slice));
+  const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(slices));
+  return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(key, data)));
+#elif defined(__SSE2__)
+  // SSE2 has no 64-bit comparison. Compare 32-bit halves, then both halves must match.
+  const __m128i key = _mm_set1_epi64x(static_cast<int64_t>(slice));
+  const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(slices));
+  const uint32_t halves = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(key, data)));
+  return ((halves & 0x3U) == 0x3U ? 0x1U : 0U) | ((halves & 0xCU) == 0xCU ? 0x2U : 0U);
+#elif defined(__aarch64__)
+  const uint64x2_t key = vdupq_n_u64(slice);
+  const uint64x2_t data = vld1q_u64(slices);
+  const uint64x2_t result = vceqq_u64(key, data);
+  return (vgetq_lane_u64(result, 0) & 0x1U) | (vgetq_lane_u64(result, 1) & 0x2U);
+#else  // no SIMD
+  return slices[0] == slice ? 1U : 0U;
+#endif  // defined(__AVX512F__)
+}
+
+/**
+ * @brief Returns the smallest index in [from, to) whose slice is equal to the given slice.
+ * @return to if no slice matches.
+ * @details
+ * This is the plain loop we had in MasstreeBorderPage. Kept as the reference implementation.
+ */
+inline SlotIndex find_slice_scalar(
+  const KeySlice* slices,
+  SlotIndex from,
+  SlotIndex to,
+  KeySlice slice) {
+  for (SlotIndex i = from; i < to; ++i) {
+    if (UNLIKELY(slices[i] == slice)) {
+      return i;
+    }
+  }
+  return to;
+}
+
+/**
+ * @brief SIMD version of find_slice_scalar().
+ * @details
+ * Compares kSliceSearchWidth slices at a time, then the remaining few slices one by one so that
+ * we never load slices at or after to.
+ */
+inline SlotIndex find_slice(
+  const KeySlice* slices,
+  SlotIndex from,
+  SlotIndex to,
+  KeySlice slice) ALWAYS_INLINE;
+inline SlotIndex find_slice(
+  const KeySlice* slices,
+  SlotIndex from,
+  SlotIndex to,
+  KeySlice slice) {
+  SlotIndex i = from;
+  for (; i + kSliceSearchWidth <= to; i += kSliceSearchWidth) {
+    const uint32_t matches = compare_slices(slices + i, slice);
+    if (UNLIKELY(matches != 0)) {
+      return i + __builtin_ctz(matches);
+    }
+  }
+  return find_slice_scalar(slices, i, to, slice);
+}
+
+}  // namespace masstree
+}  // namespace storage
+}  // namespace foedus
+#endif  // FOEDUS_STORAGE_MASSTREE_MASSTREE_SLICE_SEARCH_HPP_
@@ -236,6 +236,69 @@ class MasstreeStorage CXX11_FINAL : public Storage<MasstreeStorageControlBlock>
     PayloadLength payload_offset,
     bool read_only);
 
+  // batched get_record() methods
+
+  /**
+   * @brief Batched version of get_record() to retrieve many keys at once.
+   * @param[in] context Thread context
+   * @param[in] batch_size Number of keys to retrieve. Any number is allowed, we internally
+   * process them in chunks.
+   * @param[in] key_batch Pointers to the keys in big-endian byte order.
+   * @param[in] key_length_batch Byte sizes of the keys.
+   * @param[out] payload_batch Buffers to receive the payloads of the records.
+   * @param[in,out] payload_capacity_batch Same as payload_capacity in get_record() for each key.
+   * @param[in] read_only Whether these reads will not be followed by writes.
+   * @param[out] result_batch Result of each key, either kErrorCodeOk,
+   * kErrorCodeStrKeyNotFound, or kErrorCodeStrTooSmallPayloadBuffer.
+   * @return Error that is not specific to a key, such as read-set overflow.
+   * When it's not kErrorCodeOk, result_batch is not reliable and the transaction should abort.
+   * @details
+   * Semantically same as invoking get_record() for each key, but this method
+   * descends the tree for all keys in lock-step. In each step, we issue prefetches for the
+   * next minipage/page of every key and then come back to the first key, so that the
+   * cache misses of different keys overlap rather than being serialized.
+   * Keys that move to next layers or foster twins simply take more steps than others.
+   * Each miss-result is protected by page-version set as usual.
+   */
+  ErrorCode   get_record_batch(
+    thread::Thread* context,
+    uint16_t batch_size,
+    const void* const* key_batch,
+    const KeyLength* key_length_batch,
+    void* const* payload_batch,
+    PayloadLength* payload_capacity_batch,
+    bool read_only,
+    ErrorCode* result_batch);
+
+  /**
+   * @brief Batched version of get_record_normalized().
+   * @see get_record_batch()
+   */
+  ErrorCode   get_record_normalized_batch(
+    thread::Thread* context,
+    uint16_t batch_size,
+    const KeySlice* key_batch,
+    void* const* payload_batch,
+    PayloadLength* payload_capacity_batch,
+    bool read_only,
+    ErrorCode* result_batch);
+
+  /**
+   * @brief Batched version of get_record_primitive_normalized().
+   * @param[out] result_batch Result of each key, either kErrorCodeOk,
+   * kErrorCodeStrKeyNotFound, or kErrorCodeStrTooShortPayload.
+   * @see get_record_batch()
+   */
+  template <typename PAYLOAD>
+  ErrorCode   get_record_primitive_normalized_batch(
+    thread::Thread* context,
+    PayloadLength payload_offset,
+    uint16_t batch_size,
+    const KeySlice* key_batch,
+    PAYLOAD* payload_batch,
+    bool read_only,
+    ErrorCode* result_batch);
+
   // insert_record() methods
 
   /**
@@ -535,6 +598,50 @@ class MasstreeStorage CXX11_FINAL : public Storage<MasstreeStorageControlBlock>
     PAYLOAD* value,
     PayloadLength payload_offset);
 
+  /**
+   * @brief Increments a \e striped counter, a hot counter spread over multiple records.
+   * @param[in] context Thread context
+   * @param[in] key The primitive key of the first record of the counter
+   * @param[in] value addendum
+   * @param[in] payload_offset We write to this byte position of the records.
+   * @param[in] stripes The number of records the counter is spread over.
+   * @tparam PAYLOAD primitive type of the payload. all integers and floats are allowed.
+   * @return kErrorCodeInvalidParameter if stripes is 0 or the keys wrap around
+   * @details
+   * Same as foedus::storage::array::ArrayStorage::increment_record_striped().
+   * The stripes are the records of keys [key, key + stripes), each thread adding only to its
+   * own stripe. A stripe that doesn't exist yet is inserted with value at payload_offset and
+   * zeros before it, so the records don't have to be created in advance.
+   * Unlike the array version, each increment reads the stripe, but the stripe is private to
+   * the thread as long as there are as many stripes as threads.
+   */
+  template <typename PAYLOAD>
+  ErrorCode   increment_record_normalized_striped(
+    thread::Thread* context,
+    KeySlice key,
+    PAYLOAD value,
+    PayloadLength payload_offset,
+    uint16_t stripes);
+
+  /**
+   * @brief Reads a striped counter updated by increment_record_normalized_striped().
+   * @param[in] context Thread context
+   * @param[in] key The primitive key of the first record of the counter
+   * @param[out] value The value of the counter, the sum of all stripes.
+   * @param[in] payload_offset We read from this byte position of the records.
+   * @param[in] stripes The number of records the counter is spread over.
+   * @details
+   * Stripes that don't exist count as zero. Their absence is protected by the range-lock
+   * read set just like get_record().
+   */
+  template <typename PAYLOAD>
+  ErrorCode   get_record_primitive_normalized_striped(
+    thread::Thread* context,
+    KeySlice key,
+    PAYLOAD* value,
+    PayloadLength payload_offset,
+    uint16_t stripes);
+
   // TODO(Hideaki): Extend/shrink/update methods for payload. A bit faster than delete + insert.
 
   ErrorStack  verify_single_thread(thread::Thread* context);
@@ -588,6 +695,60 @@ class MasstreeStorage CXX11_FINAL : public Storage<MasstreeStorageControlBlock>
    */
   ErrorCode   peek_volatile_page_boundaries(Engine* engine, const PeekBoundariesArguments& args);
 
+  /** Output of partition_for_scan(). Trivially copyable, so it can be a proc input as is. */
+  struct ScanPartitions {
+    enum Constants {
+      kMaxPartitions = 256,
+    };
+    /** Number of partitions. At least 1. */
+    uint16_t  count_;
+    /**
+     * The i-th partition covers [boundaries_[i], boundaries_[i + 1]) of normalized keys.
+     * boundaries_[0] == kInfimumSlice means no lower limit, and
+     * boundaries_[count_] == kSupremumSlice means no upper limit, even for longer keys.
+     * Use MasstreeCursor::open_partition() to scan each of them.
+     */
+    KeySlice  boundaries_[kMaxPartitions + 1U];
+  };
+
+  /**
+   * @brief Divides a range of the first layer into sub-ranges of similar sizes to scan them
+   * in parallel.
+   * @param[in] engine Engine
+   * @param[in] from inclusive beginning of the range in the first layer.
+   * kInfimumSlice to begin from the smallest key.
+   * @param[in] to exclusive end of the range in the first layer.
+   * kSupremumSlice to end at the largest key.
+   * @param[in] desired_partitions at most this number of partitions are made.
+   * @param[out] out the partitions
+   * @details
+   * Partitions are separated at page boundaries of the volatile first layer, so that
+   * each partition has a similar number of border pages and also threads do not read
+   * the same page. Like peek_volatile_page_boundaries(), this method is opportunistic.
+   * The result is correct (the partitions always cover the range without overlaps), but
+   * concurrent splits might make some partitions larger than others.
+   * If there are not enough border pages, or the storage has no volatile pages,
+   * this makes fewer partitions than desired, possibly only one.
+   * Each partition is then scanned by its own thread and transaction. For example:
+   * @code{.cpp}
+   * MasstreeStorage::ScanPartitions partitions;
+   * WRAP_ERROR_CODE(orderlines.partition_for_scan(engine, low, high, thread_count, &partitions));
+   * for (uint16_t i = 0; i < partitions.count_; ++i) {
+   *   ... impersonate a thread, passing partitions and i as the input
+   * }
+   * // In each impersonated thread:
+   * MasstreeCursor cursor(orderlines, context);
+   * CHECK_ERROR_CODE(cursor.open_partition(partitions, i));
+   * @endcode
+   * Defined in masstree_storage_peek.cpp
+   */
+  ErrorCode   partition_for_scan(
+    Engine* engine,
+    KeySlice from,
+    KeySlice to,
+    uint16_t desired_partitions,
+    ScanPartitions* out);
+
   /**
    * @brief Deliberately causes splits under the volatile root of first layer, or "fatify" it.
    * @param[in] context Thread context
@@ -97,6 +97,11 @@ struct MasstreeStorageControlBlock final {
  */
 class MasstreeStoragePimpl final : public Attachable<MasstreeStorageControlBlock> {
  public:
+  enum Constants {
+    /** Max number of keys processed together in locate_record_batch(). */
+    kBatchMax = 16,
+  };
+
   MasstreeStoragePimpl() : Attachable<MasstreeStorageControlBlock>() {}
   explicit MasstreeStoragePimpl(MasstreeStorage* storage)
     : Attachable<MasstreeStorageControlBlock>(
@@ -148,6 +153,45 @@ class MasstreeStoragePimpl final : public Attachable<MasstreeStorageControlBlock
     bool for_writes,
     RecordLocation* result);
 
+  /**
+   * @brief Batched version of locate_record()/locate_record_normalized().
+   * @details
+   * Either key_batch/key_length_batch or normalized_key_batch must be given, the other
+   * being nullptr. Found/not-found of each key goes to result_batch (kErrorCodeOk or
+   * kErrorCodeStrKeyNotFound) while the return value tells errors for the whole batch.
+   * batch_size must be kBatchMax or less.
+   */
+  ErrorCode locate_record_batch(
+    thread::Thread* context,
+    uint16_t batch_size,
+    const void* const* key_batch,
+    const KeyLength* key_length_batch,
+    const KeySlice* normalized_key_batch,
+    bool for_writes,
+    RecordLocation* location_batch,
+    ErrorCode* result_batch);
+
+  /** implementation of get_record_batch family */
+  ErrorCode get_record_batch(
+    thread::Thread* context,
+    uint16_t batch_size,
+    const void* const* key_batch,
+    const KeyLength* key_length_batch,
+    const KeySlice* normalized_key_batch,
+    void* const* payload_batch,
+    PayloadLength* payload_capacity_batch,
+    bool read_only,
+    ErrorCode* result_batch);
+  template <typename PAYLOAD>
+  ErrorCode get_record_primitive_normalized_batch(
+    thread::Thread* context,
+    PayloadLength payload_offset,
+    uint16_t batch_size,
+    const KeySlice* key_batch,
+    PAYLOAD* payload_batch,
+    bool read_only,
+    ErrorCode* result_batch);
+
   /**
    * Like locate_record(), this is also a logical operation.
    */
@@ -331,6 +375,12 @@ class MasstreeStoragePimpl final : public Attachable<MasstreeStorageControlBlock
     const MasstreeIntermediatePage* cur,
     const memory::GlobalVolatilePageResolver& resolver,
     const MasstreeStorage::PeekBoundariesArguments& args);
+  ErrorCode     partition_for_scan(
+    Engine* engine,
+    KeySlice from,
+    KeySlice to,
+    uint16_t desired_partitions,
+    MasstreeStorage::ScanPartitions* out);
 
   /** Defined in masstree_storage_fatify.cpp */
   ErrorStack    fatify_first_root(
@@ -27,12 +27,17 @@ namespace foedus {
 namespace thread {
 class   GrabFreeVolatilePagesScope;
 struct  ImpersonateSession;
+struct  LatencyHistogram;
 class   Rendezvous;
 class   StoppableThread;
+struct  TaskQueue;
+struct  TaskQueueEntry;
 class   Thread;
 struct  ThreadControlBlock;
 class   ThreadGroup;
 class   ThreadGroupRef;
+struct  ThreadLatencyHistograms;
+struct  ThreadMetrics;
 struct  ThreadOptions;
 class   ThreadPimpl;
 template<typename RW_BLOCK> class ThreadPimplMcsAdaptor;
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_THREAD_LATENCY_HISTOGRAM_HPP_
+#define FOEDUS_THREAD_LATENCY_HISTOGRAM_HPP_
+
+#include <stdint.h>
+
+#include <cstring>
+#include <iosfwd>
+
+#include "foedus/compiler.hpp"
+
+namespace foedus {
+namespace thread {
+
+/**
+ * @brief A log-bucket histogram of latencies in RDTSC cycles.
+ * @ingroup THREAD
+ * @details
+ * Like HDR histograms, each power of two is divided into kSubBuckets buckets of the same width,
+ * so the relative error of percentiles is bounded (25%) regardless of the magnitude.
+ * Values below kSubBuckets have their own buckets, and values of 2^kMaxExponent cycles or
+ * more (several minutes) go into the last bucket.
+ *
+ * Recording a value is a few instructions and touches one bucket plus the header cacheline.
+ * Histograms are mergeable with add(), so per-thread histograms can be summed up without losing
+ * the tail information.
+ */
+struct LatencyHistogram {
+  enum Constants {
+    kSubBucketBits = 2,
+    kSubBuckets = 1 << kSubBucketBits,
+    /** Values up to 2^kMaxExponent cycles are distinguished. */
+    kMaxExponent = 40,
+    kBucketCount = (kMaxExponent - kSubBucketBits + 1) * kSubBuckets,
+  };
+
+  /** Number of recorded values */
+  uint64_t  count_;
+  /** Sum of recorded values, to calculate the average */
+  uint64_t  sum_;
+  /** The largest recorded value */
+  uint64_t  max_;
+  uint64_t  reserved_;
+  uint64_t  buckets_[kBucketCount];
+
+  void      reset() { std::memset(this, 0, sizeof(*this)); }
+
+  void      record(uint64_t cycles) ALWAYS_INLINE {
+    ++buckets_[to_bucket(cycles)];
+    ++count_;
+    sum_ += cycles;
+    if (cycles > max_) {
+      max_ = cycles;
+    }
+  }
+
+  /** Adds up the other histogram to this histogram. */
+  void      add(const LatencyHistogram& other);
+
+  double    get_average() const { return count_ == 0 ? 0 : static_cast<double>(sum_) / count_; }
+  /**
+   * @brief Returns the value at the given percentile.
+   * @param[in] percentile 0 to 100, eg 99.9
+   * @return an upper bound of the value at the percentile, which is at most 25% larger than
+   * the actual value. 0 if there is no value.
+   */
+  uint64_t  get_percentile(double percentile) const;
+
+  /** Returns the index of the bucket that contains the value. */
+  static uint32_t to_bucket(uint64_t value) ALWAYS_INLINE {
+    if (value < static_cast<uint64_t>(kSubBuckets)) {
+      return static_cast<uint32_t>(value);
+    }
+    const uint32_t exponent = 63U - __builtin_clzll(value);  // >= kSubBucketBits
+    const uint32_t shift = exponent - kSubBucketBits;
+    const uint32_t sub = static_cast<uint32_t>(value >> shift) & (kSubBuckets - 1U);
+    const uint32_t bucket = (shift + 1U) * kSubBuckets + sub;
+    return bucket < static_cast<uint32_t>(kBucketCount) ? bucket : kBucketCount - 1U;
+  }
+  /** Returns the smallest value in the bucket. */
+  static uint64_t get_bucket_floor(uint32_t bucket);
+
+  friend std::ostream& operator<<(std::ostream& o, const LatencyHistogram& v);
+};
+
+/**
+ * @brief Phases of a transaction whose latencies we measure.
+ * @ingroup THREAD
+ */
+enum LatencyPhase {
+  /** From begin_xct() to precommit_xct(), ie the user code accessing records. */
+  kLatencyPhaseUserBody = 0,
+  /** Taking locks of the write-set in precommit. Only in read-write transactions. */
+  kLatencyPhasePrecommitLock,
+  /** Verifying the read-set, pointer-set and page-version-set in precommit. */
+  kLatencyPhaseVerify,
+  /** Applying the write-set and publishing logs in precommit. Only in read-write transactions. */
+  kLatencyPhaseApply,
+  /** Waiting for the commit epoch to become durable in wait_for_commit(). */
+  kLatencyPhaseWaitForCommit,
+  kLatencyPhaseCount,
+};
+
+/** Returns a short name of the phase, such as "UserBody". */
+const char* get_latency_phase_name(LatencyPhase phase);
+
+/**
+ * @brief Latency histograms of one worker thread, one for each LatencyPhase.
+ * @ingroup THREAD
+ * @details
+ * Each thread has one instance of this in its ThreadControlBlock, which is placed in the
+ * shared memory. Same as ThreadMetrics, only the owner thread updates it without
+ * synchronization, and anyone can read it at any time. The histograms of all threads can be
+ * summed up with ThreadPool::get_latency_histograms_sum().
+ * Only successful transactions are recorded in phases after kLatencyPhaseUserBody.
+ */
+struct ThreadLatencyHistograms {
+  LatencyHistogram  phases_[kLatencyPhaseCount];
+
+  void      reset() { std::memset(this, 0, sizeof(*this)); }
+  void      record(LatencyPhase phase, uint64_t cycles) ALWAYS_INLINE {
+    phases_[phase].record(cycles);
+  }
+  void      add(const ThreadLatencyHistograms& other);
+  const LatencyHistogram& get(LatencyPhase phase) const { return phases_[phase]; }
+
+  friend std::ostream& operator<<(std::ostream& o, const ThreadLatencyHistograms& v);
+};
+
+}  // namespace thread
+}  // namespace foedus
+#endif  // FOEDUS_THREAD_LATENCY_HISTOGRAM_HPP_
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_THREAD_TASK_QUEUE_HPP_
+#define FOEDUS_THREAD_TASK_QUEUE_HPP_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "foedus/error_code.hpp"
+#include "foedus/proc/proc_id.hpp"
+#include "foedus/soc/shared_polling.hpp"
+#include "foedus/thread/fwd.hpp"
+#include "foedus/thread/thread_id.hpp"
+
+namespace foedus {
+namespace thread {
+
+/**
+ * @brief One slot of TaskQueue.
+ * @ingroup THREAD
+ * @details
+ * The state of the slot is represented by sequence_, relative to the ticket (position) p
+ * of the task in the slot:
+ *  \li sequence_ == p : free. a client can claim it for ticket p.
+ *  \li sequence_ == p + 1 : submitted. the worker will run it.
+ *  \li sequence_ == p + 2 : completed. the client can retrieve the result.
+ *  \li sequence_ == p + kCapacity : released. free for ticket p + kCapacity.
+ */
+struct TaskQueueEntry {
+  enum Constants {
+    kInputSize = 1 << 10,
+    kOutputSize = 1 << 10,
+  };
+  std::atomic<uint64_t> sequence_;
+  /** Result of the procedure, only the error code of the ErrorStack. */
+  ErrorCode             result_;
+  uint32_t              input_len_;
+  uint32_t              output_len_;
+  uint32_t              reserved_;
+  proc::ProcName        proc_name_;
+  char                  input_[kInputSize];
+  char                  output_[kOutputSize];
+};
+
+/**
+ * @brief A pipelined task submission queue of a worker thread.
+ * @ingroup THREAD
+ * @details
+ * Impersonation (ThreadRef::try_impersonate()) runs one procedure at a time on a worker
+ * thread, and the thread can't take the next one until the client releases the session.
+ * For short transactions, this handshake costs more than the transaction itself.
+ *
+ * This queue is a bounded lock-free ring in the shared memory of each worker thread.
+ * Any number of clients in any SOC can submit (proc name, input) pairs without waiting.
+ * The worker runs the submitted tasks back to back in the order of tickets, writes
+ * the results into the same slots, and the clients poll and retrieve them.
+ * A slot is reused only after its client retrieves the result, so clients must retrieve
+ * every ticket they submitted. Otherwise the queue eventually gets full.
+ *
+ * The procedures receive the input/output buffers in the slot, so the input and output of
+ * each task are limited to TaskQueueEntry::kInputSize and kOutputSize.
+ *
+ * When the worker thread terminates, it calls stop(), which completes all tasks not run yet
+ * with kErrorCodeBeingShutdown. Clients never wait forever for a stopped worker.
+ *
+ * This is backed by shared memory. Not instantiation, just reinterpret_cast.
+ * @see ThreadRef::submit_task()
+ */
+struct TaskQueue {
+  enum Constants {
+    kCapacity = 64,
+  };
+  TaskQueue() = delete;
+  ~TaskQueue() = delete;
+
+  void initialize();
+
+  /**
+   * @brief Claims a slot and puts the task into it. Called by clients, thread-safe.
+   * @param[in] proc_name the name of the procedure to run
+   * @param[in] input input data of arbitrary format for the procedure
+   * @param[in] input_len byte size of the input. at most TaskQueueEntry::kInputSize
+   * @param[out] ticket identifies the submitted task
+   * @return kErrorCodeThrTaskQueueFull if no slot is free, kErrorCodeThrTaskInputTooLarge if
+   * input_len is too large, kErrorCodeBeingShutdown if the worker has stopped
+   * @details
+   * This does not wake up the worker. ThreadRef::submit_task() does it.
+   */
+  ErrorCode   submit(
+    const proc::ProcName& proc_name,
+    const void* input,
+    uint32_t input_len,
+    TaskTicket* ticket);
+
+  /** @return whether the worker has completed the task. Called by clients. */
+  bool        is_completed(TaskTicket ticket) const;
+
+  /**
+   * @brief Waits until the worker completes the task. Called by clients.
+   * @param[in] ticket the task to wait for
+   * @param[in] wait_microseconds negative value means forever
+   * @return kErrorCodeTimeout if the task doesn't complete in the given time,
+   * kErrorCodeBeingShutdown if the worker has stopped without completing the task
+   */
+  ErrorCode   wait_for_completion(TaskTicket ticket, int64_t wait_microseconds) const;
+
+  /**
+   * @brief Retrieves the result of a completed task and frees the slot. Called by clients.
+   * @param[in] ticket the task to retrieve
+   * @param[out] output receives the output of the procedure. Truncated if the buffer is smaller.
+   * @param[in] output_buffer_size byte size of output
+   * @param[out] output_len receives the byte size of the output the procedure wrote
+   * @return the error code the procedure returned
+   * @pre is_completed(ticket)
+   */
+  ErrorCode   retrieve(
+    TaskTicket ticket,
+    void* output,
+    uint32_t output_buffer_size,
+    uint32_t* output_len);
+
+  /**
+   * @return the oldest submitted task to run, or nullptr if there is none.
+   * Called only by the worker.
+   */
+  TaskQueueEntry* peek_submitted();
+  /** Makes the task returned by peek_submitted() completed. Called only by the worker. */
+  void        complete_submitted(TaskQueueEntry* entry, ErrorCode result, uint32_t output_len);
+  /**
+   * Rejects further submissions and completes all tasks not run yet with
+   * kErrorCodeBeingShutdown, waking up the clients. Called only by the worker when it terminates.
+   */
+  void        stop();
+  bool        is_stopped() const { return stopped_.load(std::memory_order_acquire); }
+
+  TaskQueueEntry& get_entry(TaskTicket ticket) { return entries_[ticket % kCapacity]; }
+  const TaskQueueEntry& get_entry(TaskTicket ticket) const {
+    return entries_[ticket % kCapacity];
+  }
+
+  /** The ticket for the next submission. Clients compete for it. */
+  std::atomic<uint64_t> submit_position_;
+  char                  submit_position_pad_[64 - sizeof(std::atomic<uint64_t>)];
+  /** The ticket of the next task the worker runs. Only the worker modifies it. */
+  std::atomic<uint64_t> run_position_;
+  char                  run_position_pad_[64 - sizeof(std::atomic<uint64_t>)];
+  /** Signalled whenever the worker completes tasks. Clients wait on it. */
+  soc::SharedPolling    completion_cond_;
+  char                  completion_cond_pad_[64 - sizeof(soc::SharedPolling)];
+  /** Whether the worker has stopped. No more tasks run once this is set. */
+  std::atomic<bool>     stopped_;
+  char                  stopped_pad_[64 - sizeof(std::atomic<bool>)];
+
+  TaskQueueEntry        entries_[kCapacity];
+};
+
+}  // namespace thread
+}  // namespace foedus
+#endif  // FOEDUS_THREAD_TASK_QUEUE_HPP_
@@ -97,6 +97,21 @@ class Thread CXX11_FINAL : public virtual Initializable {
   uint64_t      get_snapshot_cache_misses() const;
   /** [statistics] resets the above two */
   void          reset_snapshot_cache_counts() const;
+  /**
+   * [statistics] Runtime counters of this thread, which are in shared memory.
+   * @see foedus::thread::ThreadMetrics
+   */
+  ThreadMetrics* get_metrics() const;
+  /**
+   * [statistics] Sampled pre-commit aborts of this thread, which are in shared memory.
+   * @see foedus::xct::XctOptions::abort_sampling_interval_
+   */
+  xct::AbortSampleRing* get_abort_samples() const;
+  /**
+   * [statistics] Latency histograms of transaction phases in this thread, in shared memory.
+   * @see foedus::thread::ThreadLatencyHistograms
+   */
+  ThreadLatencyHistograms* get_latency_histograms() const;
 
   /** Shorthand for get_global_volatile_page_resolver.resolve_offset() */
   storage::Page* resolve(storage::VolatilePagePointer ptr) const;
@@ -123,6 +138,7 @@ class Thread CXX11_FINAL : public virtual Initializable {
 
   /**
    * Find the given page in snapshot cache, reading it if not found.
+   * @see set_snapshot_cache_scan_mode()
    */
   ErrorCode     find_or_read_a_snapshot_page(
     storage::SnapshotPagePointer page_id,
@@ -149,6 +165,21 @@ class Thread CXX11_FINAL : public virtual Initializable {
    */
   ErrorCode     read_a_snapshot_page(storage::SnapshotPagePointer page_id, storage::Page* buffer);
 
+  /** @returns whether this thread is reading snapshot pages for a large scan. */
+  bool          is_snapshot_cache_scan_mode() const;
+  /**
+   * @brief Tells whether the following snapshot page reads are for a large scan.
+   * @details
+   * In the scan mode, find_or_read_a_snapshot_page() and its batched version do not increment
+   * the refcounts of the cached pages they find, and the pages they install stay
+   * probationary. Thus, CacheOptions::kEvictionPolicyScanResistant evicts them before the hot
+   * pages of other threads. The pages are still installed to the snapshot cache because
+   * the caller keeps pointers to them (eg the route of MasstreeCursor), which must be
+   * reclaimed via the cache cleaner after grace period.
+   * Usually MasstreeCursor::set_no_cache() calls this rather than the user.
+   */
+  void          set_snapshot_cache_scan_mode(bool value);
+
   /** Read contiguous pages in one shot. Other than that same as read_a_snapshot_page(). */
   ErrorCode     read_snapshot_pages(
     storage::SnapshotPagePointer page_id_begin,
@@ -116,6 +116,13 @@ const ThreadId kMaxThreadId = 0xFFFF;
  */
 typedef uint64_t ThreadTicket;
 
+/**
+ * @typedef TaskTicket
+ * @brief Identifies a task submitted to a TaskQueue. Monotonically increasing in each queue.
+ * @ingroup THREAD
+ */
+typedef uint64_t TaskTicket;
+
 /**
  * Returns a globally unique ID of Thread (core) for the given node and ordinal in the node.
  * @ingroup THREAD
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_THREAD_THREAD_METRICS_HPP_
+#define FOEDUS_THREAD_THREAD_METRICS_HPP_
+
+#include <stdint.h>
+
+#include <cstring>
+#include <iosfwd>
+
+#include "foedus/error_code.hpp"
+#include "foedus/assorted/cacheline.hpp"
+
+namespace foedus {
+namespace thread {
+
+/**
+ * @brief Runtime counters of one worker thread.
+ * @ingroup THREAD
+ * @details
+ * Each thread has one instance of this in its ThreadControlBlock, which is placed in the
+ * shared memory of the engine. Only the owner thread increments the counters, so it does so
+ * without atomic operations or fences. Anyone else, including other SOCs and an external
+ * process that attaches the shared memory, can read them at any time without coordinating with
+ * the owner. Such a reader might see slightly stale values, but never a torn counter because
+ * each counter is an aligned 8-byte word.
+ *
+ * The counters are cumulative since the engine started (or since reset()). Take a difference of
+ * two reads to get a rate. All counters of all threads can be summed up with
+ * ThreadPool::get_metrics_sum().
+ *
+ * This object occupies its own cachelines and is placed at the beginning of ThreadControlBlock
+ * so that readers don't cause false sharing with other frequently-updated fields of the thread.
+ */
+struct ThreadMetrics {
+  /** Number of transactions that successfully pre-committed. Includes read-only ones. */
+  uint64_t  commits_;
+  /** Among commits_, the number of read-only transactions. */
+  uint64_t  read_only_commits_;
+  /** Pre-commits that failed with kErrorCodeXctRaceAbort, ie verification failures. */
+  uint64_t  race_aborts_;
+  /** Pre-commits that failed with kErrorCodeXctLockAbort, ie lock acquisition failures. */
+  uint64_t  lock_aborts_;
+  /**
+   * Among race_aborts_, the number of aborts because we failed to track a record moved by a
+   * concurrent page split.
+   */
+  uint64_t  moved_record_aborts_;
+  /** Pre-commits that failed with other errors. */
+  uint64_t  other_precommit_aborts_;
+  /**
+   * Transactions explicitly aborted with XctManager::abort_xct().
+   * This is usually because a storage operation in the transaction returned an error,
+   * such as kErrorCodeXctRaceAbort in a read.
+   */
+  uint64_t  explicit_aborts_;
+  /** Sum of read-set sizes of the transactions at the time of pre-commit. */
+  uint64_t  read_set_total_;
+  /** Sum of write-set sizes (including lock-free ones) at the time of pre-commit. */
+  uint64_t  write_set_total_;
+  /** Number of times this thread waited for an MCS lock held by another thread. */
+  uint64_t  mcs_waits_;
+  /** Sum of RDTSC cycles this thread spent in the waits counted in mcs_waits_. */
+  uint64_t  mcs_wait_cycles_;
+  /** Count of cache hits in snapshot caches */
+  uint64_t  snapshot_cache_hits_;
+  /** Count of cache misses in snapshot caches */
+  uint64_t  snapshot_cache_misses_;
+  /** Number of volatile pages this thread split, such as border/intermediate pages of masstree. */
+  uint64_t  page_splits_;
+  /** Bytes of log records this thread published at commit. */
+  uint64_t  log_bytes_;
+  /**
+   * Among read_only_commits_, the number of transactions XctManager::run_readonly_xct()
+   * served from the snapshot after repeated verification failures.
+   */
+  uint64_t  readonly_snapshot_fallbacks_;
+  /** Number of times XctManager::run_xct_with_retry() retried an aborted transaction. */
+  uint64_t  retries_;
+  /** Sum of RDTSC cycles this thread waited in the backoff before the retries. */
+  uint64_t  retry_backoff_cycles_;
+
+  /** Sets all counters to zero. */
+  void reset() { std::memset(this, 0, sizeof(*this)); }
+  /** Adds up all counters of the other object to this object. */
+  void add(const ThreadMetrics& other);
+  /** Counts a failed pre-commit with the given error. */
+  void count_precommit_abort(ErrorCode error) {
+    if (error == kErrorCodeXctRaceAbort) {
+      ++race_aborts_;
+    } else if (error == kErrorCodeXctLockAbort) {
+      ++lock_aborts_;
+    } else {
+      ++other_precommit_aborts_;
+    }
+  }
+  /** @returns all aborts, whether in pre-commit or explicit. */
+  uint64_t get_total_aborts() const {
+    return race_aborts_ + lock_aborts_ + other_precommit_aborts_ + explicit_aborts_;
+  }
+
+  friend std::ostream& operator<<(std::ostream& o, const ThreadMetrics& v);
+
+  enum Constants {
+    kCounterCount = 18,
+    kPaddingSize
+      = (assorted::kCachelineSize - (kCounterCount * 8) % assorted::kCachelineSize)
+        % assorted::kCachelineSize,
+  };
+  /** Pads the object to cachelines. Keep this the last member. Not a counter. */
+  char      padding_[kPaddingSize];
+};
+
+}  // namespace thread
+}  // namespace foedus
+#endif  // FOEDUS_THREAD_THREAD_METRICS_HPP_
@@ -34,8 +34,11 @@
 #include "foedus/storage/fwd.hpp"
 #include "foedus/storage/storage_id.hpp"
 #include "foedus/thread/fwd.hpp"
+#include "foedus/thread/latency_histogram.hpp"
 #include "foedus/thread/thread_id.hpp"
+#include "foedus/thread/thread_metrics.hpp"
 #include "foedus/thread/thread_ref.hpp"
+#include "foedus/xct/abort_sample.hpp"
 #include "foedus/xct/fwd.hpp"
 #include "foedus/xct/retrospective_lock_list.hpp"
 #include "foedus/xct/xct.hpp"
@@ -51,6 +54,7 @@ struct ThreadControlBlock {
   ~ThreadControlBlock() = delete;
 
   void initialize(ThreadId my_thread_id) {
+    metrics_.reset();
     status_ = kNotInitialized;
     mcs_block_current_ = 0;
     mcs_rw_async_mapping_current_ = 0;
@@ -65,13 +69,19 @@ struct ThreadControlBlock {
     task_complete_cond_.initialize();
     in_commit_epoch_ = INVALID_EPOCH;
     my_thread_id_ = my_thread_id;
-    stat_snapshot_cache_hits_ = 0;
-    stat_snapshot_cache_misses_ = 0;
+    abort_samples_.initialize();
+    latency_histograms_.reset();
   }
   void uninitialize() {
     task_mutex_.uninitialize();
   }
 
+  /**
+   * Runtime counters of this thread, which anyone can read at any time.
+   * This must be the first member so that it's cacheline-aligned.
+   */
+  ThreadMetrics       metrics_;
+
   /**
    * How many MCS blocks we allocated in this thread's current xct.
    * reset to 0 at each transaction begin.
@@ -142,8 +152,17 @@ struct ThreadControlBlock {
   /** Used only for sanity check. This thread's ID. */
   ThreadId            my_thread_id_;
 
-  uint64_t            stat_snapshot_cache_hits_;
-  uint64_t            stat_snapshot_cache_misses_;
+  /**
+   * Sampled pre-commit aborts of this thread, which anyone can read at any time.
+   * @see foedus::xct::AbortReport
+   */
+  xct::AbortSampleRing  abort_samples_;
+
+  /**
+   * Latencies of transaction phases in this thread, which anyone can read at any time.
+   * @see foedus::thread::ThreadPool::get_latency_histograms_sum()
+   */
+  ThreadLatencyHistograms latency_histograms_;
 };
 
 /**
@@ -176,6 +195,28 @@ class ThreadPimpl final : public DefaultInitializable {
    * it and re-sets current_task_ when it's done. It exists when exit_requested_ is set.
    */
   void        handle_tasks();
+  /**
+   * Runs the tasks submitted to task_queue_ back to back until the queue gets empty
+   * or someone impersonates this thread.
+   * @return whether it ran any task
+   */
+  bool        handle_task_queue();
+  /**
+   * Invokes the procedure. Used both for impersonation and the task queue.
+   * @param[in] proc_name the procedure to run
+   * @param[in] input input of the procedure
+   * @param[in] input_len byte size of input
+   * @param[out] output the procedure writes its output here
+   * @param[in] output_buffer_size byte size of output
+   * @param[out] output_used receives the byte size the procedure wrote to output
+   */
+  ErrorStack  run_proc(
+    const proc::ProcName& proc_name,
+    const void* input,
+    uint32_t input_len,
+    void* output,
+    uint32_t output_buffer_size,
+    uint32_t* output_used);
   /** initializes the thread's policy/priority */
   void        set_thread_schedule();
   bool        is_stop_requested() const;
@@ -349,6 +390,8 @@ class ThreadPimpl final : public DefaultInitializable {
   cache::CacheHashtable*  snapshot_cache_hashtable_;
   /** shorthand for node_memory_->get_snapshot_pool() */
   memory::PagePool*       snapshot_page_pool_;
+  /** @see foedus::thread::Thread::set_snapshot_cache_scan_mode() */
+  bool                    snapshot_cache_scan_mode_;
 
   /** Page resolver to convert all page ID to page pointer. */
   memory::GlobalVolatilePageResolver global_volatile_page_resolver_;
@@ -382,6 +425,7 @@ class ThreadPimpl final : public DefaultInitializable {
   ThreadControlBlock*     control_block_;
   void*                   task_input_memory_;
   void*                   task_output_memory_;
+  TaskQueue*              task_queue_;
 
   /** Pre-allocated MCS blocks. index 0 is not used so that successor_block=0 means null. */
   xct::McsWwBlock*          mcs_ww_blocks_;
@@ -503,6 +547,11 @@ class ThreadPimplMcsAdaptor {
     }
     ASSERT_ND(false);
   }
+  void add_mcs_wait_cycles(uint64_t cycles) {
+    ThreadMetrics& metrics = pimpl_->control_block_->metrics_;
+    ++metrics.mcs_waits_;
+    metrics.mcs_wait_cycles_ += cycles;
+  }
 
  private:
   ThreadPimpl* const pimpl_;
@@ -239,6 +239,25 @@ class ThreadPool CXX11_FINAL : public virtual Initializable {
   ThreadGroupRef*     get_group_ref(ThreadGroupId numa_node);
   ThreadRef*          get_thread_ref(ThreadId id);
 
+  /**
+   * @brief Sums up the runtime counters of all threads in the engine.
+   * @param[out] out receives the sum. Its previous values are overwritten.
+   * @details
+   * This reads the counters in shared memory without any synchronization, so it can be
+   * called at any time, even while the threads are running transactions.
+   * @see foedus::thread::ThreadMetrics
+   */
+  void                get_metrics_sum(ThreadMetrics* out);
+
+  /**
+   * @brief Merges the latency histograms of all threads in the engine.
+   * @param[out] out receives the merged histograms. Its previous values are overwritten.
+   * @details
+   * Same as get_metrics_sum(), this can be called at any time.
+   * @see foedus::thread::ThreadLatencyHistograms
+   */
+  void                get_latency_histograms_sum(ThreadLatencyHistograms* out);
+
   friend  std::ostream& operator<<(std::ostream& o, const ThreadPool& v);
 
  private:
@@ -56,11 +56,33 @@ class ThreadRef CXX11_FINAL {
     uint64_t task_input_size,
     ImpersonateSession *session);
 
+  /**
+   * @brief Submits a task to the task queue of this thread without impersonating it.
+   * @param[in] proc_name the name of the procedure to run on this thread.
+   * @param[in] task_input input data of arbitrary format for the procedure.
+   * @param[in] task_input_size byte size of the input. At most TaskQueueEntry::kInputSize.
+   * @param[out] ticket receives the ticket to wait for and retrieve the result with
+   * get_task_queue()->wait_for_completion() and retrieve().
+   * @param[in] wakeup whether to wake up the thread if it's sleeping. When you submit many
+   * tasks at once, you can skip it for all but the last one.
+   * @details
+   * Unlike try_impersonate(), any number of clients can submit tasks while the thread is
+   * running other tasks, and the thread runs them back to back.
+   * @see foedus::thread::TaskQueue
+   */
+  ErrorCode     submit_task(
+    const proc::ProcName& proc_name,
+    const void* task_input,
+    uint32_t task_input_size,
+    TaskTicket* ticket,
+    bool wakeup = true);
+
   Engine*       get_engine() const { return engine_; }
   ThreadId      get_thread_id() const { return id_; }
   ThreadGroupId get_numa_node() const { return decompose_numa_node(id_); }
   void*         get_task_input_memory() const { return task_input_memory_; }
   void*         get_task_output_memory() const { return task_output_memory_; }
+  TaskQueue*    get_task_queue() const { return task_queue_; }
   xct::McsWwBlock*          get_mcs_ww_blocks() const { return mcs_ww_blocks_; }
   xct::McsRwSimpleBlock*    get_mcs_rw_simple_blocks() const { return mcs_rw_simple_blocks_; }
   xct::McsRwExtendedBlock*  get_mcs_rw_extended_blocks() const { return mcs_rw_extended_blocks_; }
@@ -76,6 +98,21 @@ class ThreadRef CXX11_FINAL {
   uint64_t      get_snapshot_cache_hits() const;
   uint64_t      get_snapshot_cache_misses() const;
   void          reset_snapshot_cache_counts() const;
+  /**
+   * Runtime counters of the thread. The thread keeps updating it while you read it.
+   * @see foedus::thread::ThreadMetrics
+   */
+  const ThreadMetrics& get_metrics() const;
+  /**
+   * Sampled pre-commit aborts of the thread. The thread keeps updating it while you read it.
+   * @see foedus::xct::AbortReport
+   */
+  const xct::AbortSampleRing& get_abort_samples() const;
+  /**
+   * Latency histograms of the thread. The thread keeps updating it while you read it.
+   * @see foedus::thread::ThreadLatencyHistograms
+   */
+  const ThreadLatencyHistograms& get_latency_histograms() const;
 
   friend std::ostream& operator<<(std::ostream& o, const ThreadRef& v);
 
@@ -88,6 +125,7 @@ class ThreadRef CXX11_FINAL {
   ThreadControlBlock*   control_block_;
   void*                 task_input_memory_;
   void*                 task_output_memory_;
+  TaskQueue*            task_queue_;
 
   /** Pre-allocated MCS blocks. index 0 is not used so that successor_block=0 means null. */
   xct::McsWwBlock*          mcs_ww_blocks_;
@@ -124,6 +162,11 @@ class ThreadGroupRef CXX11_FINAL {
    */
   Epoch                   get_min_in_commit_epoch() const;
 
+  /** Adds up the runtime counters of all threads in this group to the given object. */
+  void                    add_metrics(ThreadMetrics* out) const;
+  /** Merges the latency histograms of all threads in this group to the given object. */
+  void                    add_latency_histograms(ThreadLatencyHistograms* out) const;
+
   friend std::ostream& operator<<(std::ostream& o, const ThreadGroupRef& v);
 
  private:
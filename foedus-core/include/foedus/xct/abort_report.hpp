@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_XCT_ABORT_REPORT_HPP_
+#define FOEDUS_XCT_ABORT_REPORT_HPP_
+
+#include <stdint.h>
+
+#include <iosfwd>
+#include <vector>
+
+#include "foedus/cxx11.hpp"
+#include "foedus/fwd.hpp"
+#include "foedus/storage/storage_id.hpp"
+#include "foedus/xct/abort_sample.hpp"
+
+namespace foedus {
+namespace xct {
+
+/**
+ * @brief A record or a page that caused sampled aborts.
+ * @ingroup XCT
+ */
+struct AbortHotspot {
+  storage::StorageId  storage_id_;
+  /** Number of sampled aborts on this record/page. */
+  uint32_t            count_;
+  uint64_t            page_id_;
+  /** Address of the record. 0 if this represents a page. */
+  uintptr_t           record_address_;
+  /** Breakdown of count_. Index is AbortCause. */
+  uint32_t            cause_counts_[kAbortCauseCount];
+};
+
+/**
+ * @brief Aggregates the abort samples of all threads into the top contended records and pages.
+ * @ingroup XCT
+ * @details
+ * The samples are recorded only when XctOptions::abort_sampling_interval_ is non-zero.
+ * collect() reads AbortSampleRing of each thread in the shared memory without synchronization,
+ * so you can call it at any time, for example periodically from a monitoring thread.
+ * Each thread keeps only its latest AbortSampleRing::kCapacity samples, so the report reflects
+ * recent aborts.
+ *
+ * The page ranking counts all samples in the page, including the record-level ones, so a page
+ * with many moderately contended records shows up even if none of its records is in the top.
+ * @par Example
+ * @code{.cpp}
+ * AbortReport report(engine);
+ * report.collect(10);
+ * LOG(INFO) << report;
+ * @endcode
+ */
+class AbortReport CXX11_FINAL {
+ public:
+  explicit AbortReport(Engine* engine);
+
+  /**
+   * @brief Reads samples of all threads and ranks the records and pages.
+   * @param[in] top_k at most this number of records and pages are kept in the results.
+   */
+  void        collect(uint32_t top_k);
+
+  /** Number of samples we read in the last collect(). */
+  uint64_t    get_sample_count() const { return sample_count_; }
+  /** Breakdown of get_sample_count(). Index is AbortCause. */
+  uint64_t    get_cause_count(AbortCause cause) const { return cause_counts_[cause]; }
+  /** Top contended records, ordered by AbortHotspot::count_ descending. */
+  const std::vector<AbortHotspot>& get_hot_records() const { return hot_records_; }
+  /** Top contended pages, ordered by AbortHotspot::count_ descending. */
+  const std::vector<AbortHotspot>& get_hot_pages() const { return hot_pages_; }
+
+  /** Prints the report with storage names. */
+  friend std::ostream& operator<<(std::ostream& o, const AbortReport& v);
+
+ private:
+  Engine* const             engine_;
+  uint64_t                  sample_count_;
+  uint64_t                  cause_counts_[kAbortCauseCount];
+  std::vector<AbortHotspot> hot_records_;
+  std::vector<AbortHotspot> hot_pages_;
+};
+
+}  // namespace xct
+}  // namespace foedus
+#endif  // FOEDUS_XCT_ABORT_REPORT_HPP_
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_XCT_ABORT_SAMPLE_HPP_
+#define FOEDUS_XCT_ABORT_SAMPLE_HPP_
+
+#include <stdint.h>
+
+#include "foedus/compiler.hpp"
+#include "foedus/epoch.hpp"
+#include "foedus/storage/storage_id.hpp"
+
+namespace foedus {
+namespace xct {
+
+/**
+ * @brief What kind of check failed in pre-commit.
+ * @ingroup XCT
+ */
+enum AbortCause {
+  /** A record in the read-set was modified by another transaction. */
+  kAbortCauseReadVerify = 0,
+  /** We couldn't take a lock on a record in the write-set. */
+  kAbortCauseLock,
+  /** A record moved by a concurrent page split could not be tracked. */
+  kAbortCauseMovedRecord,
+  /** A page pointer in the pointer-set was changed. The sample has no record address. */
+  kAbortCausePointer,
+  /** A page version in the page-version-set was changed. The sample has no record address. */
+  kAbortCausePageVersion,
+  kAbortCauseCount,
+};
+
+/** Returns a short name of the cause, such as "ReadVerify". */
+const char* get_abort_cause_name(AbortCause cause);
+
+/**
+ * @brief One sampled abort in pre-commit.
+ * @ingroup XCT
+ * @details
+ * The page and storage are those of the page that contains the record (or the page pointer or
+ * the page version for page-level causes), so the page ID is a volatile page pointer in most
+ * cases. Raw addresses are fine as identifiers because all volatile pages are in the shared
+ * memory, which is mapped to the same address in all SOCs.
+ */
+struct AbortSample {
+  /** Address of the RwLockableXctId of the record. 0 for page-level causes. */
+  uintptr_t           record_address_;
+  /** Page ID in the page header. */
+  uint64_t            page_id_;
+  storage::StorageId  storage_id_;
+  /** Current global epoch when the abort happened. */
+  Epoch::EpochInteger epoch_;
+  /** AbortCause */
+  uint16_t            cause_;
+  uint16_t            reserved1_;
+  uint32_t            reserved2_;
+};
+
+/**
+ * @brief Per-thread ring buffer of AbortSample.
+ * @ingroup XCT
+ * @details
+ * Each thread has one in its ThreadControlBlock, so anyone (eg AbortReport) can read it while
+ * the owner thread keeps writing it. Only the owner thread writes to it, without any
+ * synchronization. The reader thus might see a sample being overwritten, which is fine for
+ * statistics. The ring keeps the latest kCapacity samples.
+ * @see foedus::xct::XctOptions::abort_sampling_interval_
+ */
+struct AbortSampleRing {
+  enum Constants {
+    kCapacity = 256,
+  };
+
+  void        initialize() {
+    total_samples_ = 0;
+    aborts_until_next_sample_ = 0;
+  }
+
+  /** Number of samples in the ring. */
+  uint32_t    get_count() const {
+    const uint64_t capacity = kCapacity;
+    return static_cast<uint32_t>(total_samples_ < capacity ? total_samples_ : capacity);
+  }
+
+  /**
+   * Called for each abort. Returns whether this abort should be sampled.
+   * @param[in] interval XctOptions::abort_sampling_interval_, non-zero.
+   */
+  bool        should_sample(uint32_t interval) ALWAYS_INLINE {
+    if (aborts_until_next_sample_ > 0) {
+      --aborts_until_next_sample_;
+      return false;
+    }
+    aborts_until_next_sample_ = interval - 1U;
+    return true;
+  }
+
+  /** Reserves the next sample slot to write, overwriting the oldest one if full. */
+  AbortSample* next_sample() {
+    AbortSample* ret = samples_ + (total_samples_ % kCapacity);
+    ++total_samples_;
+    return ret;
+  }
+
+  /** Number of samples ever recorded, including the ones already overwritten. */
+  uint64_t    total_samples_;
+  /** Countdown for sampling. */
+  uint32_t    aborts_until_next_sample_;
+  uint32_t    reserved_;
+  AbortSample samples_[kCapacity];
+};
+
+}  // namespace xct
+}  // namespace foedus
+#endif  // FOEDUS_XCT_ABORT_SAMPLE_HPP_
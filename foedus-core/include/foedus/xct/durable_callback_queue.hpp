@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_XCT_DURABLE_CALLBACK_QUEUE_HPP_
+#define FOEDUS_XCT_DURABLE_CALLBACK_QUEUE_HPP_
+
+#include <stdint.h>
+
+#include "foedus/assert_nd.hpp"
+#include "foedus/compiler.hpp"
+#include "foedus/cxx11.hpp"
+#include "foedus/epoch.hpp"
+
+namespace foedus {
+namespace xct {
+
+/**
+ * @brief A function invoked when a transaction committed by XctManager::precommit_xct_async()
+ * becomes durable.
+ * @ingroup XCT
+ * @param[in] commit_epoch the commit epoch of the transaction, which is now durable.
+ * @param[in] user_data the pointer given to XctManager::precommit_xct_async().
+ * @details
+ * The function is invoked on the worker thread that committed the transaction, outside of
+ * any transaction. It should be short. For example, send an acknowledgement to the client.
+ */
+typedef void (*DurableCallback)(Epoch commit_epoch, void* user_data);
+
+/**
+ * @brief Per-thread FIFO of transactions that are pre-committed but not yet durable, with
+ * the callbacks to invoke when they become durable.
+ * @ingroup XCT
+ * @details
+ * Each worker thread has its own queue in its Xct object, so no synchronization is needed.
+ * The queue is drained in bulk by XctManager when it observes that the durable global epoch
+ * advanced, so the worker does not have to park itself in wait_for_commit() after each
+ * transaction.
+ *
+ * Commit epochs in the queue are usually non-decreasing, but a read-only transaction
+ * might have an older commit epoch than the previous transaction. We anyway invoke callbacks in
+ * FIFO order, which might delay such a callback a bit, but never invokes a callback too early.
+ */
+class DurableCallbackQueue CXX11_FINAL {
+ public:
+  enum Constants {
+    /** Pending transactions per thread. When full, precommit_xct_async() waits. */
+    kCapacity = 1 << 10,
+  };
+  struct Entry {
+    Epoch           commit_epoch_;
+    DurableCallback callback_;
+    void*           user_data_;
+  };
+
+  DurableCallbackQueue() : head_(0), count_(0) {}
+
+  // No copy
+  DurableCallbackQueue(const DurableCallbackQueue& other) CXX11_FUNC_DELETE;
+  DurableCallbackQueue& operator=(const DurableCallbackQueue& other) CXX11_FUNC_DELETE;
+
+  bool      is_empty() const ALWAYS_INLINE { return count_ == 0; }
+  bool      is_full() const ALWAYS_INLINE { return count_ >= kCapacity; }
+  uint32_t  get_count() const ALWAYS_INLINE { return count_; }
+
+  /** @pre !is_empty() */
+  const Entry& front() const ALWAYS_INLINE {
+    ASSERT_ND(!is_empty());
+    return entries_[head_];
+  }
+  /** @pre !is_full() */
+  void      push_back(Epoch commit_epoch, DurableCallback callback, void* user_data) {
+    ASSERT_ND(!is_full());
+    Entry& entry = entries_[(head_ + count_) % kCapacity];
+    entry.commit_epoch_ = commit_epoch;
+    entry.callback_ = callback;
+    entry.user_data_ = user_data;
+    ++count_;
+  }
+  /** @pre !is_empty() */
+  void      pop_front() ALWAYS_INLINE {
+    ASSERT_ND(!is_empty());
+    head_ = (head_ + 1U) % kCapacity;
+    --count_;
+  }
+
+ private:
+  /** Index of the oldest entry */
+  uint32_t  head_;
+  /** Number of entries */
+  uint32_t  count_;
+  Entry     entries_[kCapacity];
+};
+
+}  // namespace xct
+}  // namespace foedus
+#endif  // FOEDUS_XCT_DURABLE_CALLBACK_QUEUE_HPP_
@@ -24,7 +24,13 @@
  */
 namespace foedus {
 namespace xct {
+struct  AbortHotspot;
+class   AbortReport;
+struct  AbortSample;
+struct  AbortSampleRing;
 class   CurrentLockList;
+class   DurableCallbackQueue;
+struct  EpochChimeStat;
 struct  InCommitEpochGuard;
 struct  LockableXctId;
 struct  LockEntry;
@@ -40,10 +46,13 @@ struct  McsWwBlock;
 struct  PointerAccess;
 struct  ReadXctAccess;
 class   RetrospectiveLockList;
+class   RetryBackoff;
 struct  RwLockableXctId;
 struct  SysxctFunctor;
 struct  SysxctWorkspace;
 struct  WriteXctAccess;
+class   WriteSetIndex;
+struct  WriteSetIndexSlot;
 class   Xct;
 struct  XctId;
 class   XctManager;
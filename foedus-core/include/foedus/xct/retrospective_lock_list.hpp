@@ -299,11 +299,9 @@ class RetrospectiveLockList {
  * This holds all locks in address order to help our commit protocol.
  *
  * We so far maintain this object in addition to read-set/write-set.
- * We can merge these objects in to one, which will allow us to add some functionality
- * and optimizations. For example, "read my own write" semantics would be
- * practically implemented with such an integrated list.
- * We can reduce the number of sorting and tracking, too.
- * But, let's do them later.
+ * "Read my own write" semantics is provided by WriteSetIndex, a per-transaction hash index
+ * on the write-set, rather than by merging these objects into one.
+ * We might still merge them later to reduce the number of sorting and tracking.
  * @note This object itself is thread-private. No concurrency control needed.
  */
 class CurrentLockList {
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_XCT_RETRY_BACKOFF_HPP_
+#define FOEDUS_XCT_RETRY_BACKOFF_HPP_
+
+#include <stdint.h>
+
+#include "foedus/compiler.hpp"
+#include "foedus/cxx11.hpp"
+#include "foedus/error_code.hpp"
+#include "foedus/assorted/uniform_random.hpp"
+#include "foedus/debugging/rdtsc.hpp"
+
+namespace foedus {
+namespace xct {
+
+/**
+ * @brief Why a transaction aborted, as far as retrying it is concerned.
+ * @ingroup XCT
+ * @see classify_abort()
+ */
+enum AbortClass {
+  /** Not an abort. */
+  kAbortClassNone = 0,
+  /** Verification failure (kErrorCodeXctRaceAbort). Retrying usually succeeds. */
+  kAbortClassRace,
+  /** Failed to acquire a lock (kErrorCodeXctLockAbort). Retrying usually succeeds. */
+  kAbortClassLock,
+  /**
+   * The transaction ran out of read/write/pointer/page-version sets.
+   * Retrying the same transaction would fail again.
+   */
+  kAbortClassSetOverflow,
+  /** Other errors, including kErrorCodeXctUserAbort. Not retried. */
+  kAbortClassOther,
+};
+
+/** @return how the given error code returned from a transaction should be handled. */
+inline AbortClass classify_abort(ErrorCode error) {
+  switch (error) {
+  case kErrorCodeOk:
+    return kAbortClassNone;
+  case kErrorCodeXctRaceAbort:
+    return kAbortClassRace;
+  case kErrorCodeXctLockAbort:
+    return kAbortClassLock;
+  case kErrorCodeXctReadSetOverflow:
+  case kErrorCodeXctWriteSetOverflow:
+  case kErrorCodeXctPageVersionSetOverflow:
+  case kErrorCodeXctPointerSetOverflow:
+    return kAbortClassSetOverflow;
+  default:
+    return kAbortClassOther;
+  }
+}
+
+/** @return whether retrying the transaction might resolve the abort. */
+inline bool is_retryable_abort(AbortClass abort_class) {
+  return abort_class == kAbortClassRace || abort_class == kAbortClassLock;
+}
+
+/**
+ * @brief Per-thread adaptive exponential backoff between retries of aborted transactions.
+ * @ingroup XCT
+ * @details
+ * Retrying an aborted transaction immediately under a skewed workload makes it collide
+ * again with the same writers, causing abort storms. This object remembers how contended
+ * this thread has been recently as a \e level. Each abort raises the level by one, and each
+ * commit lowers it by one, so a thread that keeps aborting waits exponentially longer while
+ * a thread that mostly commits barely waits at all.
+ * The wait is a random number of cycles below kMinBackoffCycles << level, capped by
+ * the maximum given to set_max_backoff_cycles(), so that retrying threads don't stay in sync.
+ *
+ * Each thread has its own object in its Xct, so no synchronization is needed.
+ * Unlike the read/write sets, this lives across transactions.
+ * @see XctManager::run_xct_with_retry()
+ */
+class RetryBackoff CXX11_FINAL {
+ public:
+  enum Constants {
+    /** Upper bound of the first backoff, roughly a few cache misses. */
+    kMinBackoffCycles = 1 << 8,
+    /** The level never goes beyond this. kMinBackoffCycles << kMaxLevel is ~1 second. */
+    kMaxLevel = 22,
+  };
+
+  RetryBackoff() : level_(0), max_backoff_cycles_(0), rnd_(0) {}
+
+  void      init(uint64_t seed, uint64_t max_backoff_cycles) {
+    level_ = 0;
+    max_backoff_cycles_ = max_backoff_cycles;
+    rnd_.set_current_seed(seed);
+  }
+  void      set_max_backoff_cycles(uint64_t cycles) { max_backoff_cycles_ = cycles; }
+  uint32_t  get_level() const { return level_; }
+
+  /** Called when a transaction committed. */
+  void      on_commit() ALWAYS_INLINE {
+    if (level_ > 0) {
+      --level_;
+    }
+  }
+  /** Called when a transaction aborted with a retryable error. */
+  void      on_abort() {
+    if (level_ < static_cast<uint32_t>(kMaxLevel)) {
+      ++level_;
+    }
+  }
+
+  /** @return the number of cycles the next backoff should wait. */
+  uint64_t  next_backoff_cycles() {
+    uint64_t ceiling = static_cast<uint64_t>(kMinBackoffCycles) << level_;
+    if (ceiling > max_backoff_cycles_) {
+      ceiling = max_backoff_cycles_;
+    }
+    if (ceiling == 0) {
+      return 0;
+    }
+    return rnd_.next_uint64() % ceiling;
+  }
+
+  /**
+   * Waits for next_backoff_cycles() without yielding the core.
+   * @return the number of cycles waited
+   */
+  uint64_t  backoff() {
+    uint64_t cycles = next_backoff_cycles();
+    if (cycles > 0) {
+      debugging::wait_rdtsc_cycles(cycles);
+    }
+    return cycles;
+  }
+
+ private:
+  uint32_t                level_;
+  uint64_t                max_backoff_cycles_;
+  assorted::UniformRandom rnd_;
+};
+
+}  // namespace xct
+}  // namespace foedus
+#endif  // FOEDUS_XCT_RETRY_BACKOFF_HPP_
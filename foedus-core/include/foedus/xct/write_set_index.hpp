@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#ifndef FOEDUS_XCT_WRITE_SET_INDEX_HPP_
+#define FOEDUS_XCT_WRITE_SET_INDEX_HPP_
+
+#include <stdint.h>
+
+#include <cstring>
+
+#include "foedus/assert_nd.hpp"
+#include "foedus/compiler.hpp"
+#include "foedus/cxx11.hpp"
+#include "foedus/xct/fwd.hpp"
+
+namespace foedus {
+namespace xct {
+
+/** Represents "no write-set entry" in WriteSetIndexSlot and WriteXctAccess. */
+const uint32_t kNoWriteOrdinal = 0xFFFFFFFFU;
+
+/**
+ * @brief One slot of WriteSetIndex.
+ * @ingroup XCT
+ * @details
+ * The slot is in use only when generation_ is same as the current generation of the index,
+ * so that we don't have to clear the slots at each transaction.
+ * @par POD
+ * This is a POD struct. Default destructor/copy-constructor/assignment operator work fine.
+ */
+struct WriteSetIndexSlot {
+  /** The record this slot is for. */
+  const RwLockableXctId*  owner_id_address_;
+  /** WriteSetIndex::generation_ as of the creation of this slot. */
+  uint32_t                generation_;
+  /** Ordinal of the first write-set entry on the record. */
+  uint32_t                first_ordinal_;
+  /** Ordinal of the last write-set entry on the record. */
+  uint32_t                last_ordinal_;
+  uint32_t                reserved_;
+};
+
+/**
+ * @brief A per-transaction hash index from records to their write-set entries.
+ * @ingroup XCT
+ * @details
+ * Write-set is an array ordered by the insertion until precommit, so finding whether
+ * the transaction has already written to a record needs a scan without this index.
+ * Xct maintains this index in add_to_write_set() and uses it to implement
+ * read-your-own-writes and to coalesce repeated overwrites to the same record.
+ *
+ * This is an open-addressing hash table with linear probing, keyed by the address of the
+ * record's owner ID. The capacity is at least twice the maximum size of write-set, so it never
+ * gets full. Clearing the index is just incrementing the generation.
+ *
+ * The ordinals in this index are valid only while the transaction body runs. Precommit
+ * sorts the write-set, after which the index must not be used until the next transaction.
+ * @note This object itself is thread-private. No concurrency control needed.
+ */
+class WriteSetIndex {
+ public:
+  WriteSetIndex() : slots_(CXX11_NULLPTR), capacity_(0), mask_(0), generation_(0) {}
+
+  /** Number of slots we need for the given max_write_set_size_. */
+  static uint32_t calculate_capacity(uint32_t max_write_set_size) {
+    uint32_t capacity = 16;
+    while (capacity < max_write_set_size * 2ULL) {
+      capacity <<= 1;
+    }
+    return capacity;
+  }
+
+  void init(WriteSetIndexSlot* slots, uint32_t capacity) {
+    ASSERT_ND((capacity & (capacity - 1U)) == 0);
+    slots_ = slots;
+    capacity_ = capacity;
+    mask_ = capacity - 1U;
+    generation_ = 1;
+    std::memset(slots_, 0, sizeof(WriteSetIndexSlot) * capacity_);
+  }
+  void uninit() {
+    slots_ = CXX11_NULLPTR;
+    capacity_ = 0;
+    mask_ = 0;
+  }
+
+  /** Logically removes all slots. */
+  void clear() {
+    ++generation_;
+    if (UNLIKELY(generation_ == 0)) {
+      // wrapped around. this happens once in 4 billion transactions.
+      std::memset(slots_, 0, sizeof(WriteSetIndexSlot) * capacity_);
+      generation_ = 1;
+    }
+  }
+
+  /** @return the slot of the record, or nullptr if this transaction has not written to it. */
+  const WriteSetIndexSlot* find(const RwLockableXctId* owner_id_address) const ALWAYS_INLINE {
+    for (uint32_t i = hash(owner_id_address);; i = (i + 1U) & mask_) {
+      const WriteSetIndexSlot* slot = slots_ + i;
+      if (slot->generation_ != generation_) {
+        return CXX11_NULLPTR;
+      } else if (slot->owner_id_address_ == owner_id_address) {
+        return slot;
+      }
+    }
+  }
+
+  /**
+   * @return the slot of the record. If it didn't exist, a new slot whose ordinals are
+   * kNoWriteOrdinal.
+   */
+  WriteSetIndexSlot* find_or_create(const RwLockableXctId* owner_id_address) ALWAYS_INLINE {
+    for (uint32_t i = hash(owner_id_address);; i = (i + 1U) & mask_) {
+      WriteSetIndexSlot* slot = slots_ + i;
+      if (slot->generation_ != generation_) {
+        slot->owner_id_address_ = owner_id_address;
+        slot->generation_ = generation_;
+        slot->first_ordinal_ = kNoWriteOrdinal;
+        slot->last_ordinal_ = kNoWriteOrdinal;
+        return slot;
+      } else if (slot->owner_id_address_ == owner_id_address) {
+        return slot;
+      }
+    }
+  }
+
+ private:
+  uint32_t hash(const RwLockableXctId* owner_id_address) const ALWAYS_INLINE {
+    // Fibonacci hashing. Take the high bits as the low bits of addresses are mostly same.
+    uint64_t key = reinterpret_cast<uintptr_t>(owner_id_address) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<uint32_t>(key >> 32) & mask_;
+  }
+
+  WriteSetIndexSlot*  slots_;
+  uint32_t            capacity_;
+  uint32_t            mask_;
+  uint32_t            generation_;
+};
+
+}  // namespace xct
+}  // namespace foedus
+#endif  // FOEDUS_XCT_WRITE_SET_INDEX_HPP_
@@ -26,6 +26,7 @@
 #include "foedus/epoch.hpp"
 #include "foedus/error_code.hpp"
 #include "foedus/fwd.hpp"
+#include "foedus/debugging/rdtsc_watch.hpp"
 #include "foedus/log/common_log_types.hpp"
 
 // For log verification. Only in debug mode
@@ -39,8 +40,11 @@
 #include "foedus/storage/record.hpp"
 #include "foedus/thread/fwd.hpp"
 #include "foedus/thread/thread_id.hpp"
+#include "foedus/xct/durable_callback_queue.hpp"
 #include "foedus/xct/fwd.hpp"
 #include "foedus/xct/retrospective_lock_list.hpp"
+#include "foedus/xct/retry_backoff.hpp"
+#include "foedus/xct/write_set_index.hpp"
 #include "foedus/xct/xct_access.hpp"
 #include "foedus/xct/xct_id.hpp"
 
@@ -83,10 +87,13 @@ class Xct {
     hot_threshold_for_this_xct_ = default_hot_threshold_for_this_xct_;
     rll_threshold_for_this_xct_ = default_rll_threshold_for_this_xct_;
     isolation_level_ = isolation_level;
+    read_volatile_in_snapshot_ = false;
+    body_watch_.start();
     pointer_set_size_ = 0;
     page_version_set_size_ = 0;
     read_set_size_ = 0;
     write_set_size_ = 0;
+    write_set_index_.clear();
     lock_free_read_set_size_ = 0;
     lock_free_write_set_size_ = 0;
     *mcs_block_current_ = 0;
@@ -147,6 +154,16 @@ class Xct {
   }
   /** Returns the level of isolation for this transaction. */
   IsolationLevel      get_isolation_level() const { return isolation_level_; }
+  /**
+   * Returns if this kSnapshot transaction has read a volatile page or record,
+   * for example of a storage created after the latest snapshot.
+   * Such reads are neither in the snapshot nor verified.
+   */
+  bool                is_read_volatile_in_snapshot() const { return read_volatile_in_snapshot_; }
+  /** Called when a kSnapshot transaction reads a volatile page or record. */
+  void                on_read_volatile_in_snapshot() { read_volatile_in_snapshot_ = true; }
+  /** Returns RDTSC cycles elapsed since this transaction began. */
+  uint64_t            get_elapsed_cycles() { return body_watch_.stop(); }
   /** Returns the ID of this transaction, but note that it is not issued until commit time! */
   const XctId&        get_id() const { return id_; }
   thread::Thread*     get_thread_context() { return context_; }
@@ -164,6 +181,41 @@ class Xct {
   LockFreeReadXctAccess* get_lock_free_read_set() { return lock_free_read_set_; }
   LockFreeWriteXctAccess* get_lock_free_write_set() { return lock_free_write_set_; }
 
+  /**
+   * @brief Returns the first write-set entry of this transaction on the record.
+   * @return nullptr if this transaction has not written to the record.
+   * @details
+   * Use get_next_write_on_record() to follow the subsequent writes on the same record
+   * in the order they were issued. This is how storages implement read-your-own-writes.
+   * Valid only in the transaction body, ie before precommit sorts the write-set.
+   */
+  WriteXctAccess*     get_first_write_on_record(const RwLockableXctId* owner_id_address) {
+    if (write_set_size_ == 0) {
+      return CXX11_NULLPTR;
+    }
+    const WriteSetIndexSlot* slot = write_set_index_.find(owner_id_address);
+    return slot ? write_set_ + slot->first_ordinal_ : CXX11_NULLPTR;
+  }
+  /**
+   * Same as get_first_write_on_record() except this returns the last (latest) one.
+   * Storages can coalesce a new write into the returned write-set entry if it is equivalent.
+   */
+  WriteXctAccess*     get_last_write_on_record(const RwLockableXctId* owner_id_address) {
+    if (write_set_size_ == 0) {
+      return CXX11_NULLPTR;
+    }
+    const WriteSetIndexSlot* slot = write_set_index_.find(owner_id_address);
+    return slot ? write_set_ + slot->last_ordinal_ : CXX11_NULLPTR;
+  }
+  /** @return the next write-set entry on the same record, nullptr if write is the last one. */
+  WriteXctAccess*     get_next_write_on_record(const WriteXctAccess* write) {
+    ASSERT_ND(write >= write_set_ && write < write_set_ + write_set_size_);
+    if (write->next_write_on_record_ == kNoWriteOrdinal) {
+      return CXX11_NULLPTR;
+    }
+    return write_set_ + write->next_write_on_record_;
+  }
+
 
   /**
    * @brief Called while a successful commit of xct to issue a new xct id.
@@ -415,6 +467,8 @@ class Xct {
   xct::RetrospectiveLockList* get_retrospective_lock_list() {
     return &retrospective_lock_list_;
   }
+  xct::DurableCallbackQueue*  get_durable_callback_queue() { return &durable_callback_queue_; }
+  xct::RetryBackoff*          get_retry_backoff() { return &retry_backoff_; }
 
   /**
    * This debug method checks whether the related_read_ and related_write_ fileds in
@@ -444,6 +498,12 @@ class Xct {
   /** Level of isolation for this transaction. */
   IsolationLevel      isolation_level_;
 
+  /** @see is_read_volatile_in_snapshot() */
+  bool                read_volatile_in_snapshot_;
+
+  /** Started when this transaction began. For thread::kLatencyPhaseUserBody. */
+  debugging::RdtscWatch body_watch_;
+
   /** Whether the object is an active transaction. */
   bool                active_;
 
@@ -502,6 +562,8 @@ class Xct {
   WriteXctAccess*     write_set_;
   uint32_t            write_set_size_;
   uint32_t            max_write_set_size_;
+  /** Index from records to write_set_. Cleared at each transaction begin. */
+  WriteSetIndex       write_set_index_;
 
   LockFreeReadXctAccess*  lock_free_read_set_;
   uint32_t                lock_free_read_set_size_;
@@ -529,6 +591,19 @@ class Xct {
    */
   xct::RetrospectiveLockList  retrospective_lock_list_;
 
+  /**
+   * Transactions of this thread committed by precommit_xct_async() and not yet durable.
+   * Unlike other members, this lives across transactions.
+   * @see foedus::xct::DurableCallbackQueue
+   */
+  xct::DurableCallbackQueue   durable_callback_queue_;
+
+  /**
+   * Backoff state for XctManager::run_xct_with_retry(). Also lives across transactions.
+   * @see foedus::xct::RetryBackoff
+   */
+  xct::RetryBackoff           retry_backoff_;
+
   void*               local_work_memory_;
   uint64_t            local_work_memory_size_;
   /** This value is reset to zero for each transaction, and always <= local_work_memory_size_ */
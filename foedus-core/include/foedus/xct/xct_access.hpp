@@ -177,6 +177,13 @@ struct WriteXctAccess : public RecordXctAccess {
   /** @see ReadXctAccess::related_write_ */
   ReadXctAccess*        related_read_;
 
+  /**
+   * Ordinal of the next write-set entry of this transaction on the same record,
+   * kNoWriteOrdinal if this is the last one. Maintained with WriteSetIndex, and valid only
+   * before precommit sorts the write-set.
+   */
+  uint32_t              next_write_on_record_;
+
   /** @copydoc foedux::xct::RecordXctAccess::compare() */
   static bool compare(const WriteXctAccess &left, const WriteXctAccess& right) ALWAYS_INLINE {
     return RecordXctAccess::compare(left, right);
@@ -17,13 +17,67 @@
  */
 #ifndef FOEDUS_XCT_XCT_MANAGER_HPP_
 #define FOEDUS_XCT_XCT_MANAGER_HPP_
+
+#include <stdint.h>
+
 #include "foedus/fwd.hpp"
 #include "foedus/initializable.hpp"
 #include "foedus/thread/fwd.hpp"
+#include "foedus/xct/durable_callback_queue.hpp"
 #include "foedus/xct/fwd.hpp"
 #include "foedus/xct/xct_id.hpp"
 namespace foedus {
 namespace xct {
+/**
+ * @brief Statistics of the epoch chime, the thread that advances the global epoch.
+ * @ingroup XCT
+ * @see XctManager::get_epoch_chime_stat()
+ */
+struct EpochChimeStat {
+  /** Interval between epoch advancements the epoch chime currently uses, in microseconds. */
+  uint64_t  current_interval_us_;
+  /** Number of epochs the epoch chime has advanced since the engine started. */
+  uint64_t  epochs_advanced_;
+  /** Wall-clock duration of the last epoch, in microseconds. */
+  uint64_t  last_epoch_duration_us_;
+  /** Longest duration of an epoch so far, in microseconds. */
+  uint64_t  max_epoch_duration_us_;
+  /** Sum of durations of all epochs so far, in microseconds. */
+  uint64_t  total_epoch_duration_us_;
+  /** Number of threads now waiting for commits to become durable in wait_for_commit(). */
+  uint32_t  current_commit_waiters_;
+  /**
+   * Number of waits in wait_for_commit() so far, not counting calls for already-durable epochs.
+   * Also incremented for each transaction committed by precommit_xct_async().
+   */
+  uint64_t  total_commit_waits_;
+};
+
+/**
+ * @brief The body of a read-only transaction run by XctManager::run_readonly_xct().
+ * @ingroup XCT
+ * @param[in,out] context Thread context, already in a transaction
+ * @param[in] user_data arbitrary pointer given to XctManager::run_readonly_xct()
+ * @return kErrorCodeOk if the body completes. Any other error aborts the transaction.
+ * @details
+ * The body might be invoked multiple times for one call of run_readonly_xct(), so it must
+ * not have side effects other than reading records through context. It must not begin, abort,
+ * or commit the transaction itself.
+ */
+typedef ErrorCode (*ReadOnlyXctBody)(thread::Thread* context, void* user_data);
+
+/**
+ * @brief The body of a transaction run by XctManager::run_xct_with_retry().
+ * @ingroup XCT
+ * @param[in,out] context Thread context, already in a transaction
+ * @param[in] user_data arbitrary pointer given to XctManager::run_xct_with_retry()
+ * @return kErrorCodeOk if the body completes. Any other error aborts the transaction.
+ * @details
+ * The body is invoked again for each retry, so it must be safe to re-execute. It must not
+ * begin, abort, or commit the transaction itself.
+ */
+typedef ErrorCode (*XctBody)(thread::Thread* context, void* user_data);
+
 /**
  * @brief Xct Manager class that provides API to begin/abort/commit transaction.
  * @ingroup XCT
@@ -62,6 +116,15 @@ class XctManager CXX11_FINAL : public virtual Initializable {
   /** Passively wait until the current global epoch becomes the given value. */
   void        wait_for_current_global_epoch(Epoch target_epoch, int64_t wait_microseconds = -1);
 
+  /**
+   * @brief Returns the statistics of the epoch chime.
+   * @details
+   * The values are updated by the epoch chime without synchronization, so they might be
+   * slightly inconsistent with each other. Only for monitoring.
+   * @see XctOptions::adaptive_epoch_interval_
+   */
+  EpochChimeStat  get_epoch_chime_stat() const;
+
   /**
    * @brief Requests to advance the current global epoch as soon as possible and blocks until
    * it actually does.
@@ -97,11 +160,143 @@ class XctManager CXX11_FINAL : public virtual Initializable {
    */
   ErrorCode   precommit_xct(thread::Thread* context, Epoch *commit_epoch);
 
+  /**
+   * @brief Runs a read-only serializable transaction that does not livelock under write load.
+   * @pre context->is_running_xct() == false
+   * @param[in,out] context Thread context
+   * @param[in] body reads records. invoked once per attempt
+   * @param[in] user_data arbitrary pointer passed to body
+   * @param[out] serialization_epoch the epoch as of which the transaction is serializable.
+   * Invalid if the transaction read nothing.
+   * @return kErrorCodeOk, or the error body returned other than kErrorCodeXctRaceAbort.
+   * kErrorCodeXctReadOnlyBodyWrote if body wrote something.
+   * @details
+   * A long read-only transaction in kSerializable keeps failing verification when concurrent
+   * transactions write to some of the records it read. This method first runs body in
+   * kSerializable as usual. After XctOptions::readonly_serializable_attempts_ race aborts in
+   * a row, it runs body again in kSnapshot, which reads snapshot pages and thus does not
+   * abort due to concurrent writers. A snapshot contains exactly the transactions up to the snapshot epoch, so
+   * a read-only transaction on it is still serializable; it is just serialized at the snapshot
+   * epoch rather than at the current epoch. In other words, we reorder the read-only
+   * transaction before the concurrent writers instead of aborting it.
+   *
+   * If a new snapshot is installed while body reads snapshot pages, body might have read
+   * storages from two snapshots. This method detects it with
+   * SnapshotManager::get_snapshot_install_sequence() and retries on the new snapshot.
+   *
+   * If no snapshot has been taken yet, this method keeps retrying in kSerializable.
+   * Storages created after the last snapshot have no snapshot pages, so kSnapshot reads of them
+   * hit volatile pages, which are neither in the snapshot nor verified.
+   * If body reads any volatile page or record in kSnapshot (Xct::is_read_volatile_in_snapshot()),
+   * this method discards the attempt and keeps retrying in kSerializable.
+   * @see foedus::thread::ThreadMetrics::readonly_snapshot_fallbacks_
+   */
+  ErrorCode   run_readonly_xct(
+    thread::Thread* context,
+    ReadOnlyXctBody body,
+    void* user_data,
+    Epoch* serialization_epoch);
+
+  /**
+   * @brief Runs a transaction, retrying it with backoff while it aborts due to contention.
+   * @pre context->is_running_xct() == false
+   * @param[in,out] context Thread context
+   * @param[in] isolation_level concurrency isolation level of the transaction
+   * @param[in] body the transaction body. invoked once per attempt
+   * @param[in] user_data arbitrary pointer passed to body
+   * @param[out] commit_epoch same as precommit_xct()
+   * @return kErrorCodeOk if the transaction pre-committed. Otherwise the error of the last
+   * attempt, which is either not retryable (see classify_abort()) or the last one allowed by
+   * XctOptions::max_retry_attempts_.
+   * @details
+   * This replaces the retry loop each client would otherwise write around begin_xct(),
+   * the body, and precommit_xct(). Retrying immediately after kErrorCodeXctRaceAbort or
+   * kErrorCodeXctLockAbort makes the transaction collide again with the same writers, so
+   * this method does two things before each retry:
+   * \li Waits for a random backoff that grows exponentially while this thread keeps aborting
+   * and shrinks as it commits. See RetryBackoff.
+   * \li Runs the retry with the retrospective lock list (RLL) of the aborted attempt, which
+   * recommends pessimistic locks on the records the aborted attempt wrote or failed to verify.
+   * Each attempt thus enables RLL regardless of XctOptions::enable_retrospective_lock_list_.
+   *
+   * Errors other than the two above are returned immediately without retrying.
+   * @see foedus::thread::ThreadMetrics::retries_
+   */
+  ErrorCode   run_xct_with_retry(
+    thread::Thread* context,
+    IsolationLevel isolation_level,
+    XctBody body,
+    void* user_data,
+    Epoch* commit_epoch);
+
 
   /**
    * @copydoc foedus::log::LogManager::wait_until_durable()
    */
   ErrorCode   wait_for_commit(Epoch commit_epoch, int64_t wait_microseconds = -1);
+  /**
+   * @brief Same as wait_for_commit(Epoch, int64_t), but records the time spent in the
+   * latency histogram of the thread.
+   * @param[in,out] context Thread context
+   * @param[in] commit_epoch the commit epoch to wait for
+   * @param[in] wait_microseconds same as wait_for_commit(Epoch, int64_t)
+   * @see foedus::thread::kLatencyPhaseWaitForCommit
+   */
+  ErrorCode   wait_for_commit(
+    thread::Thread* context,
+    Epoch commit_epoch,
+    int64_t wait_microseconds = -1);
+
+  /**
+   * @brief Pre-commits the currently running transaction on the thread, and registers a
+   * callback to be invoked when the transaction becomes durable.
+   * @pre context->is_running_xct() == true
+   * @param[in,out] context Thread context
+   * @param[in] callback invoked with commit_epoch and user_data when the transaction
+   * becomes durable. Not invoked if this method returns an error.
+   * @param[in] user_data arbitrary pointer passed to callback
+   * @param[out] commit_epoch same as precommit_xct()
+   * @details
+   * This is the asynchronous version of precommit_xct() + wait_for_commit(), or
+   * \e group \e commit. Instead of parking the worker thread until the durable global epoch
+   * reaches the commit epoch, the worker can immediately begin the next transaction.
+   * The callbacks of the thread are invoked in bulk on the same thread whenever it observes
+   * that the durable global epoch has advanced, which happens in begin_xct(),
+   * invoke_durable_callbacks(), and wait_for_durable_callbacks().
+   * Unlike wait_for_commit(), this method does not request the epoch chime to advance
+   * the epoch early. Transactions become durable at the usual pace of epochs.
+   *
+   * Each thread can have up to DurableCallbackQueue::kCapacity pending transactions.
+   * If there are already that many, this method first waits for the oldest one to become durable.
+   * When the procedure on the thread returns, the thread waits for all pending transactions
+   * and invokes their callbacks, so callbacks are never carried over to the next procedure.
+   * @see DurableCallback
+   */
+  ErrorCode   precommit_xct_async(
+    thread::Thread* context,
+    DurableCallback callback,
+    void* user_data,
+    Epoch *commit_epoch);
+
+  /**
+   * @brief Invokes the callbacks of the thread's transactions that became durable so far.
+   * @param[in,out] context Thread context
+   * @return number of callbacks invoked
+   * @details
+   * This method never blocks. It must be called outside of a transaction.
+   */
+  uint32_t    invoke_durable_callbacks(thread::Thread* context);
+
+  /**
+   * @brief Waits until all transactions of the thread committed by precommit_xct_async()
+   * become durable, invoking their callbacks.
+   * @param[in,out] context Thread context
+   * @param[in] wait_microseconds passed to each wait_for_commit() call. -1 to wait forever.
+   * @details
+   * This must be called outside of a transaction. When this method returns kErrorCodeOk,
+   * the thread has no pending callbacks.
+   */
+  ErrorCode   wait_for_durable_callbacks(thread::Thread* context, int64_t wait_microseconds = -1);
 
   /**
    * @brief Aborts the currently running transaction on the thread.
@@ -25,13 +25,17 @@
 #include "foedus/initializable.hpp"
 #include "foedus/soc/shared_memory_repo.hpp"
 #include "foedus/soc/shared_polling.hpp"
+#include "foedus/storage/storage_id.hpp"
 #include "foedus/thread/condition_variable_impl.hpp"
 #include "foedus/thread/fwd.hpp"
 #include "foedus/thread/stoppable_thread_impl.hpp"
+#include "foedus/xct/abort_sample.hpp"
+#include "foedus/xct/durable_callback_queue.hpp"
 #include "foedus/xct/fwd.hpp"
 #include "foedus/xct/retrospective_lock_list.hpp"  // to inline CurrentLockListIteratorForWriteSet
 #include "foedus/xct/xct_access.hpp"               // same above. iterator must be fast...
 #include "foedus/xct/xct_id.hpp"
+#include "foedus/xct/xct_manager.hpp"
 
 namespace foedus {
 namespace xct {
@@ -45,6 +49,13 @@ struct XctManagerControlBlock {
     current_global_epoch_advanced_.initialize();
     epoch_chime_wakeup_.initialize();
     new_transaction_paused_ = false;
+    epoch_interval_us_ = 0;
+    epochs_advanced_ = 0;
+    last_epoch_duration_us_ = 0;
+    max_epoch_duration_us_ = 0;
+    total_epoch_duration_us_ = 0;
+    commit_waiters_ = 0;
+    total_commit_waits_ = 0;
   }
   void uninitialize() {
   }
@@ -88,6 +99,22 @@ struct XctManagerControlBlock {
    * This is used only once per several minutes, so no need for optimization. Keep it simple!
    */
   std::atomic<bool>                 new_transaction_paused_;
+
+  /**
+   * @brief Statistics of the epoch chime. See EpochChimeStat for each of them.
+   * @details
+   * Written only by the epoch chime, except the two counters of commit waits, which are
+   * modified by threads in wait_for_commit() and precommit_xct_async().
+   * The epoch chime reads total_commit_waits_
+   * to tell whether someone waited in the last epoch for adaptive epoch interval.
+   */
+  std::atomic<uint64_t>             epoch_interval_us_;
+  std::atomic<uint64_t>             epochs_advanced_;
+  std::atomic<uint64_t>             last_epoch_duration_us_;
+  std::atomic<uint64_t>             max_epoch_duration_us_;
+  std::atomic<uint64_t>             total_epoch_duration_us_;
+  std::atomic<uint32_t>             commit_waiters_;
+  std::atomic<uint64_t>             total_commit_waits_;
 };
 
 /**
@@ -120,12 +147,47 @@ class XctManagerPimpl final : public DefaultInitializable {
    */
   ErrorCode   precommit_xct(thread::Thread* context, Epoch *commit_epoch);
   ErrorCode   abort_xct(thread::Thread* context);
+  ErrorCode   run_readonly_xct(
+    thread::Thread* context,
+    ReadOnlyXctBody body,
+    void* user_data,
+    Epoch* serialization_epoch);
+  ErrorCode   run_xct_with_retry(
+    thread::Thread* context,
+    IsolationLevel isolation_level,
+    XctBody body,
+    void* user_data,
+    Epoch* commit_epoch);
 
   ErrorCode   wait_for_commit(Epoch commit_epoch, int64_t wait_microseconds);
+  ErrorCode   wait_for_commit(
+    thread::Thread* context,
+    Epoch commit_epoch,
+    int64_t wait_microseconds);
+  ErrorCode   precommit_xct_async(
+    thread::Thread* context,
+    DurableCallback callback,
+    void* user_data,
+    Epoch *commit_epoch);
+  uint32_t    invoke_durable_callbacks(thread::Thread* context);
+  ErrorCode   wait_for_durable_callbacks(thread::Thread* context, int64_t wait_microseconds);
   void        set_requested_global_epoch(Epoch request);
   void        advance_current_global_epoch();
   void        wait_for_current_global_epoch(Epoch target_epoch, int64_t wait_microseconds);
   void        wakeup_epoch_chime_thread();
+  EpochChimeStat get_epoch_chime_stat() const;
+  /**
+   * Returns the interval for the next epoch when the adaptive epoch interval is enabled.
+   * @param[in] cur_interval_us the interval used for the last epoch
+   * @param[in] had_commit_waiters whether some thread waited for durable commit in the last epoch
+   * @param[in] min_interval_us the shortest interval
+   * @param[in] max_interval_us the longest interval
+   */
+  static uint64_t adapt_epoch_interval(
+    uint64_t cur_interval_us,
+    bool had_commit_waiters,
+    uint64_t min_interval_us,
+    uint64_t max_interval_us);
 
   /**
    * @brief precommit_xct() if the transaction is read-only
@@ -187,6 +249,19 @@ class XctManagerPimpl final : public DefaultInitializable {
   bool        precommit_xct_verify_pointer_set(thread::Thread* context);
   /** Returns false if there is any page version conflict */
   bool        precommit_xct_verify_page_version_set(thread::Thread* context);
+  /**
+   * Records the abort in the thread's AbortSampleRing if this abort is sampled.
+   * Does nothing unless XctOptions::abort_sampling_interval_ is non-zero.
+   * @param[in] context thread context
+   * @param[in] cause what check failed
+   * @param[in] address the record, page pointer, or page version that failed the check
+   * @param[in] storage_id used only when the address is not in a volatile page
+   */
+  void        sample_abort(
+    thread::Thread* context,
+    AbortCause cause,
+    const void* address,
+    storage::StorageId storage_id);
   /**
    * @brief Phase 3 of precommit_xct()
    * @param[in] context thread context
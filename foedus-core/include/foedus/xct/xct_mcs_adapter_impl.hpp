@@ -108,6 +108,9 @@ class McsAdaptorConcept {
 
   void add_rw_async_mapping(xct::McsRwLock* lock, xct::McsBlockIndex block_index);
 
+  /** Called after this thread waited for a lock held by another thread, for statistics. */
+  void add_mcs_wait_cycles(uint64_t cycles);
+
  private:
   McsAdaptorConcept() = delete;
   ~McsAdaptorConcept() = delete;
@@ -411,6 +414,7 @@ class McsMockAdaptor {
     }
     ASSERT_ND(false);
   }
+  void add_mcs_wait_cycles(uint64_t /*cycles*/) {}
 
  private:
   const thread::ThreadId            id_;
@@ -47,9 +47,17 @@ struct XctOptions CXX11_FINAL : public virtual externalize::Externalizable {
     kDefaultLocalWorkMemorySizeMb = 2,
     /** Default value for epoch_advance_interval_ms_. */
     kDefaultEpochAdvanceIntervalMs = 20,
+    /** Default value for min_epoch_advance_interval_ms_. */
+    kDefaultMinEpochAdvanceIntervalMs = 2,
+    /** Default value for max_epoch_advance_interval_ms_. */
+    kDefaultMaxEpochAdvanceIntervalMs = 100,
     kMcsImplementationTypeSimple = 0,
     kMcsImplementationTypeExtended = 1,
     kDefaultHotThreshold = 256,  // OCC by default (for test cases and benchamrks that don't set it)
+    /** Default value for readonly_serializable_attempts_. */
+    kDefaultReadOnlySerializableAttempts = 3,
+    /** Default value for max_retry_backoff_cycles_. */
+    kDefaultMaxRetryBackoffCycles = 1 << 20,
   };
 
   /**
@@ -111,6 +119,26 @@ struct XctOptions CXX11_FINAL : public virtual externalize::Externalizable {
    */
   uint32_t    epoch_advance_interval_ms_;
 
+  /**
+   * @brief Whether the epoch chime adapts the interval between epoch advancements to the load.
+   * @details
+   * Default is false, which always uses epoch_advance_interval_ms_.
+   * When true, epoch_advance_interval_ms_ is the initial interval. The epoch chime halves the
+   * interval (down to min_epoch_advance_interval_ms_) after an epoch in which some thread waited
+   * for a commit to become durable, either in wait_for_commit() or with precommit_xct_async(),
+   * so that the commit latency goes down.
+   * After an epoch with no such waiters, it lengthens the interval by a quarter (up to
+   * max_epoch_advance_interval_ms_) to save the overhead of epoch advancement for throughput.
+   * See XctManager::get_epoch_chime_stat() to monitor the interval.
+   */
+  bool        adaptive_epoch_interval_;
+
+  /** @brief The shortest interval the adaptive epoch chime uses. Default is 2 ms. */
+  uint32_t    min_epoch_advance_interval_ms_;
+
+  /** @brief The longest interval the adaptive epoch chime uses. Default is 100 ms. */
+  uint32_t    max_epoch_advance_interval_ms_;
+
   /**
    * @brief Whether to use Retrospective Lock List (RLL) after aborts
    * @details
@@ -162,6 +190,44 @@ struct XctOptions CXX11_FINAL : public virtual externalize::Externalizable {
    * @see foedus::xct::McsImpl
    */
   uint16_t    mcs_implementation_type_;
+
+  /**
+   * @brief Samples one out of this number of aborts in pre-commit to find contended records.
+   * @details
+   * Default is 0, which disables the sampling.
+   * When non-zero, each thread records which storage, page and record caused the abort
+   * into its AbortSampleRing. AbortReport aggregates them into the top contended records and
+   * pages. 1 samples every abort, which is fine unless the workload aborts really often.
+   * @see foedus::xct::AbortReport
+   */
+  uint32_t    abort_sampling_interval_;
+
+  /**
+   * @brief How many times XctManager::run_readonly_xct() runs the transaction in kSerializable
+   * before it falls back to the latest snapshot.
+   * @details
+   * Default is 3. 0 means it always reads the snapshot if there is one.
+   * The fallback happens only after this number of verification failures in a row, so
+   * read-only transactions under light contention still read the latest data.
+   */
+  uint16_t    readonly_serializable_attempts_;
+
+  /**
+   * @brief How many times XctManager::run_xct_with_retry() runs a transaction before it gives up.
+   * @details
+   * Default is 0, which means it retries until the transaction commits or fails with
+   * an error that is not worth retrying.
+   */
+  uint32_t    max_retry_attempts_;
+
+  /**
+   * @brief The longest backoff in CPU cycles XctManager::run_xct_with_retry() waits before
+   * retrying an aborted transaction.
+   * @details
+   * Default is 2^20 cycles, which is a few hundred microseconds. 0 disables the backoff.
+   * @see foedus::xct::RetryBackoff
+   */
+  uint64_t    max_retry_backoff_cycles_;
 };
 }  // namespace xct
 }  // namespace foedus
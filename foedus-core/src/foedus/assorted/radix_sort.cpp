@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include "foedus/assorted/radix_sort.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "foedus/assert_nd.hpp"
+
+namespace foedus {
+namespace assorted {
+
+/**
+ * Bits per digit. 11 bits (2048 buckets, 8kb of counts per digit) is a common choice because
+ * the counts and the write positions of each pass still fit in L1/L2.
+ */
+const uint16_t kRadixBits = 11;
+const uint32_t kRadix = 1U << kRadixBits;
+/** Extracts kRadixBits bits from the given bit position. */
+inline uint32_t get_digit(__uint128_t value, uint16_t shift) {
+  return static_cast<uint32_t>(value >> shift) & (kRadix - 1U);
+}
+
+/**
+ * LSD radix sort on the lowest digits*kRadixBits bits of the keys (value >> ignored_low_bits) in src.
+ * The sorted result is written to dest. src is used as work memory, thus garbage afterwards.
+ * This is called for each bucket of the first MSD pass, which usually fits in CPU caches.
+ */
+void lsd_sort(
+  __uint128_t* src,
+  __uint128_t* dest,
+  uint32_t count,
+  uint16_t ignored_low_bits,
+  uint16_t digits) {
+  if (count < kRadixSortMinCount) {
+    std::memcpy(dest, src, sizeof(__uint128_t) * count);
+    std::stable_sort(dest, dest + count, [ignored_low_bits](__uint128_t left, __uint128_t right) {
+      return (left >> ignored_low_bits) < (right >> ignored_low_bits);
+    });
+    return;
+  }
+
+  // count all digits at once
+  std::vector< uint32_t > histogram(kRadix * digits, 0);
+  for (uint32_t i = 0; i < count; ++i) {
+    const __uint128_t value = src[i];
+    for (uint16_t digit = 0; digit < digits; ++digit) {
+      ++histogram[kRadix * digit + get_digit(value, ignored_low_bits + digit * kRadixBits)];
+    }
+  }
+
+  __uint128_t* from = src;
+  __uint128_t* to = dest;
+  for (uint16_t digit = 0; digit < digits; ++digit) {
+    const uint16_t shift = ignored_low_bits + digit * kRadixBits;
+    const uint32_t* counts = &histogram[kRadix * digit];
+    if (counts[get_digit(src[0], shift)] == count) {
+      continue;  // all integers have the same value in this digit. skip it.
+    }
+    uint32_t positions[kRadix];
+    uint32_t total = 0;
+    for (uint32_t value = 0; value < kRadix; ++value) {
+      positions[value] = total;
+      total += counts[value];
+    }
+    ASSERT_ND(total == count);
+    for (uint32_t i = 0; i < count; ++i) {
+      const __uint128_t value = from[i];
+      to[positions[get_digit(value, shift)]++] = value;
+    }
+    std::swap(from, to);
+  }
+
+  if (from != dest) {
+    std::memcpy(dest, from, sizeof(__uint128_t) * count);
+  }
+}
+
+/** Runs the given function with thread index [0, threads). The calling thread runs index 0. */
+template <typename FUNC>
+void run_in_threads(uint16_t threads, FUNC func) {
+  std::vector< std::thread > helpers;
+  for (uint16_t t = 1; t < threads; ++t) {
+    helpers.emplace_back(func, t);
+  }
+  func(0);
+  for (auto& helper : helpers) {
+    helper.join();
+  }
+}
+
+void radix_sort_uint128(
+  __uint128_t* data,
+  uint32_t count,
+  __uint128_t* buffer,
+  uint16_t ignored_low_bits,
+  uint16_t max_threads) {
+  ASSERT_ND(ignored_low_bits < 128U);
+  if (count < kRadixSortMinCount) {
+    std::stable_sort(data, data + count, [ignored_low_bits](__uint128_t left, __uint128_t right) {
+      return (left >> ignored_low_bits) < (right >> ignored_low_bits);
+    });
+    return;
+  }
+
+  // Plain LSD radix sort scatters the whole input in each pass, which is not cache friendly.
+  // So, we first split the input by the most significant bits that differ (one MSD pass),
+  // then LSD-sort each bucket, which is usually small enough to fit in CPU caches.
+  // Both steps are parallelized for large inputs. The MSD pass splits the input to chunks.
+  // The buckets are independent from each other in the LSD step.
+  const uint16_t threads
+    = (max_threads <= 1U || count < kRadixSortParallelMinCount) ? 1U : max_threads;
+  std::vector< uint32_t > chunk_begins;
+  for (uint16_t t = 0; t <= threads; ++t) {
+    chunk_begins.push_back(static_cast<uint64_t>(count) * t / threads);
+  }
+
+  // Which bits differ? Higher bits of keys, epochs, and ordinals are mostly same.
+  const __uint128_t first = data[0] >> ignored_low_bits;
+  std::vector< __uint128_t > differences(threads, 0);
+  run_in_threads(threads, [&](uint16_t t) {
+    __uint128_t difference = 0;
+    for (uint32_t i = chunk_begins[t]; i < chunk_begins[t + 1U]; ++i) {
+      difference |= (data[i] >> ignored_low_bits) ^ first;
+    }
+    differences[t] = difference;
+  });
+  __uint128_t difference = 0;
+  for (uint16_t t = 0; t < threads; ++t) {
+    difference |= differences[t];
+  }
+  if (difference == 0) {
+    return;  // all keys are the same. nothing to sort
+  }
+  uint16_t key_bits = 128U;
+  while ((difference >> (key_bits - 1U)) == 0) {
+    --key_bits;
+  }
+
+  // The MSD digit is the highest kRadixBits bits that differ.
+  // The LSD digits cover the rest, possibly overlapping with the MSD digit (no harm).
+  const uint16_t msd_shift = ignored_low_bits + std::max<int>(key_bits - kRadixBits, 0);
+  const uint16_t lsd_digits = (msd_shift - ignored_low_bits + kRadixBits - 1U) / kRadixBits;
+  std::vector< std::vector< uint32_t > > positions(threads, std::vector< uint32_t >(kRadix, 0));
+  run_in_threads(threads, [&](uint16_t t) {
+    std::vector< uint32_t >& counts = positions[t];
+    for (uint32_t i = chunk_begins[t]; i < chunk_begins[t + 1U]; ++i) {
+      ++counts[get_digit(data[i], msd_shift)];
+    }
+  });
+
+  // positions[t][value]: where thread-t writes the next integer of the value.
+  // Integers of each value are ordered by thread (=input order) to keep it stable.
+  std::vector< uint32_t > bucket_begins(kRadix + 1U);
+  uint32_t total = 0;
+  for (uint32_t value = 0; value < kRadix; ++value) {
+    bucket_begins[value] = total;
+    for (uint16_t t = 0; t < threads; ++t) {
+      const uint32_t chunk_count = positions[t][value];
+      positions[t][value] = total;
+      total += chunk_count;
+    }
+  }
+  bucket_begins[kRadix] = total;
+  ASSERT_ND(total == count);
+  run_in_threads(threads, [&](uint16_t t) {
+    std::vector< uint32_t >& next = positions[t];
+    for (uint32_t i = chunk_begins[t]; i < chunk_begins[t + 1U]; ++i) {
+      const __uint128_t value = data[i];
+      buffer[next[get_digit(value, msd_shift)]++] = value;
+    }
+  });
+
+  // LSD-sort each bucket from buffer back to data.
+  std::atomic<uint32_t> next_bucket(0);
+  run_in_threads(threads, [&](uint16_t /*t*/) {
+    for (uint32_t value = next_bucket++; value < kRadix; value = next_bucket++) {
+      const uint32_t begin = bucket_begins[value];
+      const uint32_t bucket_count = bucket_begins[value + 1U] - begin;
+      lsd_sort(buffer + begin, data + begin, bucket_count, ignored_low_bits, lsd_digits);
+    }
+  });
+
+#ifndef NDEBUG
+  for (uint32_t i = 1; i < count; ++i) {
+    ASSERT_ND((data[i - 1U] >> ignored_low_bits) <= (data[i] >> ignored_low_bits));
+  }
+#endif  // NDEBUG
+}
+
+}  // namespace assorted
+}  // namespace foedus
@@ -20,7 +20,10 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <ostream>
+#include <utility>
+#include <vector>
 
 #include "foedus/assorted/assorted_func.hpp"
 #include "foedus/cache/snapshot_file_set.hpp"
@@ -67,7 +70,8 @@ CacheHashtable::CacheHashtable(BucketId physical_buckets, uint16_t numa_node)
   : numa_node_(numa_node),
   overflow_buckets_count_(determine_overflow_list_size(physical_buckets)),
   hash_func_(physical_buckets),
-  clockhand_(0) {
+  clockhand_(0),
+  probation_clockhand_(0) {
   buckets_memory_.alloc(
     sizeof(CacheBucket) * physical_buckets,
     1U << 21,
@@ -130,7 +134,7 @@ ErrorCode CacheHashtable::install(storage::SnapshotPagePointer page_id, ContentI
     if (!buckets_[bucket].is_content_set()) {
       // looks like this is empty!
       buckets_[bucket] = new_bucket;  // 8-byte implicitly-atomic write
-      refcounts_[bucket].count_ = 1;
+      refcounts_[bucket].count_ = CacheRefCount::kProbationCount;
       // this might be immediately overwritten by someone else, but that's fine.
       // that only causes a future cache miss. no correctness issue.
       return kErrorCodeOk;
@@ -161,7 +165,7 @@ ErrorCode CacheHashtable::install(storage::SnapshotPagePointer page_id, ContentI
   ASSERT_ND(new_overflow_entry < overflow_buckets_count_);
   overflow_free_buckets_head_ = overflow_buckets_[new_overflow_entry].next_;
   overflow_buckets_[new_overflow_entry].next_ = overflow_buckets_head_;
-  overflow_buckets_[new_overflow_entry].refcount_.count_ = 1;
+  overflow_buckets_[new_overflow_entry].refcount_.count_ = CacheRefCount::kProbationCount;
   overflow_buckets_[new_overflow_entry].bucket_ = new_bucket;
   assorted::memory_fence_release();
   overflow_buckets_head_ = new_overflow_entry;
@@ -170,7 +174,20 @@ ErrorCode CacheHashtable::install(storage::SnapshotPagePointer page_id, ContentI
 
 void CacheHashtable::evict(CacheHashtable::EvictArgs* args) {
   LOG(INFO) << "Snapshot-Cache eviction starts at node-" << numa_node_
-    << ", clockhand_=" << clockhand_ << ", #target=" << args->target_count_;
+    << ", clockhand_=" << clockhand_ << ", #target=" << args->target_count_
+    << ", policy=" << args->policy_;
+  args->evicted_count_ = 0;
+  if (args->policy_ == CacheOptions::kEvictionPolicyScanResistant) {
+    // pages that nobody has accessed since installed go first. hot pages keep their refcounts.
+    evict_probation_loop(args);
+    if (args->evicted_count_ >= args->target_count_) {
+      LOG(INFO) << "Snapshot-Cache eviction completed at node-" << numa_node_
+        << " only with probationary entries, probation_clockhand_=" << probation_clockhand_
+        << ", #evicted=" << args->evicted_count_;
+      return;
+    }
+  }
+
   const BucketId end = get_physical_buckets();
   BucketId cur = clockhand_;
 
@@ -184,7 +201,6 @@ void CacheHashtable::evict(CacheHashtable::EvictArgs* args) {
   }
 
   // evict on the normal buckets first.
-  args->evicted_count_ = 0;
   uint16_t loops;
   const uint16_t kMaxLoops = 16;  // if we need more loops than this, something is wrong...
   for (loops = 0; loops < kMaxLoops; ++loops) {
@@ -274,6 +290,51 @@ BucketId CacheHashtable::evict_main_loop(
   return cur_cacheline << 5;
 }
 
+void CacheHashtable::evict_probation_loop(CacheHashtable::EvictArgs* args) {
+  const BucketId end = get_physical_buckets();
+  BucketId cur = (probation_clockhand_ >> 5) << 5;
+  if (cur >= end) {
+    cur = 0;
+  }
+  const BucketId start = cur;
+  uint64_t checked_count = 0;
+  debugging::StopWatch watch;
+
+  // Same as evict_main_loop, we skip 32 zero refcounts (one cacheline) at once.
+  // Unlike evict_main_loop, we never decrement refcounts here, and we go over the table
+  // at most once. The overflow list is left to the CLOCK sweep.
+  do {
+    const uint64_t* ints = reinterpret_cast<const uint64_t*>(ASSUME_ALIGNED(refcounts_ + cur, 64));
+    bool all_zeros = true;
+    for (uint16_t i = 0; i < 8U; ++i) {
+      if (ints[i] != 0) {
+        all_zeros = false;
+        break;
+      }
+    }
+    if (!all_zeros) {
+      for (BucketId bucket = cur; bucket < cur + 32U && bucket < end; ++bucket) {
+        if (refcounts_[bucket].count_ == CacheRefCount::kProbationCount) {
+          args->add_evicted(buckets_[bucket].get_content_id());
+          buckets_[bucket].data_ = 0;
+          refcounts_[bucket].count_ = 0;
+        }
+      }
+    }
+    checked_count += 32U;
+    cur += 32U;
+    if (cur >= end) {
+      cur = 0;
+    }
+  } while (cur != start && args->evicted_count_ < args->target_count_);
+
+  probation_clockhand_ = cur;
+  watch.stop();
+  LOG(INFO) << "Snapshot-Cache eviction probation_loop at node-" << numa_node_ << ", checked "
+    << checked_count << " buckets in " << watch.elapsed_us() << "us, #evicted="
+    << args->evicted_count_;
+}
+
 void CacheHashtable::evict_overflow_loop(CacheHashtable::EvictArgs* args, uint16_t loop) {
   const uint16_t decrements = 1U << loop;
   uint32_t checked_count = 0;
@@ -348,6 +409,49 @@ ErrorStack CacheHashtable::verify_single_thread() const {
   return kRetOk;
 }
 
+void CacheHashtable::get_hot_contents(
+  uint16_t min_refcount,
+  uint32_t max_count,
+  std::vector<ContentId>* out) const {
+  ASSERT_ND(min_refcount > 0);
+  out->clear();
+  std::vector< std::pair<uint16_t, ContentId> > entries;  // (refcount, content)
+  const BucketId end = get_physical_buckets();
+  for (BucketId i = 0; i < end; ++i) {
+    const uint16_t count = refcounts_[i].count_;
+    if (count >= min_refcount) {
+      ContentId content = buckets_[i].get_content_id();
+      if (content) {
+        entries.emplace_back(count, content);
+      }
+    }
+  }
+  for (OverflowPointer i = overflow_buckets_head_; i != 0;) {
+    const uint16_t count = overflow_buckets_[i].refcount_.count_;
+    if (count >= min_refcount) {
+      ContentId content = overflow_buckets_[i].bucket_.get_content_id();
+      if (content) {
+        entries.emplace_back(count, content);
+      }
+    }
+    i = overflow_buckets_[i].next_;
+  }
+
+  std::sort(
+    entries.begin(),
+    entries.end(),
+    [](const std::pair<uint16_t, ContentId>& left, const std::pair<uint16_t, ContentId>& right) {
+      return left.first > right.first;
+    });
+  if (entries.size() > max_count) {
+    entries.resize(max_count);
+  }
+  out->reserve(entries.size());
+  for (const auto& entry : entries) {
+    out->push_back(entry.second);
+  }
+}
+
 CacheHashtable::Stat CacheHashtable::get_stat_single_thread() const {
   Stat result;
   result.normal_entries_ = 0;
@@ -376,7 +480,8 @@ CacheHashtable::Stat CacheHashtable::get_stat_single_thread() const {
 ErrorCode CacheHashtable::find_batch(
   uint16_t batch_size,
   const storage::SnapshotPagePointer* page_ids,
-  ContentId* out) const {
+  ContentId* out,
+  bool promote) const {
   if (batch_size == 0) {
     return kErrorCodeOk;
   }
@@ -416,7 +521,9 @@ ErrorCode CacheHashtable::find_batch(
       const CacheBucket& bucket = buckets_[bucket_number + i];
       if (bucket.get_tag() == tag) {
         // found (probably)!
-        refcounts_[bucket_number + i].increment();
+        if (promote) {
+          refcounts_[bucket_number + i].increment();
+        }
         out[b] = bucket.get_content_id();
         break;
       }
@@ -426,7 +533,9 @@ ErrorCode CacheHashtable::find_batch(
     if (out[b] == 0 && overflow_buckets_head_) {
       for (OverflowPointer i = overflow_buckets_head_; i != 0;) {
         if (overflow_buckets_[i].bucket_.get_tag() == tag) {
-          overflow_buckets_[i].refcount_.increment();
+          if (promote) {
+            overflow_buckets_[i].refcount_.increment();
+          }
           out[b] = overflow_buckets_[i].bucket_.get_content_id();
           break;
         }
@@ -19,22 +19,42 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <fstream>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "foedus/engine.hpp"
 #include "foedus/engine_options.hpp"
+#include "foedus/assorted/assorted_func.hpp"
 #include "foedus/cache/cache_hashtable.hpp"
+#include "foedus/cache/snapshot_file_set.hpp"
 #include "foedus/debugging/stop_watch.hpp"
+#include "foedus/fs/direct_io_file.hpp"
+#include "foedus/fs/filesystem.hpp"
+#include "foedus/fs/path.hpp"
 #include "foedus/memory/engine_memory.hpp"
 #include "foedus/memory/numa_node_memory.hpp"
 #include "foedus/savepoint/savepoint_manager.hpp"
+#include "foedus/snapshot/snapshot_id.hpp"
+#include "foedus/storage/page.hpp"
 #include "foedus/xct/xct_manager.hpp"
 
 namespace foedus {
 namespace cache {
 
+/** Max number of pages warmup() reads in one read. 256kb. */
+const uint32_t kWarmupReadPages = 64;
+/**
+ * warmup() reads a few unnecessary pages between hot pages if it can then make one read.
+ * A few more pages in one read are cheaper than one more random read.
+ */
+const uint32_t kWarmupMaxGapPages = 8;
+
 CacheManagerPimpl::CacheManagerPimpl(Engine* engine)
   : engine_(engine),
   stop_requested_(false),
@@ -92,6 +112,13 @@ ErrorStack CacheManagerPimpl::initialize_once() {
     engine_->get_soc_id());
   reclaimed_pages_ = reinterpret_cast<memory::PagePoolOffset*>(reclaimed_pages_memory_.get_block());
 
+  if (options.snapshot_cache_warmup_enabled_) {
+    // Worker threads don't run transactions until the engine is initialized, so we can
+    // fill the cache without competing with them.
+    CHECK_ERROR(warmup());
+  }
+  persist_watch_.start();
+
   // launch the cleaner thread
   stop_requested_.store(false);
   cleaner_ = std::move(std::thread(&CacheManagerPimpl::handle_cleaner, this));
@@ -107,6 +134,10 @@ ErrorStack CacheManagerPimpl::uninitialize_once() {
 
   LOG(INFO) << "Uninitializing Snapshot Cache... " << describe();
   CHECK_ERROR(stop_cleaner());
+  if (engine_->get_options().cache_.snapshot_cache_warmup_enabled_) {
+    // the cache is warmest now. remember it for the next start-up.
+    persist_hot_pages();
+  }
 
   pool_ = nullptr;
   hashtable_ = nullptr;
@@ -179,6 +210,14 @@ void CacheManagerPimpl::handle_cleaner() {
       DVLOG(2) << "Still enough free pages. do nothing";
     }
 
+    const CacheOptions& options = engine_->get_options().cache_;
+    if (options.snapshot_cache_warmup_enabled_
+      && persist_watch_.peek_elapsed_ns()
+        >= options.snapshot_cache_warmup_persist_interval_ms_ * 1000000ULL) {
+      persist_hot_pages();
+      persist_watch_.start();
+    }
+
     if (!stop_requested_) {
       std::this_thread::sleep_for(std::chrono::milliseconds(kIntervalMs));
     }
@@ -190,7 +229,11 @@ void CacheManagerPimpl::handle_cleaner() {
 void CacheManagerPimpl::handle_cleaner_evict_pages(uint64_t target_count) {
   ASSERT_ND(reclaimed_pages_count_ == 0);
   ASSERT_ND(target_count > 0);
-  CacheHashtable::EvictArgs args = { target_count, 0, reclaimed_pages_ };
+  CacheHashtable::EvictArgs args = {
+    target_count,
+    0,
+    reclaimed_pages_,
+    engine_->get_options().cache_.snapshot_cache_eviction_policy_};
   hashtable_->evict(&args);
   reclaimed_pages_count_ = args.evicted_count_;
 }
@@ -210,6 +253,224 @@ ErrorStack CacheManagerPimpl::stop_cleaner() {
 }
 
 
+std::string CacheManagerPimpl::get_hot_pages_path() const {
+  const uint16_t node = engine_->get_soc_id();
+  // the folder might be shared by nodes, so the file name contains the node, too.
+  std::stringstream str;
+  str << engine_->get_options().snapshot_.convert_folder_path_pattern(node)
+    << "/snapshot_cache_hot_pages_node_" << node;
+  return str.str();
+}
+
+void CacheManagerPimpl::persist_hot_pages() {
+  debugging::StopWatch watch;
+  // Pages not accessed since they were installed are not worth reading at start-up.
+  // We also don't remember more than what the cache holds without eviction.
+  std::vector<ContentId> contents;
+  hashtable_->get_hot_contents(CacheRefCount::kProbationCount + 1U, cleaner_threshold_, &contents);
+  std::vector< storage::SnapshotPagePointer > page_ids;
+  page_ids.reserve(contents.size());
+  const storage::Page* base = pool_->get_base();
+  for (ContentId content : contents) {
+    // The page might be being evicted and reused right now. It's fine.
+    // warmup() checks the page ID in the page read from the file anyway.
+    const storage::PageHeader& header = base[content].get_header();
+    if (header.snapshot_ && header.page_id_ != 0) {
+      page_ids.push_back(header.page_id_);
+    }
+  }
+
+  fs::Path path(get_hot_pages_path());
+  fs::Path folder = path.parent_path();
+  if (!fs::exists(folder) && !fs::create_directories(folder, true)) {
+    LOG(WARNING) << "Failed to create " << folder << " to persist hot pages. err="
+      << assorted::os_error();
+    return;
+  }
+  fs::Path tmp_path(path);
+  tmp_path += ".tmp";
+  {
+    std::ofstream file(tmp_path.c_str(), std::ios::binary | std::ios::trunc);
+    if (page_ids.size() > 0) {
+      file.write(
+        reinterpret_cast<const char*>(&page_ids[0]),
+        sizeof(storage::SnapshotPagePointer) * page_ids.size());
+    }
+    file.close();
+    if (file.fail()) {
+      LOG(WARNING) << "Failed to write hot pages to " << tmp_path << ". err="
+        << assorted::os_error();
+      return;
+    }
+  }
+  if (!fs::durable_atomic_rename(tmp_path, path)) {
+    LOG(WARNING) << "Failed to rename " << tmp_path << " to " << path << ". err="
+      << assorted::os_error();
+    return;
+  }
+  watch.stop();
+  LOG(INFO) << "Persisted " << page_ids.size() << " hot snapshot pages to " << path << " in "
+    << watch.elapsed_ms() << "ms";
+}
+
+ErrorStack CacheManagerPimpl::warmup() {
+  fs::Path path(get_hot_pages_path());
+  if (!fs::exists(path)) {
+    LOG(INFO) << "No hot snapshot pages to warm up the cache with: " << path;
+    return kRetOk;
+  } else if (engine_->get_savepoint_manager()->get_latest_snapshot_id()
+    == snapshot::kNullSnapshotId) {
+    LOG(INFO) << "There is no snapshot yet. Ignored hot snapshot pages in " << path;
+    return kRetOk;
+  }
+
+  debugging::StopWatch watch;
+  std::vector< storage::SnapshotPagePointer > page_ids(
+    fs::file_size(path) / sizeof(storage::SnapshotPagePointer));
+  if (page_ids.size() > 0) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    file.read(
+      reinterpret_cast<char*>(&page_ids[0]),
+      sizeof(storage::SnapshotPagePointer) * page_ids.size());
+    if (file.fail()) {
+      LOG(WARNING) << "Failed to read hot pages from " << path << ". We skip warm-up";
+      return kRetOk;
+    }
+  }
+
+  // Don't fill the cache beyond the cleaner threshold, otherwise the cleaner evicts them soon.
+  // The file lists hotter pages first, so we take pages from the beginning.
+  const uint64_t allocated = pool_->get_stat().allocated_pages_;
+  const uint64_t budget = cleaner_threshold_ > allocated ? cleaner_threshold_ - allocated : 0;
+  if (page_ids.size() > budget) {
+    page_ids.resize(budget);
+  }
+
+  // Then sort them so that we can read contiguous pages in one read.
+  // Snapshot pointers of the same file (snapshot and node) are contiguous when sorted.
+  std::sort(page_ids.begin(), page_ids.end());
+  page_ids.erase(std::unique(page_ids.begin(), page_ids.end()), page_ids.end());
+  std::vector< std::pair<uint32_t, uint32_t> > runs;
+  for (uint32_t i = 0; i < page_ids.size();) {
+    if (storage::extract_snapshot_id_from_snapshot_pointer(page_ids[i])
+      == snapshot::kNullSnapshotId) {
+      ++i;
+      continue;
+    }
+    uint32_t end = i + 1U;
+    while (end < page_ids.size()
+      && storage::extract_snapshot_id_from_snapshot_pointer(page_ids[end])
+        == storage::extract_snapshot_id_from_snapshot_pointer(page_ids[i])
+      && storage::extract_numa_node_from_snapshot_pointer(page_ids[end])
+        == storage::extract_numa_node_from_snapshot_pointer(page_ids[i])
+      && page_ids[end] - page_ids[end - 1U] <= kWarmupMaxGapPages
+      && page_ids[end] - page_ids[i] < kWarmupReadPages) {
+      ++end;
+    }
+    runs.emplace_back(i, end);
+    i = end;
+  }
+
+  const uint16_t threads = std::max<uint16_t>(
+    1U,
+    std::min<uint64_t>(engine_->get_options().cache_.snapshot_cache_warmup_threads_, runs.size()));
+  LOG(INFO) << "Warming up snapshot cache with " << page_ids.size() << " pages in "
+    << runs.size() << " reads by " << threads << " threads...";
+  std::atomic<uint64_t> installed_count(0);
+  std::vector< std::thread > workers;
+  for (uint16_t worker = 0; worker < threads; ++worker) {
+    workers.emplace_back(
+      &CacheManagerPimpl::warmup_worker,
+      this,
+      worker,
+      threads,
+      std::cref(page_ids),
+      std::cref(runs),
+      &installed_count);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  watch.stop();
+  LOG(INFO) << "Warmed up snapshot cache with " << installed_count.load() << " pages in "
+    << watch.elapsed_ms() << "ms: " << describe();
+  return kRetOk;
+}
+
+void CacheManagerPimpl::warmup_worker(
+  uint16_t worker,
+  uint16_t threads,
+  const std::vector< storage::SnapshotPagePointer >& page_ids,
+  const std::vector< std::pair<uint32_t, uint32_t> >& runs,
+  std::atomic<uint64_t>* installed_count) {
+  // This thread needs its own file descriptors, like worker threads.
+  SnapshotFileSet files(engine_);
+  ErrorStack init_result = files.initialize();
+  if (init_result.is_error()) {
+    // warm-up is just an optimization. never fail the startup for it.
+    LOG(WARNING) << "Warm-up worker-" << worker << " couldn't open snapshot files. Skipped warming"
+      << " up with its pages: " << init_result;
+    return;
+  }
+  memory::AlignedMemory buffer;
+  buffer.alloc(
+    kWarmupReadPages * sizeof(storage::Page),
+    1ULL << 21,
+    memory::AlignedMemory::kNumaAllocOnnode,
+    engine_->get_soc_id());
+  storage::Page* pages = reinterpret_cast<storage::Page*>(buffer.get_block());
+
+  uint64_t installed = 0;
+  for (uint32_t r = worker; r < runs.size(); r += threads) {
+    const storage::SnapshotPagePointer first = page_ids[runs[r].first];
+    const uint32_t page_count = page_ids[runs[r].second - 1U] - first + 1U;
+    ASSERT_ND(page_count <= kWarmupReadPages);
+    fs::DirectIoFile* file;
+    ErrorCode read_result = files.get_or_open_file(first, &file);
+    if (read_result == kErrorCodeOk) {
+      const storage::SnapshotLocalPageId local_page_id
+        = storage::extract_local_page_id_from_snapshot_pointer(first);
+      read_result = file->seek(
+        local_page_id * sizeof(storage::Page),
+        fs::DirectIoFile::kDirectIoSeekSet);
+    }
+    if (read_result == kErrorCodeOk) {
+      read_result = file->read_raw(sizeof(storage::Page) * page_count, pages);
+    }
+    if (read_result != kErrorCodeOk) {
+      // eg the snapshot file was removed. no big deal, the pages will be read on cache miss.
+      LOG(INFO) << "Skipped warming up with pages from " << assorted::Hex(first) << ": "
+        << get_error_name(read_result);
+      continue;
+    }
+
+    for (uint32_t i = runs[r].first; i < runs[r].second; ++i) {
+      const storage::Page* page = pages + (page_ids[i] - first);
+      if (page->get_header().page_id_ != page_ids[i] || !page->get_header().snapshot_) {
+        continue;  // the list was stale. ignore the page
+      }
+      memory::PagePoolOffset offset;
+      if (pool_->grab_one(&offset) != kErrorCodeOk) {
+        LOG(WARNING) << "Snapshot page pool ran out of pages while warming up the cache";
+        r = runs.size();  // stop all
+        break;
+      }
+      std::memcpy(static_cast<void*>(pool_->get_base() + offset), page, sizeof(storage::Page));
+      if (hashtable_->install(page_ids[i], offset) != kErrorCodeOk) {
+        pool_->release_one(offset);
+        continue;
+      }
+      ++installed;
+    }
+  }
+  *installed_count += installed;
+  ErrorStack uninit_result = files.uninitialize();
+  if (uninit_result.is_error()) {
+    LOG(WARNING) << "Warm-up worker-" << worker << " failed to close snapshot files: "
+      << uninit_result;
+  }
+}
+
 std::string CacheManagerPimpl::describe() const {
   if (pool_ == nullptr) {
     return "<SnapshotCacheManager />";
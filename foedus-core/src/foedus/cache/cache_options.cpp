@@ -27,6 +27,10 @@ CacheOptions::CacheOptions() {
   private_snapshot_cache_initial_grab_ = memory::PagePoolOffsetChunk::kMaxSize / 2;
   snapshot_cache_eviction_threshold_ = 0.75;
   snapshot_cache_urgent_threshold_ = 0.9;
+  snapshot_cache_eviction_policy_ = kEvictionPolicyClock;
+  snapshot_cache_warmup_enabled_ = false;
+  snapshot_cache_warmup_persist_interval_ms_ = kDefaultSnapshotCacheWarmupPersistIntervalMs;
+  snapshot_cache_warmup_threads_ = kDefaultSnapshotCacheWarmupThreads;
 }
 ErrorStack CacheOptions::load(tinyxml2::XMLElement* element) {
   EXTERNALIZE_LOAD_ELEMENT(element, snapshot_cache_enabled_);
@@ -38,6 +42,10 @@ ErrorStack CacheOptions::load(tinyxml2::XMLElement* element) {
   EXTERNALIZE_LOAD_ELEMENT(element, snapshot_cache_urgent_threshold_);
   ASSERT_ND(snapshot_cache_urgent_threshold_ >= snapshot_cache_eviction_threshold_);
   ASSERT_ND(snapshot_cache_urgent_threshold_ <= 1);
+  EXTERNALIZE_LOAD_ENUM_ELEMENT(element, snapshot_cache_eviction_policy_);
+  EXTERNALIZE_LOAD_ELEMENT(element, snapshot_cache_warmup_enabled_);
+  EXTERNALIZE_LOAD_ELEMENT(element, snapshot_cache_warmup_persist_interval_ms_);
+  EXTERNALIZE_LOAD_ELEMENT(element, snapshot_cache_warmup_threads_);
   return kRetOk;
 }
 ErrorStack CacheOptions::save(tinyxml2::XMLElement* element) const {
@@ -62,6 +70,15 @@ ErrorStack CacheOptions::save(tinyxml2::XMLElement* element) const {
     snapshot_cache_urgent_threshold_,
     "When the cache eviction performs in an urgent mode, which immediately advances"
     " the current epoch to release pages");
+  EXTERNALIZE_SAVE_ENUM_ELEMENT(element, snapshot_cache_eviction_policy_,
+    "How the cache cleaner chooses pages to evict. 0: CLOCK, 1: Scan-resistant CLOCK"
+    " that first evicts pages not accessed since they were installed.");
+  EXTERNALIZE_SAVE_ELEMENT(element, snapshot_cache_warmup_enabled_,
+    "Whether to remember hot snapshot pages and read them into the cache after restart.");
+  EXTERNALIZE_SAVE_ELEMENT(element, snapshot_cache_warmup_persist_interval_ms_,
+    "Interval in milliseconds to persist the hot snapshot pages.");
+  EXTERNALIZE_SAVE_ELEMENT(element, snapshot_cache_warmup_threads_,
+    "Number of threads in each node that read hot snapshot pages at startup.");
   return kRetOk;
 }
 
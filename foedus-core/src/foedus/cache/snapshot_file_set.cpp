@@ -31,7 +31,7 @@
 namespace foedus {
 namespace cache {
 
-SnapshotFileSet::SnapshotFileSet(Engine* engine) : engine_(engine) {
+SnapshotFileSet::SnapshotFileSet(Engine* engine) : engine_(engine), read_page_count_(0) {
 }
 
 ErrorStack SnapshotFileSet::initialize_once() {
@@ -101,6 +101,7 @@ ErrorCode SnapshotFileSet::read_page(storage::SnapshotPagePointer page_id, void*
     file->seek(local_page_id * sizeof(storage::Page), fs::DirectIoFile::kDirectIoSeekSet));
   CHECK_ERROR_CODE(file->read_raw(sizeof(storage::Page), out));
   ASSERT_ND(reinterpret_cast<storage::Page*>(out)->get_header().page_id_ == page_id);
+  ++read_page_count_;
   return kErrorCodeOk;
 }
 
@@ -115,6 +116,7 @@ ErrorCode SnapshotFileSet::read_pages(
   CHECK_ERROR_CODE(
     file->seek(local_page_id_begin * sizeof(storage::Page), fs::DirectIoFile::kDirectIoSeekSet));
   CHECK_ERROR_CODE(file->read_raw(sizeof(storage::Page) * page_count, out));
+  read_page_count_ += page_count;
 #ifndef NDEBUG
   storage::Page* pages = reinterpret_cast<storage::Page*>(out);
   for (uint32_t i = 0; i < page_count; ++i) {
@@ -293,6 +293,73 @@ ErrorCode  DirectIoFile::write_raw(uint64_t desired_bytes, const void* buffer) {
   return kErrorCodeOk;
 }
 
+ErrorCode  DirectIoFile::write_raw_at(
+  uint64_t offset,
+  uint64_t desired_bytes,
+  const void* buffer) const {
+  if (!is_opened()) {
+    LOG(ERROR) << "File not opened yet, or closed. this=" << *this;
+    return kErrorCodeFsNotOpened;
+  } else if (desired_bytes == 0) {
+    return kErrorCodeOk;
+  } else if (!is_odirect_aligned(offset)) {
+    LOG(ERROR) << "DirectIoFile::write_raw_at(): non-aligned input is given. offset=" << offset;
+    return kErrorCodeFsBufferNotAligned;
+  }
+
+  if (emulation_.null_device_) {
+    return kErrorCodeOk;
+  }
+
+  VLOG(1) << "DirectIoFile::write_raw_at(). offset=" << offset << ", desired_bytes="
+    << desired_bytes << ", buffer=" << buffer;
+  uint64_t total_written = 0;
+  uint64_t remaining = desired_bytes;
+  while (remaining > 0) {
+    const void* position = reinterpret_cast<const char*>(buffer) + total_written;
+    ASSERT_ND(is_odirect_aligned(position));
+    ssize_t written_bytes = ::pwrite(descriptor_, position, remaining, offset + total_written);
+    if (written_bytes < 0) {
+      LOG(ERROR) << "DirectIoFile::write_raw_at(): error. this=" << *this
+        << ", offset=" << offset << ", total_written=" << total_written
+        << ", desired_bytes=" << desired_bytes << ", remaining=" << remaining
+        << ", written_bytes=" << written_bytes << ", err=" << assorted::os_error();
+      return kErrorCodeFsWriteFail;
+    }
+
+    if (static_cast<uint64_t>(written_bytes) > remaining) {
+      LOG(ERROR) << "DirectIoFile::write_raw_at(): wtf? this=" << *this
+        << ", offset=" << offset << ", total_written=" << total_written
+        << ", desired_bytes=" << desired_bytes << ", remaining=" << remaining
+        << ", written_bytes=" << written_bytes << ", err=" << assorted::os_error();
+      return kErrorCodeFsExcessWrite;
+    } else if (!emulation_.disable_direct_io_ && !is_odirect_aligned(written_bytes)) {
+      LOG(FATAL) << "DirectIoFile::write_raw_at(): wtf2? this=" << *this
+        << ", offset=" << offset << ", total_written=" << total_written
+        << ", desired_bytes=" << desired_bytes << ", remaining=" << remaining
+        << ", written_bytes=" << written_bytes << ", err=" << assorted::os_error();
+      return kErrorCodeFsResultNotAligned;
+    }
+
+    total_written += written_bytes;
+    remaining -= written_bytes;
+  }
+  if (emulation_.emulated_write_kb_cycles_ > 0) {
+    debugging::wait_rdtsc_cycles(emulation_.emulated_write_kb_cycles_ * (desired_bytes >> 10));
+  }
+  return kErrorCodeOk;
+}
+
+uint64_t DirectIoFile::reserve_region(uint64_t bytes) {
+  ASSERT_ND(is_odirect_aligned(bytes));
+  const uint64_t ret = current_offset_;
+  if (!emulation_.null_device_) {
+    // same as write_raw(), which doesn't advance the position on null device
+    current_offset_ += bytes;
+  }
+  return ret;
+}
+
 ErrorCode  DirectIoFile::truncate(uint64_t new_length, bool sync) {
   if (!is_odirect_aligned(new_length)) {
     LOG(ERROR) << "DirectIoFile::truncate(): non-aligned input is given. "
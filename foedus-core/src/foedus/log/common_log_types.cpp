@@ -21,6 +21,7 @@
 
 #include "foedus/engine.hpp"
 #include "foedus/assorted/assorted_func.hpp"
+#include "foedus/log/log_compressor.hpp"
 #include "foedus/log/log_manager.hpp"
 #include "foedus/log/log_type.hpp"
 #include "foedus/log/logger_impl.hpp"
@@ -39,6 +40,14 @@ std::ostream& operator<<(std::ostream& o, const FillerLogType &v) {
   return o;
 }
 
+std::ostream& operator<<(std::ostream& o, const CompressedBlockLogType &v) {
+  o << "<CompressedBlockLog>" << v.header_
+    << "<uncompressed_length_>" << v.uncompressed_length_ << "</uncompressed_length_>"
+    << "<compressed_length_>" << v.compressed_length_ << "</compressed_length_>"
+    << "</CompressedBlockLog>";
+  return o;
+}
+
 std::ostream& operator<<(std::ostream& o, const EpochMarkerLogType& v) {
   o << "<EpochMarker>" << v.header_
     << "<old_epoch_>" << v.old_epoch_ << "</old_epoch_>"
@@ -81,5 +90,24 @@ void FillerLogType::populate(uint64_t size) {
   header_.log_type_code_ = get_log_code<FillerLogType>();
 }
 
+void CompressedBlockLogType::populate(uint32_t uncompressed_length, uint32_t compressed_length) {
+  ASSERT_ND(uncompressed_length <= kMaxUncompressedLength);
+  header_.storage_id_ = 0;
+  header_.log_length_ = calculate_log_length(compressed_length);
+  header_.log_type_code_ = get_log_code<CompressedBlockLogType>();
+  header_.xct_id_ = xct::XctId();
+  uncompressed_length_ = uncompressed_length;
+  compressed_length_ = compressed_length;
+  assert_valid();
+}
+
+ErrorCode CompressedBlockLogType::decompress(char* buffer) const {
+  assert_valid();
+  if (!decompress_log_block(data_, compressed_length_, buffer, uncompressed_length_)) {
+    return kErrorCodeLogCorruptedCompressedBlock;
+  }
+  return kErrorCodeOk;
+}
+
 }  // namespace log
 }  // namespace foedus
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include "foedus/log/log_compressor.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "foedus/assert_nd.hpp"
+
+namespace foedus {
+namespace log {
+
+/** Shortest match we encode. Shorter ones are cheaper as literals. */
+const uint32_t kMinMatch = 4;
+/** Bits of the hash table that remembers the last position of each 4-byte sequence. */
+const uint32_t kHashBits = 12;
+/** Match offsets are stored in 2 bytes. */
+const uint32_t kMaxOffset = 0xFFFF;
+/** Literal/match lengths in the token. This value means an extended length follows. */
+const uint32_t kTokenLengthMask = 0x0F;
+
+inline uint32_t read_sequence(const uint8_t* address) {
+  uint32_t ret;
+  std::memcpy(&ret, address, sizeof(ret));
+  return ret;
+}
+
+inline uint32_t hash_sequence(uint32_t sequence) {
+  return (sequence * 2654435761U) >> (32U - kHashBits);
+}
+
+/** Writes the rest of a length that didn't fit in the token. Returns nullptr if overflows. */
+inline uint8_t* write_extended_length(uint32_t length, uint8_t* out, const uint8_t* out_end) {
+  for (; length >= 0xFFU; length -= 0xFFU) {
+    if (out >= out_end) {
+      return nullptr;
+    }
+    *out = 0xFFU;
+    ++out;
+  }
+  if (out >= out_end) {
+    return nullptr;
+  }
+  *out = static_cast<uint8_t>(length);
+  return out + 1;
+}
+
+/** Reads the rest of a length that didn't fit in the token. Returns false if corrupted. */
+inline bool read_extended_length(const uint8_t** in, const uint8_t* in_end, uint32_t* length) {
+  while (true) {
+    if (*in >= in_end) {
+      return false;
+    }
+    uint8_t byte = **in;
+    ++(*in);
+    *length += byte;
+    if (byte != 0xFFU) {
+      return true;
+    }
+  }
+}
+
+/**
+ * Writes one sequence of literals followed by a match.
+ * match_length==0 means the last sequence, which has only literals.
+ * Returns nullptr if the output overflows.
+ */
+inline uint8_t* write_sequence(
+  const uint8_t* literals,
+  uint32_t literal_length,
+  uint32_t match_offset,
+  uint32_t match_length,
+  uint8_t* out,
+  const uint8_t* out_end) {
+  if (out >= out_end) {
+    return nullptr;
+  }
+  uint8_t* token = out;
+  ++out;
+  const uint32_t literal_code = std::min(literal_length, kTokenLengthMask);
+  uint32_t match_code = 0;
+  if (match_length > 0) {
+    ASSERT_ND(match_length >= kMinMatch);
+    match_code = std::min(match_length - kMinMatch, kTokenLengthMask);
+  }
+  *token = static_cast<uint8_t>((literal_code << 4) | match_code);
+  if (literal_code == kTokenLengthMask) {
+    out = write_extended_length(literal_length - kTokenLengthMask, out, out_end);
+    if (out == nullptr) {
+      return nullptr;
+    }
+  }
+  if (static_cast<uint64_t>(out_end - out) < literal_length) {
+    return nullptr;
+  }
+  std::memcpy(out, literals, literal_length);
+  out += literal_length;
+
+  if (match_length > 0) {
+    ASSERT_ND(match_offset > 0 && match_offset <= kMaxOffset);
+    if (out_end - out < 2) {
+      return nullptr;
+    }
+    out[0] = static_cast<uint8_t>(match_offset);
+    out[1] = static_cast<uint8_t>(match_offset >> 8);
+    out += 2;
+    if (match_code == kTokenLengthMask) {
+      out = write_extended_length(match_length - kMinMatch - kTokenLengthMask, out, out_end);
+    }
+  }
+  return out;
+}
+
+uint32_t compress_log_block(
+  const char* src,
+  uint32_t src_size,
+  char* dest,
+  uint32_t dest_capacity) {
+  ASSERT_ND(src_size <= kMaxOffset + 1U);
+  const uint8_t* const base = reinterpret_cast<const uint8_t*>(src);
+  const uint8_t* const end = base + src_size;
+  const uint8_t* in = base;
+  const uint8_t* anchor = base;  // beginning of literals not yet written
+  uint8_t* out = reinterpret_cast<uint8_t*>(dest);
+  const uint8_t* const out_end = out + dest_capacity;
+
+  if (src_size >= kMinMatch) {
+    uint32_t table[1U << kHashBits];
+    std::memset(table, 0, sizeof(table));
+    const uint8_t* const match_limit = end - kMinMatch;
+    uint32_t misses = 0;
+    while (in <= match_limit) {
+      const uint32_t sequence = read_sequence(in);
+      const uint32_t hash = hash_sequence(sequence);
+      const uint8_t* candidate = base + table[hash];
+      table[hash] = in - base;
+      if (candidate < in
+        && static_cast<uint32_t>(in - candidate) <= kMaxOffset
+        && read_sequence(candidate) == sequence) {
+        const uint8_t* match_end = in + kMinMatch;
+        const uint8_t* candidate_end = candidate + kMinMatch;
+        while (match_end < end && *match_end == *candidate_end) {
+          ++match_end;
+          ++candidate_end;
+        }
+        out = write_sequence(anchor, in - anchor, in - candidate, match_end - in, out, out_end);
+        if (out == nullptr) {
+          return 0;
+        }
+        in = match_end;
+        anchor = in;
+        misses = 0;
+      } else {
+        // skip faster on incompressible regions, like LZ4 does.
+        ++misses;
+        in += 1U + (misses >> 5);
+      }
+    }
+  }
+
+  out = write_sequence(anchor, end - anchor, 0, 0, out, out_end);
+  if (out == nullptr) {
+    return 0;
+  }
+  return out - reinterpret_cast<uint8_t*>(dest);
+}
+
+bool decompress_log_block(
+  const char* src,
+  uint32_t src_size,
+  char* dest,
+  uint32_t dest_size) {
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+  const uint8_t* const in_end = in + src_size;
+  uint8_t* const out_begin = reinterpret_cast<uint8_t*>(dest);
+  uint8_t* out = out_begin;
+  const uint8_t* const out_end = out + dest_size;
+  while (in < in_end) {
+    const uint8_t token = *in;
+    ++in;
+    uint32_t literal_length = token >> 4;
+    if (literal_length == kTokenLengthMask
+      && !read_extended_length(&in, in_end, &literal_length)) {
+      return false;
+    }
+    if (static_cast<uint64_t>(in_end - in) < literal_length
+      || static_cast<uint64_t>(out_end - out) < literal_length) {
+      return false;
+    }
+    std::memcpy(out, in, literal_length);
+    in += literal_length;
+    out += literal_length;
+    if (in == in_end) {
+      break;  // the last sequence
+    }
+
+    if (in_end - in < 2) {
+      return false;
+    }
+    const uint32_t match_offset = in[0] | (static_cast<uint32_t>(in[1]) << 8);
+    in += 2;
+    if (match_offset == 0 || match_offset > static_cast<uint64_t>(out - out_begin)) {
+      return false;
+    }
+    uint32_t match_length = token & kTokenLengthMask;
+    if (match_length == kTokenLengthMask
+      && !read_extended_length(&in, in_end, &match_length)) {
+      return false;
+    }
+    match_length += kMinMatch;
+    if (static_cast<uint64_t>(out_end - out) < match_length) {
+      return false;
+    }
+    const uint8_t* match = out - match_offset;
+    if (match_offset >= match_length) {
+      std::memcpy(out, match, match_length);
+      out += match_length;
+    } else {
+      // overlapping match, which repeats the last match_offset bytes.
+      for (uint32_t i = 0; i < match_length; ++i) {
+        *out = *match;
+        ++out;
+        ++match;
+      }
+    }
+  }
+  return out == out_end;
+}
+
+}  // namespace log
+}  // namespace foedus
@@ -31,6 +31,8 @@ LogOptions::LogOptions() {
   log_buffer_kb_ = kDefaultLogBufferKb;
   log_file_size_mb_ = kDefaultLogSizeMb;
   flush_at_shutdown_ = true;
+  compress_logs_ = false;
+  writers_per_logger_ = 0;
 }
 
 std::string LogOptions::convert_folder_path_pattern(int node, int logger) const {
@@ -58,6 +60,8 @@ ErrorStack LogOptions::load(tinyxml2::XMLElement* element) {
   EXTERNALIZE_LOAD_ELEMENT(element, log_buffer_kb_);
   EXTERNALIZE_LOAD_ELEMENT(element, log_file_size_mb_);
   EXTERNALIZE_LOAD_ELEMENT(element, flush_at_shutdown_);
+  EXTERNALIZE_LOAD_ELEMENT(element, compress_logs_);
+  EXTERNALIZE_LOAD_ELEMENT(element, writers_per_logger_);
   CHECK_ERROR(get_child_element(element, "LogDeviceEmulationOptions", &emulation_))
   return kRetOk;
 }
@@ -87,6 +91,13 @@ ErrorStack LogOptions::save(tinyxml2::XMLElement* element) const {
   EXTERNALIZE_SAVE_ELEMENT(element, log_file_size_mb_, "Size in MB of files loggers write out");
   EXTERNALIZE_SAVE_ELEMENT(element, flush_at_shutdown_,
       "Whether to flush transaction logs and take savepoint when uninitialize() is called");
+  EXTERNALIZE_SAVE_ELEMENT(element, compress_logs_,
+      "Whether loggers compress logs before writing them out. This reduces the bandwidth"
+      " to the log device at the cost of CPU in loggers.");
+  EXTERNALIZE_SAVE_ELEMENT(element, writers_per_logger_,
+      "Number of helper threads per logger that write out logs in parallel."
+      " 0 (default) means each logger sequentially writes out logs by itself."
+      " A larger value keeps multiple writes in flight, which helps to saturate NVMe SSDs.");
   CHECK_ERROR(add_child_element(element, "LogDeviceEmulationOptions",
           "[Experiments-only] Settings to emulate slower logging device", emulation_));
   return kRetOk;
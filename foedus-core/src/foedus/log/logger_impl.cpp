@@ -38,6 +38,7 @@
 #include "foedus/fs/direct_io_file.hpp"
 #include "foedus/fs/filesystem.hpp"
 #include "foedus/log/common_log_types.hpp"
+#include "foedus/log/log_compressor.hpp"
 #include "foedus/log/log_manager.hpp"
 #include "foedus/log/log_type.hpp"
 #include "foedus/log/thread_log_buffer.hpp"
@@ -75,6 +76,9 @@ ErrorStack Logger::initialize_once() {
   control_block_->initialize();
   // clear all variables
   current_file_ = nullptr;
+  writes_in_flight_ = 0;
+  write_error_ = kErrorCodeOk;
+  writer_stop_requested_ = false;
   LOG(INFO) << "Initializing Logger-" << id_ << ". assigned " << assigned_thread_ids_.size()
     << " threads, starting from " << assigned_thread_ids_[0] << ", numa_node_="
     << static_cast<int>(numa_node_);
@@ -94,9 +98,11 @@ ErrorStack Logger::initialize_once() {
     id_,
     control_block_->current_ordinal_);
   // open the log file
-  current_file_ = new fs::DirectIoFile(current_file_path_,
-                     engine_->get_options().log_.emulation_);
-  WRAP_ERROR_CODE(current_file_->open(true, true, true, true));
+  const uint16_t writers = engine_->get_options().log_.writers_per_logger_;
+  for (uint16_t i = 0; i < writers; ++i) {
+    writer_threads_.emplace_back(std::thread(&Logger::handle_writer, this));
+  }
+  CHECK_ERROR(open_current_file());
   if (control_block_->current_file_durable_offset_ < current_file_->get_current_offset()) {
     // there are non-durable regions as an incomplete remnant of previous execution.
     // probably there was a crash. in this case, we discard the non-durable regions.
@@ -124,6 +130,13 @@ ErrorStack Logger::initialize_once() {
   ASSERT_ND(fill_buffer_.get_size() >= FillerLogType::kLogWriteUnitSize);
   ASSERT_ND(fill_buffer_.get_alignment() >= FillerLogType::kLogWriteUnitSize);
   LOG(INFO) << "Logger-" << id_ << " grabbed a padding buffer. size=" << fill_buffer_.get_size();
+  if (engine_->get_options().log_.compress_logs_) {
+    CHECK_ERROR(engine_->get_memory_manager()->get_local_memory()->allocate_numa_memory(
+      kCompressBufferSize, &compress_buffer_));
+    ASSERT_ND(!compress_buffer_.is_null());
+    LOG(INFO) << "Logger-" << id_ << " grabbed a compression buffer. size="
+      << compress_buffer_.get_size();
+  }
   CHECK_ERROR(write_dummy_epoch_mark());
 
   // log file and buffer prepared. let's launch the logger thread
@@ -143,12 +156,25 @@ ErrorStack Logger::uninitialize_once() {
     }
     logger_thread_.join();
   }
+  if (!writer_threads_.empty()) {
+    {
+      std::lock_guard<std::mutex> guard(writer_mutex_);
+      ASSERT_ND(writes_in_flight_ == 0);
+      writer_stop_requested_ = true;
+    }
+    writer_wakeup_cond_.notify_all();
+    for (std::thread& writer : writer_threads_) {
+      writer.join();
+    }
+    writer_threads_.clear();
+  }
   if (current_file_) {
     current_file_->close();
     delete current_file_;
     current_file_ = nullptr;
   }
   fill_buffer_.release_block();
+  compress_buffer_.release_block();
   control_block_->uninitialize();
   return SUMMARIZE_ERROR_BATCH(batch);
 }
@@ -213,6 +239,98 @@ void Logger::handle_logger() {
   LOG(INFO) << "Logger-" << id_ << " ended. " << *this;
 }
 
+void Logger::handle_writer() {
+  thread::NumaThreadScope scope(numa_node_);
+  std::unique_lock<std::mutex> lock(writer_mutex_);
+  while (true) {
+    writer_wakeup_cond_.wait(lock, [this]{
+      return writer_stop_requested_ || !write_requests_.empty();
+    });
+    if (write_requests_.empty()) {
+      ASSERT_ND(writer_stop_requested_);
+      break;
+    }
+    WriteRequest request = write_requests_.front();
+    write_requests_.pop_front();
+    lock.unlock();
+    ErrorCode result = current_file_->write_raw_at(
+      request.offset_,
+      request.bytes_,
+      request.buffer_);
+    lock.lock();
+    if (result != kErrorCodeOk && write_error_ == kErrorCodeOk) {
+      write_error_ = result;
+    }
+    ASSERT_ND(writes_in_flight_ > 0);
+    --writes_in_flight_;
+    if (writes_in_flight_ == 0) {
+      writer_done_cond_.notify_all();
+    }
+  }
+}
+
+ErrorStack Logger::open_current_file() {
+  ASSERT_ND(current_file_ == nullptr);
+  current_file_ = new fs::DirectIoFile(current_file_path_,
+                     engine_->get_options().log_.emulation_);
+  if (writer_threads_.empty()) {
+    WRAP_ERROR_CODE(current_file_->open(true, true, true, true));
+  } else {
+    // pwrite() ignores the offset in append mode. Instead, we start from the end by ourselves.
+    WRAP_ERROR_CODE(current_file_->open(true, true, false, true));
+    WRAP_ERROR_CODE(current_file_->seek(0, fs::DirectIoFile::kDirectIoSeekEnd));
+  }
+  return kRetOk;
+}
+
+ErrorStack Logger::write_to_file(const void* buffer, uint64_t bytes, bool asynchronous) {
+  ASSERT_ND(is_log_aligned(bytes));
+  if (writer_threads_.empty()) {
+    WRAP_ERROR_CODE(current_file_->write_raw(bytes, buffer));
+    return kRetOk;
+  }
+
+  const uint64_t offset = current_file_->reserve_region(bytes);
+  if (!asynchronous) {
+    WRAP_ERROR_CODE(current_file_->write_raw_at(offset, bytes, buffer));
+    return kRetOk;
+  }
+
+  const char* position = reinterpret_cast<const char*>(buffer);
+  uint32_t requests = 0;
+  {
+    std::lock_guard<std::mutex> guard(writer_mutex_);
+    for (uint64_t cur = 0; cur < bytes; cur += kMaxAsyncWriteSize) {
+      WriteRequest request;
+      request.offset_ = offset + cur;
+      request.bytes_ = std::min<uint64_t>(bytes - cur, kMaxAsyncWriteSize);
+      request.buffer_ = position + cur;
+      write_requests_.push_back(request);
+      ++writes_in_flight_;
+      ++requests;
+    }
+  }
+  if (requests == 1U) {
+    writer_wakeup_cond_.notify_one();
+  } else {
+    writer_wakeup_cond_.notify_all();
+  }
+  return kRetOk;
+}
+
+ErrorStack Logger::wait_for_writes() {
+  if (writer_threads_.empty()) {
+    return kRetOk;
+  }
+  std::unique_lock<std::mutex> lock(writer_mutex_);
+  writer_done_cond_.wait(lock, [this]{ return writes_in_flight_ == 0; });
+  ErrorCode result = write_error_;
+  write_error_ = kErrorCodeOk;
+  lock.unlock();
+  WRAP_ERROR_CODE(result);
+  return kRetOk;
+}
+
 ErrorStack Logger::update_durable_epoch(Epoch new_durable_epoch, bool had_any_log) {
   DVLOG(1) << "Checked all loggers. new_durable_epoch=" << new_durable_epoch;
   if (had_any_log) {
@@ -284,7 +402,7 @@ ErrorStack Logger::log_epoch_switch(Epoch new_epoch) {
     + sizeof(EpochMarkerLogType));
   filler_log->populate(fill_buffer_.get_size() - sizeof(EpochMarkerLogType));
 
-  WRAP_ERROR_CODE(current_file_->write(fill_buffer_.get_size(), fill_buffer_));
+  CHECK_ERROR(write_to_file(fill_buffer_.get_block(), fill_buffer_.get_size(), false));
   control_block_->marked_epoch_ = new_epoch;
   add_epoch_history(*epoch_marker);
 
@@ -315,9 +433,7 @@ ErrorStack Logger::switch_file_if_required() {
     id_,
     ++control_block_->current_ordinal_);
   LOG(INFO) << "Logger-" << id_ << " next file=" << current_file_path_;
-  current_file_ = new fs::DirectIoFile(current_file_path_,
-                      engine_->get_options().log_.emulation_);
-  WRAP_ERROR_CODE(current_file_->open(true, true, true, true));
+  CHECK_ERROR(open_current_file());
   ASSERT_ND(current_file_->get_current_offset() == 0);
   LOG(INFO) << "Logger-" << id_ << " moved on to next file. " << *this;
   CHECK_ERROR(write_dummy_epoch_mark());
@@ -328,6 +444,20 @@ ErrorStack Logger::write_one_epoch(Epoch write_epoch) {
   ASSERT_ND(get_durable_epoch().one_more() == write_epoch);
   ASSERT_ND(write_epoch.one_more() < engine_->get_xct_manager()->get_current_global_epoch());
   bool had_any_log = false;
+  ErrorStack write_result = write_one_epoch_buffers(write_epoch, &had_any_log);
+  // Writer threads might be still reading the buffers. Release them only after the writes.
+  // Even if we failed in the middle, we must wait for the writes already issued.
+  ErrorStack wait_result = wait_for_writes();
+  CHECK_ERROR(write_result);
+  CHECK_ERROR(wait_result);
+  for (thread::Thread* the_thread : assigned_threads_) {
+    the_thread->get_thread_log_buffer().on_log_written(write_epoch);
+  }
+  CHECK_ERROR(update_durable_epoch(write_epoch, had_any_log));
+  return kRetOk;
+}
+
+ErrorStack Logger::write_one_epoch_buffers(Epoch write_epoch, bool* had_any_log) {
   for (thread::Thread* the_thread : assigned_threads_) {
     ThreadLogBuffer& buffer = the_thread->get_thread_log_buffer();
     ThreadLogBuffer::OffsetRange range = buffer.get_logs_to_write(write_epoch);
@@ -342,11 +472,11 @@ ErrorStack Logger::write_one_epoch(Epoch write_epoch) {
     }
 
     if (!range.is_empty()) {
-      if (had_any_log == false) {
+      if (*had_any_log == false) {
         // First log for this epoch. Now we write out an epoch mark.
         // If no buffers have any logs, we don't even bother writing out an epoch mark.
         VLOG(1) << "Logger-" << id_ << " has a non-empty epoch-" << write_epoch;
-        had_any_log = true;
+        *had_any_log = true;
         CHECK_ERROR(log_epoch_switch(write_epoch));
       }
 
@@ -365,9 +495,7 @@ ErrorStack Logger::write_one_epoch(Epoch write_epoch) {
         CHECK_ERROR(write_one_epoch_piece(buffer, write_epoch, 0, range.end_));
       }
     }
-    buffer.on_log_written(write_epoch);
   }
-  CHECK_ERROR(update_durable_epoch(write_epoch, had_any_log));
   return kRetOk;
 }
 
@@ -388,6 +516,9 @@ ErrorStack Logger::write_one_epoch_piece(
 
   const char* raw_buffer = buffer.get_buffer();
   assert_written_logs(write_epoch, raw_buffer + from_offset, upto_offset - from_offset);
+  if (!compress_buffer_.is_null()) {
+    return write_one_epoch_piece_compressed(raw_buffer + from_offset, upto_offset - from_offset);
+  }
 
   // 1) First-4kb. Do we have to pad at the beginning?
   if (!is_log_aligned(from_offset)) {
@@ -424,7 +555,7 @@ ErrorStack Logger::write_one_epoch_piece(
       FillerLogType* end_filler_log = reinterpret_cast<FillerLogType*>(buf);
       end_filler_log->populate(end_fill_size);
     }
-    WRAP_ERROR_CODE(current_file_->write(FillerLogType::kLogWriteUnitSize, fill_buffer_));
+    CHECK_ERROR(write_to_file(fill_buffer_.get_block(), FillerLogType::kLogWriteUnitSize, false));
     from_offset += copy_size;
   }
 
@@ -441,7 +572,7 @@ ErrorStack Logger::write_one_epoch_piece(
   if (middle_size > 0) {
     // debugging::StopWatch watch;
     VLOG(1) << "Writing middle regions: " << middle_size << " bytes from " << from_offset;
-    WRAP_ERROR_CODE(current_file_->write_raw(middle_size, raw_buffer + from_offset));
+    CHECK_ERROR(write_to_file(raw_buffer + from_offset, middle_size, true));
     // watch.stop();
     // mm, in fact too noisy... Maybe VLOG(0). but we need this information for the paper
     // LOG(INFO) << "Wrote middle regions of " << middle_size << " bytes in "
@@ -472,7 +603,85 @@ ErrorStack Logger::write_one_epoch_piece(
   FillerLogType* filler_log = reinterpret_cast<FillerLogType*>(buf);
   filler_log->populate(fill_size);
 
-  WRAP_ERROR_CODE(current_file_->write(FillerLogType::kLogWriteUnitSize, fill_buffer_));
+  CHECK_ERROR(write_to_file(fill_buffer_.get_block(), FillerLogType::kLogWriteUnitSize, false));
+  return kRetOk;
+}
+
+ErrorStack Logger::write_one_epoch_piece_compressed(const char* logs, uint64_t bytes) {
+  char* const out = reinterpret_cast<char*>(compress_buffer_.get_block());
+  const uint64_t out_capacity = compress_buffer_.get_size();
+  // what we write per iteration is at most one log (64kb) or one block. plus the last filler.
+  const uint64_t flush_threshold = out_capacity - (1U << 16) - FillerLogType::kLogWriteUnitSize;
+  const uint32_t block_header_size = sizeof(CompressedBlockLogType) - 8U;
+  uint64_t written = 0;
+  uint64_t written_total = 0;
+  for (uint64_t cur = 0; cur < bytes;) {
+    // Take as many whole logs as possible in one block
+    uint32_t block_size = 0;
+    while (cur + block_size < bytes) {
+      const LogHeader* header = reinterpret_cast<const LogHeader*>(logs + cur + block_size);
+      ASSERT_ND(header->log_length_ > 0);
+      if (block_size + header->log_length_ > CompressedBlockLogType::kMaxUncompressedLength) {
+        break;
+      }
+      block_size += header->log_length_;
+    }
+
+    if (block_size == 0) {
+      // a log larger than a block. this is rare. write it as it is.
+      block_size = reinterpret_cast<const LogHeader*>(logs + cur)->log_length_;
+      std::memcpy(out + written, logs + cur, block_size);
+      written += block_size;
+    } else {
+      // The compressed block must be smaller than the original logs. Otherwise, write them as is.
+      CompressedBlockLogType* block = reinterpret_cast<CompressedBlockLogType*>(out + written);
+      uint32_t compressed_size = 0;
+      if (block_size > block_header_size + 8U) {
+        compressed_size = compress_log_block(
+          logs + cur,
+          block_size,
+          block->data_,
+          block_size - block_header_size - 8U);
+      }
+      if (compressed_size > 0) {
+        block->populate(block_size, compressed_size);
+        ASSERT_ND(block->header_.log_length_ < block_size);
+        written += block->header_.log_length_;
+      } else {
+        std::memcpy(out + written, logs + cur, block_size);
+        written += block_size;
+      }
+    }
+    cur += block_size;
+    ASSERT_ND(cur <= bytes);
+
+    if (written >= flush_threshold) {
+      CHECK_ERROR(flush_compress_buffer(written));
+      written_total += written;
+      written = 0;
+    }
+  }
+
+  if (written > 0) {
+    CHECK_ERROR(flush_compress_buffer(written));
+    written_total += written;
+  }
+  VLOG(1) << "Logger-" << id_ << " compressed " << bytes << " bytes of logs into "
+    << written_total << " bytes";
+  return kRetOk;
+}
+
+ErrorStack Logger::flush_compress_buffer(uint64_t written) {
+  ASSERT_ND(written > 0);
+  ASSERT_ND(written % 8 == 0);
+  char* const out = reinterpret_cast<char*>(compress_buffer_.get_block());
+  const uint64_t aligned = align_log_ceil(written);
+  ASSERT_ND(aligned <= compress_buffer_.get_size());
+  if (aligned > written) {
+    FillerLogType* filler_log = reinterpret_cast<FillerLogType*>(out + written);
+    filler_log->populate(aligned - written);
+  }
+  CHECK_ERROR(write_to_file(compress_buffer_.get_block(), aligned, false));
   return kRetOk;
 }
 
@@ -31,6 +31,7 @@ MemoryOptions::MemoryOptions() {
   rigorous_page_boundary_check_ = false;
   page_pool_size_mb_per_node_ = kDefaultPagePoolSizeMbPerNode;
   private_page_pool_initial_grab_ = PagePoolOffsetChunk::kMaxSize / 2;
+  page_pool_free_pool_shards_ = 1;
 }
 
 ErrorStack MemoryOptions::load(tinyxml2::XMLElement* element) {
@@ -42,6 +43,7 @@ ErrorStack MemoryOptions::load(tinyxml2::XMLElement* element) {
   EXTERNALIZE_LOAD_ELEMENT(element, rigorous_page_boundary_check_);
   EXTERNALIZE_LOAD_ELEMENT(element, page_pool_size_mb_per_node_);
   EXTERNALIZE_LOAD_ELEMENT(element, private_page_pool_initial_grab_);
+  EXTERNALIZE_LOAD_ELEMENT(element, page_pool_free_pool_shards_);
   return kRetOk;
 }
 
@@ -78,6 +80,10 @@ ErrorStack MemoryOptions::save(tinyxml2::XMLElement* element) const {
     " Default is 50% of PagePoolOffsetChunk::kMaxSize\n"
     " Obviously, private_page_pool_initial_grab_ * kPageSize * number-of-threads must be"
     " within page_pool_size_mb_per_node_ to start up the engine.");
+  EXTERNALIZE_SAVE_ELEMENT(element, page_pool_free_pool_shards_,
+    "Number of shards the free pool of each volatile/snapshot page pool is split into.\n"
+    " Each shard has its own lock. Default is 1. Increase it only if the pool lock shows up\n"
+    " in profiles. Must be between 1 and 16.");
   return kRetOk;
 }
 
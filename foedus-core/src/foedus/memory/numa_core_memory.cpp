@@ -30,6 +30,7 @@
 #include "foedus/thread/thread_pimpl.hpp"
 #include "foedus/xct/retrospective_lock_list.hpp"
 #include "foedus/xct/sysxct_impl.hpp"
+#include "foedus/xct/write_set_index.hpp"
 #include "foedus/xct/xct_access.hpp"
 #include "foedus/xct/xct_id.hpp"
 #include "foedus/xct/xct_options.hpp"
@@ -71,6 +72,8 @@ uint64_t NumaCoreMemory::calculate_local_small_memory_size(const EngineOptions&
   const uint16_t nodes = options.thread_.group_count_;
   memory_size += sizeof(xct::ReadXctAccess) * xct_opt.max_read_set_size_;
   memory_size += sizeof(xct::WriteXctAccess) * xct_opt.max_write_set_size_;
+  memory_size += sizeof(xct::WriteSetIndexSlot)
+    * xct::WriteSetIndex::calculate_capacity(xct_opt.max_write_set_size_);
   memory_size += sizeof(xct::LockFreeReadXctAccess)
     * xct_opt.max_lock_free_read_set_size_;
   memory_size += sizeof(xct::LockFreeWriteXctAccess)
@@ -120,6 +123,9 @@ ErrorStack NumaCoreMemory::initialize_once() {
   memory += sizeof(xct::ReadXctAccess) * xct_opt.max_read_set_size_;
   small_thread_local_memory_pieces_.xct_write_access_memory_ = memory;
   memory += sizeof(xct::WriteXctAccess) * xct_opt.max_write_set_size_;
+  small_thread_local_memory_pieces_.xct_write_set_index_memory_ = memory;
+  memory += sizeof(xct::WriteSetIndexSlot)
+    * xct::WriteSetIndex::calculate_capacity(xct_opt.max_write_set_size_);
   small_thread_local_memory_pieces_.xct_lock_free_read_access_memory_ = memory;
   memory += sizeof(xct::LockFreeReadXctAccess) * xct_opt.max_lock_free_read_set_size_;
   small_thread_local_memory_pieces_.xct_lock_free_write_access_memory_ = memory;
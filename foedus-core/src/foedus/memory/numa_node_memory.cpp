@@ -68,7 +68,8 @@ ErrorStack NumaNodeMemory::initialize_once() {
     memory_repo->get_volatile_pool(numa_node_),
     volatile_size,
     true,
-    engine_->get_options().memory_.rigorous_page_boundary_check_);
+    engine_->get_options().memory_.rigorous_page_boundary_check_,
+    engine_->get_options().memory_.page_pool_free_pool_shards_);
   volatile_pool_.set_debug_pool_name(
     std::string("VolatilePool-")
     + std::to_string(static_cast<int>(numa_node_)));
@@ -89,7 +90,8 @@ ErrorStack NumaNodeMemory::initialize_once() {
     snapshot_pool_memory_.get_block(),
     snapshot_pool_memory_.get_size(),
     true,
-    engine_->get_options().memory_.rigorous_page_boundary_check_);
+    engine_->get_options().memory_.rigorous_page_boundary_check_,
+    engine_->get_options().memory_.page_pool_free_pool_shards_);
   snapshot_pool_.set_debug_pool_name(
     std::string("SnapshotPool-")
     + std::to_string(static_cast<int>(numa_node_)));
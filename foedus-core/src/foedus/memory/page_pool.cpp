@@ -103,8 +103,15 @@ void PagePool::attach(
   void* memory,
   uint64_t memory_size,
   bool owns,
-  bool rigorous_page_boundary_check) {
-  pimpl_->attach(control_block, memory, memory_size, owns, rigorous_page_boundary_check);
+  bool rigorous_page_boundary_check,
+  uint16_t free_pool_shards) {
+  pimpl_->attach(
+    control_block,
+    memory,
+    memory_size,
+    owns,
+    rigorous_page_boundary_check,
+    free_pool_shards);
 }
 PagePool::~PagePool() {
   delete pimpl_;
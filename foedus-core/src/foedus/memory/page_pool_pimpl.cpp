@@ -17,6 +17,7 @@
  */
 #include "foedus/memory/page_pool_pimpl.hpp"
 
+#include <sched.h>
 #include <glog/logging.h>
 
 #include <algorithm>
@@ -42,14 +43,16 @@ PagePoolPimpl::PagePoolPimpl()
     memory_(nullptr),
     memory_size_(0),
     owns_(false),
-    rigorous_page_boundary_check_(false) {}
+    rigorous_page_boundary_check_(false),
+    free_pool_shards_(1) {}
 
 void PagePoolPimpl::attach(
   PagePoolControlBlock* control_block,
   void* memory,
   uint64_t memory_size,
   bool owns,
-  bool rigorous_page_boundary_check) {
+  bool rigorous_page_boundary_check,
+  uint16_t free_pool_shards) {
   control_block_ = control_block;
   if (owns) {
     control_block_->debug_pool_name_.clear();
@@ -58,6 +61,9 @@ void PagePoolPimpl::attach(
   memory_size_ = memory_size;
   owns_ = owns;
   rigorous_page_boundary_check_ = rigorous_page_boundary_check;
+  free_pool_shards_ = std::max<uint16_t>(
+    1U,
+    std::min<uint16_t>(free_pool_shards, PagePoolControlBlock::kMaxFreePoolShards));
   pool_base_ = reinterpret_cast<storage::Page*>(memory_);
   pool_size_ = memory_size_ / storage::kPageSize;
 
@@ -76,7 +82,9 @@ ErrorStack PagePoolPimpl::initialize_once() {
   if (owns_) {
     LOG(INFO) << get_debug_pool_name()
       << " - total_pages=" << pool_size_ << ", pages_for_free_pool_=" << pages_for_free_pool_
-      << ", boundary_check=" << rigorous_page_boundary_check_;
+      << ", boundary_check=" << rigorous_page_boundary_check_
+      << ", free_pool_shards=" << free_pool_shards_;
+    control_block_->free_pool_shards_ = free_pool_shards_;
     control_block_->initialize();
     LOG(INFO) << get_debug_pool_name() << " - Constructing circular free pool...";
     // all pages after pages_for_free_pool_-th page is in the free pool at first
@@ -140,10 +148,16 @@ ErrorStack PagePoolPimpl::initialize_once() {
     }
     */
 
-    control_block_->free_pool_head_ = 0;
-    control_block_->free_pool_count_ = free_pool_capacity_;
+    // each shard receives a contiguous range of the free pool, which is initially full
+    for (uint16_t i = 0; i < free_pool_shards_; ++i) {
+      PagePoolFreePoolShard* shard = get_shard(i);
+      shard->begin_ = free_pool_capacity_ * i / free_pool_shards_;
+      shard->capacity_ = free_pool_capacity_ * (i + 1U) / free_pool_shards_ - shard->begin_;
+      shard->head_ = 0;
+      shard->count_ = shard->capacity_;
+    }
     LOG(INFO) << get_debug_pool_name() << " - Constructed circular free pool.";
-    assert_free_pool();
+    assert_free_pool_all();
   }
 
   return kRetOk;
@@ -151,7 +165,7 @@ ErrorStack PagePoolPimpl::initialize_once() {
 
 ErrorStack PagePoolPimpl::uninitialize_once() {
   if (owns_) {
-    assert_free_pool();
+    assert_free_pool_all();
     if (rigorous_page_boundary_check_) {
       LOG(INFO) << get_debug_pool_name() << " - releasing mprotect() odd-numbered pages...";
       debugging::StopWatch watch;
@@ -188,6 +202,55 @@ ErrorStack PagePoolPimpl::uninitialize_once() {
   return kRetOk;
 }
 
+uint16_t PagePoolPimpl::choose_home_shard() const {
+  const uint16_t shards = get_free_pool_shards();
+  if (shards <= 1U) {
+    return 0;
+  }
+  int cpu = ::sched_getcpu();
+  if (UNLIKELY(cpu < 0)) {
+    return 0;
+  }
+  return static_cast<uint16_t>(cpu % shards);
+}
+
+uint32_t PagePoolPimpl::grab_from_shard(
+  PagePoolFreePoolShard* shard,
+  uint32_t desired_grab_count,
+  PagePoolOffsetChunk* chunk) {
+  soc::SharedMutexScope guard(&shard->lock_);
+  if (shard->count_ == 0) {
+    return 0;
+  }
+
+  // grab from the head
+  assert_free_pool(shard);
+  uint64_t grab_count = std::min<uint64_t>(desired_grab_count, shard->count_);
+  const uint32_t grabbed = grab_count;
+  PagePoolOffset* base = free_pool_ + shard->begin_;
+  PagePoolOffset* head = base + shard->head_;
+  if (shard->head_ + grab_count > shard->capacity_) {
+    // wrap around
+    uint64_t wrap_count = shard->capacity_ - shard->head_;
+    chunk->push_back(head, head + wrap_count);
+    shard->head_ = 0;
+    ASSERT_ND(shard->count_ >= wrap_count);
+    shard->count_ -= wrap_count;
+    grab_count -= wrap_count;
+    head = base;
+  }
+
+  // no wrap around (or no more wrap around)
+  assert_free_pool(shard);
+  ASSERT_ND(shard->head_ + grab_count <= shard->capacity_);
+  chunk->push_back(head, head + grab_count);
+  shard->head_ += grab_count;
+  ASSERT_ND(shard->count_ >= grab_count);
+  shard->count_ -= grab_count;
+  assert_free_pool(shard);
+  return grabbed;
+}
+
 ErrorCode PagePoolPimpl::grab(uint32_t desired_grab_count, PagePoolOffsetChunk* chunk) {
   ASSERT_ND(chunk->size() + desired_grab_count <= chunk->capacity());
   VLOG(0) << get_debug_pool_name() << " - Grabbing " << desired_grab_count << " pages."
@@ -196,34 +259,22 @@ ErrorCode PagePoolPimpl::grab(uint32_t desired_grab_count, PagePoolOffsetChunk*
     << (get_free_pool_count() >= desired_grab_count
       ? get_free_pool_count() - desired_grab_count
       : 0);
-  soc::SharedMutexScope guard(&control_block_->lock_);
-  uint64_t free_count = get_free_pool_count();
-  if (UNLIKELY(free_count == 0)) {
-    LOG(WARNING) << get_debug_pool_name() << " - No more free pages left in the pool";
-    return kErrorCodeMemoryNoFreePages;
+  // Start from the home shard, then steal from other shards only if it runs out.
+  const uint16_t shards = get_free_pool_shards();
+  const uint16_t home = choose_home_shard();
+  uint32_t remaining = desired_grab_count;
+  for (uint16_t i = 0; i < shards && remaining > 0; ++i) {
+    uint16_t index = home + i;
+    if (index >= shards) {
+      index -= shards;
+    }
+    remaining -= grab_from_shard(get_shard(index), remaining, chunk);
   }
 
-  // grab from the head
-  assert_free_pool();
-  uint64_t grab_count = std::min<uint64_t>(desired_grab_count, free_count);
-  PagePoolOffset* head = free_pool_ + free_pool_head();
-  if (free_pool_head() + grab_count > free_pool_capacity_) {
-    // wrap around
-    uint64_t wrap_count = free_pool_capacity_ - free_pool_head();
-    chunk->push_back(head, head + wrap_count);
-    free_pool_head() = 0;
-    decrease_free_pool_count(wrap_count);
-    grab_count -= wrap_count;
-    head = free_pool_;
+  if (UNLIKELY(remaining == desired_grab_count)) {
+    LOG(WARNING) << get_debug_pool_name() << " - No more free pages left in the pool";
+    return kErrorCodeMemoryNoFreePages;
   }
-
-  // no wrap around (or no more wrap around)
-  assert_free_pool();
-  ASSERT_ND(free_pool_head() + grab_count <= free_pool_capacity_);
-  chunk->push_back(head, head + grab_count);
-  free_pool_head() += grab_count;
-  decrease_free_pool_count(grab_count);
-  assert_free_pool();
   return kErrorCodeOk;
 }
 
@@ -232,27 +283,74 @@ ErrorCode PagePoolPimpl::grab_one(PagePoolOffset *offset) {
     << " - Grabbing just one page. free_pool_count_=" << get_free_pool_count() << "->"
     << (get_free_pool_count() - 1);
   *offset = 0;
-  soc::SharedMutexScope guard(&control_block_->lock_);
-  uint64_t free_count = get_free_pool_count();
-  if (UNLIKELY(free_count == 0)) {
-    LOG(WARNING) << get_debug_pool_name() << " - No more free pages left in the pool";
-    return kErrorCodeMemoryNoFreePages;
+  const uint16_t shards = get_free_pool_shards();
+  const uint16_t home = choose_home_shard();
+  for (uint16_t i = 0; i < shards; ++i) {
+    uint16_t index = home + i;
+    if (index >= shards) {
+      index -= shards;
+    }
+    PagePoolFreePoolShard* shard = get_shard(index);
+    soc::SharedMutexScope guard(&shard->lock_);
+    if (shard->count_ == 0) {
+      continue;
+    }
+
+    // grab from the head
+    if (shard->head_ == shard->capacity_) {
+      // wrap around
+      shard->head_ = 0;
+    }
+
+    // no wrap around (or no more wrap around)
+    ASSERT_ND(shard->head_ + 1 <= shard->capacity_);
+    *offset = free_pool_[shard->begin_ + shard->head_];
+    ++shard->head_;
+    --shard->count_;
+    return kErrorCodeOk;
   }
 
-  // grab from the head
-  PagePoolOffset* head = free_pool_ + free_pool_head();
-  if (free_pool_head() == free_pool_capacity_) {
+  LOG(WARNING) << get_debug_pool_name() << " - No more free pages left in the pool";
+  return kErrorCodeMemoryNoFreePages;
+}
+
+template <typename CHUNK>
+uint32_t PagePoolPimpl::release_to_shard(
+  PagePoolFreePoolShard* shard,
+  uint32_t desired_release_count,
+  CHUNK* chunk) {
+  soc::SharedMutexScope guard(&shard->lock_);
+  ASSERT_ND(shard->count_ <= shard->capacity_);
+  if (shard->count_ == shard->capacity_) {
+    return 0;
+  }
+
+  // append to the tail
+  assert_free_pool(shard);
+  uint64_t release_count = std::min<uint64_t>(
+    desired_release_count,
+    shard->capacity_ - shard->count_);
+  const uint32_t released = release_count;
+  PagePoolOffset* base = free_pool_ + shard->begin_;
+  uint64_t tail = shard->head_ + shard->count_;
+  if (tail >= shard->capacity_) {
+    tail -= shard->capacity_;
+  }
+  if (tail + release_count > shard->capacity_) {
     // wrap around
-    free_pool_head() = 0;
-    head = free_pool_;
+    uint32_t wrap_count = shard->capacity_ - tail;
+    chunk->move_to(base + tail, wrap_count);
+    shard->count_ += wrap_count;
+    release_count -= wrap_count;
+    tail = 0;
   }
 
   // no wrap around (or no more wrap around)
-  ASSERT_ND(free_pool_head() + 1 <= free_pool_capacity_);
-  *offset = *head;
-  ++free_pool_head();
-  decrease_free_pool_count(1);
-  return kErrorCodeOk;
+  ASSERT_ND(tail + release_count <= shard->capacity_);
+  chunk->move_to(base + tail, release_count);
+  shard->count_ += release_count;
+  assert_free_pool(shard);
+  return released;
 }
 
 template <typename CHUNK>
@@ -261,43 +359,28 @@ void PagePoolPimpl::release_impl(uint32_t desired_release_count, CHUNK* chunk) {
   VLOG(0) << get_debug_pool_name() << " - Releasing " << desired_release_count << " pages."
     << " free_pool_count_=" << get_free_pool_count() << "->"
     << (get_free_pool_count() + desired_release_count);
-  soc::SharedMutexScope guard(&control_block_->lock_);
-  uint64_t free_count = get_free_pool_count();
-  if (free_count + desired_release_count > free_pool_capacity_) {
+  // Return to the home shard, then to other shards only if it is full.
+  // We don't check the total free count beforehand. Summing up shards without their locks
+  // races with concurrent grabs/releases. Each shard checks its capacity under its lock.
+  const uint16_t shards = get_free_pool_shards();
+  const uint16_t home = choose_home_shard();
+  uint32_t remaining = std::min<uint64_t>(desired_release_count, chunk->size());
+  for (uint16_t i = 0; i < shards && remaining > 0; ++i) {
+    uint16_t index = home + i;
+    if (index >= shards) {
+      index -= shards;
+    }
+    remaining -= release_to_shard<CHUNK>(get_shard(index), remaining, chunk);
+  }
+  if (UNLIKELY(remaining > 0)) {
     // this can't happen unless something is wrong! This is a critical issue from which
     // we can't recover because page pool is inconsistent!
     LOG(ERROR) << get_debug_pool_name()
       << " - PagePoolPimpl::release() More than full free-pool. inconsistent state!"
-        << " free_count/capacity/release_count=" << free_count << "/" << free_pool_capacity_
-          << "/" << desired_release_count;
+      << " capacity/release_count=" << free_pool_capacity_ << "/" << desired_release_count
+      << ". Could not release " << remaining << " pages.";
     // TASK(Hideaki) Do a duplicate-check here to identify the problemetic pages.
-    // crash here only in debug mode. otherwise just log the error
-    // ASSERT_ND(free_count + desired_release_count <= free_pool_capacity_);
-    // TASK(Hideaki) need to figure out why we hit this.
-    return;
-  }
-
-  // append to the tail
-  assert_free_pool();
-  uint64_t release_count = std::min<uint64_t>(desired_release_count, chunk->size());
-  uint64_t tail = free_pool_head() + free_count;
-  if (tail >= free_pool_capacity_) {
-    tail -= free_pool_capacity_;
-  }
-  if (tail + release_count > free_pool_capacity_) {
-    // wrap around
-    uint32_t wrap_count = free_pool_capacity_ - tail;
-    chunk->move_to(free_pool_ + tail, wrap_count);
-    increase_free_pool_count(wrap_count);
-    release_count -= wrap_count;
-    tail = 0;
   }
-
-  // no wrap around (or no more wrap around)
-  ASSERT_ND(tail + release_count <= free_pool_capacity_);
-  chunk->move_to(free_pool_ + tail, release_count);
-  increase_free_pool_count(release_count);
-  assert_free_pool();
 }
 void PagePoolPimpl::release(uint32_t desired_release_count, PagePoolOffsetChunk* chunk) {
   release_impl<PagePoolOffsetChunk>(desired_release_count, chunk);
@@ -313,30 +396,37 @@ void PagePoolPimpl::release_one(PagePoolOffset offset) {
   ASSERT_ND(is_initialized() || !owns_);
   VLOG(1) << get_debug_pool_name() << " - Releasing just one page. free_pool_count_="
     << get_free_pool_count() << "->" << (get_free_pool_count() + 1);
-  soc::SharedMutexScope guard(&control_block_->lock_);
-  uint64_t free_count = get_free_pool_count();
-  if (free_count >= free_pool_capacity_) {
-    // this can't happen unless something is wrong! This is a critical issue from which
-    // we can't recover because page pool is inconsistent!
-    LOG(ERROR) << get_debug_pool_name()
-      << " - PagePoolPimpl::release_one() More than full free-pool. inconsistent state!";
-    COERCE_ERROR(ERROR_STACK(kErrorCodeMemoryDuplicatePage));
-  }
+  const uint16_t shards = get_free_pool_shards();
+  const uint16_t home = choose_home_shard();
+  for (uint16_t i = 0; i < shards; ++i) {
+    uint16_t index = home + i;
+    if (index >= shards) {
+      index -= shards;
+    }
+    PagePoolFreePoolShard* shard = get_shard(index);
+    soc::SharedMutexScope guard(&shard->lock_);
+    if (shard->count_ >= shard->capacity_) {
+      continue;
+    }
 
-  // append to the tail
-  uint64_t tail = free_pool_head() + free_count;
-  if (tail >= free_pool_capacity_) {
-    tail -= free_pool_capacity_;
-  }
-  if (tail == free_pool_capacity_) {
-    // wrap around
-    tail = 0;
+    // append to the tail
+    uint64_t tail = shard->head_ + shard->count_;
+    if (tail >= shard->capacity_) {
+      tail -= shard->capacity_;
+    }
+
+    // no wrap around (or no more wrap around)
+    ASSERT_ND(tail + 1 <= shard->capacity_);
+    free_pool_[shard->begin_ + tail] = offset;
+    ++shard->count_;
+    return;
   }
 
-  // no wrap around (or no more wrap around)
-  ASSERT_ND(tail + 1 <= free_pool_capacity_);
-  free_pool_[tail] = offset;
-  increase_free_pool_count(1);
+  // this can't happen unless something is wrong! This is a critical issue from which
+  // we can't recover because page pool is inconsistent!
+  LOG(ERROR) << get_debug_pool_name()
+    << " - PagePoolPimpl::release_one() More than full free-pool. inconsistent state!";
+  COERCE_ERROR(ERROR_STACK(kErrorCodeMemoryDuplicatePage));
 }
 
 
@@ -350,7 +440,7 @@ std::ostream& operator<<(std::ostream& o, const PagePoolPimpl& v) {
       << v.rigorous_page_boundary_check_ << "</rigorous_page_boundary_check_>"
     << "<pages_for_free_pool_>" << v.pages_for_free_pool_ << "</pages_for_free_pool_>"
     << "<free_pool_capacity_>" << v.free_pool_capacity_ << "</free_pool_capacity_>"
-    << "<free_pool_head_>" << v.free_pool_head() << "</free_pool_head_>"
+    << "<free_pool_shards_>" << v.get_free_pool_shards() << "</free_pool_shards_>"
     << "<free_pool_count_>" << v.get_free_pool_count() << "</free_pool_count_>"
     << "</PagePool>";
   return o;
@@ -28,6 +28,7 @@
 #include "foedus/error_stack_batch.hpp"
 #include "foedus/assorted/atomic_fences.hpp"
 #include "foedus/assorted/dumb_spinlock.hpp"
+#include "foedus/restart/log_replayer_impl.hpp"
 #include "foedus/soc/soc_manager.hpp"
 
 namespace foedus {
@@ -49,6 +50,11 @@ ErrorStack ProcManagerPimpl::initialize_once() {
   if (!engine_->is_master()) {
     LOG(INFO) << "Initializing ProcManager(" << engine_->describe_short() << ")..";
     get_local_data()->control_block_->initialize();
+    // System procedures come first so that they have the same IDs in all SOCs.
+    LocalProcId id = insert(
+      ProcAndName(restart::LogReplayer::kProcName, restart::LogReplayer::replay_proc),
+      get_local_data());
+    ASSERT_ND(id != kLocalProcInvalid);
   }
 
   // TODO(Hideaki) load shared libraries
@@ -0,0 +1,435 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include "foedus/restart/log_replayer_impl.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/assorted/assorted_func.hpp"
+#include "foedus/debugging/stop_watch.hpp"
+#include "foedus/fs/direct_io_file.hpp"
+#include "foedus/fs/filesystem.hpp"
+#include "foedus/log/common_log_types.hpp"
+#include "foedus/log/log_type.hpp"
+#include "foedus/log/thread_log_buffer.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/array/array_log_types.hpp"
+#include "foedus/storage/array/array_storage.hpp"
+#include "foedus/storage/hash/hash_log_types.hpp"
+#include "foedus/storage/hash/hash_storage.hpp"
+#include "foedus/storage/masstree/masstree_log_types.hpp"
+#include "foedus/storage/masstree/masstree_storage.hpp"
+#include "foedus/storage/sequential/sequential_log_types.hpp"
+#include "foedus/storage/sequential/sequential_storage.hpp"
+#include "foedus/thread/thread.hpp"
+#include "foedus/xct/xct_manager.hpp"
+
+namespace foedus {
+namespace restart {
+
+/** Direct I/O alignment. Same as in LogMapper */
+const uint64_t kIoAlignment = 0x1000;
+inline uint64_t align_io_floor(uint64_t offset) {
+  return (offset / kIoAlignment) * kIoAlignment;
+}
+inline uint64_t align_io_ceil(uint64_t offset) {
+  return align_io_floor(offset + kIoAlignment - 1U);
+}
+
+const char* const LogReplayer::kProcName = "foedus_restart_log_replayer";
+
+ErrorStack LogReplayer::replay_proc(const proc::ProcArguments& args) {
+  const LogReplayerInput* input = reinterpret_cast<const LogReplayerInput*>(args.input_buffer_);
+  ASSERT_ND(args.input_len_ >= sizeof(LogReplayerInput));
+  ASSERT_ND(args.input_len_ == LogReplayerInput::calculate_size(input->logger_count_));
+  LogReplayer replayer(args.context_, input);
+  return replayer.replay();
+}
+
+LogReplayer::LogReplayer(thread::Thread* context, const LogReplayerInput* input)
+  : engine_(context->get_engine()),
+    context_(context),
+    input_(input),
+    staging_used_(0),
+    replayed_count_(0),
+    skipped_count_(0) {
+}
+
+ErrorStack LogReplayer::replay() {
+  LOG(INFO) << "Log replayer-" << input_->partition_ << "/" << input_->partition_count_
+    << " started in thread-" << context_->get_thread_id() << ". Replaying logs in ("
+    << input_->snapshot_epoch_ << ", " << input_->durable_epoch_ << "]";
+  debugging::StopWatch watch;
+
+  const uint64_t io_buffer_size = static_cast<uint64_t>(
+    engine_->get_options().restart_.replay_io_buffer_mb_) << 20;
+  const int numa_node = context_->get_numa_node();
+  streams_.resize(input_->logger_count_);
+  for (uint16_t i = 0; i < input_->logger_count_; ++i) {
+    LogStream* stream = &streams_[i];
+    stream->logger_id_ = i;
+    stream->numa_node_ = i / input_->loggers_per_node_;
+    stream->range_ = input_->log_ranges_[i];
+    stream->io_buffer_.alloc(
+      io_buffer_size,
+      memory::kHugepageSize,
+      memory::AlignedMemory::kNumaAllocOnnode,
+      numa_node);
+    CHECK_OUTOFMEMORY(stream->io_buffer_.get_block());
+    stream->block_buffer_.alloc(
+      log::CompressedBlockLogType::kMaxUncompressedLength,
+      1U << 12,
+      memory::AlignedMemory::kNumaAllocOnnode,
+      numa_node);
+    CHECK_OUTOFMEMORY(stream->block_buffer_.get_block());
+    CHECK_ERROR(open_stream(stream));
+  }
+  staging_.alloc(1U << 21, 1U << 12, memory::AlignedMemory::kNumaAllocOnnode, numa_node);
+  CHECK_OUTOFMEMORY(staging_.get_block());
+  payload_buffer_.alloc(1U << 16, 1U << 12, memory::AlignedMemory::kNumaAllocOnnode, numa_node);
+  CHECK_OUTOFMEMORY(payload_buffer_.get_block());
+
+  while (true) {
+    // Pick the smallest epoch among the next logs of all loggers.
+    bool found = false;
+    Epoch cur_epoch;
+    for (LogStream& stream : streams_) {
+      const log::RecordLogType* entry;
+      CHECK_ERROR(peek_stream(&stream, &entry));
+      if (entry) {
+        Epoch epoch = entry->header_.xct_id_.get_epoch();
+        if (!found || epoch < cur_epoch) {
+          cur_epoch = epoch;
+          found = true;
+        }
+      }
+    }
+    if (!found) {
+      break;
+    }
+
+    staging_used_ = 0;
+    staged_logs_.clear();
+    for (LogStream& stream : streams_) {
+      CHECK_ERROR(stage_epoch(&stream, cur_epoch));
+    }
+    CHECK_ERROR(replay_staged());
+  }
+
+  watch.stop();
+  LOG(INFO) << "Log replayer-" << input_->partition_ << " replayed " << replayed_count_
+    << " logs in " << watch.elapsed_sec() << " sec. skipped " << skipped_count_ << " logs";
+  return kRetOk;
+}
+
+ErrorStack LogReplayer::open_stream(LogStream* stream) {
+  stream->cur_inbuf_ = 0;
+  stream->end_inbuf_ = 0;
+  stream->buf_infile_aligned_ = 0;
+  stream->end_infile_ = 0;
+  stream->block_cur_ = 0;
+  stream->block_end_ = 0;
+  if (stream->range_.is_empty()) {
+    stream->ended_ = true;
+    return kRetOk;
+  }
+  stream->ended_ = false;
+  stream->cur_file_ordinal_ = stream->range_.begin_file_ordinal;
+  return load_stream(stream, stream->range_.begin_offset);
+}
+
+ErrorStack LogReplayer::load_stream(LogStream* stream, uint64_t next_infile) {
+  const log::LogOptions& option = engine_->get_options().log_;
+  while (true) {
+    fs::Path path(option.construct_suffixed_log_path(
+      stream->numa_node_,
+      stream->logger_id_,
+      stream->cur_file_ordinal_));
+    if (stream->cur_file_ordinal_ == stream->range_.end_file_ordinal) {
+      stream->end_infile_ = stream->range_.end_offset;
+    } else {
+      stream->end_infile_ = align_io_floor(fs::file_size(path));
+    }
+
+    if (next_infile >= stream->end_infile_) {
+      if (stream->cur_file_ordinal_ == stream->range_.end_file_ordinal) {
+        stream->ended_ = true;
+        return kRetOk;
+      }
+      ++stream->cur_file_ordinal_;
+      next_infile = 0;
+      continue;
+    }
+
+    stream->buf_infile_aligned_ = align_io_floor(next_infile);
+    uint64_t read_size = std::min<uint64_t>(
+      stream->io_buffer_.get_size(),
+      align_io_ceil(stream->end_infile_ - stream->buf_infile_aligned_));
+    fs::DirectIoFile file(path, option.emulation_);
+    WRAP_ERROR_CODE(file.open(true, false, false, false));
+    WRAP_ERROR_CODE(file.seek(stream->buf_infile_aligned_, fs::DirectIoFile::kDirectIoSeekSet));
+    WRAP_ERROR_CODE(file.read(read_size, &stream->io_buffer_));
+    file.close();
+
+    stream->cur_inbuf_ = next_infile - stream->buf_infile_aligned_;
+    stream->end_inbuf_ = std::min<uint64_t>(
+      read_size,
+      stream->end_infile_ - stream->buf_infile_aligned_);
+    return kRetOk;
+  }
+}
+
+ErrorStack LogReplayer::peek_stream(LogStream* stream, const log::RecordLogType** out) {
+  *out = nullptr;
+  while (!stream->ended_) {
+    if (stream->block_cur_ < stream->block_end_) {
+      // in the middle of a compressed block
+      const char* block_buffer = reinterpret_cast<const char*>(stream->block_buffer_.get_block());
+      const log::LogHeader* header
+        = reinterpret_cast<const log::LogHeader*>(block_buffer + stream->block_cur_);
+      if (UNLIKELY(header->log_length_ == 0
+        || stream->block_cur_ + header->log_length_ > stream->block_end_)) {
+        LOG(ERROR) << "inconsistent log in a compressed block. logger=" << stream->logger_id_
+          << ", log header=" << *header;
+        return ERROR_STACK(kErrorCodeSnapshotInvalidLogEnd);
+      }
+      if (header->get_type() == log::kLogCodeFiller) {
+        stream->block_cur_ += header->log_length_;
+        continue;
+      }
+      ASSERT_ND(header->get_kind() == log::kRecordLogs);
+      *out = reinterpret_cast<const log::RecordLogType*>(header);
+      return kRetOk;
+    }
+    if (stream->cur_inbuf_ >= stream->end_inbuf_) {
+      CHECK_ERROR(load_stream(stream, stream->buf_infile_aligned_ + stream->end_inbuf_));
+      continue;
+    }
+    const char* buffer = reinterpret_cast<const char*>(stream->io_buffer_.get_block());
+    const log::LogHeader* header
+      = reinterpret_cast<const log::LogHeader*>(buffer + stream->cur_inbuf_);
+    ASSERT_ND(header->log_length_ > 0);
+    if (UNLIKELY(header->log_length_ + stream->cur_inbuf_ > stream->end_inbuf_)) {
+      // The log spans the end of the buffer. Read again from the log.
+      uint64_t log_infile = stream->buf_infile_aligned_ + stream->cur_inbuf_;
+      if (log_infile + header->log_length_ > stream->end_infile_
+        || stream->buf_infile_aligned_ == align_io_floor(log_infile)) {
+        LOG(ERROR) << "inconsistent end of log entry. offset=" << log_infile
+          << ", logger=" << stream->logger_id_ << ", log header=" << *header;
+        return ERROR_STACK(kErrorCodeSnapshotInvalidLogEnd);
+      }
+      CHECK_ERROR(load_stream(stream, log_infile));
+      continue;
+    }
+
+    if (header->get_type() == log::kLogCodeEpochMarker
+      || header->get_type() == log::kLogCodeFiller) {
+      stream->cur_inbuf_ += header->log_length_;
+      continue;
+    }
+    if (header->get_type() == log::kLogCodeCompressedBlock) {
+      const log::CompressedBlockLogType* block
+        = reinterpret_cast<const log::CompressedBlockLogType*>(header);
+      if (block->uncompressed_length_ > log::CompressedBlockLogType::kMaxUncompressedLength) {
+        LOG(ERROR) << "invalid compressed block. logger=" << stream->logger_id_ << ", " << *block;
+        return ERROR_STACK(kErrorCodeLogCorruptedCompressedBlock);
+      }
+      WRAP_ERROR_CODE(block->decompress(reinterpret_cast<char*>(
+        stream->block_buffer_.get_block())));
+      stream->block_cur_ = 0;
+      stream->block_end_ = block->uncompressed_length_;
+      stream->cur_inbuf_ += header->log_length_;
+      continue;
+    }
+    ASSERT_ND(header->get_kind() == log::kRecordLogs);
+    *out = reinterpret_cast<const log::RecordLogType*>(header);
+    return kRetOk;
+  }
+  return kRetOk;
+}
+
+ErrorStack LogReplayer::stage_epoch(LogStream* stream, Epoch epoch) {
+  while (true) {
+    const log::RecordLogType* entry;
+    CHECK_ERROR(peek_stream(stream, &entry));
+    if (entry == nullptr || entry->header_.xct_id_.get_epoch() != epoch) {
+      return kRetOk;
+    }
+    const uint16_t log_length = entry->header_.log_length_;
+    if (stream->block_cur_ < stream->block_end_) {
+      stream->block_cur_ += log_length;  // the entry is in block_buffer_
+    } else {
+      stream->cur_inbuf_ += log_length;
+    }
+
+    // The log range is inclusive of both ends in terms of epoch markers, but let's make sure.
+    if ((input_->snapshot_epoch_.is_valid() && epoch <= input_->snapshot_epoch_)
+      || epoch > input_->durable_epoch_) {
+      continue;
+    }
+    if (!is_my_storage(entry->header_.storage_id_)) {
+      continue;
+    }
+
+    WRAP_ERROR_CODE(staging_.assure_capacity(staging_used_ + log_length, 2.0, true));
+    std::memcpy(reinterpret_cast<char*>(staging_.get_block()) + staging_used_, entry, log_length);
+    StagedLog staged;
+    staged.ordinal_ = entry->header_.xct_id_.get_ordinal();
+    staged.offset_ = staging_used_;
+    staged_logs_.push_back(staged);
+    staging_used_ += log_length;
+  }
+}
+
+ErrorStack LogReplayer::replay_staged() {
+  // stable, so that logs of the same transaction keep the order.
+  std::stable_sort(
+    staged_logs_.begin(),
+    staged_logs_.end(),
+    [](const StagedLog& left, const StagedLog& right) { return left.ordinal_ < right.ordinal_; });
+  const char* base = reinterpret_cast<const char*>(staging_.get_block());
+  for (const StagedLog& staged : staged_logs_) {
+    CHECK_ERROR(replay_log(reinterpret_cast<const log::RecordLogType*>(base + staged.offset_)));
+  }
+  return kRetOk;
+}
+
+ErrorStack LogReplayer::replay_log(const log::RecordLogType* entry) {
+  xct::XctManager* xct_manager = engine_->get_xct_manager();
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context_, xct::kSerializable));
+  ErrorCode ret = apply_log(entry);
+  if (ret != kErrorCodeOk) {
+    WRAP_ERROR_CODE(xct_manager->abort_xct(context_));
+    if (ret == kErrorCodeStrKeyNotFound
+      || ret == kErrorCodeStrKeyAlreadyExists
+      || ret == kErrorCodeStrTooShortPayload) {
+      // Shouldn't happen as far as logs are consistent. Report and move on.
+      LOG(WARNING) << "Log replay of " << entry->header_ << " resulted in "
+        << get_error_name(ret) << ". skipped";
+      ++skipped_count_;
+      return kRetOk;
+    }
+    return ERROR_STACK(ret);
+  }
+
+  // The original log is still in the log file. We must not write it again, or the next
+  // snapshot would apply it twice. Discard the new log before commit, which makes
+  // the commit publish nothing while still applying the write set.
+  context_->get_thread_log_buffer().discard_current_xct_log();
+  Epoch commit_epoch;
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context_, &commit_epoch));
+  ++replayed_count_;
+  return kRetOk;
+}
+
+ErrorCode LogReplayer::apply_log(const log::RecordLogType* entry) {
+  const storage::StorageId storage_id = entry->header_.storage_id_;
+  switch (entry->header_.get_type()) {
+  case log::kLogCodeArrayOverwrite:
+  case log::kLogCodeArrayIncrement: {
+    // Both of them are replayed as a whole-payload overwrite of the log-applied image,
+    // so that we don't have to dispatch increments by value types.
+    storage::array::ArrayStorage storage(engine_, storage_id);
+    const auto* casted = reinterpret_cast<const storage::array::ArrayCommonUpdateLogType*>(entry);
+    const uint16_t payload_size = storage.get_payload_size();
+    char* payload = reinterpret_cast<char*>(payload_buffer_.get_block());
+    CHECK_ERROR_CODE(storage.get_record(context_, casted->offset_, payload));
+    if (entry->header_.get_type() == log::kLogCodeArrayOverwrite) {
+      reinterpret_cast<const storage::array::ArrayOverwriteLogType*>(entry)->apply_record(
+        context_,
+        storage_id,
+        nullptr,
+        payload);
+    } else {
+      reinterpret_cast<const storage::array::ArrayIncrementLogType*>(entry)->apply_record(
+        context_,
+        storage_id,
+        nullptr,
+        payload);
+    }
+    return storage.overwrite_record(context_, casted->offset_, payload, 0, payload_size);
+  }
+  case log::kLogCodeSequentialAppend: {
+    storage::sequential::SequentialStorage storage(engine_, storage_id);
+    const auto* casted
+      = reinterpret_cast<const storage::sequential::SequentialAppendLogType*>(entry);
+    return storage.append_record(context_, casted->payload_, casted->payload_count_);
+  }
+  case log::kLogCodeHashInsert:
+  case log::kLogCodeHashDelete:
+  case log::kLogCodeHashOverwrite:
+  case log::kLogCodeHashUpdate: {
+    storage::hash::HashStorage storage(engine_, storage_id);
+    const auto* casted = reinterpret_cast<const storage::hash::HashCommonLogType*>(entry);
+    const char* key = casted->get_key();
+    const uint16_t key_length = casted->key_length_;
+    const char* payload = casted->get_payload();
+    if (entry->header_.get_type() == log::kLogCodeHashInsert) {
+      return storage.insert_record(context_, key, key_length, payload, casted->payload_count_);
+    } else if (entry->header_.get_type() == log::kLogCodeHashDelete) {
+      return storage.delete_record(context_, key, key_length);
+    } else if (entry->header_.get_type() == log::kLogCodeHashOverwrite) {
+      return storage.overwrite_record(
+        context_,
+        key,
+        key_length,
+        payload,
+        casted->payload_offset_,
+        casted->payload_count_);
+    } else {
+      return storage.upsert_record(context_, key, key_length, payload, casted->payload_count_);
+    }
+  }
+  case log::kLogCodeMasstreeInsert:
+  case log::kLogCodeMasstreeDelete:
+  case log::kLogCodeMasstreeOverwrite:
+  case log::kLogCodeMasstreeUpdate: {
+    storage::masstree::MasstreeStorage storage(engine_, storage_id);
+    const auto* casted
+      = reinterpret_cast<const storage::masstree::MasstreeCommonLogType*>(entry);
+    const char* key = casted->get_key();
+    const storage::masstree::KeyLength key_length = casted->key_length_;
+    const char* payload = casted->get_payload();
+    if (entry->header_.get_type() == log::kLogCodeMasstreeInsert) {
+      return storage.insert_record(context_, key, key_length, payload, casted->payload_count_);
+    } else if (entry->header_.get_type() == log::kLogCodeMasstreeDelete) {
+      return storage.delete_record(context_, key, key_length);
+    } else if (entry->header_.get_type() == log::kLogCodeMasstreeOverwrite) {
+      return storage.overwrite_record(
+        context_,
+        key,
+        key_length,
+        payload,
+        casted->payload_offset_,
+        casted->payload_count_);
+    } else {
+      return storage.upsert_record(context_, key, key_length, payload, casted->payload_count_);
+    }
+  }
+  default:
+    LOG(FATAL) << "Unexpected record log type in log replay:" << entry->header_;
+    return kErrorCodeInvalidParameter;
+  }
+}
+
+}  // namespace restart
+}  // namespace foedus
@@ -19,6 +19,9 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "foedus/engine.hpp"
 #include "foedus/engine_options.hpp"
 #include "foedus/epoch.hpp"
@@ -26,13 +29,17 @@
 #include "foedus/fs/direct_io_file.hpp"
 #include "foedus/log/common_log_types.hpp"
 #include "foedus/log/log_manager.hpp"
+#include "foedus/log/logger_ref.hpp"
 #include "foedus/memory/aligned_memory.hpp"
+#include "foedus/restart/log_replayer_impl.hpp"
 #include "foedus/savepoint/savepoint_manager.hpp"
 #include "foedus/snapshot/snapshot_manager.hpp"
 #include "foedus/snapshot/snapshot_manager_pimpl.hpp"
 #include "foedus/soc/soc_manager.hpp"
 #include "foedus/storage/storage_log_types.hpp"
 #include "foedus/storage/storage_manager.hpp"
+#include "foedus/thread/impersonate_session.hpp"
+#include "foedus/thread/thread_pool.hpp"
 #include "foedus/xct/xct_manager.hpp"
 
 namespace foedus {
@@ -92,6 +99,12 @@ ErrorStack RestartManagerPimpl::recover() {
 
   LOG(INFO) << "There are logs that are durable but not yet snapshotted.";
   CHECK_ERROR(redo_meta_logs(durable_epoch, snapshot_epoch));
+  if (engine_->get_options().restart_.replay_logs_) {
+    // The logs will be snapshotted later as usual by the snapshot thread.
+    CHECK_ERROR(replay_record_logs(durable_epoch, snapshot_epoch));
+    LOG(INFO) << "Finished log replay during start-up. Now we can start processing transaction";
+    return kRetOk;
+  }
   LOG(INFO) << "Launching snapshot..";
   snapshot::SnapshotManagerPimpl* snapshot_pimpl = engine_->get_snapshot_manager()->get_pimpl();
   snapshot::Snapshot the_snapshot;
@@ -172,5 +185,57 @@ ErrorStack RestartManagerPimpl::redo_meta_logs(Epoch durable_epoch, Epoch snapsh
   return kRetOk;
 }
 
+ErrorStack RestartManagerPimpl::replay_record_logs(Epoch durable_epoch, Epoch snapshot_epoch) {
+  const EngineOptions& options = engine_->get_options();
+  const uint16_t node_count = options.thread_.group_count_;
+  const uint16_t loggers_per_node = options.log_.loggers_per_node_;
+  const uint16_t logger_count = node_count * loggers_per_node;
+  const uint16_t replayers_per_node = std::max<uint16_t>(1U, std::min<uint16_t>(
+    options.restart_.replay_threads_per_node_,
+    options.thread_.thread_count_per_group_));
+  const uint16_t replayer_count = node_count * replayers_per_node;
+  LOG(INFO) << "Replaying record logs from " << snapshot_epoch << " to " << durable_epoch
+    << " with " << replayer_count << " replayers";
+
+  const uint32_t input_size = LogReplayerInput::calculate_size(logger_count);
+  std::vector< memory::AlignedMemory > inputs(replayer_count);
+  std::vector< thread::ImpersonateSession > sessions(replayer_count);
+  for (uint16_t i = 0; i < replayer_count; ++i) {
+    inputs[i].alloc(input_size, 1U << 12, memory::AlignedMemory::kNumaAllocOnnode, 0);
+    CHECK_OUTOFMEMORY(inputs[i].get_block());
+    LogReplayerInput* input = reinterpret_cast<LogReplayerInput*>(inputs[i].get_block());
+    input->snapshot_epoch_ = snapshot_epoch;
+    input->durable_epoch_ = durable_epoch;
+    input->partition_ = i;
+    input->partition_count_ = replayer_count;
+    input->logger_count_ = logger_count;
+    input->loggers_per_node_ = loggers_per_node;
+    for (log::LoggerId j = 0; j < logger_count; ++j) {
+      log::LoggerRef logger = engine_->get_log_manager()->get_logger(j);
+      input->log_ranges_[j] = logger.get_log_range(snapshot_epoch, durable_epoch);
+    }
+  }
+
+  thread::ThreadPool* pool = engine_->get_thread_pool();
+  for (uint16_t i = 0; i < replayer_count; ++i) {
+    thread::ThreadGroupId node = i / replayers_per_node;
+    if (!pool->impersonate_on_numa_node(
+      node,
+      LogReplayer::kProcName,
+      inputs[i].get_block(),
+      input_size,
+      &sessions[i])) {
+      LOG(ERROR) << "Couldn't launch log replayer-" << i << " on node-" << node;
+      return ERROR_STACK(kErrorCodeThrNoThreadAvailable);
+    }
+  }
+
+  ErrorStackBatch batch;
+  for (uint16_t i = 0; i < replayer_count; ++i) {
+    batch.emprace_back(sessions[i].get_result());
+  }
+  return SUMMARIZE_ERROR_BATCH(batch);
+}
+
 }  // namespace restart
 }  // namespace foedus
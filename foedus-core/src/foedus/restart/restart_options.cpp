@@ -20,14 +20,28 @@
 namespace foedus {
 namespace restart {
 RestartOptions::RestartOptions() {
+  replay_logs_ = false;
+  replay_threads_per_node_ = kDefaultReplayThreadsPerNode;
+  replay_io_buffer_mb_ = kDefaultReplayIoBufferMb;
 }
 
-ErrorStack RestartOptions::load(tinyxml2::XMLElement* /*element*/) {
+ErrorStack RestartOptions::load(tinyxml2::XMLElement* element) {
+  EXTERNALIZE_LOAD_ELEMENT(element, replay_logs_);
+  EXTERNALIZE_LOAD_ELEMENT(element, replay_threads_per_node_);
+  EXTERNALIZE_LOAD_ELEMENT(element, replay_io_buffer_mb_);
   return kRetOk;
 }
 
 ErrorStack RestartOptions::save(tinyxml2::XMLElement* element) const {
   CHECK_ERROR(insert_comment(element, "Set of options for restart manager"));
+
+  EXTERNALIZE_SAVE_ELEMENT(element, replay_logs_,
+    "Whether to replay durable-but-not-snapshotted record logs into volatile pages\n"
+    " at restart instead of taking a snapshot before accepting transactions.");
+  EXTERNALIZE_SAVE_ELEMENT(element, replay_threads_per_node_,
+    "Number of worker threads per NUMA node used for log replay.");
+  EXTERNALIZE_SAVE_ELEMENT(element, replay_io_buffer_mb_,
+    "Size in MB of the IO buffer each replaying thread allocates per logger.");
   return kRetOk;
 }
 
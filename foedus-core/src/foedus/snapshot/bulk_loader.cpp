@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include "foedus/snapshot/bulk_loader.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "foedus/assert_nd.hpp"
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/assorted/assorted_func.hpp"
+#include "foedus/debugging/stop_watch.hpp"
+#include "foedus/fs/direct_io_file.hpp"
+#include "foedus/fs/filesystem.hpp"
+#include "foedus/log/common_log_types.hpp"
+#include "foedus/snapshot/log_reducer_impl.hpp"
+#include "foedus/snapshot/snapshot_manager.hpp"
+#include "foedus/snapshot/snapshot_manager_pimpl.hpp"
+#include "foedus/xct/xct_id.hpp"
+#include "foedus/xct/xct_manager.hpp"
+
+namespace foedus {
+namespace snapshot {
+
+/** Same as LogReducer. Bytes after this are retained in the IO buffer as a fragment. */
+const uint64_t kFragmentMargin = 1ULL << 16;
+/** FullBlockHeader::block_length_ is a BufferPosition, which is 32 bits in 8-bytes unit. */
+const uint64_t kMaxBlockBytes = (1ULL << 32) * 8ULL;
+const uint64_t kMaxLogCount = (1ULL << 32) - 1ULL;
+
+BulkLoader::BulkLoader(Engine* engine, storage::StorageId storage_id)
+  : engine_(engine),
+  storage_id_(storage_id),
+  opened_(false),
+  epoch_(),
+  record_count_(0),
+  shortest_key_length_(0xFFFFFFFFU),
+  longest_key_length_(0),
+  io_buffer_pos_(0),
+  written_bytes_(0),
+  reserved_length_(0) {
+}
+
+BulkLoader::~BulkLoader() {
+  if (opened_) {
+    LOG(WARNING) << "BulkLoader for storage-" << storage_id_ << " is destructed without commit."
+      << " Aborting " << record_count_ << " records";
+    release(false);
+  }
+}
+
+ErrorStack BulkLoader::open() {
+  ASSERT_ND(!opened_);
+  SnapshotManagerPimpl* snapshot_manager = engine_->get_snapshot_manager()->get_pimpl();
+  WRAP_ERROR_CODE(snapshot_manager->begin_bulk_load());
+  // From now on, no snapshot runs until release().
+  opened_ = true;
+  ErrorCode checked = check_storage();
+  if (checked != kErrorCodeOk) {
+    LOG(ERROR) << "Storage-" << storage_id_ << " can't be bulk-loaded: " << get_error_name(checked);
+    release(false);
+    return ERROR_STACK(checked);
+  }
+
+  // Any epoch after the last snapshot works. The current global epoch is the natural choice.
+  epoch_ = engine_->get_xct_manager()->get_current_global_epoch();
+  record_count_ = 0;
+  shortest_key_length_ = 0xFFFFFFFFU;
+  longest_key_length_ = 0;
+  written_bytes_ = 0;
+  reserved_length_ = 0;
+
+  const SnapshotOptions& option = engine_->get_options().snapshot_;
+  io_buffer_.alloc(
+    static_cast<uint64_t>(option.log_reducer_dump_io_buffer_mb_) << 20,
+    memory::kHugepageSize,
+    memory::AlignedMemory::kNumaAllocOnnode,
+    0);
+  first_page_.alloc(
+    log::FillerLogType::kLogWriteUnitSize,
+    log::FillerLogType::kLogWriteUnitSize,
+    memory::AlignedMemory::kNumaAllocOnnode,
+    0);
+  // The header is filled in close_file(). Logs come after it.
+  io_buffer_pos_ = sizeof(FullBlockHeader);
+
+  fs::Path path = snapshot_manager->get_bulk_load_file_path(storage_id_);
+  if (fs::exists(path)) {
+    LOG(WARNING) << "Removing a stale bulk-load file " << path;
+    fs::remove(path);
+  }
+  file_.reset(new fs::DirectIoFile(path, option.emulation_));
+  // not O_APPEND, because close_file() rewrites the first page with pwrite.
+  ErrorCode opened = file_->open(false, true, false, true);
+  if (opened != kErrorCodeOk) {
+    release(false);
+    return ERROR_STACK(opened);
+  }
+  LOG(INFO) << "Bulk-loading storage-" << storage_id_ << " to " << path << ". epoch=" << epoch_;
+  return kRetOk;
+}
+
+char* BulkLoader::reserve_log(uint16_t log_length) {
+  ASSERT_ND(opened_);
+  ASSERT_ND(log_length % 8U == 0);
+  ASSERT_ND(io_buffer_pos_ + log_length <= io_buffer_.get_size());
+  reserved_length_ = log_length;
+  return reinterpret_cast<char*>(io_buffer_.get_block()) + io_buffer_pos_;
+}
+
+ErrorCode BulkLoader::append_reserved_log(uint32_t key_length, uint32_t ordinal) {
+  ASSERT_ND(opened_);
+  ASSERT_ND(reserved_length_ > 0);
+  if (UNLIKELY(record_count_ >= kMaxLogCount
+    || written_bytes_ + io_buffer_pos_ + reserved_length_ >= kMaxBlockBytes)) {
+    return kErrorCodeSnapshotBulkLoadTooLarge;
+  }
+  char* address = reinterpret_cast<char*>(io_buffer_.get_block()) + io_buffer_pos_;
+  log::RecordLogType* record = reinterpret_cast<log::RecordLogType*>(address);
+  ASSERT_ND(record->header_.log_length_ == reserved_length_);
+  ASSERT_ND(record->header_.storage_id_ == storage_id_);
+  record->header_.xct_id_.set(epoch_.value(), ordinal);
+
+  io_buffer_pos_ += reserved_length_;
+  reserved_length_ = 0;
+  ++record_count_;
+  shortest_key_length_ = std::min(shortest_key_length_, key_length);
+  longest_key_length_ = std::max(longest_key_length_, key_length);
+  if (io_buffer_pos_ >= io_buffer_.get_size() - kFragmentMargin) {
+    CHECK_ERROR_CODE(flush_io_buffer(io_buffer_.get_size() - kFragmentMargin));
+  }
+  return kErrorCodeOk;
+}
+
+ErrorCode BulkLoader::flush_io_buffer(uint64_t upto) {
+  ASSERT_ND(upto % log::FillerLogType::kLogWriteUnitSize == 0);
+  ASSERT_ND(upto <= io_buffer_pos_);
+  char* buffer = reinterpret_cast<char*>(io_buffer_.get_block());
+  if (written_bytes_ == 0) {
+    // keep the first page to complete the header later.
+    std::memcpy(first_page_.get_block(), buffer, log::FillerLogType::kLogWriteUnitSize);
+  }
+  CHECK_ERROR_CODE(file_->write(upto, io_buffer_));
+  if (io_buffer_pos_ > upto) {
+    std::memcpy(buffer, buffer + upto, io_buffer_pos_ - upto);
+  }
+  io_buffer_pos_ -= upto;
+  written_bytes_ += upto;
+  return kErrorCodeOk;
+}
+
+ErrorCode BulkLoader::close_file() {
+  const uint64_t total_bytes = written_bytes_ + io_buffer_pos_;
+  ASSERT_ND(total_bytes < kMaxBlockBytes);
+  ASSERT_ND(record_count_ > 0);
+  ASSERT_ND(record_count_ <= kMaxLogCount);
+
+  // for aligned write, add a filler block at the end, just like LogReducer does.
+  char* buffer = reinterpret_cast<char*>(io_buffer_.get_block());
+  if (io_buffer_pos_ % log::FillerLogType::kLogWriteUnitSize != 0) {
+    uint64_t upto = assorted::align<uint64_t, log::FillerLogType::kLogWriteUnitSize>(
+      io_buffer_pos_);
+    FillerBlockHeader* filler = reinterpret_cast<FillerBlockHeader*>(buffer + io_buffer_pos_);
+    filler->block_length_ = to_buffer_position(upto - io_buffer_pos_);
+    filler->magic_word_ = BlockHeaderBase::kFillerBlockHeaderMagicWord;
+    if (upto - io_buffer_pos_ > sizeof(FillerBlockHeader)) {
+      std::memset(
+        buffer + io_buffer_pos_ + sizeof(FillerBlockHeader),
+        0,
+        upto - io_buffer_pos_ - sizeof(FillerBlockHeader));
+    }
+    io_buffer_pos_ = upto;
+  }
+
+  // complete the header, which might be already written out.
+  char* first_page = buffer;
+  if (written_bytes_ > 0) {
+    first_page = reinterpret_cast<char*>(first_page_.get_block());
+  }
+  FullBlockHeader* header = reinterpret_cast<FullBlockHeader*>(first_page);
+  header->magic_word_ = BlockHeaderBase::kFullBlockHeaderMagicWord;
+  header->block_length_ = to_buffer_position(total_bytes);
+  header->storage_id_ = storage_id_;
+  header->log_count_ = record_count_;
+  header->shortest_key_length_ = shortest_key_length_;
+  header->longest_key_length_ = longest_key_length_;
+  header->assert_key_length();
+
+  if (io_buffer_pos_ > 0) {
+    CHECK_ERROR_CODE(file_->write(io_buffer_pos_, io_buffer_));
+    written_bytes_ += io_buffer_pos_;
+    io_buffer_pos_ = 0;
+  }
+  if (first_page != buffer) {
+    CHECK_ERROR_CODE(file_->write_raw_at(0, log::FillerLogType::kLogWriteUnitSize, first_page));
+  }
+  ASSERT_ND(written_bytes_ % log::FillerLogType::kLogWriteUnitSize == 0);
+  return kErrorCodeOk;
+}
+
+ErrorStack BulkLoader::commit(bool wait_for_snapshot) {
+  ASSERT_ND(opened_);
+  if (record_count_ == 0) {
+    LOG(INFO) << "Bulk-load of storage-" << storage_id_ << " had no record. Nothing to do";
+    release(false);
+    return kRetOk;
+  }
+
+  debugging::StopWatch watch;
+  ErrorCode closed = close_file();
+  if (closed != kErrorCodeOk) {
+    release(false);
+    return ERROR_STACK(closed);
+  }
+  LOG(INFO) << "Wrote " << record_count_ << " records (" << written_bytes_ << " bytes) to"
+    << " the bulk-load file of storage-" << storage_id_ << ". Now taking a snapshot";
+
+  // The snapshot must cover our epoch.
+  xct::XctManager* xct_manager = engine_->get_xct_manager();
+  ErrorCode waited = xct_manager->wait_for_commit(epoch_);
+  if (waited != kErrorCodeOk) {
+    release(false);
+    return ERROR_STACK(waited);
+  }
+  release(true);
+  engine_->get_snapshot_manager()->trigger_snapshot_immediate(wait_for_snapshot);
+  watch.stop();
+  if (wait_for_snapshot) {
+    LOG(INFO) << "Bulk-loaded storage-" << storage_id_ << " is now snapshotted in "
+      << watch.elapsed_ms() << "ms";
+  } else {
+    LOG(INFO) << "Bulk-loaded storage-" << storage_id_ << " will be snapshotted after all"
+      << " bulk-loaders are closed";
+  }
+  return kRetOk;
+}
+
+ErrorStack BulkLoader::abort() {
+  ASSERT_ND(opened_);
+  LOG(INFO) << "Aborting bulk-load of storage-" << storage_id_ << ". " << record_count_
+    << " records are discarded";
+  release(false);
+  return kRetOk;
+}
+
+void BulkLoader::release(bool committed) {
+  ASSERT_ND(opened_);
+  SnapshotManagerPimpl* snapshot_manager = engine_->get_snapshot_manager()->get_pimpl();
+  if (file_) {
+    file_->close();
+    file_.reset();
+    if (!committed) {
+      fs::remove(snapshot_manager->get_bulk_load_file_path(storage_id_));
+    }
+  }
+  io_buffer_.release_block();
+  first_page_.release_block();
+  opened_ = false;
+  snapshot_manager->end_bulk_load(committed ? storage_id_ : 0);
+}
+
+}  // namespace snapshot
+}  // namespace foedus
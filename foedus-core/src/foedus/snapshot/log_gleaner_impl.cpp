@@ -42,8 +42,11 @@
 #include "foedus/snapshot/snapshot_manager_pimpl.hpp"
 #include "foedus/soc/soc_manager.hpp"
 #include "foedus/storage/composer.hpp"
+#include "foedus/storage/metadata.hpp"
 #include "foedus/storage/partitioner.hpp"
+#include "foedus/storage/storage.hpp"
 #include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/hash/hash_storage.hpp"
 #include "foedus/thread/stoppable_thread_impl.hpp"
 
 namespace foedus {
@@ -167,7 +170,21 @@ ErrorStack LogGleaner::execute() {
     snapshot_manager_memory_->wakeup_snapshot_children();
 
   // then, wait until all mappers/reducers are done
+  const bool pipelined = engine_->get_options().snapshot_.pipeline_root_construction_;
+  root_info_cursors_.assign(control_block_->reducers_count_, 0);
+  root_statistics_.clear();
   SPINLOCK_WHILE(!is_error() && !is_all_completed()) {
+    if (pipelined) {
+      // Meanwhile, construct root pages of storages that all reducers have composed
+      // so that Step 3 only has to deal with the storages the slowest reducer just finished.
+      ErrorStack ret = construct_root_pages(false);
+      if (ret.is_error()) {
+        LOG(ERROR) << "Failed to construct root pages while gleaning: " << ret << *this;
+        control_block_->gleaning_ = false;
+        CHECK_ERROR(cancel_reducers_mappers());
+        return ret;
+      }
+    }
     // snapshot is an infrequent operation, doesn't have to wake up immediately.
     // just sleep for a while
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -175,7 +192,8 @@ ErrorStack LogGleaner::execute() {
 
   control_block_->gleaning_ = false;
   watch2.stop();
-  LOG(INFO) << "Gleaner Step 2: Ended in " << watch2.elapsed_sec() << "s";
+  LOG(INFO) << "Gleaner Step 2: Ended in " << watch2.elapsed_sec() << "s. Constructed root pages"
+    << " of " << new_root_page_pointers_.size() << " storages during Step 2.";
 
   LOG(INFO) << "Gleaner Step 3: Combine outputs from reducers (root page info)..." << *this;
   debugging::StopWatch watch3;
@@ -185,7 +203,12 @@ ErrorStack LogGleaner::execute() {
     LOG(WARNING) << "gleaner stopped without completion. cancelled? " << *this;
   } else {
     LOG(INFO) << "All mappers/reducers successfully done. Now on to the final phase." << *this;
-    CHECK_ERROR(construct_root_pages());
+    CHECK_ERROR(construct_root_pages(true));
+    storage::ComposeStatistics statistics = root_statistics_;
+    for (uint16_t i = 0; i < control_block_->reducers_count_; ++i) {
+      statistics.add(LogReducerRef(engine_, i).get_compose_statistics());
+    }
+    LOG(INFO) << "Pages composed in this snapshot: " << statistics;
   }
   watch3.stop();
   LOG(INFO) << "Gleaner Step 3: Ended in " << watch3.elapsed_sec() << "s";
@@ -197,25 +220,46 @@ ErrorStack LogGleaner::execute() {
   return kRetOk;
 }
 
-ErrorStack LogGleaner::construct_root_pages() {
-  ASSERT_ND(new_root_page_pointers_.size() == 0);
-  debugging::StopWatch stop_watch;
+namespace {
+/**
+ * Multi-level hash storages construct their root pages with one thread per node, each
+ * appending to the snapshot file of the node. We can't do it while any reducer is writing.
+ */
+bool construct_root_writes_all_nodes(Engine* engine, storage::StorageId storage_id) {
+  storage::StorageControlBlock* block = engine->get_storage_manager()->get_storage(storage_id);
+  if (block->meta_.type_ != storage::kHashStorage) {
+    return false;
+  }
+  return storage::hash::HashStorage(engine, block).get_levels() > 1U;
+}
+}  // namespace
 
+ErrorStack LogGleaner::construct_root_pages(bool all_reducers_completed) {
   const uint16_t count = control_block_->reducers_count_;
+  ASSERT_ND(root_info_cursors_.size() == count);
+  std::vector<uint32_t>& cursors = root_info_cursors_;
   std::vector<const storage::Page*> tmp_array(count, nullptr);
-  std::vector<uint16_t> cursors;
-  std::vector<uint16_t> buffer_sizes;
+  std::vector<bool> completed;
+  std::vector<uint32_t> buffer_sizes;
   std::vector<const storage::Page*> buffers;
   for (uint16_t i = 0; i < count; ++i) {
-    cursors.push_back(0);
     LogReducerRef reducer(engine_, i);
+    // check completion first. If it's completed, the storage count we read next is final.
+    completed.push_back(all_reducers_completed || reducer.is_merge_completed());
     buffer_sizes.push_back(reducer.get_total_storage_count());
     buffers.push_back(reducer.get_root_info_pages());
+    ASSERT_ND(cursors[i] <= buffer_sizes[i]);
   }
+  if (!completed[0]) {
+    // we append to the node-0 snapshot file, which the node-0 reducer is still writing to.
+    return kRetOk;
+  }
+
+  debugging::StopWatch stop_watch;
+  const uint32_t constructed_before = new_root_page_pointers_.size();
 
-  // composers read snapshot files.
+  // composers read snapshot files. opened when we find the first storage to process.
   cache::SnapshotFileSet fileset(engine_);
-  CHECK_ERROR(fileset.initialize());
   UninitializeGuard fileset_guard(&fileset, UninitializeGuard::kWarnIfUninitializeError);
 
   // composers need SnapshotWriter to write out to.
@@ -226,15 +270,19 @@ ErrorStack LogGleaner::construct_root_pages() {
     &gleaner_resource_->writer_pool_memory_,
     &gleaner_resource_->writer_intermediate_memory_,
     true);  // we append to the node-0 snapshot file.
-  CHECK_ERROR(snapshot_writer.open());
 
   storage::StorageId prev_storage_id = 0;
   // each reducer's root-info-page must be sorted by storage_id, so we do kind of merge-sort here.
   while (true) {
     // determine which storage to process by finding the smallest storage_id
     storage::StorageId min_storage_id = 0;
+    bool ready = true;
     for (uint16_t i = 0; i < count; ++i) {
       if (cursors[i] == buffer_sizes[i]) {
+        // a running reducer might still produce a root-info page of any later storage.
+        if (!completed[i]) {
+          ready = false;
+        }
         continue;
       }
       const storage::Page* root_info_page = buffers[i] + cursors[i];
@@ -248,7 +296,18 @@ ErrorStack LogGleaner::construct_root_pages() {
     }
 
     if (min_storage_id == 0) {
-      break;  // all reducers' all root info pages processed
+      ASSERT_ND(!all_reducers_completed || ready);
+      break;  // all reducers' all (so far published) root info pages processed
+    } else if (!ready) {
+      break;  // some reducer is not done with min_storage_id yet. come back later.
+    } else if (!all_reducers_completed
+      && construct_root_writes_all_nodes(engine_, min_storage_id)) {
+      break;  // must wait for all reducers to close their snapshot files
+    }
+
+    if (!fileset.is_initialized()) {
+      CHECK_ERROR(fileset.initialize());
+      CHECK_ERROR(snapshot_writer.open());
     }
 
     // fill tmp_array
@@ -274,7 +333,8 @@ ErrorStack LogGleaner::construct_root_pages() {
       &tmp_array[0],
       input_count,
       gleaner_resource_,
-      &new_root_page_pointer};
+      &new_root_page_pointer,
+      &root_statistics_};
     CHECK_ERROR(composer.construct_root(args));
     ASSERT_ND(new_root_page_pointer > 0);
     ASSERT_ND(new_root_page_pointers_.find(min_storage_id) == new_root_page_pointers_.end());
@@ -299,8 +359,12 @@ ErrorStack LogGleaner::construct_root_pages() {
   CHECK_ERROR(fileset.uninitialize());
 
   stop_watch.stop();
-  LOG(INFO) << "constructed root pages for " << new_root_page_pointers_.size()
-    << " storages. in " << stop_watch.elapsed_ms() << "ms. "<< *this;
+  const uint32_t constructed = new_root_page_pointers_.size() - constructed_before;
+  if (constructed > 0 || all_reducers_completed) {
+    LOG(INFO) << "constructed root pages for " << constructed << " storages in "
+      << stop_watch.elapsed_ms() << "ms. all_reducers_completed=" << all_reducers_completed
+      << ", total=" << new_root_page_pointers_.size() << ". " << *this;
+  }
   return kRetOk;
 }
 
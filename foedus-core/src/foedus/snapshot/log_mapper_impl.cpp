@@ -20,6 +20,7 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <cstring>
 #include <ostream>
 #include <string>
 
@@ -32,6 +33,7 @@
 #include "foedus/debugging/stop_watch.hpp"
 #include "foedus/fs/direct_io_file.hpp"
 #include "foedus/fs/filesystem.hpp"
+#include "foedus/log/common_log_types.hpp"
 #include "foedus/log/log_manager.hpp"
 #include "foedus/log/log_type.hpp"
 #include "foedus/log/logger_impl.hpp"
@@ -66,8 +68,17 @@ ErrorStack LogMapper::initialize_once() {
 
   uint64_t io_buffer_size = static_cast<uint64_t>(option.log_mapper_io_buffer_mb_) << 20;
   io_buffer_size = assorted::align<uint64_t, memory::kHugepageSize>(io_buffer_size);
+  io_read_size_ = io_buffer_size;
+  decompressed_inbuf_ = io_read_size_;
+  // Region for decompressed logs. Even if compress_logs_ is off now, log files might have been
+  // written with it on. Then we have a smaller region and just flush buckets more often.
+  uint64_t decompress_size = memory::kHugepageSize;
+  if (engine_->get_options().log_.compress_logs_) {
+    decompress_size = io_buffer_size;
+  }
+  ASSERT_ND(decompress_size >= log::CompressedBlockLogType::kMaxUncompressedLength);
   io_buffer_.alloc(
-    io_buffer_size,
+    io_buffer_size + decompress_size,
     memory::kHugepageSize,
     memory::AlignedMemory::kNumaAllocOnnode,
     numa_node_);
@@ -158,7 +169,7 @@ ErrorStack LogMapper::handle_process() {
   // Lengthy, but otherwise it's so confusing.
   processed_log_count_ = 0;
   IoBufStatus status;
-  status.size_inbuf_aligned_ = io_buffer_.get_size();
+  status.size_inbuf_aligned_ = io_read_size_;
   status.cur_file_ordinal_ = log_range.begin_file_ordinal;
   status.ended_ = false;
   status.first_read_ = true;
@@ -204,7 +215,7 @@ ErrorStack LogMapper::handle_process() {
       WRAP_ERROR_CODE(file.seek(status.buf_infile_aligned_, fs::DirectIoFile::kDirectIoSeekSet));
       DVLOG(1) << to_string() << " seeked to: " << assorted::Hex(status.buf_infile_aligned_);
       status.end_inbuf_aligned_ = std::min(
-        io_buffer_.get_size(),
+        io_read_size_,
         align_io_ceil(status.end_infile_ - status.buf_infile_aligned_));
       ASSERT_ND(status.end_inbuf_aligned_ % kIoAlignment == 0);
       WRAP_ERROR_CODE(file.read(status.end_inbuf_aligned_, &io_buffer_));
@@ -255,6 +266,7 @@ ErrorStack LogMapper::handle_process_buffer(const fs::DirectIoFile &file, IoBufS
   // many temporary memory are used only within this method and completely cleared out
   // for every call.
   clear_storage_buckets();
+  decompressed_inbuf_ = io_read_size_;
 
   char* buffer = reinterpret_cast<char*>(io_buffer_.get_block());
   status->more_in_the_file_ = false;
@@ -270,7 +282,8 @@ ErrorStack LogMapper::handle_process_buffer(const fs::DirectIoFile &file, IoBufS
     ASSERT_ND(!status->first_read_ || header->get_type() == log::kLogCodeEpochMarker);
     ASSERT_ND(header->get_kind() == log::kRecordLogs
       || header->get_type() == log::kLogCodeEpochMarker
-      || header->get_type() == log::kLogCodeFiller);
+      || header->get_type() == log::kLogCodeFiller
+      || header->get_type() == log::kLogCodeCompressedBlock);
 
     if (UNLIKELY(header->log_length_ + status->cur_inbuf_ > status->end_inbuf_aligned_)) {
       // if a log goes beyond this read, stop processing here and read from that offset again.
@@ -307,23 +320,20 @@ ErrorStack LogMapper::handle_process_buffer(const fs::DirectIoFile &file, IoBufS
       }
     } else if (UNLIKELY(header->get_type() == log::kLogCodeFiller)) {
       // skip filler log
+    } else if (UNLIKELY(header->get_type() == log::kLogCodeCompressedBlock)) {
+      CHECK_ERROR(handle_compressed_block(
+        file,
+        reinterpret_cast<const log::CompressedBlockLogType*>(header)));
+    } else if (UNLIKELY(decompressed_inbuf_ != io_read_size_)) {
+      // Logs from a compressed block precede this log and sit after the read region.
+      // BufferPosition breaks ties when sorting logs, so it must be monotonic in log order.
+      // Thus we place this log after them, too. This happens only when the logger wrote
+      // this log as-is because compressing it didn't pay off.
+      const uint64_t copied_inbuf = reserve_decompressed_region(header->log_length_);
+      std::memcpy(buffer + copied_inbuf, header, header->log_length_);
+      bucket_log_or_flush(header->storage_id_, copied_inbuf);
     } else {
-      bool bucketed = bucket_log(header->storage_id_, status->cur_inbuf_);
-      if (UNLIKELY(!bucketed)) {
-        // need to add a new bucket
-        bool added = add_new_bucket(header->storage_id_);
-        if (added) {
-          bucketed = bucket_log(header->storage_id_, status->cur_inbuf_);
-          ASSERT_ND(bucketed);
-        } else {
-          // runs out of bucket_memory. have to flush now.
-          flush_all_buckets();
-          added = add_new_bucket(header->storage_id_);
-          ASSERT_ND(added);
-          bucketed = bucket_log(header->storage_id_, status->cur_inbuf_);
-          ASSERT_ND(bucketed);
-        }
-      }
+      bucket_log_or_flush(header->storage_id_, status->cur_inbuf_);
     }
 
     status->cur_inbuf_ += header->log_length_;
@@ -362,6 +372,76 @@ inline bool LogMapper::bucket_log(storage::StorageId storage_id, uint64_t pos) {
   }
 }
 
+inline void LogMapper::bucket_log_or_flush(storage::StorageId storage_id, uint64_t pos) {
+  bool bucketed = bucket_log(storage_id, pos);
+  if (UNLIKELY(!bucketed)) {
+    // need to add a new bucket
+    bool added = add_new_bucket(storage_id);
+    if (added) {
+      bucketed = bucket_log(storage_id, pos);
+      ASSERT_ND(bucketed);
+    } else {
+      // runs out of bucket_memory. have to flush now.
+      flush_all_buckets();
+      added = add_new_bucket(storage_id);
+      ASSERT_ND(added);
+      bucketed = bucket_log(storage_id, pos);
+      ASSERT_ND(bucketed);
+    }
+  }
+}
+
+ErrorStack LogMapper::handle_compressed_block(
+  const fs::DirectIoFile &file,
+  const log::CompressedBlockLogType* block) {
+  const uint32_t uncompressed_length = block->uncompressed_length_;
+  if (UNLIKELY(uncompressed_length > log::CompressedBlockLogType::kMaxUncompressedLength)) {
+    LOG(ERROR) << to_string() << " invalid compressed block. file=" << file << ", " << *block;
+    return ERROR_STACK_MSG(kErrorCodeLogCorruptedCompressedBlock, file.get_path().c_str());
+  }
+  // Reserve the region before bucketizing, which might flush buckets in the middle.
+  // We don't reuse the region until the next handle_process_buffer() or a flush in
+  // reserve_decompressed_region(), so the logs in this block remain valid until they are sent out.
+  char* buffer = reinterpret_cast<char*>(io_buffer_.get_block());
+  const uint64_t begin_inbuf = reserve_decompressed_region(uncompressed_length);
+  const uint64_t end_inbuf = begin_inbuf + uncompressed_length;
+  ErrorCode decompressed = block->decompress(buffer + begin_inbuf);
+  if (UNLIKELY(decompressed != kErrorCodeOk)) {
+    LOG(ERROR) << to_string() << " failed to decompress a block. file=" << file << ", " << *block;
+    return ERROR_STACK_MSG(decompressed, file.get_path().c_str());
+  }
+
+  for (uint64_t cur_inbuf = begin_inbuf; cur_inbuf < end_inbuf;) {
+    const log::LogHeader* header = reinterpret_cast<const log::LogHeader*>(buffer + cur_inbuf);
+    if (UNLIKELY(header->log_length_ == 0 || cur_inbuf + header->log_length_ > end_inbuf)) {
+      LOG(ERROR) << to_string() << " inconsistent log in a compressed block. file=" << file
+        << ", " << *block << ", log header=" << *header;
+      return ERROR_STACK_MSG(kErrorCodeSnapshotInvalidLogEnd, file.get_path().c_str());
+    }
+    if (LIKELY(header->get_type() != log::kLogCodeFiller)) {
+      // logs in a compressed block are only the logs from worker threads.
+      ASSERT_ND(header->get_kind() == log::kRecordLogs);
+      bucket_log_or_flush(header->storage_id_, cur_inbuf);
+      ++processed_log_count_;
+    }
+    cur_inbuf += header->log_length_;
+  }
+  return kRetOk;
+}
+
+uint64_t LogMapper::reserve_decompressed_region(uint32_t length) {
+  if (decompressed_inbuf_ + length > io_buffer_.get_size()) {
+    // no room. send out everything so far, which frees up the region.
+    VLOG(0) << to_string() << " ran out of the region for decompressed logs. flushing buckets";
+    flush_all_buckets();
+    decompressed_inbuf_ = io_read_size_;
+  }
+  ASSERT_ND(decompressed_inbuf_ + length <= io_buffer_.get_size());
+  const uint64_t begin_inbuf = decompressed_inbuf_;
+  decompressed_inbuf_ += length;
+  return begin_inbuf;
+}
+
 bool LogMapper::add_new_bucket(storage::StorageId storage_id) {
   if (buckets_allocated_count_ >= buckets_memory_.get_size() / sizeof(Bucket)) {
     // we allocated all buckets_memory_! we have to flush the buckets now.
@@ -42,6 +42,8 @@
 #include "foedus/memory/memory_id.hpp"
 #include "foedus/snapshot/log_gleaner_impl.hpp"
 #include "foedus/snapshot/snapshot.hpp"
+#include "foedus/snapshot/snapshot_manager.hpp"
+#include "foedus/snapshot/snapshot_manager_pimpl.hpp"
 #include "foedus/soc/soc_manager.hpp"
 #include "foedus/storage/composer.hpp"
 #include "foedus/storage/partitioner.hpp"
@@ -525,9 +527,13 @@ fs::Path LogReducer::get_sorted_run_file_path(uint32_t sorted_run) const {
   return path;
 }
 
-LogReducer::MergeContext::MergeContext(uint32_t dumped_files_count)
+LogReducer::MergeContext::MergeContext(
+  uint32_t dumped_files_count,
+  const std::vector<storage::StorageId>& bulk_loaded_storages)
   : dumped_files_count_(dumped_files_count),
-  tmp_sorted_buffer_array_(new SortedBuffer*[dumped_files_count + 1]),
+  bulk_loaded_storages_(bulk_loaded_storages),
+  tmp_sorted_buffer_array_(
+    new SortedBuffer*[dumped_files_count + bulk_loaded_storages.size() + 1U]),
   tmp_sorted_buffer_count_(0) {
 }
 
@@ -591,11 +597,11 @@ ErrorStack LogReducer::merge_sort() {
   // thus, we release the reducer's dump IO buffer to reduce memory pressure.
   dump_io_buffer_.release_block();
 
-  MergeContext context(sorted_runs_);
+  MergeContext context(sorted_runs_, merge_sort_get_bulk_loaded_storages());
   LOG(INFO) << to_string() << " merge sorting " << sorted_runs_ << " sorted runs and the current"
     << " buffer which has "
     << 8ULL * control_block_->get_current_buffer_status().get_tail_position()
-    << " bytes";
+    << " bytes, and " << context.bulk_loaded_storages_.size() << " bulk-load files";
   debugging::StopWatch merge_watch;
 
   // prepare the input streams for composers
@@ -639,7 +645,8 @@ ErrorStack LogReducer::merge_sort() {
       context.tmp_sorted_buffer_count_,
       &composer_work_memory,
       parent_.get_base_epoch(),
-      root_info_page};
+      root_info_page,
+      &control_block_->compose_statistics_};
     CHECK_ERROR(composer.compose(args));
 
     // move on to next blocks
@@ -651,9 +658,12 @@ ErrorStack LogReducer::merge_sort() {
   ASSERT_ND(control_block_->total_storage_count_ <= get_max_storage_count());
 
   snapshot_writer.close();
+  // now the gleaner can append to our snapshot file and take all our root-info pages.
+  control_block_->merge_completed_ = true;
   merge_watch.stop();
   LOG(INFO) << to_string() << " completed merging in " << merge_watch.elapsed_sec() << " seconds"
-    << " . total_storage_count_=" << control_block_->total_storage_count_;
+    << " . total_storage_count_=" << control_block_->total_storage_count_
+    << ", " << control_block_->compose_statistics_;
   return kRetOk;
 }
 
@@ -678,20 +688,20 @@ void LogReducer::merge_sort_check_buffer_status() const {
 }
 
 void LogReducer::merge_sort_allocate_io_buffers(LogReducer::MergeContext* context) const {
-  if (context->dumped_files_count_ == 0) {
+  if (context->get_files_count() == 0) {
     LOG(INFO) << to_string() << " great, no sorted run files. everything in-memory";
     return;
   }
   debugging::StopWatch alloc_watch;
   uint64_t size_per_run =
     static_cast<uint64_t>(engine_->get_options().snapshot_.log_reducer_read_io_buffer_kb_) << 10;
-  uint64_t size_total = size_per_run * context->dumped_files_count_;
+  uint64_t size_total = size_per_run * context->get_files_count();
   context->io_memory_.alloc(
     size_total,
     memory::kHugepageSize,
     memory::AlignedMemory::kNumaAllocOnnode,
     get_numa_node());
-  for (uint32_t i = 0; i < context->dumped_files_count_; ++i) {
+  for (uint32_t i = 0; i < context->get_files_count(); ++i) {
     context->io_buffers_.emplace_back(memory::AlignedMemorySlice(
       &context->io_memory_,
       i * size_per_run,
@@ -776,7 +786,7 @@ ErrorStack LogReducer::merge_sort_open_sorted_runs(LogReducer::MergeContext* con
     from_buffer_position(buffer_status.components.tail_position_)));
 
   // sorted run files
-  ASSERT_ND(context->io_buffers_.size() == sorted_runs_);
+  ASSERT_ND(context->io_buffers_.size() == context->get_files_count());
   for (uint32_t sorted_run = 0 ; sorted_run < context->dumped_files_count_; ++sorted_run) {
     fs::Path path = get_sorted_run_file_path(sorted_run);
     if (!fs::exists(path)) {
@@ -798,11 +808,47 @@ ErrorStack LogReducer::merge_sort_open_sorted_runs(LogReducer::MergeContext* con
     context->sorted_files_auto_ptrs_.emplace_back(std::move(file_ptr));
   }
 
+  // bulk-load files. They are in the same format as sorted run files.
+  SnapshotManagerPimpl* snapshot_manager = engine_->get_snapshot_manager()->get_pimpl();
+  for (uint32_t i = 0; i < context->bulk_loaded_storages_.size(); ++i) {
+    fs::Path path = snapshot_manager->get_bulk_load_file_path(context->bulk_loaded_storages_[i]);
+    if (!fs::exists(path)) {
+      LOG(FATAL) << to_string() << " wtf. this bulk-load file doesn't exist " << path;
+    }
+    LOG(INFO) << to_string() << " composing a bulk-load file " << path
+      << " (" << fs::file_size(path) << " bytes)";
+
+    std::unique_ptr<fs::DirectIoFile> file_ptr(new fs::DirectIoFile(
+      path,
+      engine_->get_options().snapshot_.emulation_));
+    WRAP_ERROR_CODE(file_ptr->open(true, false, false, false));
+
+    context->sorted_buffers_.emplace_back(new DumpFileSortedBuffer(
+      file_ptr.get(),
+      context->io_buffers_[context->dumped_files_count_ + i]));
+    context->sorted_files_auto_ptrs_.emplace_back(std::move(file_ptr));
+  }
+
   ASSERT_ND(context->sorted_files_auto_ptrs_.size() == context->sorted_buffers_.size() - 1U);
-  ASSERT_ND(context->dumped_files_count_ == context->sorted_buffers_.size() - 1U);
+  ASSERT_ND(context->get_files_count() == context->sorted_buffers_.size() - 1U);
   return kRetOk;
 }
 
+std::vector<storage::StorageId> LogReducer::merge_sort_get_bulk_loaded_storages() const {
+  std::vector<storage::StorageId> ret;
+  if (get_numa_node() != 0) {
+    return ret;
+  }
+  // No bulk-loader is active during snapshotting, so the list is stable now.
+  const SnapshotManagerControlBlock* block
+    = engine_->get_snapshot_manager()->get_pimpl()->control_block_;
+  ASSERT_ND(block->active_bulk_loads_.load() == 0);
+  ret.assign(
+    block->pending_bulk_loads_,
+    block->pending_bulk_loads_ + block->pending_bulk_loads_count_);
+  return ret;
+}
+
 ErrorStack LogReducer::merge_sort_initialize_sort_buffers(LogReducer::MergeContext* context) const {
   for (uint32_t index = 0 ; index < context->sorted_buffers_.size(); ++index) {
     SortedBuffer* buffer = context->sorted_buffers_[index].get();
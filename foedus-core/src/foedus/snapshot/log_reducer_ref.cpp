@@ -58,6 +58,14 @@ uint32_t LogReducerRef::get_total_storage_count() const {
   return control_block_->total_storage_count_;
 }
 
+bool LogReducerRef::is_merge_completed() const {
+  return control_block_->merge_completed_;
+}
+
+const storage::ComposeStatistics& LogReducerRef::get_compose_statistics() const {
+  return control_block_->compose_statistics_;
+}
+
 uint32_t    LogReducerRef::get_current_buffer_index_atomic() const {
   return control_block_->current_buffer_;
 }
@@ -35,6 +35,9 @@ Epoch SnapshotManager::get_snapshot_epoch() const { return pimpl_->get_snapshot_
 Epoch SnapshotManager::get_snapshot_epoch_weak() const {
   return pimpl_->get_snapshot_epoch_weak();
 }
+uint64_t SnapshotManager::get_snapshot_install_sequence() const {
+  return pimpl_->get_snapshot_install_sequence();
+}
 
 SnapshotId SnapshotManager::get_previous_snapshot_id() const {
   return pimpl_->get_previous_snapshot_id();
@@ -223,11 +223,19 @@ void SnapshotManagerPimpl::handle_snapshot() {
     }
 
     if (triggered) {
-      Snapshot new_snapshot;
-      ErrorStack stack = handle_snapshot_triggered(&new_snapshot);
-      if (stack.is_error()) {
-        LOG(ERROR) << "Snapshot failed:" << stack;
+      // Dekker-style handshake with begin_bulk_load(). Either we see the bulk-loader,
+      // or the bulk-loader sees us and waits.
+      control_block_->snapshot_in_progress_.store(true);
+      if (control_block_->active_bulk_loads_.load() > 0) {
+        LOG(INFO) << "Bulk-loads are running. Postponed snapshotting until they are done";
+      } else {
+        Snapshot new_snapshot;
+        ErrorStack stack = handle_snapshot_triggered(&new_snapshot);
+        if (stack.is_error()) {
+          LOG(ERROR) << "Snapshot failed:" << stack;
+        }
       }
+      control_block_->snapshot_in_progress_.store(false);
     } else {
       VLOG(1) << "Snapshotting not triggered. going to sleep again";
     }
@@ -365,8 +373,17 @@ ErrorStack SnapshotManagerPimpl::handle_snapshot_triggered(Snapshot *new_snapsho
   // Invokes savepoint module to make sure this snapshot has "happened".
   CHECK_ERROR(snapshot_savepoint(*new_snapshot));
 
+  // Now the bulk-loaded records are in the snapshot. We don't need the bulk-load files.
+  remove_pending_bulk_loads();
+
   // install pointers to snapshot pages and drop volatile pages.
-  CHECK_ERROR(drop_volatile_pages(*new_snapshot, new_root_page_pointers));
+  // The install sequence stays odd until we publish the new snapshot epoch below.
+  control_block_->snapshot_install_sequence_.fetch_add(1U);
+  ErrorStack drop_result = drop_volatile_pages(*new_snapshot, new_root_page_pointers);
+  if (drop_result.is_error()) {
+    control_block_->snapshot_install_sequence_.fetch_add(1U);
+    return drop_result;
+  }
 
   Epoch new_snapshot_epoch = new_snapshot->valid_until_epoch_;
   ASSERT_ND(new_snapshot_epoch.is_valid() &&
@@ -378,6 +395,7 @@ ErrorStack SnapshotManagerPimpl::handle_snapshot_triggered(Snapshot *new_snapsho
   previous_snapshot_time_ = std::chrono::system_clock::now();
 
   control_block_->snapshot_epoch_ = epoch_after;
+  control_block_->snapshot_install_sequence_.fetch_add(1U);
   assorted::memory_fence_release();
   control_block_->snapshot_taken_.signal();
   return kRetOk;
@@ -485,6 +503,53 @@ fs::Path SnapshotManagerPimpl::get_snapshot_metadata_file_path(SnapshotId snapsh
   return file;
 }
 
+ErrorCode SnapshotManagerPimpl::begin_bulk_load() {
+  {
+    // Reserve a slot in the pending list now so that end_bulk_load() never fails.
+    soc::SharedMutexScope scope(&control_block_->pending_bulk_loads_mutex_);
+    if (control_block_->pending_bulk_loads_count_ + control_block_->active_bulk_loads_.load()
+        >= static_cast<uint32_t>(SnapshotManagerControlBlock::kMaxPendingBulkLoads)) {
+      return kErrorCodeSnapshotTooManyBulkLoads;
+    }
+    control_block_->active_bulk_loads_.fetch_add(1U);
+  }
+  // If a snapshot is now running, it might not have seen us. Wait for it.
+  SPINLOCK_WHILE(control_block_->snapshot_in_progress_.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return kErrorCodeOk;
+}
+
+void SnapshotManagerPimpl::end_bulk_load(storage::StorageId committed_storage_id) {
+  // no snapshot runs while we are active, but concurrent bulk-loaders might modify the list.
+  soc::SharedMutexScope scope(&control_block_->pending_bulk_loads_mutex_);
+  if (committed_storage_id != 0) {
+    ASSERT_ND(control_block_->pending_bulk_loads_count_
+      < static_cast<uint32_t>(SnapshotManagerControlBlock::kMaxPendingBulkLoads));
+    control_block_->pending_bulk_loads_[control_block_->pending_bulk_loads_count_]
+      = committed_storage_id;
+    ++control_block_->pending_bulk_loads_count_;
+  }
+  ASSERT_ND(control_block_->active_bulk_loads_.load() > 0);
+  control_block_->active_bulk_loads_.fetch_sub(1U);
+}
+
+fs::Path SnapshotManagerPimpl::get_bulk_load_file_path(storage::StorageId storage_id) const {
+  fs::Path path(get_option().get_primary_folder_path());
+  path /= std::string("bulk_load_") + std::to_string(storage_id);
+  return path;
+}
+
+void SnapshotManagerPimpl::remove_pending_bulk_loads() {
+  for (uint32_t i = 0; i < control_block_->pending_bulk_loads_count_; ++i) {
+    fs::Path path = get_bulk_load_file_path(control_block_->pending_bulk_loads_[i]);
+    LOG(INFO) << "Bulk-loaded storage-" << control_block_->pending_bulk_loads_[i]
+      << " is now in the snapshot. Deleting " << path;
+    fs::remove(path);
+  }
+  control_block_->pending_bulk_loads_count_ = 0;
+}
+
 ErrorStack SnapshotManagerPimpl::drop_volatile_pages(
   const Snapshot& new_snapshot,
   const std::map<storage::StorageId, storage::SnapshotPagePointer>& new_root_page_pointers) {
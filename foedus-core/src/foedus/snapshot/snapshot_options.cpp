@@ -33,6 +33,8 @@ SnapshotOptions::SnapshotOptions() {
   log_reducer_buffer_mb_ = kDefaultLogReducerBufferMb;
   log_reducer_dump_io_buffer_mb_ = kDefaultLogReducerDumpIoBufferMb;
   log_reducer_read_io_buffer_kb_ = kDefaultLogReducerReadIoBufferKb;
+  log_reducer_sort_threads_ = 1;
+  pipeline_root_construction_ = true;
   snapshot_writer_page_pool_size_mb_ = kDefaultSnapshotWriterPagePoolSizeMb;
   snapshot_writer_intermediate_pool_size_mb_ = kDefaultSnapshotWriterIntermediatePoolSizeMb;
 }
@@ -60,6 +62,8 @@ ErrorStack SnapshotOptions::load(tinyxml2::XMLElement* element) {
   EXTERNALIZE_LOAD_ELEMENT(element, log_reducer_buffer_mb_);
   EXTERNALIZE_LOAD_ELEMENT(element, log_reducer_dump_io_buffer_mb_);
   EXTERNALIZE_LOAD_ELEMENT(element, log_reducer_read_io_buffer_kb_);
+  EXTERNALIZE_LOAD_ELEMENT(element, log_reducer_sort_threads_);
+  EXTERNALIZE_LOAD_ELEMENT(element, pipeline_root_construction_);
   EXTERNALIZE_LOAD_ELEMENT(element, snapshot_writer_page_pool_size_mb_);
   EXTERNALIZE_LOAD_ELEMENT(element, snapshot_writer_intermediate_pool_size_mb_);
   CHECK_ERROR(get_child_element(element, "SnapshotDeviceEmulationOptions", &emulation_))
@@ -95,6 +99,11 @@ ErrorStack SnapshotOptions::save(tinyxml2::XMLElement* element) const {
   EXTERNALIZE_SAVE_ELEMENT(element, log_reducer_read_io_buffer_kb_,
     "The size in KB of a buffer in reducer to read one temporary file. Note that the total"
     " memory consumption is this number times the number of temporary files. It's a merge-sort.");
+  EXTERNALIZE_SAVE_ELEMENT(element, log_reducer_sort_threads_,
+    "Max number of threads each reducer uses to sort a large batch of logs. Default is 1.");
+  EXTERNALIZE_SAVE_ELEMENT(element, pipeline_root_construction_,
+    "Whether the gleaner constructs root pages of storages while reducers are still"
+    " merge-sorting other storages. Default is true.");
   EXTERNALIZE_SAVE_ELEMENT(element, snapshot_writer_page_pool_size_mb_,
     "The size in MB of one snapshot writer, which holds data pages modified in the snapshot"
     " and them sequentially dumps them to a file for each storage.");
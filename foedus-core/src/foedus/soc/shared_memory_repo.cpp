@@ -451,6 +451,10 @@ void SharedMemoryRepo::set_node_memory_anchors(
     total += ThreadMemoryAnchors::kTaskOutputMemorySize;
     put_node_memory_boundary(node, &total, "thread_task_output_memory_boundary", reset_boundaries);
 
+    thread_anchor.task_queue_memory_ = reinterpret_cast<thread::TaskQueue*>(base + total);
+    total += ThreadMemoryAnchors::kTaskQueueMemorySize;
+    put_node_memory_boundary(node, &total, "thread_task_queue_memory_boundary", reset_boundaries);
+
     thread_anchor.mcs_ww_lock_memories_ = reinterpret_cast<xct::McsWwBlock*>(base + total);
     total += ThreadMemoryAnchors::kMcsWwLockMemorySize;
     put_node_memory_boundary(node, &total, "thread_mcs_lock_memories_boundary", reset_boundaries);
@@ -520,6 +524,7 @@ uint64_t SharedMemoryRepo::calculate_node_memory_size(const EngineOptions& optio
   total += threads_per_node * (ThreadMemoryAnchors::kThreadMemorySize + kBoundarySize);
   total += threads_per_node * (ThreadMemoryAnchors::kTaskInputMemorySize + kBoundarySize);
   total += threads_per_node * (ThreadMemoryAnchors::kTaskOutputMemorySize + kBoundarySize);
+  total += threads_per_node * (ThreadMemoryAnchors::kTaskQueueMemorySize + kBoundarySize);
   total += threads_per_node * (ThreadMemoryAnchors::kMcsWwLockMemorySize + kBoundarySize);
   total += threads_per_node * (ThreadMemoryAnchors::kMcsRwLockMemorySize + kBoundarySize);
   total += threads_per_node * (ThreadMemoryAnchors::kMcsRwLockMemorySize + kBoundarySize);
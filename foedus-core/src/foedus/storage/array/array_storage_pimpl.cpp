@@ -163,6 +163,45 @@ ErrorCode ArrayStorage::increment_record_oneshot(
     payload_offset);
 }
 
+template <typename T>
+ErrorCode ArrayStorage::increment_record_striped(
+  thread::Thread* context,
+  ArrayOffset offset,
+  T value,
+  uint16_t payload_offset,
+  uint16_t stripes) {
+  if (UNLIKELY(stripes == 0 || offset + stripes > get_array_size())) {
+    return kErrorCodeInvalidParameter;
+  }
+  const ArrayOffset stripe = context->get_thread_global_ordinal() % stripes;
+  return ArrayStoragePimpl(this).increment_record_oneshot<T>(
+    context,
+    offset + stripe,
+    value,
+    payload_offset);
+}
+
+template <typename T>
+ErrorCode ArrayStorage::get_record_primitive_striped(
+  thread::Thread* context,
+  ArrayOffset offset,
+  T* value,
+  uint16_t payload_offset,
+  uint16_t stripes) {
+  if (UNLIKELY(stripes == 0 || offset + stripes > get_array_size())) {
+    return kErrorCodeInvalidParameter;
+  }
+  ArrayStoragePimpl pimpl(this);
+  T sum = 0;
+  for (uint16_t i = 0; i < stripes; ++i) {
+    T delta;
+    CHECK_ERROR_CODE(pimpl.get_record_primitive<T>(context, offset + i, &delta, payload_offset));
+    sum += delta;
+  }
+  *value = sum;
+  return kErrorCodeOk;
+}
+
 /**
  * Calculate leaf/interior pages we need.
  * @return index=level.
@@ -379,7 +418,15 @@ inline ErrorCode ArrayStoragePimpl::get_record(
   Record *record = nullptr;
   bool snapshot_record;
   CHECK_ERROR_CODE(locate_record_for_read(context, offset, &record, &snapshot_record));
-  CHECK_ERROR_CODE(context->get_current_xct().on_record_read(false, &record->owner_id_));
+  xct::Xct& current_xct = context->get_current_xct();
+  CHECK_ERROR_CODE(current_xct.on_record_read(false, &record->owner_id_));
+  const xct::WriteXctAccess* own_write = current_xct.get_first_write_on_record(&record->owner_id_);
+  if (UNLIKELY(own_write)) {
+    char buffer[kDataSize];
+    read_own_writes(context, record, own_write, buffer);
+    std::memcpy(payload, buffer + payload_offset, payload_count);
+    return kErrorCodeOk;
+  }
   std::memcpy(payload, record->payload_ + payload_offset, payload_count);
   return kErrorCodeOk;
 }
@@ -394,7 +441,15 @@ ErrorCode ArrayStoragePimpl::get_record_primitive(
   Record *record = nullptr;
   bool snapshot_record;
   CHECK_ERROR_CODE(locate_record_for_read(context, offset, &record, &snapshot_record));
-  CHECK_ERROR_CODE(context->get_current_xct().on_record_read(false, &record->owner_id_));
+  xct::Xct& current_xct = context->get_current_xct();
+  CHECK_ERROR_CODE(current_xct.on_record_read(false, &record->owner_id_));
+  const xct::WriteXctAccess* own_write = current_xct.get_first_write_on_record(&record->owner_id_);
+  if (UNLIKELY(own_write)) {
+    char buffer[kDataSize];
+    read_own_writes(context, record, own_write, buffer);
+    std::memcpy(payload, buffer + payload_offset, sizeof(T));
+    return kErrorCodeOk;
+  }
   char* ptr = record->payload_ + payload_offset;
   *payload = *reinterpret_cast<const T*>(ptr);
   return kErrorCodeOk;
@@ -412,10 +467,81 @@ inline ErrorCode ArrayStoragePimpl::get_record_payload(
     current_xct.get_isolation_level() != xct::kDirtyRead) {
     CHECK_ERROR_CODE(current_xct.on_record_read(false, &record->owner_id_));
   }
+  const xct::WriteXctAccess* own_write = current_xct.get_first_write_on_record(&record->owner_id_);
+  if (UNLIKELY(own_write)) {
+    return read_own_writes_payload(context, record, own_write, payload);
+  }
   *payload = record->payload_;
   return kErrorCodeOk;
 }
 
+void ArrayStoragePimpl::read_own_writes(
+  thread::Thread* context,
+  const Record* record,
+  const xct::WriteXctAccess* first_write,
+  char* buffer) {
+  ASSERT_ND(first_write->owner_id_address_ == &record->owner_id_);
+  xct::Xct& current_xct = context->get_current_xct();
+  xct::RwLockableXctId* owner_id = first_write->owner_id_address_;
+  std::memcpy(buffer, record->payload_, get_payload_size());
+  for (const xct::WriteXctAccess* write = first_write;
+        write;
+        write = current_xct.get_next_write_on_record(write)) {
+    ASSERT_ND(write->storage_id_ == get_id());
+    const log::RecordLogType* log_entry = write->log_entry_;
+    if (log_entry->header_.get_type() == log::kLogCodeArrayOverwrite) {
+      reinterpret_cast<const ArrayOverwriteLogType*>(log_entry)->apply_record(
+        context,
+        get_id(),
+        owner_id,
+        buffer);
+    } else {
+      ASSERT_ND(log_entry->header_.get_type() == log::kLogCodeArrayIncrement);
+      reinterpret_cast<const ArrayIncrementLogType*>(log_entry)->apply_record(
+        context,
+        get_id(),
+        owner_id,
+        buffer);
+    }
+  }
+}
+
+ErrorCode ArrayStoragePimpl::read_own_writes_payload(
+  thread::Thread* context,
+  const Record* record,
+  const xct::WriteXctAccess* first_write,
+  const void** payload) {
+  // The caller expects a pointer that stays valid during the transaction.
+  void* buffer;
+  CHECK_ERROR_CODE(context->get_current_xct().acquire_local_work_memory(
+    get_payload_size(),
+    &buffer));
+  read_own_writes(context, record, first_write, reinterpret_cast<char*>(buffer));
+  *payload = buffer;
+  return kErrorCodeOk;
+}
+
+inline bool ArrayStoragePimpl::coalesce_overwrite(
+  xct::WriteXctAccess* last_write,
+  const void *payload,
+  uint16_t payload_offset,
+  uint16_t payload_count) {
+  if (last_write->log_entry_->header_.get_type() != log::kLogCodeArrayOverwrite) {
+    return false;
+  }
+  ArrayOverwriteLogType* log_entry
+    = reinterpret_cast<ArrayOverwriteLogType*>(last_write->log_entry_);
+  if (payload_offset < log_entry->payload_offset_
+    || payload_offset + payload_count > log_entry->payload_offset_ + log_entry->payload_count_) {
+    return false;
+  }
+  std::memcpy(
+    log_entry->get_payload_address() + (payload_offset - log_entry->payload_offset_),
+    payload,
+    payload_count);
+  return true;
+}
+
 inline ErrorCode ArrayStoragePimpl::get_record_for_write(
   thread::Thread* context,
   ArrayOffset offset,
@@ -453,11 +579,16 @@ inline ErrorCode ArrayStoragePimpl::overwrite_record(
   const void *payload,
   uint16_t payload_offset,
   uint16_t payload_count) {
+  xct::Xct& current_xct = context->get_current_xct();
+  xct::WriteXctAccess* last_write = current_xct.get_last_write_on_record(&record->owner_id_);
+  if (last_write && coalesce_overwrite(last_write, payload, payload_offset, payload_count)) {
+    return kErrorCodeOk;
+  }
   uint16_t log_length = ArrayOverwriteLogType::calculate_log_length(payload_count);
   ArrayOverwriteLogType* log_entry = reinterpret_cast<ArrayOverwriteLogType*>(
     context->get_thread_log_buffer().reserve_new_log(log_length));
   log_entry->populate(get_id(), offset, payload, payload_offset, payload_count);
-  return context->get_current_xct().add_to_write_set(
+  return current_xct.add_to_write_set(
     get_id(),
     &record->owner_id_,
     record->payload_,
@@ -471,11 +602,16 @@ inline ErrorCode ArrayStoragePimpl::overwrite_record_primitive(
   Record* record,
   T payload,
   uint16_t payload_offset) {
+  xct::Xct& current_xct = context->get_current_xct();
+  xct::WriteXctAccess* last_write = current_xct.get_last_write_on_record(&record->owner_id_);
+  if (last_write && coalesce_overwrite(last_write, &payload, payload_offset, sizeof(T))) {
+    return kErrorCodeOk;
+  }
   uint16_t log_length = ArrayOverwriteLogType::calculate_log_length(sizeof(T));
   ArrayOverwriteLogType* log_entry = reinterpret_cast<ArrayOverwriteLogType*>(
     context->get_thread_log_buffer().reserve_new_log(log_length));
   log_entry->populate_primitive<T>(get_id(), offset, payload, payload_offset);
-  return context->get_current_xct().add_to_write_set(
+  return current_xct.add_to_write_set(
     get_id(),
     &record->owner_id_,
     record->payload_,
@@ -493,19 +629,21 @@ ErrorCode ArrayStoragePimpl::increment_record(
   // NOTE This version is like other storage's increment implementation.
   // Taking read-set (and potentially locks), read the value, then remember the overwrite log.
   // However the increment_record_oneshot() below is pretty different.
-  CHECK_ERROR_CODE(context->get_current_xct().on_record_read(true, &record->owner_id_));
-  char* ptr = record->payload_ + payload_offset;
-  T tmp = *reinterpret_cast<const T*>(ptr);
+  xct::Xct& current_xct = context->get_current_xct();
+  CHECK_ERROR_CODE(current_xct.on_record_read(true, &record->owner_id_));
+  T tmp;
+  const xct::WriteXctAccess* own_write = current_xct.get_first_write_on_record(&record->owner_id_);
+  if (UNLIKELY(own_write)) {
+    // increment on top of what this transaction has written, then coalesce below
+    char buffer[kDataSize];
+    read_own_writes(context, record, own_write, buffer);
+    std::memcpy(&tmp, buffer + payload_offset, sizeof(T));
+  } else {
+    char* ptr = record->payload_ + payload_offset;
+    tmp = *reinterpret_cast<const T*>(ptr);
+  }
   *value += tmp;
-  uint16_t log_length = ArrayOverwriteLogType::calculate_log_length(sizeof(T));
-  ArrayOverwriteLogType* log_entry = reinterpret_cast<ArrayOverwriteLogType*>(
-    context->get_thread_log_buffer().reserve_new_log(log_length));
-  log_entry->populate_primitive<T>(get_id(), offset, *value, payload_offset);
-  return context->get_current_xct().add_to_write_set(
-    get_id(),
-    &record->owner_id_,
-    record->payload_,
-    log_entry);
+  return overwrite_record_primitive<T>(context, offset, record, *value, payload_offset);
 }
 
 template <typename T>
@@ -710,6 +848,17 @@ inline ErrorCode ArrayStoragePimpl::get_record_primitive_batch(
     char* ptr = record_batch[i]->payload_ + payload_offset;
     payload_batch[i] = *reinterpret_cast<const T*>(ptr);
   }
+  if (UNLIKELY(current_xct.get_write_set_size() > 0)) {
+    for (uint8_t i = 0; i < batch_size; ++i) {
+      const xct::WriteXctAccess* own_write
+        = current_xct.get_first_write_on_record(&record_batch[i]->owner_id_);
+      if (own_write) {
+        char buffer[kDataSize];
+        read_own_writes(context, record_batch[i], own_write, buffer);
+        std::memcpy(payload_batch + i, buffer + payload_offset, sizeof(T));
+      }
+    }
+  }
   return kErrorCodeOk;
 }
 
@@ -740,6 +889,19 @@ inline ErrorCode ArrayStoragePimpl::get_record_payload_batch(
   for (uint8_t i = 0; i < batch_size; ++i) {
     payload_batch[i] = record_batch[i]->payload_;
   }
+  if (UNLIKELY(current_xct.get_write_set_size() > 0)) {
+    for (uint8_t i = 0; i < batch_size; ++i) {
+      const xct::WriteXctAccess* own_write
+        = current_xct.get_first_write_on_record(&record_batch[i]->owner_id_);
+      if (own_write) {
+        CHECK_ERROR_CODE(read_own_writes_payload(
+          context,
+          record_batch[i],
+          own_write,
+          &payload_batch[i]));
+      }
+    }
+  }
   return kErrorCodeOk;
 }
 
@@ -1174,6 +1336,16 @@ INSTANTIATE_ALL_NUMERIC_TYPES(EX_INC1S);
 #define EX_INC1S_IMPL(x) template ErrorCode ArrayStoragePimpl::increment_record_oneshot< x > \
   (thread::Thread* context, ArrayOffset offset, x value, uint16_t payload_offset)
 INSTANTIATE_ALL_NUMERIC_TYPES(EX_INC1S_IMPL);
+
+#define EX_INC_STRIPED(x) template ErrorCode ArrayStorage::increment_record_striped< x > \
+  (thread::Thread* context, ArrayOffset offset, x value, uint16_t payload_offset, \
+  uint16_t stripes)
+INSTANTIATE_ALL_NUMERIC_TYPES(EX_INC_STRIPED);
+
+#define EX_GET_STRIPED(x) template ErrorCode ArrayStorage::get_record_primitive_striped< x > \
+  (thread::Thread* context, ArrayOffset offset, x* value, uint16_t payload_offset, \
+  uint16_t stripes)
+INSTANTIATE_ALL_NUMERIC_TYPES(EX_GET_STRIPED);
 // @endcond
 
 }  // namespace array
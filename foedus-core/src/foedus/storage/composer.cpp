@@ -43,6 +43,14 @@ std::ostream& operator<<(std::ostream& o, const Composer& v) {
     << "</Composer>";
   return o;
 }
+std::ostream& operator<<(std::ostream& o, const ComposeStatistics& v) {
+  o << "<ComposeStatistics>"
+    << "<pages_written_>" << v.pages_written_ << "</pages_written_>"
+    << "<previous_pages_read_>" << v.previous_pages_read_ << "</previous_pages_read_>"
+    << "<pages_reused_>" << v.pages_reused_ << "</pages_reused_>"
+    << "</ComposeStatistics>";
+  return o;
+}
 std::ostream& operator<<(std::ostream& o, const Composer::DropResult& v) {
   o << "<DropResult>"
     << "<max_observed_>" << v.max_observed_ << "</max_observed_>"
@@ -58,26 +66,64 @@ Composer::Composer(Engine *engine, StorageId storage_id)
     storage_type_(engine_->get_storage_manager()->get_storage(storage_id_)->meta_.type_) {}
 
 
+namespace {
+/**
+ * Counts pages written to the snapshot writer and read from the snapshot files during
+ * compose()/construct_root(), which are common to all storage types.
+ */
+struct ComposeIoCounter {
+  ComposeIoCounter(snapshot::SnapshotWriter* writer, cache::SnapshotFileSet* files)
+    : writer_(writer),
+      files_(files),
+      written_before_(extract_local_page_id_from_snapshot_pointer(writer->get_next_page_id())),
+      read_before_(files->get_read_page_count()) {}
+
+  void add_to(ComposeStatistics* statistics) const {
+    if (statistics) {
+      statistics->pages_written_
+        += extract_local_page_id_from_snapshot_pointer(writer_->get_next_page_id())
+          - written_before_;
+      statistics->previous_pages_read_ += files_->get_read_page_count() - read_before_;
+    }
+  }
+
+  snapshot::SnapshotWriter* const writer_;
+  cache::SnapshotFileSet* const   files_;
+  const SnapshotLocalPageId       written_before_;
+  const uint64_t                  read_before_;
+};
+}  // namespace
+
 ErrorStack Composer::compose(const ComposeArguments& args) {
+  ComposeIoCounter counter(args.snapshot_writer_, args.previous_snapshot_files_);
+  ErrorStack ret;
   switch (storage_type_) {
-    case kArrayStorage: return array::ArrayComposer(this).compose(args);
-    case kHashStorage: return hash::HashComposer(this).compose(args);
-    case kSequentialStorage: return sequential::SequentialComposer(this).compose(args);
-    case kMasstreeStorage: return masstree::MasstreeComposer(this).compose(args);
+    case kArrayStorage: ret = array::ArrayComposer(this).compose(args); break;
+    case kHashStorage: ret = hash::HashComposer(this).compose(args); break;
+    case kSequentialStorage: ret = sequential::SequentialComposer(this).compose(args); break;
+    case kMasstreeStorage: ret = masstree::MasstreeComposer(this).compose(args); break;
     default:
       return kRetOk;
   }
+  counter.add_to(args.statistics_);
+  return ret;
 }
 
 ErrorStack Composer::construct_root(const ConstructRootArguments& args) {
+  ComposeIoCounter counter(args.snapshot_writer_, args.previous_snapshot_files_);
+  ErrorStack ret;
   switch (storage_type_) {
-    case kArrayStorage: return array::ArrayComposer(this).construct_root(args);
-    case kHashStorage: return hash::HashComposer(this).construct_root(args);
-    case kSequentialStorage: return sequential::SequentialComposer(this).construct_root(args);
-    case kMasstreeStorage: return masstree::MasstreeComposer(this).construct_root(args);
+    case kArrayStorage: ret = array::ArrayComposer(this).construct_root(args); break;
+    case kHashStorage: ret = hash::HashComposer(this).construct_root(args); break;
+    case kSequentialStorage:
+      ret = sequential::SequentialComposer(this).construct_root(args);
+      break;
+    case kMasstreeStorage: ret = masstree::MasstreeComposer(this).construct_root(args); break;
     default:
       return kRetOk;
   }
+  counter.add_to(args.statistics_);
+  return ret;
 }
 
 Composer::DropResult Composer::drop_volatiles(const DropVolatilesArguments& args) {
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include "foedus/storage/hash/hash_bulk_loader.hpp"
+
+#include <string>
+#include <utility>
+
+#include "foedus/assert_nd.hpp"
+#include "foedus/compiler.hpp"
+#include "foedus/engine.hpp"
+#include "foedus/memory/engine_memory.hpp"
+#include "foedus/memory/page_resolver.hpp"
+#include "foedus/storage/hash/hash_hashinate.hpp"
+#include "foedus/storage/hash/hash_log_types.hpp"
+#include "foedus/storage/hash/hash_metadata.hpp"
+#include "foedus/storage/hash/hash_page_impl.hpp"
+#include "foedus/storage/hash/hash_storage.hpp"
+#include "foedus/storage/hash/hash_storage_pimpl.hpp"
+#include "foedus/xct/xct_id.hpp"
+
+namespace foedus {
+namespace storage {
+namespace hash {
+
+HashBulkLoader::HashBulkLoader(Engine* engine, StorageId storage_id)
+  : snapshot::BulkLoader(engine, storage_id),
+  bin_bits_(0),
+  current_bin_(kInvalidHashBin) {
+  HashStorage storage(engine_, storage_id_);
+  if (storage.exists()) {
+    bin_bits_ = storage.get_bin_bits();
+  }
+}
+
+HashBin HashBulkLoader::get_bin(const void* key, uint16_t key_length) const {
+  ASSERT_ND(bin_bits_ > 0);
+  return hashinate(key, key_length) >> (64U - bin_bits_);
+}
+
+ErrorCode HashBulkLoader::check_storage() {
+  current_bin_ = kInvalidHashBin;
+  current_bin_keys_.clear();
+  HashStorage storage(engine_, storage_id_);
+  if (!storage.exists()) {
+    return kErrorCodeStrAlreadyDropped;
+  }
+  bin_bits_ = storage.get_bin_bits();
+  const DualPagePointer& root_pointer = storage.get_control_block()->root_page_pointer_;
+  if (root_pointer.snapshot_pointer_ != 0 || root_pointer.volatile_pointer_.is_null()) {
+    return kErrorCodeSnapshotBulkLoadNotEmpty;
+  }
+
+  // An empty hash storage has only the root page. See HashStoragePimpl::create().
+  // HashComposer::construct_root() installs the new snapshot pointers to the root page.
+  const memory::GlobalVolatilePageResolver& resolver
+    = engine_->get_memory_manager()->get_global_volatile_page_resolver();
+  const HashIntermediatePage* root = reinterpret_cast<const HashIntermediatePage*>(
+    resolver.resolve_offset(root_pointer.volatile_pointer_));
+  for (uint16_t i = 0; i < storage.get_root_children(); ++i) {
+    const DualPagePointer& child_pointer = root->get_pointer(i);
+    if (child_pointer.snapshot_pointer_ != 0 || !child_pointer.volatile_pointer_.is_null()) {
+      return kErrorCodeSnapshotBulkLoadNotEmpty;
+    }
+  }
+  return kErrorCodeOk;
+}
+
+ErrorCode HashBulkLoader::append(
+  const void* key,
+  uint16_t key_length,
+  const void* payload,
+  uint16_t payload_count) {
+  const HashValue hash = hashinate(key, key_length);
+  const HashBin bin = hash >> (64U - bin_bits_);
+  if (bin != current_bin_) {
+    if (UNLIKELY(current_bin_ != kInvalidHashBin && bin < current_bin_)) {
+      return kErrorCodeSnapshotBulkLoadUnsorted;
+    }
+    current_bin_ = bin;
+    current_bin_keys_.clear();
+  }
+  std::string key_str(reinterpret_cast<const char*>(key), key_length);
+  for (const std::string& another : current_bin_keys_) {
+    if (UNLIKELY(another == key_str)) {
+      return kErrorCodeSnapshotBulkLoadUnsorted;
+    }
+  }
+  // HashComposer orders records in a bin by XctId, so we give increasing ordinals.
+  const uint32_t ordinal = current_bin_keys_.size() + 1U;
+  if (UNLIKELY(ordinal > xct::kMaxXctOrdinal)) {
+    return kErrorCodeSnapshotBulkLoadTooLarge;
+  }
+
+  uint16_t log_length = HashInsertLogType::calculate_log_length(key_length, payload_count);
+  HashInsertLogType* log_entry = reinterpret_cast<HashInsertLogType*>(reserve_log(log_length));
+  log_entry->populate(storage_id_, key, key_length, bin_bits_, hash, payload, payload_count);
+  CHECK_ERROR_CODE(append_reserved_log(key_length, ordinal));
+  current_bin_keys_.emplace_back(std::move(key_str));
+  return kErrorCodeOk;
+}
+
+}  // namespace hash
+}  // namespace storage
+}  // namespace foedus
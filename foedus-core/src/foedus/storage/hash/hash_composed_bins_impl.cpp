@@ -98,6 +98,7 @@ ErrorStack ComposedBinsMergedStream::init(
   ASSERT_ND(root_page->get_level() >= 1U);
   snapshot_id_ = writer->get_snapshot_id();
   std::memset(cur_path_, 0, sizeof(cur_path_));
+  pages_reused_ = 0;
 
   inputs_memory_.reset(new ComposedBinsBuffer[input_count]);
   inputs_ = inputs_memory_.get();
@@ -294,6 +295,9 @@ ErrorCode ComposedBinsMergedStream::assure_writer_buffer(
   ASSERT_ND(*writer_buffer_pos <= writer->get_page_size());
   ASSERT_ND(writer_higher_buffer_pos <= writer->get_intermediate_size());
   if (UNLIKELY(*writer_buffer_pos == writer->get_page_size())) {
+    count_reused_pointers(
+      reinterpret_cast<const HashIntermediatePage*>(writer->get_page_base()),
+      *writer_buffer_pos);
     CHECK_ERROR_CODE(writer->dump_pages(0, *writer_buffer_pos));
     *writer_buffer_pos = 0;
   }
@@ -304,6 +308,19 @@ ErrorCode ComposedBinsMergedStream::assure_writer_buffer(
   return kErrorCodeOk;
 }
 
+void ComposedBinsMergedStream::count_reused_pointers(
+  const HashIntermediatePage* pages,
+  uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    for (uint16_t j = 0; j < kHashIntermediatePageFanout; ++j) {
+      SnapshotPagePointer pointer = pages[i].get_pointer(j).snapshot_pointer_;
+      if (pointer != 0 && extract_snapshot_id_from_snapshot_pointer(pointer) != snapshot_id_) {
+        ++pages_reused_;
+      }
+    }
+  }
+}
+
 }  // namespace hash
 }  // namespace storage
 }  // namespace foedus
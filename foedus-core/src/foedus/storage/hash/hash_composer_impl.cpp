@@ -161,13 +161,16 @@ ErrorStack HashComposer::construct_root(const Composer::ConstructRootArguments&
 
     const uint16_t nodes = engine_->get_soc_count();
     std::unique_ptr< ErrorStack[] > error_stacks(new ErrorStack[nodes]);
+    std::unique_ptr< ComposeStatistics[] > statistics(new ComposeStatistics[nodes]);
     for (uint16_t numa_node = 0; numa_node < nodes; ++numa_node) {
+      statistics.get()[numa_node].clear();
       threads.emplace_back(
         HashComposer::launch_construct_root_multi_level,
         this,
         &args,
         numa_node,
         root_page,
+        statistics.get() + numa_node,
         error_stacks.get() + numa_node);
     }
 
@@ -182,6 +185,11 @@ ErrorStack HashComposer::construct_root(const Composer::ConstructRootArguments&
       CHECK_ERROR(error_stacks.get()[numa_node]);
     }
     LOG(INFO) << to_string() << " construct_root() joined";
+    if (args.statistics_) {
+      for (uint16_t numa_node = 0; numa_node < nodes; ++numa_node) {
+        args.statistics_->add(statistics.get()[numa_node]);
+      }
+    }
     // propagate errors.
     for (uint16_t numa_node = 0; numa_node < nodes; ++numa_node) {
       CHECK_ERROR(error_stacks.get()[numa_node]);
@@ -191,6 +199,14 @@ ErrorStack HashComposer::construct_root(const Composer::ConstructRootArguments&
   // write out root_page image
   SnapshotPagePointer new_root_page_id = args.snapshot_writer_->get_next_page_id();
   root_page->header().page_id_ = new_root_page_id;
+  if (args.statistics_) {
+    const snapshot::SnapshotId new_snapshot_id = args.snapshot_writer_->get_snapshot_id();
+    for (uint16_t i = 0; i < kHashIntermediatePageFanout; ++i) {
+      args.statistics_->on_pointer_written(
+        root_page->get_pointer(i).snapshot_pointer_,
+        new_snapshot_id);
+    }
+  }
   std::memcpy(args.snapshot_writer_->get_page_base(), root_page, kPageSize);
   WRAP_ERROR_CODE(args.snapshot_writer_->dump_pages(0, 1));
   ASSERT_ND(args.snapshot_writer_->get_next_page_id() == new_root_page_id + 1ULL);
@@ -259,7 +275,8 @@ ErrorStack HashComposer::construct_root_single_level(
 ErrorStack HashComposer::construct_root_multi_level(
   const Composer::ConstructRootArguments& args,
   uint16_t numa_node,
-  HashIntermediatePage* root_page) {
+  HashIntermediatePage* root_page,
+  ComposeStatistics* out_statistics) {
   const uint16_t nodes = engine_->get_soc_count();
   const uint16_t root_children = storage_.get_root_children();
   ASSERT_ND(numa_node < nodes);
@@ -293,6 +310,7 @@ ErrorStack HashComposer::construct_root_multi_level(
     snapshot_writer = snapshot_writer_to_delete.get();
     CHECK_ERROR(snapshot_writer->open());
   }
+  const SnapshotPagePointer first_page_id = snapshot_writer->get_next_page_id();
 
   const uint32_t inputs = args.root_info_pages_count_;
   ASSERT_ND(inputs > 0);
@@ -350,6 +368,9 @@ ErrorStack HashComposer::construct_root_multi_level(
       // We have modified at least one level-0 page because we had at least one bin.
       // level-0 page knew its page ID back then. just write them out.
       ASSERT_ND(writer_buffer_pos > 0);
+      streams.count_reused_pointers(
+        reinterpret_cast<const HashIntermediatePage*>(snapshot_writer->get_page_base()),
+        writer_buffer_pos);
       WRAP_ERROR_CODE(snapshot_writer->dump_pages(0, writer_buffer_pos));
 
       // higher-levels need to set page IDs because we couldn't know their page IDs back then.
@@ -401,14 +422,21 @@ ErrorStack HashComposer::construct_root_multi_level(
         delete[] ref_counts;
 #endif  // NDEBUG
 
+        streams.count_reused_pointers(higher_base, writer_higher_buffer_pos);
         WRAP_ERROR_CODE(snapshot_writer->dump_intermediates(0, writer_higher_buffer_pos));
         root_page->get_pointer(index).snapshot_pointer_ = base_id;
       }
+      out_statistics->pages_reused_ += streams.pages_reused_;
     }
   }
 
+  out_statistics->previous_pages_read_ += fileset.get_read_page_count();
+
 
   if (numa_node != 0) {
+    // pages written via args.snapshot_writer_ (node-0) are counted by Composer
+    out_statistics->pages_written_
+      += snapshot_writer->get_next_page_id() - first_page_id;
     snapshot_writer_to_delete.get()->close();
   }
 
@@ -1164,6 +1192,14 @@ ErrorStack HashComposeContext::install_snapshot_data_pages_root_child(
 /////////////////////////////////////////////////////////////////////////////
 Composer::DropResult HashComposer::drop_volatiles(const Composer::DropVolatilesArguments& args) {
   Composer::DropResult result(args);
+  if (!args.partitioned_drop_ || args.my_partition_ == 0) {
+    // just one thread does it
+    ErrorStack installed = install_root_children_pointers();
+    if (installed.is_error()) {
+      LOG(ERROR) << to_string() << " failed to install pointers to new root children. "
+        << installed;
+    }
+  }
   if (storage_.get_hash_metadata()->keeps_all_volatile_pages()) {
     LOG(INFO) << "Keep-all-volatile: Storage-" << storage_.get_name()
       << " is configured to keep all volatile pages.";
@@ -1199,6 +1235,34 @@ Composer::DropResult HashComposer::drop_volatiles(const Composer::DropVolatilesA
   return result;
 }
 
+ErrorStack HashComposer::install_root_children_pointers() {
+  // install_snapshot_data_pages() skips root children without volatile pages.
+  // They have new snapshot pages only when the records came from a BulkLoader, which doesn't
+  // make volatile pages. Give them the new pointers here, otherwise the records are invisible.
+  const DualPagePointer& root_pointer = storage_.get_control_block()->root_page_pointer_;
+  HashIntermediatePage* volatile_root = resolve_intermediate(root_pointer.volatile_pointer_);
+  if (volatile_root == nullptr || root_pointer.snapshot_pointer_ == 0) {
+    return kRetOk;
+  }
+
+  cache::SnapshotFileSet fileset(engine_);
+  CHECK_ERROR(fileset.initialize());
+  UninitializeGuard fileset_guard(&fileset, UninitializeGuard::kWarnIfUninitializeError);
+  memory::AlignedMemory buffer;
+  buffer.alloc(kPageSize, kPageSize, memory::AlignedMemory::kNumaAllocOnnode, 0);
+  HashIntermediatePage* root_page = reinterpret_cast<HashIntermediatePage*>(buffer.get_block());
+  WRAP_ERROR_CODE(fileset.read_page(root_pointer.snapshot_pointer_, root_page));
+  ASSERT_ND(root_page->header().storage_id_ == storage_id_);
+  for (uint16_t i = 0; i < storage_.get_root_children(); ++i) {
+    DualPagePointer* pointer = volatile_root->get_pointer_address(i);
+    if (pointer->volatile_pointer_.is_null()) {
+      pointer->snapshot_pointer_ = root_page->get_pointer(i).snapshot_pointer_;
+    }
+  }
+  CHECK_ERROR(fileset.uninitialize());
+  return kRetOk;
+}
+
 void HashComposer::drop_volatiles_child(
   const Composer::DropVolatilesArguments& args,
   DualPagePointer* child_pointer,
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include "foedus/storage/hash/hash_cursor.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#include "foedus/assorted/atomic_fences.hpp"
+#include "foedus/storage/page.hpp"
+#include "foedus/storage/hash/hash_hashinate.hpp"
+#include "foedus/storage/hash/hash_page_impl.hpp"
+#include "foedus/storage/hash/hash_storage_pimpl.hpp"
+#include "foedus/thread/thread.hpp"
+#include "foedus/xct/xct.hpp"
+
+namespace foedus {
+namespace storage {
+namespace hash {
+
+HashCursor::HashCursor(HashStorage storage, thread::Thread* context)
+  : engine_(storage.get_engine()),
+    storage_(storage.get_engine(), storage.get_control_block()),
+    context_(context),
+    current_xct_(&context->get_current_xct()) {
+  reached_end_ = true;
+  cur_page_snapshot_ = false;
+  cur_bin_ = 0;
+  cur_level0_ = nullptr;
+  cur_page_ = nullptr;
+  cur_page_record_count_ = 0;
+  cur_slot_ = 0;
+  cur_location_.clear();
+}
+
+HashBinRange HashCursor::get_partition(
+  HashBin bin_count,
+  uint16_t partitions,
+  uint16_t partition) {
+  ASSERT_ND(partitions > 0);
+  ASSERT_ND(partition < partitions);
+  return HashBinRange(
+    bin_count * partition / partitions,
+    bin_count * (partition + 1U) / partitions);
+}
+
+HashValue HashCursor::get_hash() const {
+  ASSERT_ND(is_valid_record());
+  return cur_location_.page_->get_slot(cur_location_.index_).hash_;
+}
+
+ErrorCode HashCursor::open(HashBin begin_bin, HashBin end_bin) {
+  range_ = HashBinRange(begin_bin, std::min<HashBin>(end_bin, storage_.get_bin_count()));
+  reached_end_ = false;
+  cur_bin_ = range_.begin_;
+  cur_level0_ = nullptr;
+  cur_page_ = nullptr;
+  cur_page_record_count_ = 0;
+  cur_slot_ = 0;
+  cur_location_.clear();
+  return seek_valid_record();
+}
+
+ErrorCode HashCursor::next() {
+  ASSERT_ND(is_valid_record());
+  ++cur_slot_;
+  return seek_valid_record();
+}
+
+ErrorCode HashCursor::seek_valid_record() {
+  while (true) {
+    if (cur_page_ == nullptr) {
+      // we are done with the previous bin. cur_bin_ is the next bin to open.
+      if (cur_bin_ >= range_.end_) {
+        reached_end_ = true;
+        cur_location_.clear();
+        return kErrorCodeOk;
+      }
+      CHECK_ERROR_CODE(open_bin());
+      continue;
+    }
+
+    for (; cur_slot_ < cur_page_record_count_; ++cur_slot_) {
+      if (cur_page_snapshot_) {
+        // final in snapshot page, so physical-only suffices (no protection needed).
+        cur_location_.populate_physical(cur_page_, cur_slot_);
+      } else {
+        // [Logical check]: takes read-set unless the record is moved.
+        CHECK_ERROR_CODE(cur_location_.populate_logical(
+          current_xct_,
+          cur_page_,
+          cur_slot_,
+          false));
+      }
+
+      // A moved record has its new location later in the same bin. We will see it there.
+      // A deleted record is skipped, but still in read-set to protect against re-insertion.
+      if (cur_location_.observed_.is_moved() || cur_location_.observed_.is_deleted()) {
+        continue;
+      }
+      return kErrorCodeOk;
+    }
+
+    CHECK_ERROR_CODE(next_page());
+  }
+}
+
+ErrorCode HashCursor::open_bin() {
+  ASSERT_ND(cur_page_ == nullptr);
+  ASSERT_ND(range_.contains(cur_bin_));
+  HashStoragePimpl pimpl(&storage_);
+  const IntermediateRoute route = IntermediateRoute::construct(cur_bin_);
+  if (cur_level0_ == nullptr || !cur_level0_->get_bin_range().contains(cur_bin_)) {
+    // Walk down to the level-0 page that contains this bin. We reuse it for the following
+    // kHashIntermediatePageFanout bins at most, so this is not a frequent operation.
+    cur_level0_ = nullptr;
+    HashIntermediatePage* parent;
+    CHECK_ERROR_CODE(pimpl.get_root_page(context_, false, &parent));
+    while (parent->get_level() > 0) {
+      const uint8_t parent_level = parent->get_level();
+      const uint16_t index = route.route[parent_level];
+      Page* next;
+      CHECK_ERROR_CODE(pimpl.follow_page(context_, false, parent, index, &next));
+      if (next == nullptr) {
+        // The whole subtree doesn't exist. Protect the result like locate_bin(), then skip it.
+        if (!parent->header().snapshot_) {
+          VolatilePagePointer volatile_null;
+          volatile_null.clear();
+          CHECK_ERROR_CODE(current_xct_->add_to_pointer_set(
+            &parent->get_pointer(index).volatile_pointer_,
+            volatile_null));
+        }
+        const uint64_t subtree_bins = kHashMaxBins[parent_level];
+        cur_bin_ = (cur_bin_ / subtree_bins + 1U) * subtree_bins;
+        return kErrorCodeOk;
+      }
+      parent = reinterpret_cast<HashIntermediatePage*>(next);
+    }
+    cur_level0_ = parent;
+  }
+
+  cur_level0_->assert_bin(cur_bin_);
+  Page* bin_head;
+  CHECK_ERROR_CODE(pimpl.follow_page(context_, false, cur_level0_, route.route[0], &bin_head));
+  if (bin_head == nullptr) {
+    // Empty bin. follow_page() has already added a pointer set if the parent is volatile.
+    ++cur_bin_;
+    return kErrorCodeOk;
+  }
+  return open_page(reinterpret_cast<HashDataPage*>(bin_head));
+}
+
+ErrorCode HashCursor::open_page(HashDataPage* page) {
+  ASSERT_ND(page->get_bin() == cur_bin_);
+  cur_page_ = page;
+  cur_page_snapshot_ = page->header().snapshot_;
+  cur_slot_ = 0;
+  if (cur_page_snapshot_) {
+    // snapshot world. no race.
+    cur_page_record_count_ = page->get_record_count();
+    return kErrorCodeOk;
+  }
+
+  // we are in volatile page, there might be a race! Same protocol as locate_record().
+  while (true) {
+    const uint16_t record_count = page->get_record_count();
+    PageVersionStatus page_status = page->header().page_version_.status_;
+    assorted::memory_fence_acquire();  // from now on, page_status is the ground truth here.
+    if (UNLIKELY(record_count != page->get_record_count())) {
+      DVLOG(1) << "Interesting. concurrent insertion just happend to the page";
+      continue;
+    }
+    if (UNLIKELY(!page_status.has_next_page() && !page->next_page().volatile_pointer_.is_null())) {
+      DVLOG(1) << "Interesting. concurrent next-page installation just happend to the page";
+      continue;
+    }
+
+    cur_page_record_count_ = record_count;
+    if (!page_status.has_next_page()) {
+      // This is the last page in the bin. [Logical check]: Remember the page_status we observed
+      // so that a new page appended to the bin is detected at commit time.
+      CHECK_ERROR_CODE(current_xct_->add_to_page_version_set(
+        &page->header().page_version_,
+        page_status));
+    }
+    return kErrorCodeOk;
+  }
+}
+
+ErrorCode HashCursor::next_page() {
+  ASSERT_ND(cur_page_);
+  const DualPagePointer& next = cur_page_->next_page();
+  HashDataPage* next_page = nullptr;
+  if (cur_page_snapshot_) {
+    ASSERT_ND(next.volatile_pointer_.is_null());
+    if (next.snapshot_pointer_) {
+      Page* page;
+      CHECK_ERROR_CODE(context_->find_or_read_a_snapshot_page(next.snapshot_pointer_, &page));
+      ASSERT_ND(page->get_header().snapshot_);
+      next_page = reinterpret_cast<HashDataPage*>(page);
+    }
+  } else if (!next.volatile_pointer_.is_null()) {
+    next_page = context_->resolve_cast<HashDataPage>(next.volatile_pointer_);
+    ASSERT_ND(!next_page->header().snapshot_);
+  }
+
+  cur_page_ = nullptr;
+  if (next_page) {
+    return open_page(next_page);
+  }
+
+  // that was the last page in the bin.
+  ++cur_bin_;
+  return kErrorCodeOk;
+}
+
+}  // namespace hash
+}  // namespace storage
+}  // namespace foedus
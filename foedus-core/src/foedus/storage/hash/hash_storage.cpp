@@ -137,6 +137,65 @@ ErrorCode HashStorage::get_record_primitive(
     read_only);
 }
 
+ErrorCode HashStorage::get_record_batch(
+  thread::Thread* context,
+  uint16_t batch_size,
+  const void* const* key_batch,
+  const uint16_t* key_length_batch,
+  void* const* payload_batch,
+  uint16_t* payload_capacity_batch,
+  bool read_only,
+  ErrorCode* result_batch) {
+  HashStoragePimpl pimpl(this);
+  for (uint16_t cur = 0; cur < batch_size;) {
+    uint16_t chunk = batch_size - cur;
+    if (chunk > HashStoragePimpl::kBatchMax) {
+      chunk = HashStoragePimpl::kBatchMax;
+    }
+    CHECK_ERROR_CODE(pimpl.get_record_batch(
+      context,
+      chunk,
+      &key_batch[cur],
+      &key_length_batch[cur],
+      &payload_batch[cur],
+      &payload_capacity_batch[cur],
+      read_only,
+      &result_batch[cur]));
+    cur += chunk;
+  }
+  return kErrorCodeOk;
+}
+
+template <typename PAYLOAD>
+ErrorCode HashStorage::get_record_primitive_batch(
+  thread::Thread* context,
+  uint16_t payload_offset,
+  uint16_t batch_size,
+  const void* const* key_batch,
+  const uint16_t* key_length_batch,
+  PAYLOAD* payload_batch,
+  bool read_only,
+  ErrorCode* result_batch) {
+  HashStoragePimpl pimpl(this);
+  for (uint16_t cur = 0; cur < batch_size;) {
+    uint16_t chunk = batch_size - cur;
+    if (chunk > HashStoragePimpl::kBatchMax) {
+      chunk = HashStoragePimpl::kBatchMax;
+    }
+    CHECK_ERROR_CODE(pimpl.get_record_primitive_batch(
+      context,
+      payload_offset,
+      chunk,
+      &key_batch[cur],
+      &key_length_batch[cur],
+      &payload_batch[cur],
+      read_only,
+      &result_batch[cur]));
+    cur += chunk;
+  }
+  return kErrorCodeOk;
+}
+
 ErrorCode HashStorage::insert_record(
   thread::Thread* context,
   const void* key,
@@ -314,6 +373,17 @@ INSTANTIATE_ALL_NUMERIC_TYPES(EXPIN_3);
     x* value, \
     uint16_t payload_offset)
 INSTANTIATE_ALL_NUMERIC_TYPES(EXPIN_5);
+
+#define EXPIN_6(x) template ErrorCode HashStorage::get_record_primitive_batch< x > \
+  (thread::Thread* context, \
+    uint16_t payload_offset, \
+    uint16_t batch_size, \
+    const void* const* key_batch, \
+    const uint16_t* key_length_batch, \
+    x* payload_batch, \
+    bool read_only, \
+    ErrorCode* result_batch)
+INSTANTIATE_ALL_NUMERIC_TYPES(EXPIN_6);
 // @endcond
 
 
@@ -247,6 +247,104 @@ ErrorCode HashStoragePimpl::get_record_part(
   return kErrorCodeOk;
 }
 
+ErrorCode HashStoragePimpl::get_record_batch(
+  thread::Thread* context,
+  uint16_t batch_size,
+  const void* const* key_batch,
+  const uint16_t* key_length_batch,
+  void* const* payload_batch,
+  uint16_t* payload_capacity_batch,
+  bool read_only,
+  ErrorCode* result_batch) {
+  ASSERT_ND(batch_size <= kBatchMax);
+  HashCombo combos[kBatchMax];
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    combos[i] = HashCombo(key_batch[i], key_length_batch[i], get_meta());
+  }
+  RecordLocation locations[kBatchMax];
+  CHECK_ERROR_CODE(locate_record_batch(
+    context,
+    !read_only,
+    batch_size,
+    key_batch,
+    key_length_batch,
+    combos,
+    locations));
+
+  // the records are likely in different pages. let's parallelize the cache misses here, too.
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    if (locations[i].is_found()) {
+      assorted::prefetch_cacheline(locations[i].record_ + locations[i].get_aligned_key_length());
+    }
+  }
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    const RecordLocation& location = locations[i];
+    if (!location.is_found()) {
+      result_batch[i] = kErrorCodeStrKeyNotFound;  // protected by pointer/page version set
+      continue;
+    }
+    uint16_t payload_length = location.cur_payload_length_;
+    if (payload_length > payload_capacity_batch[i]) {
+      DVLOG(0) << "buffer too small??" << payload_length << ":" << payload_capacity_batch[i];
+      payload_capacity_batch[i] = payload_length;
+      result_batch[i] = kErrorCodeStrTooSmallPayloadBuffer;
+      continue;
+    }
+    payload_capacity_batch[i] = payload_length;
+    uint16_t key_offset = location.get_aligned_key_length();
+    std::memcpy(payload_batch[i], location.record_ + key_offset, payload_length);
+    result_batch[i] = kErrorCodeOk;
+  }
+  return kErrorCodeOk;
+}
+
+template <typename PAYLOAD>
+ErrorCode HashStoragePimpl::get_record_primitive_batch(
+  thread::Thread* context,
+  uint16_t payload_offset,
+  uint16_t batch_size,
+  const void* const* key_batch,
+  const uint16_t* key_length_batch,
+  PAYLOAD* payload_batch,
+  bool read_only,
+  ErrorCode* result_batch) {
+  ASSERT_ND(batch_size <= kBatchMax);
+  HashCombo combos[kBatchMax];
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    combos[i] = HashCombo(key_batch[i], key_length_batch[i], get_meta());
+  }
+  RecordLocation locations[kBatchMax];
+  CHECK_ERROR_CODE(locate_record_batch(
+    context,
+    !read_only,
+    batch_size,
+    key_batch,
+    key_length_batch,
+    combos,
+    locations));
+
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    if (locations[i].is_found()) {
+      assorted::prefetch_cacheline(
+        locations[i].record_ + locations[i].get_aligned_key_length() + payload_offset);
+    }
+  }
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    const RecordLocation& location = locations[i];
+    if (!location.is_found()) {
+      result_batch[i] = kErrorCodeStrKeyNotFound;  // protected by pointer/page version set
+    } else if (location.cur_payload_length_ < payload_offset + sizeof(PAYLOAD)) {
+      LOG(WARNING) << "short record " << combos[i];  // probably this is a rare error. so warn.
+      result_batch[i] = kErrorCodeStrTooShortPayload;
+    } else {
+      const char* ptr = location.record_ + location.get_aligned_key_length() + payload_offset;
+      payload_batch[i] = *reinterpret_cast<const PAYLOAD*>(ptr);
+      result_batch[i] = kErrorCodeOk;
+    }
+  }
+  return kErrorCodeOk;
+}
+
 uint16_t adjust_payload_hint(uint16_t payload_count, uint16_t physical_payload_hint) {
   ASSERT_ND(physical_payload_hint >= payload_count);  // if not, most likely misuse.
   if (physical_payload_hint < payload_count) {
@@ -886,6 +984,107 @@ ErrorCode HashStoragePimpl::locate_bin(
   return kErrorCodeOk;
 }
 
+ErrorCode HashStoragePimpl::locate_bin_batch(
+  thread::Thread* context,
+  bool for_write,
+  uint16_t batch_size,
+  const HashCombo* combo_batch,
+  HashDataPage** bin_head_batch) {
+  ASSERT_ND(batch_size <= kBatchMax);
+  HashIntermediatePage* root;
+  CHECK_ERROR_CODE(get_root_page(context, for_write, &root));
+  ASSERT_ND(root);
+  xct::Xct& current_xct = context->get_current_xct();
+
+  // All bins are at the same depth, so every search is at the same level in each iteration.
+  // parents[i] becomes null once the i-th search has finished with a null page.
+  HashIntermediatePage* parents[kBatchMax];
+  const uint8_t root_level = root->get_level();
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    parents[i] = root;
+    bin_head_batch[i] = nullptr;
+    uint16_t index = combo_batch[i].route_.route[root_level];
+    assorted::prefetch_cacheline(root->get_pointer_address(index));
+  }
+
+  for (int16_t level = root_level; level >= 0; --level) {
+    for (uint16_t i = 0; i < batch_size; ++i) {
+      HashIntermediatePage* parent = parents[i];
+      if (!parent) {
+        continue;
+      }
+      ASSERT_ND(parent->get_level() == level);
+      uint16_t index = combo_batch[i].route_.route[level];
+      Page* next;
+      CHECK_ERROR_CODE(follow_page(context, for_write, parent, index, &next));
+      if (!next) {
+        // same as locate_bin(). we just have to add a pointer set to protect the result.
+        ASSERT_ND(!for_write);
+        if (!parent->header().snapshot_
+          && current_xct.get_isolation_level() == xct::kSerializable) {
+          VolatilePagePointer volatile_null;
+          volatile_null.clear();
+          CHECK_ERROR_CODE(
+            current_xct.add_to_pointer_set(
+              &parent->get_pointer(index).volatile_pointer_,
+              volatile_null));
+        }
+        parents[i] = nullptr;
+      } else if (level == 0) {
+        HashDataPage* bin_head = reinterpret_cast<HashDataPage*>(next);
+        ASSERT_ND(bin_head->get_bin() == combo_batch[i].bin_);
+        bin_head_batch[i] = bin_head;
+        // header/next-page/bloom filter are in the first two cachelines,
+        // and the slots grow backwards from the end of the page.
+        assorted::prefetch_cachelines(bin_head, 2);
+        assorted::prefetch_cacheline(bin_head->get_slot_address(0));
+      } else {
+        HashIntermediatePage* child = reinterpret_cast<HashIntermediatePage*>(next);
+        parents[i] = child;
+        assorted::prefetch_cacheline(
+          child->get_pointer_address(combo_batch[i].route_.route[level - 1]));
+      }
+    }
+  }
+
+#ifndef NDEBUG
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    ASSERT_ND(bin_head_batch[i] != nullptr || !for_write);
+  }
+#endif  // NDEBUG
+  return kErrorCodeOk;
+}
+
+ErrorCode HashStoragePimpl::locate_record_batch(
+  thread::Thread* context,
+  bool for_write,
+  uint16_t batch_size,
+  const void* const* key_batch,
+  const uint16_t* key_length_batch,
+  const HashCombo* combo_batch,
+  RecordLocation* result_batch) {
+  ASSERT_ND(batch_size <= kBatchMax);
+  HashDataPage* bin_heads[kBatchMax];
+  CHECK_ERROR_CODE(locate_bin_batch(context, for_write, batch_size, combo_batch, bin_heads));
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    if (!bin_heads[i]) {
+      result_batch[i].clear();  // protected by pointer set
+      continue;
+    }
+    CHECK_ERROR_CODE(locate_record_logical(
+      context,
+      for_write,
+      false,
+      0,
+      key_batch[i],
+      key_length_batch[i],
+      combo_batch[i],
+      bin_heads[i],
+      result_batch + i));
+  }
+  return kErrorCodeOk;
+}
+
 ErrorCode HashStoragePimpl::locate_record_in_snapshot(
   thread::Thread* context,
   const void* key,
@@ -1197,6 +1396,17 @@ xct::TrackMovedRecordResult HashStoragePimpl::track_moved_record_search(
   x* value, \
   uint16_t payload_offset)
 INSTANTIATE_ALL_NUMERIC_TYPES(EXPIN_5I);
+
+#define EXPIN_6I(x) template ErrorCode HashStoragePimpl::get_record_primitive_batch< x > \
+  (thread::Thread* context, \
+  uint16_t payload_offset, \
+  uint16_t batch_size, \
+  const void* const* key_batch, \
+  const uint16_t* key_length_batch, \
+  x* payload_batch, \
+  bool read_only, \
+  ErrorCode* result_batch)
+INSTANTIATE_ALL_NUMERIC_TYPES(EXPIN_6I);
 // @endcond
 
 }  // namespace hash
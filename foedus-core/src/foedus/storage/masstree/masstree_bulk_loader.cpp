@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include "foedus/storage/masstree/masstree_bulk_loader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "foedus/assert_nd.hpp"
+#include "foedus/compiler.hpp"
+#include "foedus/engine.hpp"
+#include "foedus/assorted/endianness.hpp"
+#include "foedus/memory/engine_memory.hpp"
+#include "foedus/memory/page_resolver.hpp"
+#include "foedus/storage/masstree/masstree_log_types.hpp"
+#include "foedus/storage/masstree/masstree_metadata.hpp"
+#include "foedus/storage/masstree/masstree_page_impl.hpp"
+#include "foedus/storage/masstree/masstree_storage.hpp"
+#include "foedus/storage/masstree/masstree_storage_pimpl.hpp"
+
+namespace foedus {
+namespace storage {
+namespace masstree {
+
+MasstreeBulkLoader::MasstreeBulkLoader(Engine* engine, StorageId storage_id)
+  : snapshot::BulkLoader(engine, storage_id),
+  previous_key_length_(0),
+  has_previous_key_(false) {
+}
+
+ErrorCode MasstreeBulkLoader::check_storage() {
+  has_previous_key_ = false;
+  MasstreeStorage storage(engine_, storage_id_);
+  if (!storage.exists()) {
+    return kErrorCodeStrAlreadyDropped;
+  }
+  const MasstreeMetadata* meta = storage.get_masstree_metadata();
+  const DualPagePointer& root_pointer = storage.get_control_block()->root_page_pointer_;
+  if (root_pointer.snapshot_pointer_ != 0 || root_pointer.volatile_pointer_.is_null()) {
+    return kErrorCodeSnapshotBulkLoadNotEmpty;
+  }
+
+  // An empty masstree has a root intermediate page with only one empty border page.
+  // See MasstreeStoragePimpl::load_empty().
+  const memory::GlobalVolatilePageResolver& resolver
+    = engine_->get_memory_manager()->get_global_volatile_page_resolver();
+  const MasstreeIntermediatePage* root = reinterpret_cast<const MasstreeIntermediatePage*>(
+    resolver.resolve_offset(root_pointer.volatile_pointer_));
+  if (root->get_key_count() != 0 || root->has_foster_child()) {
+    return kErrorCodeSnapshotBulkLoadNotEmpty;
+  }
+  const DualPagePointer& child_pointer = root->get_minipage(0).pointers_[0];
+  if (child_pointer.snapshot_pointer_ != 0 || child_pointer.volatile_pointer_.is_null()) {
+    return kErrorCodeSnapshotBulkLoadNotEmpty;
+  }
+  const MasstreeBorderPage* child = reinterpret_cast<const MasstreeBorderPage*>(
+    resolver.resolve_offset(child_pointer.volatile_pointer_));
+  if (child->get_key_count() != 0 || child->has_foster_child()) {
+    return kErrorCodeSnapshotBulkLoadNotEmpty;
+  }
+
+  // The empty volatile pages would hide the new snapshot pages unless they are dropped.
+  // See MasstreeComposer::drop_root_volatile().
+  if (meta->keeps_all_volatile_pages()
+    || meta->snapshot_drop_volatile_pages_layer_threshold_ > 0
+    || root->get_btree_level() >= meta->snapshot_drop_volatile_pages_btree_levels_) {
+    return kErrorCodeSnapshotBulkLoadKeepsVolatile;
+  }
+  return kErrorCodeOk;
+}
+
+ErrorCode MasstreeBulkLoader::append(
+  const void* key,
+  KeyLength key_length,
+  const void* payload,
+  PayloadLength payload_count) {
+  ASSERT_ND(key_length <= kMaxKeyLength);
+  if (UNLIKELY(payload_count > kMaxPayloadLength)) {
+    return kErrorCodeStrTooLongPayload;
+  }
+
+  if (has_previous_key_) {
+    int cmp = std::memcmp(previous_key_, key, std::min(previous_key_length_, key_length));
+    if (UNLIKELY(cmp > 0 || (cmp == 0 && previous_key_length_ >= key_length))) {
+      return kErrorCodeSnapshotBulkLoadUnsorted;
+    }
+  }
+
+  uint16_t log_length = MasstreeInsertLogType::calculate_log_length(key_length, payload_count);
+  MasstreeInsertLogType* log_entry = reinterpret_cast<MasstreeInsertLogType*>(
+    reserve_log(log_length));
+  log_entry->populate(storage_id_, key, key_length, payload, payload_count);
+  // Keys are unique, so the ordinal doesn't matter.
+  CHECK_ERROR_CODE(append_reserved_log(key_length, 1U));
+
+  std::memcpy(previous_key_, key, key_length);
+  previous_key_length_ = key_length;
+  has_previous_key_ = true;
+  return kErrorCodeOk;
+}
+
+ErrorCode MasstreeBulkLoader::append_normalized(
+  KeySlice key,
+  const void* payload,
+  PayloadLength payload_count) {
+  char be_key[sizeof(KeySlice)];
+  assorted::write_bigendian<KeySlice>(key, be_key);
+  return append(be_key, sizeof(be_key), payload, payload_count);
+}
+
+}  // namespace masstree
+}  // namespace storage
+}  // namespace foedus
@@ -191,6 +191,12 @@ ErrorStack MasstreeComposer::construct_root(const Composer::ConstructRootArgumen
 
   new_root->get_header().page_id_ = new_root_id;
   *args.new_root_page_pointer_ = new_root_id;
+  if (args.statistics_) {
+    const snapshot::SnapshotId new_snapshot_id = args.snapshot_writer_->get_snapshot_id();
+    for (MasstreeIntermediatePointerIterator it(merged); it.is_valid(); it.next()) {
+      args.statistics_->on_pointer_written(it.get_pointer().snapshot_pointer_, new_snapshot_id);
+    }
+  }
   WRAP_ERROR_CODE(args.snapshot_writer_->dump_pages(0, 1 + dummy_count));
 
   // AFTER writing out the root page, install the pointer to new root page
@@ -2077,6 +2083,13 @@ ErrorStack MasstreeComposeContext::flush_buffer() {
 
   ASSERT_ND(allocated_pages_ <= max_pages_);
 
+  // 2) Count pointers to unchanged pages of previous snapshots, which we just keep pointing to.
+  if (args_.statistics_) {
+    for (memory::PagePoolOffset i = 1; i < allocated_pages_; ++i) {  // page-0 is a dummy
+      count_reused_pointers(get_page(i));
+    }
+  }
+
   WRAP_ERROR_CODE(get_writer()->dump_pages(0, allocated_pages_));
   allocated_pages_ = 0;
   page_id_base_ = get_writer()->get_next_page_id();
@@ -2084,6 +2097,22 @@ ErrorStack MasstreeComposeContext::flush_buffer() {
   return kRetOk;
 }
 
+void MasstreeComposeContext::count_reused_pointers(MasstreePage* page) const {
+  ComposeStatistics* statistics = args_.statistics_;
+  if (page->is_border()) {
+    MasstreeBorderPage* casted = as_border(page);
+    for (SlotIndex i = 0; i < casted->get_key_count(); ++i) {
+      if (casted->does_point_to_layer(i)) {
+        statistics->on_pointer_written(casted->get_next_layer(i)->snapshot_pointer_, snapshot_id_);
+      }
+    }
+  } else {
+    for (MasstreeIntermediatePointerIterator it(as_intermdiate(page)); it.is_valid(); it.next()) {
+      statistics->on_pointer_written(it.get_pointer().snapshot_pointer_, snapshot_id_);
+    }
+  }
+}
+
 void MasstreeComposeContext::store_cur_prefix(uint8_t layer, KeySlice prefix_slice) {
   assorted::write_bigendian<KeySlice>(prefix_slice, cur_prefix_be_ + layer * kSliceLen);
   cur_prefix_slices_[layer] = prefix_slice;
@@ -31,6 +31,7 @@
 #include "foedus/storage/masstree/masstree_retry_impl.hpp"
 #include "foedus/storage/masstree/masstree_storage.hpp"
 #include "foedus/storage/masstree/masstree_storage_pimpl.hpp"
+#include "foedus/thread/thread.hpp"
 #include "foedus/xct/xct.hpp"
 
 
@@ -45,6 +46,7 @@ MasstreeCursor::MasstreeCursor(MasstreeStorage storage, thread::Thread* context)
     current_xct_(&context->get_current_xct()) {
   for_writes_ = false;
   forward_cursor_ = true;
+  no_cache_ = false;
   reached_end_ = false;
 
   route_count_ = 0;
@@ -171,12 +173,31 @@ MasstreePage* MasstreeCursor::resolve_volatile(VolatilePagePointer ptr) const {
 //
 /////////////////////////////////////////////////////////////////////////////////////////
 
+/** Puts the thread in snapshot cache scan mode during the scope if the cursor says no_cache. */
+struct SnapshotCacheScanScope {
+  SnapshotCacheScanScope(thread::Thread* context, bool no_cache)
+    : context_(context), enabled_(no_cache && !context->is_snapshot_cache_scan_mode()) {
+    if (enabled_) {
+      context_->set_snapshot_cache_scan_mode(true);
+    }
+  }
+  ~SnapshotCacheScanScope() {
+    if (enabled_) {
+      context_->set_snapshot_cache_scan_mode(false);
+    }
+  }
+  thread::Thread* const context_;
+  const bool enabled_;
+};
+
 ErrorCode MasstreeCursor::next() {
   ASSERT_ND(!should_skip_cur_route_);
   if (!is_valid_record()) {
     return kErrorCodeOk;
   }
 
+  SnapshotCacheScanScope scan_scope(context_, no_cache_);
+
   assert_route();
 
   CHECK_ERROR_CODE(proceed_route());
@@ -950,6 +971,7 @@ ErrorCode MasstreeCursor::open(
     return kErrorCodeXctNoXct;
   }
 
+  SnapshotCacheScanScope scan_scope(context_, no_cache_);
   forward_cursor_ = forward_cursor;
   reached_end_ = false;
   for_writes_ = for_writes;
@@ -1003,6 +1025,35 @@ ErrorCode MasstreeCursor::open(
   return kErrorCodeOk;
 }
 
+ErrorCode MasstreeCursor::open_partition(
+  const MasstreeStorage::ScanPartitions& partitions,
+  uint16_t partition,
+  bool for_writes) {
+  ASSERT_ND(partition < partitions.count_);
+  const KeySlice low = partitions.boundaries_[partition];
+  const KeySlice high = partitions.boundaries_[partition + 1U];
+  ASSERT_ND(low < high);
+  // An 8-byte key is compared with other keys as a byte string, so [low, high) of 8-byte keys
+  // precisely contains keys of any length whose first slice is in [low, high).
+  // Infimum/supremum instead mean no limit so that we don't miss shorter/longer keys there.
+  const KeySlice low_be = assorted::htobe<KeySlice>(low);
+  const KeySlice high_be = assorted::htobe<KeySlice>(high);
+  const bool low_infimum = (low == kInfimumSlice);
+  const bool high_supremum = (high == kSupremumSlice);
+  static_assert(kKeyLengthExtremum == 0, "Key length 0 must mean infimum/supremum");
+  const KeyLength low_length = low_infimum ? 0 : sizeof(KeySlice);
+  const KeyLength high_length = high_supremum ? 0 : sizeof(KeySlice);
+  return open(
+    low_infimum ? nullptr : reinterpret_cast<const char*>(&low_be),
+    low_length,
+    high_supremum ? nullptr : reinterpret_cast<const char*>(&high_be),
+    high_length,
+    true,
+    for_writes,
+    true,
+    false);
+}
+
 inline ErrorCode MasstreeCursor::locate_layer(uint8_t layer) {
   MasstreePage* layer_root = cur_route()->page_;
   ASSERT_ND(layer_root->is_layer_root());
@@ -26,6 +26,7 @@
 #include "foedus/debugging/rdtsc_watch.hpp"
 #include "foedus/storage/masstree/masstree_page_impl.hpp"
 #include "foedus/thread/thread.hpp"
+#include "foedus/thread/thread_metrics.hpp"
 
 namespace foedus {
 namespace storage {
@@ -135,6 +136,7 @@ ErrorCode SplitBorder::run(xct::SysxctWorkspace* sysxct_workspace) {
 
   assorted::memory_fence_release();
 
+  ++context_->get_metrics()->page_splits_;
   watch.stop();
   DVLOG(1) << "Costed " << watch.elapsed() << " cycles to split a page. original page physical"
     << " record count: " << static_cast<int>(key_count)
@@ -542,6 +544,7 @@ void SplitIntermediate::split_impl_no_error(thread::GrabFreeVolatilePagesScope*
     context_->collect_retired_volatile_page(piggyback_adopt_child_->get_volatile_page_id());
   }
 
+  ++context_->get_metrics()->page_splits_;
   watch.stop();
   DVLOG(1) << "Costed " << watch.elapsed() << " cycles to split a node. original node"
     << " key count: " << static_cast<int>(key_count);
@@ -19,6 +19,7 @@
 
 #include <glog/logging.h>
 
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -29,6 +30,7 @@
 #include "foedus/storage/masstree/masstree_retry_impl.hpp"
 #include "foedus/storage/masstree/masstree_storage_pimpl.hpp"
 #include "foedus/thread/thread.hpp"
+#include "foedus/xct/xct.hpp"
 
 namespace foedus {
 namespace storage {
@@ -230,6 +232,93 @@ ErrorCode MasstreeStorage::get_record_primitive_normalized(
     sizeof(PAYLOAD));
 }
 
+ErrorCode MasstreeStorage::get_record_batch(
+  thread::Thread* context,
+  uint16_t batch_size,
+  const void* const* key_batch,
+  const KeyLength* key_length_batch,
+  void* const* payload_batch,
+  PayloadLength* payload_capacity_batch,
+  bool read_only,
+  ErrorCode* result_batch) {
+  MasstreeStoragePimpl pimpl(this);
+  for (uint16_t cur = 0; cur < batch_size;) {
+    uint16_t chunk = batch_size - cur;
+    if (chunk > MasstreeStoragePimpl::kBatchMax) {
+      chunk = MasstreeStoragePimpl::kBatchMax;
+    }
+    CHECK_ERROR_CODE(pimpl.get_record_batch(
+      context,
+      chunk,
+      &key_batch[cur],
+      &key_length_batch[cur],
+      nullptr,
+      &payload_batch[cur],
+      &payload_capacity_batch[cur],
+      read_only,
+      &result_batch[cur]));
+    cur += chunk;
+  }
+  return kErrorCodeOk;
+}
+
+ErrorCode MasstreeStorage::get_record_normalized_batch(
+  thread::Thread* context,
+  uint16_t batch_size,
+  const KeySlice* key_batch,
+  void* const* payload_batch,
+  PayloadLength* payload_capacity_batch,
+  bool read_only,
+  ErrorCode* result_batch) {
+  MasstreeStoragePimpl pimpl(this);
+  for (uint16_t cur = 0; cur < batch_size;) {
+    uint16_t chunk = batch_size - cur;
+    if (chunk > MasstreeStoragePimpl::kBatchMax) {
+      chunk = MasstreeStoragePimpl::kBatchMax;
+    }
+    CHECK_ERROR_CODE(pimpl.get_record_batch(
+      context,
+      chunk,
+      nullptr,
+      nullptr,
+      &key_batch[cur],
+      &payload_batch[cur],
+      &payload_capacity_batch[cur],
+      read_only,
+      &result_batch[cur]));
+    cur += chunk;
+  }
+  return kErrorCodeOk;
+}
+
+template <typename PAYLOAD>
+ErrorCode MasstreeStorage::get_record_primitive_normalized_batch(
+  thread::Thread* context,
+  PayloadLength payload_offset,
+  uint16_t batch_size,
+  const KeySlice* key_batch,
+  PAYLOAD* payload_batch,
+  bool read_only,
+  ErrorCode* result_batch) {
+  MasstreeStoragePimpl pimpl(this);
+  for (uint16_t cur = 0; cur < batch_size;) {
+    uint16_t chunk = batch_size - cur;
+    if (chunk > MasstreeStoragePimpl::kBatchMax) {
+      chunk = MasstreeStoragePimpl::kBatchMax;
+    }
+    CHECK_ERROR_CODE(pimpl.get_record_primitive_normalized_batch<PAYLOAD>(
+      context,
+      payload_offset,
+      chunk,
+      &key_batch[cur],
+      &payload_batch[cur],
+      read_only,
+      &result_batch[cur]));
+    cur += chunk;
+  }
+  return kErrorCodeOk;
+}
+
 PayloadLength adjust_payload_hint(
   PayloadLength payload_count,
   PayloadLength physical_payload_hint) {
@@ -624,6 +713,70 @@ SlotIndex MasstreeStorage::estimate_records_per_page(
   return ret;
 }
 
+template <typename PAYLOAD>
+ErrorCode MasstreeStorage::increment_record_normalized_striped(
+  thread::Thread* context,
+  KeySlice key,
+  PAYLOAD value,
+  PayloadLength payload_offset,
+  uint16_t stripes) {
+  if (UNLIKELY(stripes == 0 || key + (stripes - 1U) < key)) {
+    return kErrorCodeInvalidParameter;
+  }
+  const KeySlice stripe_key = key + context->get_thread_global_ordinal() % stripes;
+  PAYLOAD tmp = value;
+  ErrorCode ret = increment_record_normalized<PAYLOAD>(context, stripe_key, &tmp, payload_offset);
+  if (ret != kErrorCodeStrKeyNotFound) {
+    return ret;
+  }
+
+  // This thread's first increment on the counter. The stripe starts with the addendum.
+  const PayloadLength payload_count = payload_offset + sizeof(PAYLOAD);
+  if (UNLIKELY(payload_count > kMaxPayloadLength)) {
+    return kErrorCodeStrTooShortPayload;
+  }
+  void* payload;
+  CHECK_ERROR_CODE(context->get_current_xct().acquire_local_work_memory(payload_count, &payload));
+  std::memset(payload, 0, payload_offset);
+  std::memcpy(reinterpret_cast<char*>(payload) + payload_offset, &value, sizeof(PAYLOAD));
+  ret = insert_record_normalized(context, stripe_key, payload, payload_count);
+  if (ret == kErrorCodeStrKeyAlreadyExists) {
+    // Another thread on the same stripe inserted it first. Now it's there, so just increment.
+    tmp = value;
+    ret = increment_record_normalized<PAYLOAD>(context, stripe_key, &tmp, payload_offset);
+  }
+  return ret;
+}
+
+template <typename PAYLOAD>
+ErrorCode MasstreeStorage::get_record_primitive_normalized_striped(
+  thread::Thread* context,
+  KeySlice key,
+  PAYLOAD* value,
+  PayloadLength payload_offset,
+  uint16_t stripes) {
+  if (UNLIKELY(stripes == 0 || key + (stripes - 1U) < key)) {
+    return kErrorCodeInvalidParameter;
+  }
+  PAYLOAD sum = 0;
+  for (uint16_t i = 0; i < stripes; ++i) {
+    PAYLOAD delta;
+    ErrorCode ret = get_record_primitive_normalized<PAYLOAD>(
+      context,
+      key + i,
+      &delta,
+      payload_offset,
+      true);
+    if (ret == kErrorCodeOk) {
+      sum += delta;
+    } else if (ret != kErrorCodeStrKeyNotFound) {
+      return ret;
+    }
+  }
+  *value = sum;
+  return kErrorCodeOk;
+}
+
 // Explicit instantiations for each payload type
 // @cond DOXYGEN_IGNORE
 #define EXPIN_1(x) template ErrorCode MasstreeStorage::get_record_primitive< x > \
@@ -654,6 +807,24 @@ INSTANTIATE_ALL_NUMERIC_TYPES(EXPIN_5);
 #define EXPIN_6(x) template ErrorCode MasstreeStorage::increment_record_normalized< x > \
   (thread::Thread* context, KeySlice key, x* value, PayloadLength payload_offset)
 INSTANTIATE_ALL_NUMERIC_TYPES(EXPIN_6);
+
+#define EXPIN_7(x) template ErrorCode \
+  MasstreeStorage::get_record_primitive_normalized_batch< x > \
+  (thread::Thread* context, PayloadLength payload_offset, uint16_t batch_size, \
+  const KeySlice* key_batch, x* payload_batch, bool read_only, ErrorCode* result_batch)
+INSTANTIATE_ALL_NUMERIC_TYPES(EXPIN_7);
+
+#define EXPIN_8(x) template ErrorCode \
+  MasstreeStorage::increment_record_normalized_striped< x > \
+  (thread::Thread* context, KeySlice key, x value, PayloadLength payload_offset, \
+  uint16_t stripes)
+INSTANTIATE_ALL_NUMERIC_TYPES(EXPIN_8);
+
+#define EXPIN_9(x) template ErrorCode \
+  MasstreeStorage::get_record_primitive_normalized_striped< x > \
+  (thread::Thread* context, KeySlice key, x* value, PayloadLength payload_offset, \
+  uint16_t stripes)
+INSTANTIATE_ALL_NUMERIC_TYPES(EXPIN_9);
 // @endcond
 
 }  // namespace masstree
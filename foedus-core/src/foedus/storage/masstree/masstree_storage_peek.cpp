@@ -19,6 +19,9 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "foedus/memory/engine_memory.hpp"
 #include "foedus/storage/page.hpp"
 #include "foedus/storage/masstree/masstree_page_impl.hpp"
@@ -236,6 +239,94 @@ ErrorCode MasstreeStoragePimpl::peek_volatile_page_boundaries_this_layer_recurse
   return kErrorCodeOk;
 }
 
+ErrorCode MasstreeStorage::partition_for_scan(
+  Engine* engine,
+  KeySlice from,
+  KeySlice to,
+  uint16_t desired_partitions,
+  MasstreeStorage::ScanPartitions* out) {
+  MasstreeStoragePimpl pimpl(this);
+  return pimpl.partition_for_scan(engine, from, to, desired_partitions, out);
+}
+
+ErrorCode MasstreeStoragePimpl::partition_for_scan(
+  Engine* engine,
+  KeySlice from,
+  KeySlice to,
+  uint16_t desired_partitions,
+  MasstreeStorage::ScanPartitions* out) {
+  ASSERT_ND(from < to);
+  ASSERT_ND(desired_partitions > 0);
+  out->count_ = 1;
+  out->boundaries_[0] = from;
+  out->boundaries_[1] = to;
+  const uint32_t desired = std::min<uint32_t>(
+    desired_partitions,
+    MasstreeStorage::ScanPartitions::kMaxPartitions);
+  if (desired <= 1U) {
+    return kErrorCodeOk;
+  }
+
+  // Collect page boundaries of the first layer in the range, a batch at a time.
+  // A large storage has millions of border pages, so we keep every stride-th boundary and
+  // double the stride whenever the samples are full. The samples are thus still evenly spaced.
+  const uint32_t kBatchSize = 1U << 12;
+  const uint32_t kMaxSamples = 1U << 14;
+  std::vector<KeySlice> batch(kBatchSize);
+  std::vector<KeySlice> samples;
+  samples.reserve(kMaxSamples);
+  uint64_t stride = 1;
+  uint64_t seen = 0;
+  KeySlice batch_from = from;
+  while (true) {
+    uint32_t found = 0;
+    MasstreeStorage::PeekBoundariesArguments args = {
+      nullptr,
+      0,
+      kBatchSize,
+      batch_from,
+      to,
+      &batch[0],
+      &found };
+    CHECK_ERROR_CODE(peek_volatile_page_boundaries(engine, args));
+    ASSERT_ND(found <= kBatchSize);
+    for (uint32_t i = 0; i < found; ++i, ++seen) {
+      if (seen % stride != 0) {
+        continue;
+      }
+      if (samples.size() >= kMaxSamples) {
+        for (uint32_t j = 0; j * 2U < samples.size(); ++j) {
+          samples[j] = samples[j * 2U];
+        }
+        samples.resize((samples.size() + 1U) / 2U);
+        stride *= 2U;
+        ASSERT_ND(seen % stride == 0);
+      }
+      ASSERT_ND(samples.empty() || samples.back() < batch[i]);
+      samples.push_back(batch[i]);
+    }
+    if (found < kBatchSize) {
+      break;
+    }
+    // peek_volatile_page_boundaries() returns only boundaries larger than from
+    batch_from = batch[found - 1U];
+  }
+
+  // N boundaries make N + 1 ranges of roughly one page each. Combine them evenly.
+  const uint32_t boundary_count = samples.size();
+  const uint32_t partitions = std::min<uint32_t>(desired, boundary_count + 1U);
+  for (uint32_t p = 1; p < partitions; ++p) {
+    uint32_t index = static_cast<uint64_t>(p) * (boundary_count + 1U) / partitions - 1U;
+    ASSERT_ND(index < boundary_count);
+    out->boundaries_[p] = samples[index];
+    ASSERT_ND(out->boundaries_[p - 1U] < out->boundaries_[p]);
+  }
+  out->boundaries_[partitions] = to;
+  out->count_ = partitions;
+  DVLOG(1) << "Made " << partitions << " partitions out of " << seen << " page boundaries";
+  return kErrorCodeOk;
+}
+
 }  // namespace masstree
 }  // namespace storage
 }  // namespace foedus
@@ -364,6 +364,152 @@ ErrorCode MasstreeStoragePimpl::locate_record_normalized(
   return kErrorCodeOk;
 }
 
+ErrorCode MasstreeStoragePimpl::locate_record_batch(
+  thread::Thread* context,
+  uint16_t batch_size,
+  const void* const* key_batch,
+  const KeyLength* key_length_batch,
+  const KeySlice* normalized_key_batch,
+  bool for_writes,
+  RecordLocation* location_batch,
+  ErrorCode* result_batch) {
+  ASSERT_ND(batch_size <= kBatchMax);
+  ASSERT_ND((key_batch == nullptr) != (normalized_key_batch == nullptr));
+  xct::Xct* cur_xct = &context->get_current_xct();
+  MasstreeIntermediatePage* first_root;
+  CHECK_ERROR_CODE(get_first_root(context, for_writes, &first_root));
+  first_root->prefetch_general();
+
+  // Per-key state of the lock-step descent. A key is done when cur_page_ is null.
+  MasstreePage* cur_page[kBatchMax];
+  // The intermediate page we came from. We check fences and adoption when we visit next time,
+  // which gives the prefetch of the new page some time to complete.
+  MasstreeIntermediatePage* parent_page[kBatchMax];
+  KeySlice slices[kBatchMax];
+  uint8_t layers[kBatchMax];
+  uint8_t minipage_indexes[kBatchMax];
+  uint16_t remaining = batch_size;
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    location_batch[i].clear();
+    cur_page[i] = first_root;
+    parent_page[i] = nullptr;
+    layers[i] = 0;
+    if (normalized_key_batch) {
+      slices[i] = normalized_key_batch[i];
+    } else {
+      ASSERT_ND(key_length_batch[i] <= kMaxKeyLength);
+      slices[i] = slice_layer(key_batch[i], key_length_batch[i], 0);
+    }
+  }
+
+  while (remaining > 0) {
+    // 1st pass: validate the page we moved to, then locate and prefetch minipages.
+    for (uint16_t i = 0; i < batch_size; ++i) {
+      MasstreePage* cur = cur_page[i];
+      if (cur == nullptr) {
+        continue;
+      }
+      MasstreeIntermediatePage* parent = parent_page[i];
+      if (parent) {
+        parent_page[i] = nullptr;
+        if (UNLIKELY(!cur->within_fences(slices[i]))) {
+          // same as find_border_physical(). local retry suffices thanks to foster-twin
+          DVLOG(0) << "Interesting. concurrent thread affected the search. local retry";
+          assorted::memory_fence_acquire();
+          cur_page[i] = parent;
+          cur = parent;
+        } else if (cur->has_foster_child() && !parent->is_moved()) {
+          if (!cur->is_locked() && !parent->is_locked()) {
+            Adopt functor(context, parent, cur);
+            CHECK_ERROR_CODE(context->run_nested_sysxct(&functor, 2));
+          } else {
+            DVLOG(1) << "Someone else seems doing something there.. already adopting? skip it";
+          }
+        }
+      }
+      if (!cur->is_border()) {
+        MasstreeIntermediatePage* page = reinterpret_cast<MasstreeIntermediatePage*>(cur);
+        minipage_indexes[i] = page->find_minipage(slices[i]);
+        page->get_minipage(minipage_indexes[i]).prefetch();
+      }
+    }
+
+    // 2nd pass: move one step further and prefetch the next page, or conclude the key.
+    for (uint16_t i = 0; i < batch_size; ++i) {
+      MasstreePage* cur = cur_page[i];
+      if (cur == nullptr) {
+        continue;
+      }
+      assert_aligned_page(cur);
+      ASSERT_ND(cur->get_layer() == layers[i]);
+      KeySlice slice = slices[i];
+      if (!cur->is_border()) {
+        MasstreeIntermediatePage* page = reinterpret_cast<MasstreeIntermediatePage*>(cur);
+        MasstreeIntermediatePage::MiniPage& minipage = page->get_minipage(minipage_indexes[i]);
+        uint8_t pointer_index = minipage.find_pointer(slice);
+        MasstreePage* next;
+        CHECK_ERROR_CODE(
+          follow_page(context, for_writes, &minipage.pointers_[pointer_index], &next));
+        next->prefetch_general();
+        cur_page[i] = next;
+        parent_page[i] = page;
+        continue;
+      }
+
+      // We follow foster-twins only in border pages. See find_border_physical().
+      if (UNLIKELY(cur->has_foster_child())) {
+        if (cur->within_foster_minor(slice)) {
+          cur = reinterpret_cast<MasstreePage*>(context->resolve(cur->get_foster_minor()));
+        } else {
+          cur = reinterpret_cast<MasstreePage*>(context->resolve(cur->get_foster_major()));
+        }
+        ASSERT_ND(cur->within_fences(slice));
+        cur->prefetch_general();
+        cur_page[i] = cur;
+        continue;
+      }
+
+      MasstreeBorderPage* border = reinterpret_cast<MasstreeBorderPage*>(cur);
+      PageVersionStatus border_version = border->get_version().status_;
+      assorted::memory_fence_consume();
+      SlotIndex index;
+      if (normalized_key_batch) {
+        index = border->find_key_normalized(0, border->get_key_count(), slice);
+      } else {
+        KeyLength remainder_length = key_length_batch[i] - layers[i] * 8;
+        const void* suffix = reinterpret_cast<const char*>(key_batch[i]) + (layers[i] + 1) * 8;
+        index = border->find_key(slice, suffix, remainder_length);
+      }
+
+      if (index == kBorderPageMaxSlots) {
+        // not found. add it to page version set to protect the lack of record
+        if (!border->header().snapshot_) {
+          CHECK_ERROR_CODE(cur_xct->add_to_page_version_set(
+            border->get_version_address(),
+            border_version));
+        }
+        result_batch[i] = kErrorCodeStrKeyNotFound;
+      } else if (border->does_point_to_layer(index)) {
+        // normalized keys are just one slice, so they never go to next layer
+        ASSERT_ND(normalized_key_batch == nullptr);
+        MasstreePage* next_root;
+        CHECK_ERROR_CODE(follow_layer(context, for_writes, border, index, &next_root));
+        next_root->prefetch_general();
+        ++layers[i];
+        slices[i] = slice_layer(key_batch[i], key_length_batch[i], layers[i]);
+        cur_page[i] = next_root;
+        continue;
+      } else {
+        CHECK_ERROR_CODE(location_batch[i].populate_logical(cur_xct, border, index, for_writes));
+        result_batch[i] = kErrorCodeOk;
+      }
+      cur_page[i] = nullptr;
+      --remaining;
+    }
+  }
+  return kErrorCodeOk;
+}
+
 ErrorCode MasstreeStoragePimpl::follow_page(
   thread::Thread* context,
   bool for_writes,
@@ -642,6 +788,89 @@ ErrorCode MasstreeStoragePimpl::retrieve_part_general(
   return kErrorCodeOk;
 }
 
+ErrorCode MasstreeStoragePimpl::get_record_batch(
+  thread::Thread* context,
+  uint16_t batch_size,
+  const void* const* key_batch,
+  const KeyLength* key_length_batch,
+  const KeySlice* normalized_key_batch,
+  void* const* payload_batch,
+  PayloadLength* payload_capacity_batch,
+  bool read_only,
+  ErrorCode* result_batch) {
+  RecordLocation location_batch[kBatchMax];
+  CHECK_ERROR_CODE(locate_record_batch(
+    context,
+    batch_size,
+    key_batch,
+    key_length_batch,
+    normalized_key_batch,
+    !read_only,
+    location_batch,
+    result_batch));
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    if (result_batch[i] == kErrorCodeOk) {
+      // the payload is usually in a cacheline different from the slot and key.
+      assorted::prefetch_cacheline(
+        location_batch[i].page_->get_record_payload(location_batch[i].index_));
+    }
+  }
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    if (result_batch[i] != kErrorCodeOk) {
+      continue;
+    }
+    ErrorCode code = retrieve_general(
+      context,
+      location_batch[i],
+      payload_batch[i],
+      payload_capacity_batch + i);
+    if (code == kErrorCodeStrKeyNotFound || code == kErrorCodeStrTooSmallPayloadBuffer) {
+      result_batch[i] = code;
+    } else {
+      CHECK_ERROR_CODE(code);
+    }
+  }
+  return kErrorCodeOk;
+}
+
+template <typename PAYLOAD>
+ErrorCode MasstreeStoragePimpl::get_record_primitive_normalized_batch(
+  thread::Thread* context,
+  PayloadLength payload_offset,
+  uint16_t batch_size,
+  const KeySlice* key_batch,
+  PAYLOAD* payload_batch,
+  bool read_only,
+  ErrorCode* result_batch) {
+  RecordLocation location_batch[kBatchMax];
+  CHECK_ERROR_CODE(locate_record_batch(
+    context,
+    batch_size,
+    nullptr,
+    nullptr,
+    key_batch,
+    !read_only,
+    location_batch,
+    result_batch));
+  for (uint16_t i = 0; i < batch_size; ++i) {
+    if (result_batch[i] != kErrorCodeOk) {
+      continue;
+    }
+    ErrorCode code = retrieve_part_general(
+      context,
+      location_batch[i],
+      payload_batch + i,
+      payload_offset,
+      sizeof(PAYLOAD));
+    if (code == kErrorCodeStrKeyNotFound || code == kErrorCodeStrTooShortPayload) {
+      result_batch[i] = code;
+    } else {
+      CHECK_ERROR_CODE(code);
+    }
+  }
+  return kErrorCodeOk;
+}
+
 ErrorCode MasstreeStoragePimpl::register_record_write_log(
   thread::Thread* context,
   const RecordLocation& location,
@@ -862,6 +1091,12 @@ inline xct::TrackMovedRecordResult MasstreeStoragePimpl::track_moved_record(
   (thread::Thread* context, const RecordLocation& location, \
   const void* be_key, KeyLength key_length, x* value, PayloadLength payload_offset)
 INSTANTIATE_ALL_NUMERIC_TYPES(EXPIN_5);
+
+#define EXPIN_6(x) template ErrorCode \
+  MasstreeStoragePimpl::get_record_primitive_normalized_batch< x > \
+  (thread::Thread* context, PayloadLength payload_offset, uint16_t batch_size, \
+  const KeySlice* key_batch, x* payload_batch, bool read_only, ErrorCode* result_batch)
+INSTANTIATE_ALL_NUMERIC_TYPES(EXPIN_6);
 // @endcond
 
 }  // namespace masstree
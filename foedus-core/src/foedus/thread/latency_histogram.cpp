@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include "foedus/thread/latency_histogram.hpp"
+
+#include <cmath>
+#include <ostream>
+
+namespace foedus {
+namespace thread {
+
+const char* get_latency_phase_name(LatencyPhase phase) {
+  switch (phase) {
+  case kLatencyPhaseUserBody:
+    return "UserBody";
+  case kLatencyPhasePrecommitLock:
+    return "PrecommitLock";
+  case kLatencyPhaseVerify:
+    return "Verify";
+  case kLatencyPhaseApply:
+    return "Apply";
+  case kLatencyPhaseWaitForCommit:
+    return "WaitForCommit";
+  default:
+    return "Unknown";
+  }
+}
+
+uint64_t LatencyHistogram::get_bucket_floor(uint32_t bucket) {
+  if (bucket < static_cast<uint32_t>(kSubBuckets)) {
+    return bucket;
+  }
+  const uint32_t shift = bucket / kSubBuckets - 1U;
+  const uint64_t sub = bucket % kSubBuckets;
+  return (kSubBuckets + sub) << shift;
+}
+
+void LatencyHistogram::add(const LatencyHistogram& other) {
+  count_ += other.count_;
+  sum_ += other.sum_;
+  if (other.max_ > max_) {
+    max_ = other.max_;
+  }
+  for (uint32_t i = 0; i < kBucketCount; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+}
+
+uint64_t LatencyHistogram::get_percentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count_));
+  if (rank == 0) {
+    rank = 1;
+  }
+  uint64_t cumulative = 0;
+  for (uint32_t i = 0; i + 1U < kBucketCount; ++i) {
+    cumulative += buckets_[i];
+    if (cumulative >= rank) {
+      // The largest value in this bucket, but never larger than what we actually observed.
+      const uint64_t ceiling = get_bucket_floor(i + 1U) - 1U;
+      return ceiling < max_ ? ceiling : max_;
+    }
+  }
+  return max_;
+}
+
+std::ostream& operator<<(std::ostream& o, const LatencyHistogram& v) {
+  o << "<count_>" << v.count_ << "</count_>"
+    << "<average_>" << v.get_average() << "</average_>"
+    << "<p50_>" << v.get_percentile(50) << "</p50_>"
+    << "<p90_>" << v.get_percentile(90) << "</p90_>"
+    << "<p99_>" << v.get_percentile(99) << "</p99_>"
+    << "<p999_>" << v.get_percentile(99.9) << "</p999_>"
+    << "<max_>" << v.max_ << "</max_>";
+  return o;
+}
+
+void ThreadLatencyHistograms::add(const ThreadLatencyHistograms& other) {
+  for (uint16_t i = 0; i < kLatencyPhaseCount; ++i) {
+    phases_[i].add(other.phases_[i]);
+  }
+}
+
+std::ostream& operator<<(std::ostream& o, const ThreadLatencyHistograms& v) {
+  o << "<ThreadLatencyHistograms unit=\"cycles\">";
+  for (uint16_t i = 0; i < kLatencyPhaseCount; ++i) {
+    const char* name = get_latency_phase_name(static_cast<LatencyPhase>(i));
+    o << "<" << name << ">" << v.phases_[i] << "</" << name << ">";
+  }
+  o << "</ThreadLatencyHistograms>";
+  return o;
+}
+
+}  // namespace thread
+}  // namespace foedus
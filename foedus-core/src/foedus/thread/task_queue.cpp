@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include "foedus/thread/task_queue.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "foedus/assert_nd.hpp"
+#include "foedus/compiler.hpp"
+#include "foedus/debugging/stop_watch.hpp"
+#include "foedus/soc/shared_memory_repo.hpp"
+
+namespace foedus {
+namespace thread {
+
+static_assert(
+  sizeof(TaskQueue) <= soc::ThreadMemoryAnchors::kTaskQueueMemorySize,
+  "TaskQueue doesn't fit in the shared memory");
+
+void TaskQueue::initialize() {
+  submit_position_.store(0);
+  run_position_.store(0);
+  completion_cond_.initialize();
+  stopped_.store(false);
+  for (uint32_t i = 0; i < kCapacity; ++i) {
+    TaskQueueEntry& entry = entries_[i];
+    entry.sequence_.store(i);
+    entry.result_ = kErrorCodeOk;
+    entry.input_len_ = 0;
+    entry.output_len_ = 0;
+    entry.proc_name_.clear();
+  }
+}
+
+ErrorCode TaskQueue::submit(
+  const proc::ProcName& proc_name,
+  const void* input,
+  uint32_t input_len,
+  TaskTicket* ticket) {
+  if (UNLIKELY(input_len > static_cast<uint32_t>(TaskQueueEntry::kInputSize))) {
+    return kErrorCodeThrTaskInputTooLarge;
+  }
+  if (UNLIKELY(is_stopped())) {
+    return kErrorCodeBeingShutdown;
+  }
+  uint64_t position = submit_position_.load(std::memory_order_relaxed);
+  TaskQueueEntry* entry;
+  while (true) {
+    entry = &get_entry(position);
+    uint64_t sequence = entry->sequence_.load(std::memory_order_acquire);
+    int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+    if (diff == 0) {
+      if (submit_position_.compare_exchange_weak(position, position + 1U)) {
+        break;
+      }
+      // position was reloaded by the failed CAS
+    } else if (diff < 0) {
+      // the client of the previous lap has not retrieved the slot yet
+      return kErrorCodeThrTaskQueueFull;
+    } else {
+      position = submit_position_.load(std::memory_order_relaxed);
+    }
+  }
+
+  entry->proc_name_ = proc_name;
+  entry->input_len_ = input_len;
+  entry->output_len_ = 0;
+  entry->result_ = kErrorCodeOk;
+  if (input_len > 0) {
+    std::memcpy(entry->input_, input, input_len);
+  }
+  entry->sequence_.store(position + 1U, std::memory_order_release);
+  *ticket = position;
+  return kErrorCodeOk;
+}
+
+bool TaskQueue::is_completed(TaskTicket ticket) const {
+  return get_entry(ticket).sequence_.load(std::memory_order_acquire) == ticket + 2U;
+}
+
+ErrorCode TaskQueue::wait_for_completion(TaskTicket ticket, int64_t wait_microseconds) const {
+  debugging::StopWatch watch;
+  while (true) {
+    uint64_t demand = completion_cond_.acquire_ticket();
+    if (is_completed(ticket)) {
+      return kErrorCodeOk;
+    }
+    if (UNLIKELY(is_stopped())) {
+      // The worker completed everything it saw before it stopped. A task still not completed
+      // was submitted in a race with stop(), and no one will ever run it.
+      return is_completed(ticket) ? kErrorCodeOk : kErrorCodeBeingShutdown;
+    }
+    if (wait_microseconds < 0) {
+      completion_cond_.wait(demand);
+      continue;
+    }
+    int64_t remaining = wait_microseconds - static_cast<int64_t>(watch.peek_elapsed_ns() / 1000);
+    if (remaining <= 0) {
+      return is_completed(ticket) ? kErrorCodeOk : kErrorCodeTimeout;
+    }
+    completion_cond_.timedwait(demand, remaining);
+  }
+}
+
+ErrorCode TaskQueue::retrieve(
+  TaskTicket ticket,
+  void* output,
+  uint32_t output_buffer_size,
+  uint32_t* output_len) {
+  ASSERT_ND(is_completed(ticket));
+  TaskQueueEntry& entry = get_entry(ticket);
+  ErrorCode result = entry.result_;
+  *output_len = entry.output_len_;
+  uint32_t copy_len = std::min<uint32_t>(entry.output_len_, output_buffer_size);
+  if (copy_len > 0) {
+    std::memcpy(output, entry.output_, copy_len);
+  }
+  entry.sequence_.store(ticket + kCapacity, std::memory_order_release);
+  return result;
+}
+
+TaskQueueEntry* TaskQueue::peek_submitted() {
+  uint64_t position = run_position_.load(std::memory_order_relaxed);
+  TaskQueueEntry* entry = &get_entry(position);
+  if (entry->sequence_.load(std::memory_order_acquire) == position + 1U) {
+    return entry;
+  }
+  return nullptr;
+}
+
+void TaskQueue::complete_submitted(
+  TaskQueueEntry* entry,
+  ErrorCode result,
+  uint32_t output_len) {
+  uint64_t position = run_position_.load(std::memory_order_relaxed);
+  ASSERT_ND(entry == &get_entry(position));
+  ASSERT_ND(entry->sequence_.load() == position + 1U);
+  ASSERT_ND(output_len <= static_cast<uint32_t>(TaskQueueEntry::kOutputSize));
+  entry->result_ = result;
+  entry->output_len_ = output_len;
+  entry->sequence_.store(position + 2U, std::memory_order_release);
+  run_position_.store(position + 1U, std::memory_order_release);
+  completion_cond_.signal();
+}
+
+void TaskQueue::stop() {
+  stopped_.store(true, std::memory_order_release);
+  // Submissions after this see stopped_. Fail the ones that made it before.
+  while (true) {
+    TaskQueueEntry* entry = peek_submitted();
+    if (entry == nullptr) {
+      break;
+    }
+    complete_submitted(entry, kErrorCodeBeingShutdown, 0);
+  }
+  completion_cond_.signal();
+}
+
+}  // namespace thread
+}  // namespace foedus
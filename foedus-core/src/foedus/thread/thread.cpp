@@ -60,16 +60,24 @@ memory::NumaNodeMemory* Thread::get_node_memory() const {
 }
 
 uint64_t Thread::get_snapshot_cache_hits() const {
-  return pimpl_->control_block_->stat_snapshot_cache_hits_;
+  return pimpl_->control_block_->metrics_.snapshot_cache_hits_;
 }
 
 uint64_t Thread::get_snapshot_cache_misses() const {
-  return pimpl_->control_block_->stat_snapshot_cache_misses_;
+  return pimpl_->control_block_->metrics_.snapshot_cache_misses_;
 }
 
 void Thread::reset_snapshot_cache_counts() const {
-  pimpl_->control_block_->stat_snapshot_cache_hits_ = 0;
-  pimpl_->control_block_->stat_snapshot_cache_misses_ = 0;
+  pimpl_->control_block_->metrics_.snapshot_cache_hits_ = 0;
+  pimpl_->control_block_->metrics_.snapshot_cache_misses_ = 0;
+}
+
+ThreadMetrics* Thread::get_metrics() const { return &pimpl_->control_block_->metrics_; }
+xct::AbortSampleRing* Thread::get_abort_samples() const {
+  return &pimpl_->control_block_->abort_samples_;
+}
+ThreadLatencyHistograms* Thread::get_latency_histograms() const {
+  return &pimpl_->control_block_->latency_histograms_;
 }
 
 xct::Xct&   Thread::get_current_xct()   { return pimpl_->current_xct_; }
@@ -86,6 +94,8 @@ ErrorCode Thread::read_a_snapshot_page(
   storage::Page* buffer) {
   return pimpl_->read_a_snapshot_page(page_id, buffer);
 }
+bool Thread::is_snapshot_cache_scan_mode() const { return pimpl_->snapshot_cache_scan_mode_; }
+void Thread::set_snapshot_cache_scan_mode(bool value) { pimpl_->snapshot_cache_scan_mode_ = value; }
 ErrorCode Thread::read_snapshot_pages(
   storage::SnapshotPagePointer page_id_begin,
   uint32_t page_count,
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include "foedus/thread/thread_metrics.hpp"
+
+#include <ostream>
+
+namespace foedus {
+namespace thread {
+
+static_assert(
+  sizeof(ThreadMetrics) % assorted::kCachelineSize == 0,
+  "ThreadMetrics must occupy whole cachelines");
+static_assert(
+  sizeof(ThreadMetrics) - ThreadMetrics::kPaddingSize == ThreadMetrics::kCounterCount * 8U,
+  "kCounterCount doesn't match the number of counters in ThreadMetrics");
+
+void ThreadMetrics::add(const ThreadMetrics& other) {
+  // All counters are contiguous uint64_t before padding_.
+  uint64_t* mine = reinterpret_cast<uint64_t*>(this);
+  const uint64_t* theirs = reinterpret_cast<const uint64_t*>(&other);
+  for (uint32_t i = 0; i < kCounterCount; ++i) {
+    mine[i] += theirs[i];
+  }
+}
+
+std::ostream& operator<<(std::ostream& o, const ThreadMetrics& v) {
+  o << "<ThreadMetrics>"
+    << "<commits_>" << v.commits_ << "</commits_>"
+    << "<read_only_commits_>" << v.read_only_commits_ << "</read_only_commits_>"
+    << "<race_aborts_>" << v.race_aborts_ << "</race_aborts_>"
+    << "<lock_aborts_>" << v.lock_aborts_ << "</lock_aborts_>"
+    << "<moved_record_aborts_>" << v.moved_record_aborts_ << "</moved_record_aborts_>"
+    << "<other_precommit_aborts_>" << v.other_precommit_aborts_ << "</other_precommit_aborts_>"
+    << "<explicit_aborts_>" << v.explicit_aborts_ << "</explicit_aborts_>"
+    << "<read_set_total_>" << v.read_set_total_ << "</read_set_total_>"
+    << "<write_set_total_>" << v.write_set_total_ << "</write_set_total_>"
+    << "<mcs_waits_>" << v.mcs_waits_ << "</mcs_waits_>"
+    << "<mcs_wait_cycles_>" << v.mcs_wait_cycles_ << "</mcs_wait_cycles_>"
+    << "<snapshot_cache_hits_>" << v.snapshot_cache_hits_ << "</snapshot_cache_hits_>"
+    << "<snapshot_cache_misses_>" << v.snapshot_cache_misses_ << "</snapshot_cache_misses_>"
+    << "<page_splits_>" << v.page_splits_ << "</page_splits_>"
+    << "<log_bytes_>" << v.log_bytes_ << "</log_bytes_>"
+    << "<readonly_snapshot_fallbacks_>" << v.readonly_snapshot_fallbacks_
+      << "</readonly_snapshot_fallbacks_>"
+    << "<retries_>" << v.retries_ << "</retries_>"
+    << "<retry_backoff_cycles_>" << v.retry_backoff_cycles_ << "</retry_backoff_cycles_>"
+    << "</ThreadMetrics>";
+  return o;
+}
+
+}  // namespace thread
+}  // namespace foedus
@@ -41,6 +41,7 @@
 #include "foedus/soc/shared_memory_repo.hpp"
 #include "foedus/soc/soc_manager.hpp"
 #include "foedus/thread/numa_thread_scope.hpp"
+#include "foedus/thread/task_queue.hpp"
 #include "foedus/thread/thread.hpp"
 #include "foedus/thread/thread_pool.hpp"
 #include "foedus/thread/thread_pool_pimpl.hpp"
@@ -66,12 +67,14 @@ ThreadPimpl::ThreadPimpl(
     node_memory_(nullptr),
     snapshot_cache_hashtable_(nullptr),
     snapshot_page_pool_(nullptr),
+    snapshot_cache_scan_mode_(false),
     log_buffer_(engine, id),
     current_xct_(engine, holder, id),
     snapshot_file_set_(engine),
     control_block_(nullptr),
     task_input_memory_(nullptr),
     task_output_memory_(nullptr),
+    task_queue_(nullptr),
     mcs_ww_blocks_(nullptr),
     mcs_rw_simple_blocks_(nullptr),
     mcs_rw_extended_blocks_(nullptr),
@@ -87,6 +90,8 @@ ErrorStack ThreadPimpl::initialize_once() {
   control_block_->initialize(id_);
   task_input_memory_ = anchors->task_input_memory_;
   task_output_memory_ = anchors->task_output_memory_;
+  task_queue_ = anchors->task_queue_memory_;
+  task_queue_->initialize();
   mcs_ww_blocks_ = anchors->mcs_ww_lock_memories_;
   mcs_rw_simple_blocks_ = anchors->mcs_rw_simple_lock_memories_;
   mcs_rw_extended_blocks_ = anchors->mcs_rw_extended_lock_memories_;
@@ -175,9 +180,10 @@ void ThreadPimpl::handle_tasks() {
       if (is_stop_requested()) {
         break;
       }
-      // these two status are "not urgent".
-      if (control_block_->status_ == kWaitingForTask
-        || control_block_->status_ == kWaitingForClientRelease) {
+      // these two status are "not urgent" unless there are queued tasks.
+      if ((control_block_->status_ == kWaitingForTask
+          || control_block_->status_ == kWaitingForClientRelease)
+        && task_queue_->peek_submitted() == nullptr) {
         VLOG(0) << "Thread-" << id_ << " sleeping...";
         control_block_->wakeup_cond_.timedwait(demand, 100000ULL, 1U << 16, 1U << 13);
       }
@@ -187,38 +193,17 @@ void ThreadPimpl::handle_tasks() {
       control_block_->output_len_ = 0;
       control_block_->status_ = kRunningTask;
 
-      // Reset the default value of enable_rll_for_this_xct etc to system-wide setting
-      // for every impersonation.
-      current_xct_.set_default_rll_for_this_xct(
-        engine_->get_options().xct_.enable_retrospective_lock_list_);
-      current_xct_.set_default_hot_threshold_for_this_xct(
-        engine_->get_options().storage_.hot_threshold_);
-      current_xct_.set_default_rll_threshold_for_this_xct(
-        engine_->get_options().xct_.hot_threshold_for_retrospective_lock_list_);
-
       const proc::ProcName& proc_name = control_block_->proc_name_;
       VLOG(0) << "Thread-" << id_ << " retrieved a task: " << proc_name;
-      proc::Proc proc = nullptr;
-      ErrorStack result = engine_->get_proc_manager()->get_proc(proc_name, &proc);
-      if (result.is_error()) {
-        // control_block_->proc_result_
-        LOG(ERROR) << "Thread-" << id_ << " couldn't find procedure: " << proc_name;
-      } else {
-        uint32_t output_used = 0;
-        proc::ProcArguments args = {
-          engine_,
-          holder_,
-          task_input_memory_,
-          control_block_->input_len_,
-          task_output_memory_,
-          soc::ThreadMemoryAnchors::kTaskOutputMemorySize,
-          &output_used,
-        };
-        result = proc(args);
-        VLOG(0) << "Thread-" << id_ << " run(task) returned. result =" << result
-          << ", output_used=" << output_used;
-        control_block_->output_len_ = output_used;
-      }
+      uint32_t output_used = 0;
+      ErrorStack result = run_proc(
+        proc_name,
+        task_input_memory_,
+        control_block_->input_len_,
+        task_output_memory_,
+        soc::ThreadMemoryAnchors::kTaskOutputMemorySize,
+        &output_used);
+      control_block_->output_len_ = output_used;
       if (result.is_error()) {
         control_block_->proc_result_.from_error_stack(result);
       } else {
@@ -231,11 +216,85 @@ void ThreadPimpl::handle_tasks() {
       }
       VLOG(0) << "Thread-" << id_ << " finished a task. result =" << result;
     }
+    handle_task_queue();
   }
   ASSERT_ND(is_stop_requested());
+  // Don't leave the clients of queued tasks waiting forever.
+  task_queue_->stop();
   control_block_->status_ = kTerminated;
   LOG(INFO) << "Thread-" << id_ << " exits";
 }
+
+bool ThreadPimpl::handle_task_queue() {
+  bool ran = false;
+  // Impersonation has priority. Also, we don't touch status_ here because clients
+  // change it under task_mutex_ to impersonate this thread.
+  while (!is_stop_requested() && control_block_->status_ != kWaitingForExecution) {
+    TaskQueueEntry* entry = task_queue_->peek_submitted();
+    if (entry == nullptr) {
+      break;
+    }
+    ran = true;
+    uint32_t output_used = 0;
+    ErrorStack result = run_proc(
+      entry->proc_name_,
+      entry->input_,
+      entry->input_len_,
+      entry->output_,
+      TaskQueueEntry::kOutputSize,
+      &output_used);
+    VLOG(1) << "Thread-" << id_ << " finished a queued task. result =" << result;
+    task_queue_->complete_submitted(entry, result.get_error_code(), output_used);
+  }
+  return ran;
+}
+
+ErrorStack ThreadPimpl::run_proc(
+  const proc::ProcName& proc_name,
+  const void* input,
+  uint32_t input_len,
+  void* output,
+  uint32_t output_buffer_size,
+  uint32_t* output_used) {
+  *output_used = 0;
+  // Reset the default value of enable_rll_for_this_xct etc to system-wide setting
+  // for every task.
+  current_xct_.set_default_rll_for_this_xct(
+    engine_->get_options().xct_.enable_retrospective_lock_list_);
+  current_xct_.set_default_hot_threshold_for_this_xct(
+    engine_->get_options().storage_.hot_threshold_);
+  current_xct_.set_default_rll_threshold_for_this_xct(
+    engine_->get_options().xct_.hot_threshold_for_retrospective_lock_list_);
+
+  proc::Proc proc = nullptr;
+  ErrorStack result = engine_->get_proc_manager()->get_proc(proc_name, &proc);
+  if (result.is_error()) {
+    LOG(ERROR) << "Thread-" << id_ << " couldn't find procedure: " << proc_name;
+    return result;
+  }
+  proc::ProcArguments args = {
+    engine_,
+    holder_,
+    input,
+    input_len,
+    output,
+    output_buffer_size,
+    output_used,
+  };
+  result = proc(args);
+  VLOG(0) << "Thread-" << id_ << " run(task) returned. result =" << result
+    << ", output_used=" << *output_used;
+  if (!current_xct_.get_durable_callback_queue()->is_empty()) {
+    // Don't carry over durable callbacks to the next task. Its user_data might be gone.
+    VLOG(0) << "Thread-" << id_ << " waits for pending durable callbacks of the task";
+    ErrorCode wait_ret
+      = engine_->get_xct_manager()->wait_for_durable_callbacks(holder_, -1);
+    if (wait_ret != kErrorCodeOk && !result.is_error()) {
+      result = ERROR_STACK(wait_ret);
+    }
+  }
+  return result;
+}
 void ThreadPimpl::set_thread_schedule() {
   // this code totally assumes pthread. maybe ifdef to handle Windows.. later!
   SPINLOCK_WHILE(raw_thread_set_ == false) {
@@ -458,7 +517,10 @@ ErrorCode ThreadPimpl::follow_page_pointer(
     }
   } else {
     // if there is a snapshot page, we have a few more choices.
-    if (!volatile_pointer.is_null()) {
+    // kSnapshot reads follow snapshot pointers from the root even if there are volatile pages.
+    const bool prefer_snapshot
+      = !will_modify && current_xct_.get_isolation_level() == xct::kSnapshot;
+    if (!volatile_pointer.is_null() && !prefer_snapshot) {
       // we have a volatile page, which is guaranteed to be latest
       *page = global_volatile_page_resolver_.resolve_offset(volatile_pointer);
     } else if (will_modify) {
@@ -471,6 +533,11 @@ ErrorCode ThreadPimpl::follow_page_pointer(
     }
   }
   ASSERT_ND((*page) == nullptr || (followed_snapshot == (*page)->get_header().snapshot_));
+  if (*page && !followed_snapshot && !will_modify
+    && current_xct_.get_isolation_level() == xct::kSnapshot) {
+    // no snapshot page to read, e.g. the storage was created after the latest snapshot.
+    current_xct_.on_read_volatile_in_snapshot();
+  }
 
   // if we follow a snapshot pointer, remember pointer set
   if (current_xct_.get_isolation_level() == xct::kSerializable) {
@@ -503,6 +570,7 @@ ErrorCode ThreadPimpl::follow_page_pointers_for_read_batch(
   bool has_some_snapshot = false;
   const bool needs_ptr_set
     = take_ptr_set_snapshot && current_xct_.get_isolation_level() == xct::kSerializable;
+  const bool prefer_snapshot = current_xct_.get_isolation_level() == xct::kSnapshot;
 
   // REMINDER: Remember that it might be parents == out. We thus use tmp_out.
   storage::Page* tmp_out[Thread::kMaxFindPagesBatch];
@@ -522,7 +590,8 @@ ErrorCode ThreadPimpl::follow_page_pointers_for_read_batch(
     // followed_snapshots is both input and output.
     // as input, it should indicate whether the parent is snapshot or not
     ASSERT_ND(parents[b]->get_header().snapshot_ == followed_snapshots[b]);
-    if (pointer->snapshot_pointer_ != 0 && pointer->volatile_pointer_.is_null()) {
+    if (pointer->snapshot_pointer_ != 0
+      && (prefer_snapshot || pointer->volatile_pointer_.is_null())) {
       has_some_snapshot = true;
       snapshot_page_ids[b] = pointer->snapshot_pointer_;
     }
@@ -588,6 +657,9 @@ ErrorCode ThreadPimpl::follow_page_pointers_for_read_batch(
       ASSERT_ND(!pointer->volatile_pointer_.is_null());
       out[b] = global_volatile_page_resolver_.resolve_offset(pointer->volatile_pointer_);
     }
+    if (prefer_snapshot && out[b]) {
+      current_xct_.on_read_volatile_in_snapshot();
+    }
   }
   return kErrorCodeOk;
 }
@@ -649,7 +721,8 @@ ErrorCode ThreadPimpl::find_or_read_a_snapshot_page(
   storage::Page** out) {
   if (snapshot_cache_hashtable_) {
     ASSERT_ND(engine_->get_options().cache_.snapshot_cache_enabled_);
-    memory::PagePoolOffset offset = snapshot_cache_hashtable_->find(page_id);
+    memory::PagePoolOffset offset
+      = snapshot_cache_hashtable_->find(page_id, !snapshot_cache_scan_mode_);
     // the "find" is very efficient and wait-free, but instead it might have false positive/nagative
     // in which case we should just install a new page. No worry about duplicate thanks to the
     // immutability of snapshot pages. it just wastes a bit of CPU and memory.
@@ -660,9 +733,9 @@ ErrorCode ThreadPimpl::find_or_read_a_snapshot_page(
       CHECK_ERROR_CODE(on_snapshot_cache_miss(page_id, &offset));
       ASSERT_ND(offset != 0);
       CHECK_ERROR_CODE(snapshot_cache_hashtable_->install(page_id, offset));
-      ++control_block_->stat_snapshot_cache_misses_;
+      ++control_block_->metrics_.snapshot_cache_misses_;
     } else {
-      ++control_block_->stat_snapshot_cache_hits_;
+      ++control_block_->metrics_.snapshot_cache_hits_;
     }
     ASSERT_ND(offset != 0);
     *out = snapshot_page_pool_->get_base() + offset;
@@ -698,7 +771,11 @@ ErrorCode ThreadPimpl::find_or_read_snapshot_pages_batch(
   if (snapshot_cache_hashtable_) {
     ASSERT_ND(engine_->get_options().cache_.snapshot_cache_enabled_);
     memory::PagePoolOffset offsets[Thread::kMaxFindPagesBatch];
-    CHECK_ERROR_CODE(snapshot_cache_hashtable_->find_batch(batch_size, page_ids, offsets));
+    CHECK_ERROR_CODE(snapshot_cache_hashtable_->find_batch(
+      batch_size,
+      page_ids,
+      offsets,
+      !snapshot_cache_scan_mode_));
     for (uint16_t b = 0; b < batch_size; ++b) {
       memory::PagePoolOffset offset = offsets[b];
       storage::SnapshotPagePointer page_id = page_ids[b];
@@ -717,9 +794,9 @@ ErrorCode ThreadPimpl::find_or_read_snapshot_pages_batch(
         CHECK_ERROR_CODE(on_snapshot_cache_miss(page_id, &offset));
         ASSERT_ND(offset != 0);
         CHECK_ERROR_CODE(snapshot_cache_hashtable_->install(page_id, offset));
-        ++control_block_->stat_snapshot_cache_misses_;
+        ++control_block_->metrics_.snapshot_cache_misses_;
       } else {
-        ++control_block_->stat_snapshot_cache_hits_;
+        ++control_block_->metrics_.snapshot_cache_hits_;
       }
       ASSERT_ND(offset != 0);
       out[b] = snapshot_page_pool_->get_base() + offset;
@@ -20,6 +20,10 @@
 #include <ostream>
 
 #include "foedus/assert_nd.hpp"
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/thread/latency_histogram.hpp"
+#include "foedus/thread/thread_metrics.hpp"
 #include "foedus/thread/thread_pool_pimpl.hpp"
 
 namespace foedus {
@@ -71,6 +75,22 @@ ThreadRef* ThreadPool::get_thread_ref(ThreadId id) {
   return pimpl_->get_thread(id);
 }
 
+void ThreadPool::get_metrics_sum(ThreadMetrics* out) {
+  out->reset();
+  const uint16_t group_count = pimpl_->engine_->get_options().thread_.group_count_;
+  for (ThreadGroupId group = 0; group < group_count; ++group) {
+    pimpl_->get_group(group)->add_metrics(out);
+  }
+}
+
+void ThreadPool::get_latency_histograms_sum(ThreadLatencyHistograms* out) {
+  out->reset();
+  const uint16_t group_count = pimpl_->engine_->get_options().thread_.group_count_;
+  for (ThreadGroupId group = 0; group < group_count; ++group) {
+    pimpl_->get_group(group)->add_latency_histograms(out);
+  }
+}
+
 
 std::ostream& operator<<(std::ostream& o, const ThreadPool& v) {
   o << *v.pimpl_;
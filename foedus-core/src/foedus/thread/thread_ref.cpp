@@ -27,7 +27,10 @@
 #include "foedus/soc/shared_memory_repo.hpp"
 #include "foedus/soc/soc_manager.hpp"
 #include "foedus/thread/impersonate_session.hpp"
+#include "foedus/thread/latency_histogram.hpp"
+#include "foedus/thread/task_queue.hpp"
 #include "foedus/thread/thread_id.hpp"
+#include "foedus/thread/thread_metrics.hpp"
 #include "foedus/thread/thread_pimpl.hpp"
 
 namespace foedus {
@@ -39,6 +42,7 @@ ThreadRef::ThreadRef()
   control_block_(nullptr),
   task_input_memory_(nullptr),
   task_output_memory_(nullptr),
+  task_queue_(nullptr),
   mcs_ww_blocks_(nullptr),
   mcs_rw_simple_blocks_(nullptr),
   mcs_rw_extended_blocks_(nullptr),
@@ -50,6 +54,7 @@ ThreadRef::ThreadRef(Engine* engine, ThreadId id) : engine_(engine), id_(id) {
   control_block_ = anchors->thread_memory_;
   task_input_memory_ = anchors->task_input_memory_;
   task_output_memory_ = anchors->task_output_memory_;
+  task_queue_ = anchors->task_queue_memory_;
   mcs_ww_blocks_ = anchors->mcs_ww_lock_memories_;
   mcs_rw_simple_blocks_ = anchors->mcs_rw_simple_lock_memories_;
   mcs_rw_extended_blocks_ = anchors->mcs_rw_extended_lock_memories_;
@@ -100,6 +105,19 @@ bool ThreadRef::try_impersonate(
   return true;
 }
 
+ErrorCode ThreadRef::submit_task(
+  const proc::ProcName& proc_name,
+  const void* task_input,
+  uint32_t task_input_size,
+  TaskTicket* ticket,
+  bool wakeup) {
+  CHECK_ERROR_CODE(task_queue_->submit(proc_name, task_input, task_input_size, ticket));
+  if (wakeup) {
+    control_block_->wakeup_cond_.signal();
+  }
+  return kErrorCodeOk;
+}
+
 ThreadGroupRef::ThreadGroupRef() : engine_(nullptr), group_id_(0) {
 }
 
@@ -117,16 +135,40 @@ Epoch ThreadRef::get_in_commit_epoch() const {
 }
 
 uint64_t ThreadRef::get_snapshot_cache_hits() const {
-  return control_block_->stat_snapshot_cache_hits_;
+  return control_block_->metrics_.snapshot_cache_hits_;
 }
 
 uint64_t ThreadRef::get_snapshot_cache_misses() const {
-  return control_block_->stat_snapshot_cache_misses_;
+  return control_block_->metrics_.snapshot_cache_misses_;
 }
 
 void ThreadRef::reset_snapshot_cache_counts() const {
-  control_block_->stat_snapshot_cache_hits_ = 0;
-  control_block_->stat_snapshot_cache_misses_ = 0;
+  control_block_->metrics_.snapshot_cache_hits_ = 0;
+  control_block_->metrics_.snapshot_cache_misses_ = 0;
+}
+
+const ThreadMetrics& ThreadRef::get_metrics() const {
+  return control_block_->metrics_;
+}
+
+const xct::AbortSampleRing& ThreadRef::get_abort_samples() const {
+  return control_block_->abort_samples_;
+}
+
+const ThreadLatencyHistograms& ThreadRef::get_latency_histograms() const {
+  return control_block_->latency_histograms_;
+}
+
+void ThreadGroupRef::add_metrics(ThreadMetrics* out) const {
+  for (const auto& t : threads_) {
+    out->add(t.get_metrics());
+  }
+}
+
+void ThreadGroupRef::add_latency_histograms(ThreadLatencyHistograms* out) const {
+  for (const auto& t : threads_) {
+    out->add(t.get_latency_histograms());
+  }
 }
 
 Epoch ThreadGroupRef::get_min_in_commit_epoch() const {
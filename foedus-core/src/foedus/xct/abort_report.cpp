@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include "foedus/xct/abort_report.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/assorted/assorted_func.hpp"
+#include "foedus/assorted/atomic_fences.hpp"
+#include "foedus/storage/storage.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/thread/thread_ref.hpp"
+
+namespace foedus {
+namespace xct {
+
+const char* get_abort_cause_name(AbortCause cause) {
+  switch (cause) {
+  case kAbortCauseReadVerify:
+    return "ReadVerify";
+  case kAbortCauseLock:
+    return "Lock";
+  case kAbortCauseMovedRecord:
+    return "MovedRecord";
+  case kAbortCausePointer:
+    return "Pointer";
+  case kAbortCausePageVersion:
+    return "PageVersion";
+  default:
+    return "Unknown";
+  }
+}
+
+AbortReport::AbortReport(Engine* engine) : engine_(engine), sample_count_(0) {
+  std::memset(cause_counts_, 0, sizeof(cause_counts_));
+}
+
+namespace {
+void add_to_hotspot(
+  const AbortSample& sample,
+  uintptr_t record_address,
+  AbortHotspot* hotspot) {
+  if (hotspot->count_ == 0) {
+    std::memset(hotspot, 0, sizeof(AbortHotspot));
+    hotspot->storage_id_ = sample.storage_id_;
+    hotspot->page_id_ = sample.page_id_;
+    hotspot->record_address_ = record_address;
+  }
+  ++hotspot->count_;
+  ++hotspot->cause_counts_[sample.cause_];
+}
+
+template <typename KEY>
+void take_top(
+  const std::map<KEY, AbortHotspot>& all,
+  uint32_t top_k,
+  std::vector<AbortHotspot>* out) {
+  out->clear();
+  out->reserve(all.size());
+  for (const auto& it : all) {
+    out->push_back(it.second);
+  }
+  std::sort(out->begin(), out->end(), [](const AbortHotspot& left, const AbortHotspot& right) {
+    return left.count_ > right.count_;
+  });
+  if (out->size() > top_k) {
+    out->resize(top_k);
+  }
+}
+}  // namespace
+
+void AbortReport::collect(uint32_t top_k) {
+  sample_count_ = 0;
+  std::memset(cause_counts_, 0, sizeof(cause_counts_));
+  std::map<uintptr_t, AbortHotspot> records;
+  std::map<uint64_t, AbortHotspot> pages;
+
+  const thread::ThreadOptions& options = engine_->get_options().thread_;
+  thread::ThreadPool* pool = engine_->get_thread_pool();
+  assorted::memory_fence_acquire();
+  for (thread::ThreadGroupId group = 0; group < options.group_count_; ++group) {
+    thread::ThreadGroupRef* group_ref = pool->get_group_ref(group);
+    for (thread::ThreadLocalOrdinal i = 0; i < options.thread_count_per_group_; ++i) {
+      const AbortSampleRing& ring = group_ref->get_thread(i)->get_abort_samples();
+      const uint32_t count = ring.get_count();
+      for (uint32_t s = 0; s < count; ++s) {
+        AbortSample sample = ring.samples_[s];  // copy as the owner might be overwriting it
+        if (sample.cause_ >= kAbortCauseCount) {
+          continue;  // torn read. just skip
+        }
+        ++sample_count_;
+        ++cause_counts_[sample.cause_];
+        if (sample.record_address_) {
+          add_to_hotspot(sample, sample.record_address_, &records[sample.record_address_]);
+        }
+        add_to_hotspot(sample, 0, &pages[sample.page_id_]);
+      }
+    }
+  }
+
+  take_top(records, top_k, &hot_records_);
+  take_top(pages, top_k, &hot_pages_);
+}
+
+namespace {
+void print_hotspot(std::ostream* out, Engine* engine, const AbortHotspot& v) {
+  std::ostream& o = *out;
+  o << "<Hotspot count=\"" << v.count_ << "\" storage=\"";
+  if (v.storage_id_ != 0 && engine->get_storage_manager()->get_storage(v.storage_id_)->exists()) {
+    o << engine->get_storage_manager()->get_name(v.storage_id_);
+  } else {
+    o << v.storage_id_;
+  }
+  o << "\" page_id=\"" << assorted::Hex(v.page_id_, 16) << "\"";
+  if (v.record_address_) {
+    o << " record=\"" << assorted::Hex(v.record_address_, 16) << "\"";
+  }
+  o << ">";
+  for (uint16_t c = 0; c < kAbortCauseCount; ++c) {
+    if (v.cause_counts_[c]) {
+      o << "<" << get_abort_cause_name(static_cast<AbortCause>(c)) << ">" << v.cause_counts_[c]
+        << "</" << get_abort_cause_name(static_cast<AbortCause>(c)) << ">";
+    }
+  }
+  o << "</Hotspot>" << std::endl;
+}
+}  // namespace
+
+std::ostream& operator<<(std::ostream& o, const AbortReport& v) {
+  o << "<AbortReport><samples_>" << v.sample_count_ << "</samples_>";
+  for (uint16_t c = 0; c < kAbortCauseCount; ++c) {
+    o << "<" << get_abort_cause_name(static_cast<AbortCause>(c)) << ">" << v.cause_counts_[c]
+      << "</" << get_abort_cause_name(static_cast<AbortCause>(c)) << ">";
+  }
+  o << std::endl << "<HotRecords>" << std::endl;
+  for (const AbortHotspot& hotspot : v.hot_records_) {
+    print_hotspot(&o, v.engine_, hotspot);
+  }
+  o << "</HotRecords>" << std::endl << "<HotPages>" << std::endl;
+  for (const AbortHotspot& hotspot : v.hot_pages_) {
+    print_hotspot(&o, v.engine_, hotspot);
+  }
+  o << "</HotPages></AbortReport>";
+  return o;
+}
+
+}  // namespace xct
+}  // namespace foedus
@@ -67,6 +67,7 @@ Xct::Xct(Engine* engine, thread::Thread* context, thread::ThreadId thread_id)
   pointer_set_size_ = 0;
   page_version_set_size_ = 0;
   isolation_level_ = kSerializable;
+  read_volatile_in_snapshot_ = false;
   mcs_block_current_ = nullptr;
   mcs_rw_async_mapping_current_ = nullptr;
   local_work_memory_ = nullptr;
@@ -91,6 +92,7 @@ void Xct::initialize(
   hot_threshold_for_this_xct_ = default_hot_threshold_for_this_xct_;
   default_rll_threshold_for_this_xct_ = xct_opt.hot_threshold_for_retrospective_lock_list_;
   rll_threshold_for_this_xct_ = default_rll_threshold_for_this_xct_;
+  retry_backoff_.init(thread_id_ + 1U, xct_opt.max_retry_backoff_cycles_);
 
   sysxct_workspace_ = reinterpret_cast<SysxctWorkspace*>(pieces.sysxct_workspace_memory_);
 
@@ -100,6 +102,9 @@ void Xct::initialize(
   write_set_ = reinterpret_cast<WriteXctAccess*>(pieces.xct_write_access_memory_);
   write_set_size_ = 0;
   max_write_set_size_ = xct_opt.max_write_set_size_;
+  write_set_index_.init(
+    reinterpret_cast<WriteSetIndexSlot*>(pieces.xct_write_set_index_memory_),
+    WriteSetIndex::calculate_capacity(max_write_set_size_));
   lock_free_read_set_ = reinterpret_cast<LockFreeReadXctAccess*>(
     pieces.xct_lock_free_read_access_memory_);
   lock_free_read_set_size_ = 0;
@@ -281,6 +286,9 @@ ErrorCode Xct::on_record_read(
     // because we don't take any read locks in these modes, so the
     // original SILO's write-lock protocol is enough and abort-free.
     ASSERT_ND(isolation_level_ == kDirtyRead || isolation_level_ == kSnapshot);
+    if (isolation_level_ == kSnapshot) {
+      read_volatile_in_snapshot_ = true;
+    }
     *observed_xid = tid_address->xct_id_.spin_while_being_written();
     ASSERT_ND(!observed_xid->is_being_written());
     return kErrorCodeOk;
@@ -466,6 +474,17 @@ ErrorCode Xct::add_to_write_set(
   write->storage_id_ = storage_id;
   write->set_owner_id_resolve_lock_id(resolver, owner_id_address);
   write->related_read_ = CXX11_NULLPTR;
+  write->next_write_on_record_ = kNoWriteOrdinal;
+
+  // chain the writes on the same record in the order they are issued
+  WriteSetIndexSlot* slot = write_set_index_.find_or_create(owner_id_address);
+  if (slot->first_ordinal_ == kNoWriteOrdinal) {
+    slot->first_ordinal_ = write_set_size_;
+  } else {
+    ASSERT_ND(slot->last_ordinal_ < write_set_size_);
+    write_set_[slot->last_ordinal_].next_write_on_record_ = write_set_size_;
+  }
+  slot->last_ordinal_ = write_set_size_;
   ++write_set_size_;
   return kErrorCodeOk;
 }
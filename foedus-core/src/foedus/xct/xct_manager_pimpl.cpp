@@ -31,20 +31,30 @@
 #include "foedus/assorted/atomic_fences.hpp"
 #include "foedus/assorted/cacheline.hpp"
 #include "foedus/cache/cache_manager.hpp"
+#include "foedus/debugging/rdtsc_watch.hpp"
 #include "foedus/debugging/stop_watch.hpp"
 #include "foedus/log/log_manager.hpp"
 #include "foedus/log/log_type_invoke.hpp"
 #include "foedus/log/thread_log_buffer.hpp"
+#include "foedus/memory/page_resolver.hpp"
 #include "foedus/savepoint/savepoint.hpp"
 #include "foedus/savepoint/savepoint_manager.hpp"
+#include "foedus/snapshot/snapshot_manager.hpp"
 #include "foedus/soc/soc_manager.hpp"
+#include "foedus/storage/page.hpp"
 #include "foedus/storage/record.hpp"
 #include "foedus/storage/storage_manager.hpp"
+#include "foedus/thread/latency_histogram.hpp"
 #include "foedus/thread/thread.hpp"
+#include "foedus/thread/thread_metrics.hpp"
 #include "foedus/thread/thread_pool.hpp"
 #include "foedus/thread/thread_ref.hpp"
+#include "foedus/xct/abort_report.hpp"
+#include "foedus/xct/abort_sample.hpp"
+#include "foedus/xct/durable_callback_queue.hpp"
 #include "foedus/xct/in_commit_epoch_guard.hpp"
 #include "foedus/xct/retrospective_lock_list.hpp"
+#include "foedus/xct/retry_backoff.hpp"
 #include "foedus/xct/xct.hpp"
 #include "foedus/xct/xct_access.hpp"
 #include "foedus/xct/xct_id.hpp"
@@ -68,9 +78,16 @@ Epoch       XctManager::get_current_grace_epoch_weak() const {
 }
 
 void        XctManager::advance_current_global_epoch() { pimpl_->advance_current_global_epoch(); }
+EpochChimeStat XctManager::get_epoch_chime_stat() const { return pimpl_->get_epoch_chime_stat(); }
 ErrorCode   XctManager::wait_for_commit(Epoch commit_epoch, int64_t wait_microseconds) {
   return pimpl_->wait_for_commit(commit_epoch, wait_microseconds);
 }
+ErrorCode   XctManager::wait_for_commit(
+  thread::Thread* context,
+  Epoch commit_epoch,
+  int64_t wait_microseconds) {
+  return pimpl_->wait_for_commit(context, commit_epoch, wait_microseconds);
+}
 
 ErrorCode   XctManager::begin_xct(thread::Thread* context, IsolationLevel isolation_level) {
   return pimpl_->begin_xct(context, isolation_level);
@@ -79,7 +96,44 @@ ErrorCode   XctManager::begin_xct(thread::Thread* context, IsolationLevel isolat
 ErrorCode   XctManager::precommit_xct(thread::Thread* context, Epoch *commit_epoch) {
   return pimpl_->precommit_xct(context, commit_epoch);
 }
-ErrorCode   XctManager::abort_xct(thread::Thread* context)  { return pimpl_->abort_xct(context); }
+ErrorCode   XctManager::run_readonly_xct(
+  thread::Thread* context,
+  ReadOnlyXctBody body,
+  void* user_data,
+  Epoch* serialization_epoch) {
+  return pimpl_->run_readonly_xct(context, body, user_data, serialization_epoch);
+}
+ErrorCode   XctManager::run_xct_with_retry(
+  thread::Thread* context,
+  IsolationLevel isolation_level,
+  XctBody body,
+  void* user_data,
+  Epoch* commit_epoch) {
+  return pimpl_->run_xct_with_retry(context, isolation_level, body, user_data, commit_epoch);
+}
+ErrorCode   XctManager::precommit_xct_async(
+  thread::Thread* context,
+  DurableCallback callback,
+  void* user_data,
+  Epoch *commit_epoch) {
+  return pimpl_->precommit_xct_async(context, callback, user_data, commit_epoch);
+}
+uint32_t    XctManager::invoke_durable_callbacks(thread::Thread* context) {
+  return pimpl_->invoke_durable_callbacks(context);
+}
+ErrorCode   XctManager::wait_for_durable_callbacks(
+  thread::Thread* context,
+  int64_t wait_microseconds) {
+  return pimpl_->wait_for_durable_callbacks(context, wait_microseconds);
+}
+ErrorCode   XctManager::abort_xct(thread::Thread* context)  {
+  ErrorCode ret = pimpl_->abort_xct(context);
+  if (ret == kErrorCodeOk) {
+    // pre-commit failures internally call XctManagerPimpl::abort_xct. they are counted there.
+    ++context->get_metrics()->explicit_aborts_;
+  }
+  return ret;
+}
 
 ErrorStack XctManagerPimpl::initialize_once() {
   LOG(INFO) << "Initializing XctManager..";
@@ -101,6 +155,9 @@ ErrorStack XctManagerPimpl::initialize_once() {
   return kRetOk;
 }
 
+/** How many records/pages we show in the abort report at shutdown. */
+const uint32_t kAbortReportTopK = 10;
+
 ErrorStack XctManagerPimpl::uninitialize_once() {
   LOG(INFO) << "Uninitializing XctManager..";
   ErrorStackBatch batch;
@@ -117,6 +174,13 @@ ErrorStack XctManagerPimpl::uninitialize_once() {
       }
       epoch_chime_thread_.join();
     }
+    if (engine_->get_options().xct_.abort_sampling_interval_ > 0) {
+      AbortReport report(engine_);
+      report.collect(kAbortReportTopK);
+      if (report.get_sample_count() > 0) {
+        LOG(INFO) << "Contended records/pages observed in this run: " << report;
+      }
+    }
     control_block_->uninitialize();
   }
   return SUMMARIZE_ERROR_BATCH(batch);
@@ -139,8 +203,22 @@ void XctManagerPimpl::handle_epoch_chime() {
   SPINLOCK_WHILE(!is_stop_requested() && !is_initialized()) {
     assorted::memory_fence_acquire();
   }
-  uint64_t interval_microsec = engine_->get_options().xct_.epoch_advance_interval_ms_ * 1000ULL;
-  LOG(INFO) << "epoch_chime_thread now starts processing. interval_microsec=" << interval_microsec;
+  const XctOptions& options = engine_->get_options().xct_;
+  uint64_t interval_microsec = options.epoch_advance_interval_ms_ * 1000ULL;
+  const bool adaptive = options.adaptive_epoch_interval_;
+  const uint64_t min_interval_microsec = options.min_epoch_advance_interval_ms_ * 1000ULL;
+  const uint64_t max_interval_microsec
+    = std::max<uint64_t>(options.max_epoch_advance_interval_ms_ * 1000ULL, min_interval_microsec);
+  if (adaptive) {
+    interval_microsec = std::min(
+      std::max(interval_microsec, min_interval_microsec),
+      max_interval_microsec);
+  }
+  control_block_->epoch_interval_us_ = interval_microsec;
+  LOG(INFO) << "epoch_chime_thread now starts processing. interval_microsec=" << interval_microsec
+    << ", adaptive=" << adaptive;
+  uint64_t prev_commit_waits = control_block_->total_commit_waits_.load();
+  debugging::StopWatch epoch_watch;
   while (!is_stop_requested()) {
     {
       uint64_t demand = control_block_->epoch_chime_wakeup_.acquire_ticket();
@@ -179,6 +257,30 @@ void XctManagerPimpl::handle_epoch_chime() {
       control_block_->current_global_epoch_advanced_.signal();
     }
     engine_->get_log_manager()->wakeup_loggers();
+
+    const uint64_t duration_us = epoch_watch.stop() / 1000ULL;
+    epoch_watch.start();
+    ++control_block_->epochs_advanced_;
+    control_block_->last_epoch_duration_us_ = duration_us;
+    control_block_->total_epoch_duration_us_ += duration_us;
+    if (duration_us > control_block_->max_epoch_duration_us_) {
+      control_block_->max_epoch_duration_us_ = duration_us;
+    }
+
+    // Someone waited if the counter advanced or someone is still waiting.
+    const uint64_t cur_commit_waits = control_block_->total_commit_waits_.load();
+    const bool had_commit_waiters
+      = cur_commit_waits != prev_commit_waits || control_block_->commit_waiters_.load() > 0;
+    prev_commit_waits = cur_commit_waits;
+    if (adaptive) {
+      interval_microsec = adapt_epoch_interval(
+        interval_microsec,
+        had_commit_waiters,
+        min_interval_microsec,
+        max_interval_microsec);
+      control_block_->epoch_interval_us_ = interval_microsec;
+      VLOG(1) << "epoch_chime_thread. next interval_microsec=" << interval_microsec;
+    }
   }
   LOG(INFO) << "epoch_chime_thread ended.";
 }
@@ -234,6 +336,35 @@ void XctManagerPimpl::handle_epoch_chime_wait_grace_period(Epoch grace_epoch) {
 }
 
 
+uint64_t XctManagerPimpl::adapt_epoch_interval(
+  uint64_t cur_interval_us,
+  bool had_commit_waiters,
+  uint64_t min_interval_us,
+  uint64_t max_interval_us) {
+  ASSERT_ND(min_interval_us <= max_interval_us);
+  uint64_t next;
+  if (had_commit_waiters) {
+    // Someone cares about latency. Quickly shorten it.
+    next = cur_interval_us / 2U;
+  } else {
+    // Pure throughput load. Slowly lengthen it. +1 so that we can grow from a tiny value.
+    next = cur_interval_us + cur_interval_us / 4U + 1U;
+  }
+  return std::min(std::max(next, min_interval_us), max_interval_us);
+}
+
+EpochChimeStat XctManagerPimpl::get_epoch_chime_stat() const {
+  EpochChimeStat stat;
+  stat.current_interval_us_ = control_block_->epoch_interval_us_.load();
+  stat.epochs_advanced_ = control_block_->epochs_advanced_.load();
+  stat.last_epoch_duration_us_ = control_block_->last_epoch_duration_us_.load();
+  stat.max_epoch_duration_us_ = control_block_->max_epoch_duration_us_.load();
+  stat.total_epoch_duration_us_ = control_block_->total_epoch_duration_us_.load();
+  stat.current_commit_waiters_ = control_block_->commit_waiters_.load();
+  stat.total_commit_waits_ = control_block_->total_commit_waits_.load();
+  return stat;
+}
+
 void XctManagerPimpl::wakeup_epoch_chime_thread() {
   control_block_->epoch_chime_wakeup_.signal();  // hurrrrry up!
 }
@@ -296,7 +427,97 @@ ErrorCode XctManagerPimpl::wait_for_commit(Epoch commit_epoch, int64_t wait_micr
     wakeup_epoch_chime_thread();
   }
 
-  return engine_->get_log_manager()->wait_until_durable(commit_epoch, wait_microseconds);
+  log::LogManager* log_manager = engine_->get_log_manager();
+  if (commit_epoch <= log_manager->get_durable_global_epoch() || wait_microseconds == 0) {
+    return log_manager->wait_until_durable(commit_epoch, wait_microseconds);
+  }
+
+  // We will really wait. Let the epoch chime know it, eg for adaptive epoch interval.
+  ++control_block_->total_commit_waits_;
+  ++control_block_->commit_waiters_;
+  ErrorCode ret = log_manager->wait_until_durable(commit_epoch, wait_microseconds);
+  --control_block_->commit_waiters_;
+  return ret;
+}
+
+ErrorCode XctManagerPimpl::wait_for_commit(
+  thread::Thread* context,
+  Epoch commit_epoch,
+  int64_t wait_microseconds) {
+  debugging::RdtscWatch watch;
+  ErrorCode ret = wait_for_commit(commit_epoch, wait_microseconds);
+  if (ret == kErrorCodeOk) {
+    context->get_latency_histograms()->record(thread::kLatencyPhaseWaitForCommit, watch.stop());
+  }
+  return ret;
+}
+
+ErrorCode XctManagerPimpl::precommit_xct_async(
+  thread::Thread* context,
+  DurableCallback callback,
+  void* user_data,
+  Epoch *commit_epoch) {
+  ASSERT_ND(callback);
+  DurableCallbackQueue* queue = context->get_current_xct().get_durable_callback_queue();
+  if (UNLIKELY(queue->is_full())) {
+    // Back pressure. Make room by waiting for the oldest one. We have to do this before
+    // pre-commit because we can't fail after pre-commit.
+    DVLOG(0) << *context << " has too many pending durable callbacks. Waiting for the oldest";
+    const Epoch oldest = queue->front().commit_epoch_;
+    if (oldest.is_valid()) {
+      CHECK_ERROR_CODE(wait_for_commit(context, oldest, -1));
+    }
+    invoke_durable_callbacks(context);
+    ASSERT_ND(!queue->is_full());
+  }
+
+  CHECK_ERROR_CODE(precommit_xct(context, commit_epoch));
+  // This transaction now waits for durability, though asynchronously. Let the epoch chime know
+  // it for each commit. Under steady async load the queue is never empty, so counting only
+  // when it becomes non-empty would make the chime think nobody is waiting.
+  ++control_block_->total_commit_waits_;
+  queue->push_back(*commit_epoch, callback, user_data);
+  // Read-only transactions might be already durable.
+  invoke_durable_callbacks(context);
+  return kErrorCodeOk;
+}
+
+uint32_t XctManagerPimpl::invoke_durable_callbacks(thread::Thread* context) {
+  DurableCallbackQueue* queue = context->get_current_xct().get_durable_callback_queue();
+  if (queue->is_empty()) {
+    return 0;
+  }
+  const Epoch durable_epoch = engine_->get_log_manager()->get_durable_global_epoch();
+  uint32_t invoked = 0;
+  while (!queue->is_empty()) {
+    const DurableCallbackQueue::Entry entry = queue->front();
+    // invalid commit epoch means a read-only transaction that read nothing. already durable.
+    if (entry.commit_epoch_.is_valid() && entry.commit_epoch_ > durable_epoch) {
+      break;
+    }
+    // pop first so that the callback sees a consistent queue
+    queue->pop_front();
+    entry.callback_(entry.commit_epoch_, entry.user_data_);
+    ++invoked;
+  }
+  DVLOG(1) << *context << " invoked " << invoked << " durable callbacks. durable_epoch="
+    << durable_epoch << ", remaining=" << queue->get_count();
+  return invoked;
+}
+
+ErrorCode XctManagerPimpl::wait_for_durable_callbacks(
+  thread::Thread* context,
+  int64_t wait_microseconds) {
+  DurableCallbackQueue* queue = context->get_current_xct().get_durable_callback_queue();
+  while (!queue->is_empty()) {
+    // Most entries become durable together with the oldest one, so this loop is usually short.
+    const Epoch oldest = queue->front().commit_epoch_;
+    if (oldest.is_valid()) {
+      CHECK_ERROR_CODE(wait_for_commit(context, oldest, wait_microseconds));
+    }
+    invoke_durable_callbacks(context);
+  }
+  return kErrorCodeOk;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -312,6 +533,9 @@ ErrorCode XctManagerPimpl::begin_xct(thread::Thread* context, IsolationLevel iso
   if (UNLIKELY(control_block_->new_transaction_paused_.load())) {
     wait_until_resume_accepting_xct(context);
   }
+  if (!current_xct.get_durable_callback_queue()->is_empty()) {
+    invoke_durable_callbacks(context);
+  }
   DVLOG(1) << *context << " Began new transaction."
     << " RLL size=" << current_xct.get_retrospective_lock_list()->get_last_active_entry();
   current_xct.activate(isolation_level);
@@ -347,6 +571,14 @@ ErrorCode XctManagerPimpl::precommit_xct(thread::Thread* context, Epoch *commit_
   }
   ASSERT_ND(current_xct.assert_related_read_write());
 
+  context->get_latency_histograms()->record(
+    thread::kLatencyPhaseUserBody,
+    current_xct.get_elapsed_cycles());
+  thread::ThreadMetrics* metrics = context->get_metrics();
+  metrics->read_set_total_ += current_xct.get_read_set_size();
+  metrics->write_set_total_
+    += current_xct.get_write_set_size() + current_xct.get_lock_free_write_set_size();
+
   ErrorCode result;
   bool read_only = context->get_current_xct().is_read_only();
   if (read_only) {
@@ -357,10 +589,15 @@ ErrorCode XctManagerPimpl::precommit_xct(thread::Thread* context, Epoch *commit_
 
   ASSERT_ND(current_xct.assert_related_read_write());
   if (result != kErrorCodeOk) {
+    metrics->count_precommit_abort(result);
     ErrorCode abort_ret = abort_xct(context);
     ASSERT_ND(abort_ret == kErrorCodeOk);
     DVLOG(1) << *context << " Aborting because of contention";
   } else {
+    ++metrics->commits_;
+    if (read_only) {
+      ++metrics->read_only_commits_;
+    }
     current_xct.get_retrospective_lock_list()->clear_entries();
     release_and_clear_all_current_locks(context);
     current_xct.deactivate();
@@ -368,13 +605,137 @@ ErrorCode XctManagerPimpl::precommit_xct(thread::Thread* context, Epoch *commit_
   ASSERT_ND(current_xct.get_current_lock_list()->is_empty());
   return result;
 }
+ErrorCode XctManagerPimpl::run_readonly_xct(
+  thread::Thread* context,
+  ReadOnlyXctBody body,
+  void* user_data,
+  Epoch* serialization_epoch) {
+  ASSERT_ND(body);
+  const uint32_t serializable_attempts
+    = engine_->get_options().xct_.readonly_serializable_attempts_;
+  snapshot::SnapshotManager* snapshot_manager = engine_->get_snapshot_manager();
+  thread::ThreadMetrics* metrics = context->get_metrics();
+  // false once body turns out to read something that is not in the snapshot
+  bool snapshot_usable = true;
+  for (uint32_t race_aborts = 0;;) {
+    IsolationLevel isolation_level = kSerializable;
+    Epoch snapshot_epoch;
+    uint64_t install_sequence = 0;
+    if (snapshot_usable && race_aborts >= serializable_attempts) {
+      // seqlock-style. if a new snapshot is being installed now, stay serializable this time.
+      install_sequence = snapshot_manager->get_snapshot_install_sequence();
+      snapshot_epoch = snapshot_manager->get_snapshot_epoch();
+      if (snapshot_epoch.is_valid() && (install_sequence & 1U) == 0) {
+        isolation_level = kSnapshot;
+      }
+    }
+    CHECK_ERROR_CODE(begin_xct(context, isolation_level));
+    ErrorCode body_ret = body(context, user_data);
+    if (body_ret == kErrorCodeOk && !context->get_current_xct().is_read_only()) {
+      body_ret = kErrorCodeXctReadOnlyBodyWrote;
+    }
+    bool snapshot_unusable = false;
+    if (body_ret == kErrorCodeOk && isolation_level == kSnapshot) {
+      assorted::memory_fence_acquire();
+      if (context->get_current_xct().is_read_volatile_in_snapshot()) {
+        // body read volatile pages, e.g. of a storage created after the snapshot. Such reads
+        // are neither in the snapshot nor verified. Retry in kSerializable from now on.
+        DVLOG(1) << *context << " read-only transaction read volatile pages in kSnapshot";
+        snapshot_usable = false;
+        snapshot_unusable = true;
+        body_ret = kErrorCodeXctRaceAbort;
+      } else if (snapshot_manager->get_snapshot_install_sequence() != install_sequence) {
+        // Root pointers of a new snapshot were installed while we were reading, so we might
+        // have read from two snapshots. Just retry on the new snapshot.
+        snapshot_unusable = true;
+        body_ret = kErrorCodeXctRaceAbort;
+      }
+    }
+    if (body_ret != kErrorCodeOk) {
+      ErrorCode abort_ret = abort_xct(context);
+      ASSERT_ND(abort_ret == kErrorCodeOk);
+      if (snapshot_unusable) {
+        // this is a verification failure rather than the user's decision
+        metrics->count_precommit_abort(body_ret);
+      } else {
+        ++metrics->explicit_aborts_;
+      }
+      if (body_ret != kErrorCodeXctRaceAbort) {
+        return body_ret;
+      }
+      ++race_aborts;
+      continue;
+    }
+
+    ErrorCode precommit_ret = precommit_xct(context, serialization_epoch);
+    if (precommit_ret == kErrorCodeOk) {
+      if (isolation_level == kSnapshot) {
+        // reads on snapshot pages are not in the read-set. serialized at the snapshot.
+        *serialization_epoch = snapshot_epoch;
+        ++metrics->readonly_snapshot_fallbacks_;
+      }
+      return kErrorCodeOk;
+    } else if (precommit_ret != kErrorCodeXctRaceAbort) {
+      return precommit_ret;
+    }
+    ++race_aborts;
+    DVLOG(1) << *context << " read-only transaction failed verification " << race_aborts
+      << " times in a row";
+  }
+}
+
+ErrorCode XctManagerPimpl::run_xct_with_retry(
+  thread::Thread* context,
+  IsolationLevel isolation_level,
+  XctBody body,
+  void* user_data,
+  Epoch* commit_epoch) {
+  ASSERT_ND(body);
+  const uint32_t max_attempts = engine_->get_options().xct_.max_retry_attempts_;
+  Xct& current_xct = context->get_current_xct();
+  RetryBackoff* backoff = current_xct.get_retry_backoff();
+  thread::ThreadMetrics* metrics = context->get_metrics();
+  for (uint32_t attempt = 1;; ++attempt) {
+    CHECK_ERROR_CODE(begin_xct(context, isolation_level));
+    // RLL is constructed when this attempt aborts, and used by the next attempt.
+    current_xct.set_enable_rll_for_this_xct(true);
+    ErrorCode ret = body(context, user_data);
+    if (ret == kErrorCodeOk) {
+      ret = precommit_xct(context, commit_epoch);
+      if (ret == kErrorCodeOk) {
+        backoff->on_commit();
+        return kErrorCodeOk;
+      }
+      // precommit_xct() has already aborted the transaction.
+    } else {
+      ErrorCode abort_ret = abort_xct(context);
+      ASSERT_ND(abort_ret == kErrorCodeOk);
+      ++metrics->explicit_aborts_;
+    }
+
+    const AbortClass abort_class = classify_abort(ret);
+    if (!is_retryable_abort(abort_class) || (max_attempts != 0 && attempt >= max_attempts)) {
+      // we won't retry, so the RLL must not affect the next, unrelated transaction.
+      current_xct.get_retrospective_lock_list()->clear_entries();
+      return ret;
+    }
+    backoff->on_abort();
+    ++metrics->retries_;
+    metrics->retry_backoff_cycles_ += backoff->backoff();
+    DVLOG(1) << *context << " retrying transaction after " << attempt << " attempts. class="
+      << abort_class << ", backoff level=" << backoff->get_level();
+  }
+}
+
 ErrorCode XctManagerPimpl::precommit_xct_readonly(thread::Thread* context, Epoch *commit_epoch) {
   DVLOG(1) << *context << " Committing read_only";
   ASSERT_ND(context->get_thread_log_buffer().get_offset_committed() ==
       context->get_thread_log_buffer().get_offset_tail());
   *commit_epoch = Epoch();
   assorted::memory_fence_acquire();  // this is enough for read-only case
+  debugging::RdtscWatch watch;
   if (precommit_xct_verify_readonly(context, commit_epoch)) {
+    context->get_latency_histograms()->record(thread::kLatencyPhaseVerify, watch.stop());
     return kErrorCodeOk;
   } else {
     return kErrorCodeXctRaceAbort;
@@ -385,10 +746,13 @@ ErrorCode XctManagerPimpl::precommit_xct_readwrite(thread::Thread* context, Epoc
   DVLOG(1) << *context << " Committing read-write";
   XctId max_xct_id;
   max_xct_id.set(Epoch::kEpochInitialDurable, 1);  // TODO(Hideaki) not quite..
+  thread::ThreadLatencyHistograms* latencies = context->get_latency_histograms();
+  debugging::RdtscWatch watch;
   ErrorCode lock_ret = precommit_xct_lock(context, &max_xct_id);  // Phase 1
   if (lock_ret != kErrorCodeOk) {
     return lock_ret;
   }
+  latencies->record(thread::kLatencyPhasePrecommitLock, watch.stop());
 
   // BEFORE the first fence, update the in commit epoch for epoch chime.
   // see InCommitEpochGuard class comments for why we need to do this.
@@ -401,6 +765,7 @@ ErrorCode XctManagerPimpl::precommit_xct_readwrite(thread::Thread* context, Epoc
   DVLOG(1) << *context << " Acquired read-write commit epoch " << *commit_epoch;
 
   assorted::memory_fence_acq_rel();
+  watch.start();
   bool verified = precommit_xct_verify_readwrite(context, &max_xct_id);  // phase 2
 #ifndef NDEBUG
   {
@@ -415,14 +780,22 @@ ErrorCode XctManagerPimpl::precommit_xct_readwrite(thread::Thread* context, Epoc
   }
 #endif  // NDEBUG
   if (verified) {
+    latencies->record(thread::kLatencyPhaseVerify, watch.stop());
+    watch.start();
     precommit_xct_apply(context, max_xct_id, commit_epoch);  // phase 3. this does NOT unlock
     // announce log AFTER (with fence) apply, because apply sets xct_order in the logs.
     assorted::memory_fence_release();
+    log::ThreadLogBuffer& log_buffer = context->get_thread_log_buffer();
     if (engine_->get_options().log_.emulation_.null_device_) {
-      context->get_thread_log_buffer().discard_current_xct_log();
+      log_buffer.discard_current_xct_log();
     } else {
-      context->get_thread_log_buffer().publish_committed_log(*commit_epoch);
+      context->get_metrics()->log_bytes_ += log::ThreadLogBuffer::distance(
+        log_buffer.get_meta().buffer_size_,
+        log_buffer.get_offset_committed(),
+        log_buffer.get_offset_tail());
+      log_buffer.publish_committed_log(*commit_epoch);
     }
+    latencies->record(thread::kLatencyPhaseApply, watch.stop());
     return kErrorCodeOk;
   }
   return kErrorCodeXctRaceAbort;
@@ -481,17 +854,22 @@ void XctManagerPimpl::precommit_xct_sort_access(thread::Thread* context) {
   uint32_t        write_set_size = current_xct.get_write_set_size();
 
   ASSERT_ND(current_xct.assert_related_read_write());
-  std::sort(write_set, write_set + write_set_size, WriteXctAccess::compare);
-  // after the sorting, the related-link from read-set to write-set is now broken.
-  // we fix it by following the back-link from write-set to read-set.
-  for (uint32_t i = 0; i < write_set_size; ++i) {
-    WriteXctAccess* entry = write_set + i;
-    if (entry->related_read_) {
-      ASSERT_ND(entry->owner_id_address_ == entry->related_read_->owner_id_address_);
-      ASSERT_ND(entry->related_read_->related_write_);
-      entry->related_read_->related_write_ = entry;
+  // Write-sets are often created in the canonical order already, eg sequential accesses to
+  // an array, or a single record repeatedly overwritten (which WriteSetIndex lets storages
+  // coalesce in the first place). A linear check is much cheaper than sorting in that case.
+  if (!std::is_sorted(write_set, write_set + write_set_size, WriteXctAccess::compare)) {
+    std::sort(write_set, write_set + write_set_size, WriteXctAccess::compare);
+    // after the sorting, the related-link from read-set to write-set is now broken.
+    // we fix it by following the back-link from write-set to read-set.
+    for (uint32_t i = 0; i < write_set_size; ++i) {
+      WriteXctAccess* entry = write_set + i;
+      if (entry->related_read_) {
+        ASSERT_ND(entry->owner_id_address_ == entry->related_read_->owner_id_address_);
+        ASSERT_ND(entry->related_read_->related_write_);
+        entry->related_read_->related_write_ = entry;
+      }
+      entry->ordinal_ = i;
     }
-    entry->ordinal_ = i;
   }
   ASSERT_ND(current_xct.assert_related_read_write());
 
@@ -522,6 +900,8 @@ ErrorCode XctManagerPimpl::precommit_xct_lock_batch_track_moved(thread::Thread*
     if (UNLIKELY(rec->needs_track_moved())) {
       if (!precommit_xct_lock_track_write(context, entry)) {
         DLOG(INFO) << "Failed to track moved record?? this must be very rare";
+        ++context->get_metrics()->moved_record_aborts_;
+        sample_abort(context, kAbortCauseMovedRecord, rec, entry->storage_id_);
         return kErrorCodeXctRaceAbort;
       }
       ASSERT_ND(entry->owner_id_address_ != rec);
@@ -603,7 +983,11 @@ moved_retry:
         ASSERT_ND(new_pos == kLockListPositionInvalid || new_pos < lock_pos);
 #endif  // NDEBUG
       }
-      CHECK_ERROR_CODE(context->cll_try_or_acquire_single_lock(lock_pos));
+      ErrorCode lock_ret = context->cll_try_or_acquire_single_lock(lock_pos);
+      if (UNLIKELY(lock_ret != kErrorCodeOk)) {
+        sample_abort(context, kAbortCauseLock, entry->owner_id_address_, entry->storage_id_);
+        return lock_ret;
+      }
     }
 
     if (UNLIKELY(entry->owner_id_address_->needs_track_moved())) {
@@ -628,6 +1012,7 @@ moved_retry:
       if (r->related_read_) {
         ASSERT_ND(r->related_read_->owner_id_address_ == r->owner_id_address_);
         if (r->owner_id_address_->xct_id_ != r->related_read_->observed_owner_id_) {
+          sample_abort(context, kAbortCauseReadVerify, r->owner_id_address_, r->storage_id_);
           return kErrorCodeXctRaceAbort;
         }
       }
@@ -669,6 +1054,7 @@ bool XctManagerPimpl::precommit_xct_verify_readonly(thread::Thread* context, Epo
       // probably there still is some code to forget that.
       // At least safe to abort here, so keep it this way for now.
       DLOG(WARNING) << *context << "?? this should have been checked. being_written! will abort";
+      sample_abort(context, kAbortCauseReadVerify, access.owner_id_address_, access.storage_id_);
       return false;
     }
 
@@ -682,12 +1068,15 @@ bool XctManagerPimpl::precommit_xct_verify_readonly(thread::Thread* context, Epo
     // but that's fragile. too much complexity for little. we just verify always. period.
     if (UNLIKELY(access.owner_id_address_->needs_track_moved())) {
       if (!precommit_xct_verify_track_read(context, &access)) {
+        ++context->get_metrics()->moved_record_aborts_;
+        sample_abort(context, kAbortCauseMovedRecord, access.owner_id_address_, access.storage_id_);
         return false;
       }
     }
     if (access.observed_owner_id_ != access.owner_id_address_->xct_id_) {
       DLOG(WARNING) << *context << " read set changed by other transaction. will abort";
       // read clobbered
+      sample_abort(context, kAbortCauseReadVerify, access.owner_id_address_, access.storage_id_);
       return false;
     }
 
@@ -703,6 +1092,7 @@ bool XctManagerPimpl::precommit_xct_verify_readonly(thread::Thread* context, Epo
     ASSERT_ND(!access.owner_id_address_->needs_track_moved());
     if (access.observed_owner_id_ != access.owner_id_address_->xct_id_) {
       DLOG(WARNING) << *context << " lock free read set changed by other transaction. will abort";
+      sample_abort(context, kAbortCauseReadVerify, access.owner_id_address_, access.storage_id_);
       return false;
     }
 
@@ -747,6 +1137,7 @@ bool XctManagerPimpl::precommit_xct_verify_readwrite(thread::Thread* context, Xc
     if (UNLIKELY(access.observed_owner_id_.is_being_written())) {
       // same as above.
       DLOG(WARNING) << *context << "?? this should have been checked. being_written! will abort";
+      sample_abort(context, kAbortCauseReadVerify, access.owner_id_address_, access.storage_id_);
       return false;
     }
     storage::StorageManager* st = engine_->get_storage_manager();
@@ -766,6 +1157,8 @@ bool XctManagerPimpl::precommit_xct_verify_readwrite(thread::Thread* context, Xc
     // if the rare event (yet another concurrent split) happens, we just abort the transaction.
     if (UNLIKELY(access.owner_id_address_->needs_track_moved())) {
       if (!precommit_xct_verify_track_read(context, &access)) {
+        ++context->get_metrics()->moved_record_aborts_;
+        sample_abort(context, kAbortCauseMovedRecord, access.owner_id_address_, access.storage_id_);
         return false;
       }
     }
@@ -773,6 +1166,7 @@ bool XctManagerPimpl::precommit_xct_verify_readwrite(thread::Thread* context, Xc
     if (access.observed_owner_id_ != access.owner_id_address_->xct_id_) {
       DVLOG(1) << *context << " read set changed by other transaction. will abort";
       // same as read_only
+      sample_abort(context, kAbortCauseReadVerify, access.owner_id_address_, access.storage_id_);
       return false;
     }
 
@@ -812,6 +1206,7 @@ bool XctManagerPimpl::precommit_xct_verify_readwrite(thread::Thread* context, Xc
     ASSERT_ND(!access.owner_id_address_->needs_track_moved());
     if (access.observed_owner_id_ != access.owner_id_address_->xct_id_) {
       DLOG(WARNING) << *context << " lock free read set changed by other transaction. will abort";
+      sample_abort(context, kAbortCauseReadVerify, access.owner_id_address_, access.storage_id_);
       return false;
     }
   }
@@ -839,6 +1234,7 @@ bool XctManagerPimpl::precommit_xct_verify_pointer_set(thread::Thread* context)
     const PointerAccess& access = pointer_set[i];
     if (access.address_->word !=  access.observed_.word) {
       DLOG(WARNING) << *context << " volatile ptr is changed by other transaction. will abort";
+      sample_abort(context, kAbortCausePointer, access.address_, 0);
       return false;
     }
   }
@@ -859,12 +1255,56 @@ bool XctManagerPimpl::precommit_xct_verify_page_version_set(thread::Thread* cont
     if (access.address_->status_ != access.observed_) {
       DLOG(WARNING) << *context << " page version is changed by other transaction. will abort"
         " observed=" << access.observed_ << ", now=" << access.address_->status_;
+      sample_abort(context, kAbortCausePageVersion, access.address_, 0);
       return false;
     }
   }
   return true;
 }
 
+void XctManagerPimpl::sample_abort(
+  thread::Thread* context,
+  AbortCause cause,
+  const void* address,
+  storage::StorageId storage_id) {
+  const uint32_t interval = engine_->get_options().xct_.abort_sampling_interval_;
+  if (LIKELY(interval == 0)) {
+    return;
+  }
+  AbortSampleRing* ring = context->get_abort_samples();
+  if (!ring->should_sample(interval)) {
+    return;
+  }
+
+  AbortSample* sample = ring->next_sample();
+  sample->cause_ = kAbortCauseCount;  // AbortReport skips it until we are done
+  assorted::memory_fence_release();
+  if (cause == kAbortCausePointer || cause == kAbortCausePageVersion) {
+    sample->record_address_ = 0;
+  } else {
+    sample->record_address_ = reinterpret_cast<uintptr_t>(address);
+  }
+  sample->page_id_ = 0;
+  sample->storage_id_ = storage_id;
+  // The address might be in a storage control block (eg root pointers, sequential storage).
+  // Read the page header only when it's in the volatile page pool.
+  const memory::GlobalVolatilePageResolver& resolver = context->get_global_volatile_page_resolver();
+  const storage::Page* page = storage::to_page(address);
+  for (uint16_t node = 0; node < resolver.numa_node_count_; ++node) {
+    const storage::Page* base = resolver.bases_[node];
+    if (page >= base + resolver.begin_ && page < base + resolver.end_) {
+      sample->page_id_ = page->get_header().page_id_;
+      sample->storage_id_ = page->get_header().storage_id_;
+      break;
+    }
+  }
+  sample->epoch_ = get_current_global_epoch_weak().value();
+  sample->reserved1_ = 0;
+  sample->reserved2_ = 0;
+  assorted::memory_fence_release();
+  sample->cause_ = cause;
+}
+
 void XctManagerPimpl::precommit_xct_apply(
   thread::Thread* context,
   XctId max_xct_id,
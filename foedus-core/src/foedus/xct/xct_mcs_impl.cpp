@@ -24,6 +24,7 @@
 #include "foedus/assert_nd.hpp"
 #include "foedus/assorted/atomic_fences.hpp"
 #include "foedus/assorted/spin_until_impl.hpp"
+#include "foedus/debugging/rdtsc.hpp"
 #include "foedus/thread/thread_pimpl.hpp"  // just for explicit instantiation at the end
 #include "foedus/xct/xct_id.hpp"
 #include "foedus/xct/xct_mcs_adapter_impl.hpp"
@@ -42,6 +43,19 @@ void spin_until(COND spin_until_cond) {
   assorted::spin_until(spin_until_cond);
 }
 
+/**
+ * spin_until() to wait for a lock held by another thread to be granted.
+ * Reports the cycles we spent in the wait to the adaptor for ThreadMetrics.
+ * Called only when we are sure we are queued behind another thread, so the two RDTSCs are
+ * negligible compared to the wait itself.
+ */
+template <typename ADAPTOR, typename COND>
+void spin_until_granted(ADAPTOR* adaptor, COND spin_until_cond) {
+  const uint64_t started = debugging::get_rdtsc();
+  assorted::spin_until(spin_until_cond);
+  adaptor->add_mcs_wait_cycles(debugging::get_rdtsc() - started);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 ///      WW-lock implementations (all simple versions)
@@ -124,7 +138,8 @@ McsBlockIndex McsWwImpl<ADAPTOR>::acquire_unconditional(McsWwLock* mcs_lock) {
 
   ASSERT_ND(address->is_valid_atomic());
   ASSERT_ND(!address->is_guest_atomic());
-  spin_until([me_waiting]{ return !me_waiting->load(std::memory_order_acquire); });
+  spin_until_granted(&adaptor_, [me_waiting]{
+    return !me_waiting->load(std::memory_order_acquire); });
   DVLOG(1) << "Okay, now I hold the lock. me=" << id << ", ex-pred=" << predecessor_id;
   ASSERT_ND(!me_waiting->load());
   ASSERT_ND(mcs_lock->is_locked());
@@ -412,7 +427,7 @@ class McsImpl<ADAPTOR, McsRwSimpleBlock> {  // partial specialization for McsRwS
         // Predecessor is a writer or a waiting reader. The successor class field and the
         // blocked state in pred_block are separated, so we can blindly set_successor().
         pred_block->set_successor_next_only(id, block_index);
-        spin_until([my_block]{ return my_block->is_granted(); });
+        spin_until_granted(&adaptor_, [my_block]{ return my_block->is_granted(); });
       } else {
         // Join the active, reader predecessor
         ASSERT_ND(!pred_block->is_blocked());
@@ -510,7 +525,7 @@ class McsImpl<ADAPTOR, McsRwSimpleBlock> {  // partial specialization for McsRwS
       pred_block->set_successor_class_writer();
       pred_block->set_successor_next_only(id, block_index);
     }
-    spin_until([my_block]{ return my_block->is_granted(); });
+    spin_until_granted(&adaptor_, [my_block]{ return my_block->is_granted(); });
     return block_index;
   }
 
@@ -916,6 +931,17 @@ class McsImpl<ADAPTOR, McsRwExtendedBlock> {  // partial specialization for McsR
     pred_block->set_next_id(me);
   }
 
+  /** McsRwExtendedBlock::timeout_granted() that reports the wait cycles to the adaptor. */
+  bool timeout_granted_counted(McsRwExtendedBlock* my_block, int32_t timeout) {
+    if (timeout == McsRwExtendedBlock::kTimeoutZero || my_block->pred_flag_is_granted()) {
+      return my_block->timeout_granted(timeout);
+    }
+    const uint64_t started = debugging::get_rdtsc();
+    const bool granted = my_block->timeout_granted(timeout);
+    adaptor_.add_mcs_wait_cycles(debugging::get_rdtsc() - started);
+    return granted;
+  }
+
   ErrorCode acquire_reader_lock(McsRwLock* lock, McsBlockIndex* out_block_index, int32_t timeout) {
     auto* my_block = init_block(out_block_index, false);
     ASSERT_ND(my_block->pred_flag_is_waiting());
@@ -1037,7 +1063,7 @@ class McsImpl<ADAPTOR, McsRwExtendedBlock> {  // partial specialization for McsR
       expected, pred_block->make_next_flag_waiting_with_reader_successor());
     if (val == expected) {
       link_pred(pred, pred_block, my_tail_int, my_block);
-      if (my_block->timeout_granted(timeout)) {
+      if (timeout_granted_counted(my_block, timeout)) {
         return finish_acquire_reader_lock(lock, my_block, my_tail_int);
       }
       if (timeout == McsRwExtendedBlock::kTimeoutZero) {
@@ -1317,7 +1343,7 @@ class McsImpl<ADAPTOR, McsRwExtendedBlock> {  // partial specialization for McsR
       timeout = McsRwExtendedBlock::kTimeoutNever;
     }
 
-    if (my_block->timeout_granted(timeout)) {
+    if (timeout_granted_counted(my_block, timeout)) {
       return finish_acquire_reader_lock(lock, my_block, my_tail_int);
     }
     if (timeout == McsRwExtendedBlock::kTimeoutZero) {
@@ -1434,7 +1460,7 @@ class McsImpl<ADAPTOR, McsRwExtendedBlock> {  // partial specialization for McsR
       timeout = McsRwExtendedBlock::kTimeoutNever;
     }
 
-    if (my_block->timeout_granted(timeout)) {
+    if (timeout_granted_counted(my_block, timeout)) {
       my_block->set_next_flag_granted();
       adaptor_.remove_rw_async_mapping(lock);
       ASSERT_ND(lock->nreaders() == 0);
@@ -26,10 +26,17 @@ XctOptions::XctOptions() {
   max_lock_free_write_set_size_ = kDefaultMaxLockFreeWriteSetSize;
   local_work_memory_size_mb_ = kDefaultLocalWorkMemorySizeMb;
   epoch_advance_interval_ms_ = kDefaultEpochAdvanceIntervalMs;
+  adaptive_epoch_interval_ = false;
+  min_epoch_advance_interval_ms_ = kDefaultMinEpochAdvanceIntervalMs;
+  max_epoch_advance_interval_ms_ = kDefaultMaxEpochAdvanceIntervalMs;
   enable_retrospective_lock_list_ = false;  // TODO(Hideaki) tentative!
   hot_threshold_for_retrospective_lock_list_ = kDefaultHotThreshold;
   force_canonical_xlocks_in_precommit_ = true;  // TODO(Hideaki) tentative!
   mcs_implementation_type_ = kMcsImplementationTypeSimple;
+  abort_sampling_interval_ = 0;
+  readonly_serializable_attempts_ = kDefaultReadOnlySerializableAttempts;
+  max_retry_attempts_ = 0;
+  max_retry_backoff_cycles_ = kDefaultMaxRetryBackoffCycles;
 }
 
 ErrorStack XctOptions::load(tinyxml2::XMLElement* element) {
@@ -39,10 +46,17 @@ ErrorStack XctOptions::load(tinyxml2::XMLElement* element) {
   EXTERNALIZE_LOAD_ELEMENT(element, max_lock_free_write_set_size_);
   EXTERNALIZE_LOAD_ELEMENT(element, local_work_memory_size_mb_);
   EXTERNALIZE_LOAD_ELEMENT(element, epoch_advance_interval_ms_);
+  EXTERNALIZE_LOAD_ELEMENT(element, adaptive_epoch_interval_);
+  EXTERNALIZE_LOAD_ELEMENT(element, min_epoch_advance_interval_ms_);
+  EXTERNALIZE_LOAD_ELEMENT(element, max_epoch_advance_interval_ms_);
   EXTERNALIZE_LOAD_ELEMENT(element, enable_retrospective_lock_list_);
   EXTERNALIZE_LOAD_ELEMENT(element, hot_threshold_for_retrospective_lock_list_);
   EXTERNALIZE_LOAD_ELEMENT(element, force_canonical_xlocks_in_precommit_);
   EXTERNALIZE_LOAD_ELEMENT(element, mcs_implementation_type_);
+  EXTERNALIZE_LOAD_ELEMENT(element, abort_sampling_interval_);
+  EXTERNALIZE_LOAD_ELEMENT(element, readonly_serializable_attempts_);
+  EXTERNALIZE_LOAD_ELEMENT(element, max_retry_attempts_);
+  EXTERNALIZE_LOAD_ELEMENT(element, max_retry_backoff_cycles_);
   return kRetOk;
 }
 
@@ -72,6 +86,15 @@ ErrorStack XctOptions::save(tinyxml2::XMLElement* element) const {
     " out savepoint file for each non-empty epoch. However, too infrequent epoch advancement\n"
     " would increase the latency of queries because transactions are not deemed as commit"
     " until the epoch advances.");
+  EXTERNALIZE_SAVE_ELEMENT(element, adaptive_epoch_interval_,
+    "Whether the epoch chime adapts the interval between epoch advancements to the load.\n"
+    " When true, epoch_advance_interval_ms_ is the initial interval. The interval is halved\n"
+    " after an epoch in which some thread waited for durable commit, and lengthened by a quarter"
+    " after an epoch without such waiters.");
+  EXTERNALIZE_SAVE_ELEMENT(element, min_epoch_advance_interval_ms_,
+    "The shortest interval the adaptive epoch chime uses. Default is 2 ms.");
+  EXTERNALIZE_SAVE_ELEMENT(element, max_epoch_advance_interval_ms_,
+    "The longest interval the adaptive epoch chime uses. Default is 100 ms.");
   EXTERNALIZE_SAVE_ELEMENT(element, enable_retrospective_lock_list_,
     "When enabled, we remember read/write-sets on abort and use it as RLL on next run.");
   EXTERNALIZE_SAVE_ELEMENT(element, hot_threshold_for_retrospective_lock_list_,
@@ -83,6 +106,19 @@ ErrorStack XctOptions::save(tinyxml2::XMLElement* element) const {
   EXTERNALIZE_SAVE_ELEMENT(element, mcs_implementation_type_,
     "Defines which implementation of MCS locks to use for RW locks."
     " So far we allow kMcsImplementationTypeSimple and kMcsImplementationTypeExtended.");
+  EXTERNALIZE_SAVE_ELEMENT(element, abort_sampling_interval_,
+    "Samples one out of this number of aborts in pre-commit to find contended records."
+    " 0 (default) disables the sampling.");
+  EXTERNALIZE_SAVE_ELEMENT(element, readonly_serializable_attempts_,
+    "How many times run_readonly_xct() runs the transaction in serializable isolation level"
+    " before it falls back to the latest snapshot. 0 means it always reads the snapshot.");
+  EXTERNALIZE_SAVE_ELEMENT(element, max_retry_attempts_,
+    "How many times run_xct_with_retry() runs a transaction before it gives up."
+    " 0 (default) means it retries as long as the abort is worth retrying.");
+  EXTERNALIZE_SAVE_ELEMENT(element, max_retry_backoff_cycles_,
+    "The longest backoff in CPU cycles run_xct_with_retry() waits before retrying an aborted"
+    " transaction. The backoff grows exponentially while the thread keeps aborting."
+    " 0 disables the backoff.");
   return kRetOk;
 }
 
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <stdint.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "foedus/test_common.hpp"
+#include "foedus/assorted/radix_sort.hpp"
+#include "foedus/assorted/uniform_random.hpp"
+
+namespace foedus {
+namespace assorted {
+
+DEFINE_TEST_CASE_PACKAGE(RadixSortTest, foedus.assorted);
+
+/**
+ * Sort entries like partitioners: 48-bit key, 16-bit epoch, 32-bit ordinal, 32-bit position.
+ * Keys/epochs/ordinals are from narrow ranges to have duplicates and trivial digits.
+ * The positions are the input order so that we can check stability.
+ */
+void test_sort(uint32_t count, uint16_t threads, uint64_t key_range) {
+  UniformRandom rnd(count + threads);
+  std::vector<__uint128_t> data(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    data[i] = static_cast<__uint128_t>(rnd.next_uint64() % key_range) << 80
+      | static_cast<__uint128_t>(rnd.uniform_within(0, 3)) << 64
+      | static_cast<__uint128_t>(rnd.uniform_within(0, 1000)) << 32
+      | static_cast<__uint128_t>(i);
+  }
+  std::vector<__uint128_t> expected(data);
+  std::stable_sort(expected.begin(), expected.end(), [](__uint128_t left, __uint128_t right) {
+    return (left >> 32) < (right >> 32);
+  });
+
+  std::vector<__uint128_t> buffer(count + 1U);
+  radix_sort_uint128(&data[0], count, &buffer[0], 32, threads);
+  for (uint32_t i = 0; i < count; ++i) {
+    ASSERT_TRUE(expected[i] == data[i]) << i;
+  }
+}
+
+TEST(RadixSortTest, Small) {
+  for (uint32_t count = 1; count < kRadixSortMinCount; count *= 3U) {
+    test_sort(count, 1, 1000);
+  }
+}
+TEST(RadixSortTest, Single) { test_sort(100000, 1, 1ULL << 40); }
+TEST(RadixSortTest, SingleFewKeys) { test_sort(100000, 1, 10); }
+TEST(RadixSortTest, Parallel) { test_sort(kRadixSortParallelMinCount + 12345U, 4, 1ULL << 40); }
+TEST(RadixSortTest, ParallelFewKeys) { test_sort(kRadixSortParallelMinCount + 3U, 3, 100); }
+
+}  // namespace assorted
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(RadixSortTest, foedus.assorted);
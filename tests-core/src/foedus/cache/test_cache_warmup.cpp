@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <gtest/gtest.h>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/epoch.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/cache/cache_hashtable.hpp"
+#include "foedus/memory/engine_memory.hpp"
+#include "foedus/memory/numa_node_memory.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/snapshot/snapshot_manager.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/array/array_metadata.hpp"
+#include "foedus/storage/array/array_storage.hpp"
+#include "foedus/storage/array/array_storage_pimpl.hpp"
+#include "foedus/thread/thread.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/xct/xct_manager.hpp"
+
+/**
+ * @file test_cache_warmup.cpp
+ * Remembers hot snapshot pages at shutdown and reads them into the cache at restart.
+ */
+namespace foedus {
+namespace cache {
+DEFINE_TEST_CASE_PACKAGE(CacheWarmupTest, foedus.cache);
+
+const uint32_t kRecords = 1024;
+const storage::StorageName kName("test");
+
+ErrorStack populate_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::array::ArrayStorage array(args.engine_, kName);
+  xct::XctManager* xct_manager = args.engine_->get_xct_manager();
+  Epoch commit_epoch;
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+  for (uint32_t i = 0; i < kRecords; ++i) {
+    uint64_t data = i;
+    WRAP_ERROR_CODE(array.overwrite_record(context, i, &data));
+  }
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  WRAP_ERROR_CODE(xct_manager->wait_for_commit(commit_epoch));
+  return kRetOk;
+}
+
+/** Reads all records from the snapshot twice, so that the snapshot pages become hot. */
+ErrorStack read_snapshot_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::array::ArrayStorage array(args.engine_, kName);
+  xct::XctManager* xct_manager = args.engine_->get_xct_manager();
+  Epoch commit_epoch;
+  for (uint32_t rep = 0; rep < 2U; ++rep) {
+    WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSnapshot));
+    for (uint32_t i = 0; i < kRecords; ++i) {
+      uint64_t data = 0;
+      WRAP_ERROR_CODE(array.get_record(context, i, &data));
+      EXPECT_EQ(i, data);
+    }
+    WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  }
+  return kRetOk;
+}
+
+/** Checks the cache right after the restart, before anyone reads the storage. */
+ErrorStack verify_warm_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::array::ArrayStorage array(args.engine_, kName);
+  const CacheHashtable* hashtable
+    = context->get_engine()->get_memory_manager()->get_local_memory()->get_snapshot_cache_table();
+  CacheHashtable::Stat stat = hashtable->get_stat_single_thread();
+  EXPECT_GT(stat.normal_entries_ + stat.overflow_entries_, 0U);
+  storage::SnapshotPagePointer root
+    = array.get_control_block()->root_page_pointer_.snapshot_pointer_;
+  EXPECT_NE(0U, root);
+  EXPECT_NE(0U, hashtable->find(root, false));
+  return kRetOk;
+}
+
+ErrorStack verify_cold_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  const CacheHashtable* hashtable
+    = context->get_engine()->get_memory_manager()->get_local_memory()->get_snapshot_cache_table();
+  CacheHashtable::Stat stat = hashtable->get_stat_single_thread();
+  EXPECT_EQ(0U, stat.normal_entries_ + stat.overflow_entries_);
+  return kRetOk;
+}
+
+void test_run(bool warmup_enabled) {
+  EngineOptions options = get_tiny_options();
+  options.cache_.snapshot_cache_warmup_enabled_ = warmup_enabled;
+  options.cache_.snapshot_cache_warmup_threads_ = 2;
+  {
+    Engine engine(options);
+    engine.get_proc_manager()->pre_register("populate_task", populate_task);
+    engine.get_proc_manager()->pre_register("read_snapshot_task", read_snapshot_task);
+    COERCE_ERROR(engine.initialize());
+    {
+      UninitializeGuard guard(&engine);
+      storage::array::ArrayMetadata meta(kName, sizeof(uint64_t), kRecords);
+      storage::array::ArrayStorage out;
+      Epoch commit_epoch;
+      COERCE_ERROR(engine.get_storage_manager()->create_array(&meta, &out, &commit_epoch));
+      COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("populate_task"));
+      engine.get_snapshot_manager()->trigger_snapshot_immediate(true);
+      COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("read_snapshot_task"));
+      // the hot pages are persisted at shutdown
+      COERCE_ERROR(engine.uninitialize());
+    }
+  }
+  {
+    Engine engine(options);
+    engine.get_proc_manager()->pre_register("verify_warm_task", verify_warm_task);
+    engine.get_proc_manager()->pre_register("verify_cold_task", verify_cold_task);
+    COERCE_ERROR(engine.initialize());
+    {
+      UninitializeGuard guard(&engine);
+      const char* verify = warmup_enabled ? "verify_warm_task" : "verify_cold_task";
+      COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous(verify));
+      COERCE_ERROR(engine.uninitialize());
+    }
+  }
+  cleanup_test(options);
+}
+
+TEST(CacheWarmupTest, Warm) { test_run(true); }
+TEST(CacheWarmupTest, Disabled) { test_run(false); }
+
+}  // namespace cache
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(CacheWarmupTest, foedus.cache);
@@ -170,7 +170,11 @@ void test_evict(const uint32_t kHashTableSize, const uint32_t kCounts) {
   for (uint32_t rep = 0; rep < 3U; ++rep) {
     uint32_t evicted[kCounts];
     std::memset(evicted, 0, sizeof(evicted));
-    CacheHashtable::EvictArgs args = { kCounts / 10, 0, evicted };
+    CacheHashtable::EvictArgs args = {
+      kCounts / 10,
+      0,
+      evicted,
+      CacheOptions::kEvictionPolicyClock};
     hashtable.evict(&args);
     EXPECT_GE(args.evicted_count_, args.target_count_ * 8U / 10U);  // might be a bit smaller
     EXPECT_LE(args.evicted_count_, args.target_count_ * 12U / 10U);  // might be a bit larger
@@ -224,6 +228,94 @@ TEST(HashTableTest, EvictLittleOverflow) { test_evict(12345, 2000); }
 // these take long time if run with the same scale. so, one tenth.
 TEST(HashTableTest, EvictManyOverflow) { test_evict(1234, 500); }
 TEST(HashTableTest, EvictMostlyOverflow) { test_evict(1234, 1000); }
+
+TEST(HashTableTest, FindNoPromote) {
+  CacheHashtable hashtable(12345, 0);
+  storage::SnapshotPagePointer pointer = storage::to_snapshot_page_pointer(1, 0, 3);
+  EXPECT_EQ(kErrorCodeOk, hashtable.install(pointer, 42));
+  EXPECT_EQ(42U, hashtable.find(pointer, false));
+
+  // not promoted, so still probationary
+  ContentId evicted[1];
+  CacheHashtable::EvictArgs args = { 1, 0, evicted, CacheOptions::kEvictionPolicyScanResistant };
+  hashtable.evict(&args);
+  EXPECT_EQ(1U, args.evicted_count_);
+  EXPECT_EQ(42U, evicted[0]);
+  EXPECT_EQ(0, hashtable.find(pointer));
+
+  // promoted, so the other probationary page is evicted instead
+  storage::SnapshotPagePointer another = storage::to_snapshot_page_pointer(1, 0, 4);
+  EXPECT_EQ(kErrorCodeOk, hashtable.install(pointer, 43));
+  EXPECT_EQ(43U, hashtable.find(pointer));
+  EXPECT_EQ(kErrorCodeOk, hashtable.install(another, 44));
+  hashtable.evict(&args);
+  EXPECT_EQ(1U, args.evicted_count_);
+  EXPECT_EQ(44U, evicted[0]);
+  EXPECT_EQ(43U, hashtable.find(pointer));
+}
+
+TEST(HashTableTest, GetHotContents) {
+  CacheHashtable hashtable(12345, 0);
+  for (uint32_t i = 0; i < 100U; ++i) {
+    storage::SnapshotPagePointer pointer = storage::to_snapshot_page_pointer(1, 0, i);
+    EXPECT_EQ(kErrorCodeOk, hashtable.install(pointer, i + 42U));
+    // i-th page is accessed i % 5 times
+    for (uint32_t rep = 0; rep < i % 5U; ++rep) {
+      EXPECT_EQ(i + 42U, hashtable.find(pointer));
+    }
+  }
+
+  std::vector<ContentId> contents;
+  hashtable.get_hot_contents(CacheRefCount::kProbationCount + 1U, 1000U, &contents);
+  EXPECT_EQ(80U, contents.size());  // pages never accessed after install are excluded
+  hashtable.get_hot_contents(CacheRefCount::kProbationCount + 1U, 30U, &contents);
+  ASSERT_EQ(30U, contents.size());
+  for (ContentId content : contents) {
+    EXPECT_GE((content - 42U) % 5U, 3U) << content;  // hotter first
+  }
+}
+
+/** Installs hot pages, then repeats scans of pages accessed only once, evicting scanned ones. */
+uint32_t test_scan_evict(CacheOptions::EvictionPolicy policy) {
+  const uint32_t kHotPages = 1000;
+  const uint32_t kScanPages = 1000;
+  const uint32_t kScans = 3;
+  CacheHashtable hashtable(123456, 0);
+  for (uint32_t i = 0; i < kHotPages; ++i) {
+    storage::SnapshotPagePointer pointer = storage::to_snapshot_page_pointer(1, 0, i);
+    EXPECT_EQ(kErrorCodeOk, hashtable.install(pointer, i + 42U));
+    EXPECT_EQ(i + 42U, hashtable.find(pointer));
+  }
+
+  std::vector<ContentId> evicted(kHotPages + kScanPages);
+  for (uint32_t scan = 0; scan < kScans; ++scan) {
+    const uint32_t scan_begin = kHotPages + scan * kScanPages;
+    for (uint32_t i = scan_begin; i < scan_begin + kScanPages; ++i) {
+      storage::SnapshotPagePointer pointer = storage::to_snapshot_page_pointer(1, 0, i);
+      EXPECT_EQ(kErrorCodeOk, hashtable.install(pointer, i + 42U));
+      EXPECT_EQ(i + 42U, hashtable.find(pointer, false));
+    }
+    CacheHashtable::EvictArgs args = { kScanPages, 0, &evicted[0], policy };
+    hashtable.evict(&args);
+    EXPECT_GE(args.evicted_count_, kScanPages);
+    COERCE_ERROR(hashtable.verify_single_thread());
+  }
+
+  uint32_t surviving_hot_pages = 0;
+  for (uint32_t i = 0; i < kHotPages; ++i) {
+    storage::SnapshotPagePointer pointer = storage::to_snapshot_page_pointer(1, 0, i);
+    if (hashtable.find(pointer) == i + 42U) {
+      ++surviving_hot_pages;
+    }
+  }
+  std::cout << "policy=" << policy << ", surviving hot pages=" << surviving_hot_pages << std::endl;
+  return surviving_hot_pages;
+}
+
+TEST(HashTableTest, EvictScanClock) { test_scan_evict(CacheOptions::kEvictionPolicyClock); }
+TEST(HashTableTest, EvictScanResistant) {
+  EXPECT_EQ(1000U, test_scan_evict(CacheOptions::kEvictionPolicyScanResistant));
+}
 }  // namespace cache
 }  // namespace foedus
 
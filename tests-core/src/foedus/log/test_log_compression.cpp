@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <stdint.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "foedus/test_common.hpp"
+#include "foedus/assorted/uniform_random.hpp"
+#include "foedus/log/common_log_types.hpp"
+#include "foedus/log/log_compressor.hpp"
+
+/**
+ * @file test_log_compression.cpp
+ * Testcases for the compression of log blocks.
+ * Logger/LogMapper/LogReplayer with LogOptions::compress_logs_ are tested in
+ * test_snapshot_array.cpp and test_restart_replay.cpp.
+ */
+namespace foedus {
+namespace log {
+DEFINE_TEST_CASE_PACKAGE(LogCompressionTest, foedus.log);
+
+const uint32_t kBlockSize = CompressedBlockLogType::kMaxUncompressedLength;
+
+/** Log-like data. 48-byte entries with repetitive headers and a few random bytes. */
+void fill_log_like(uint32_t size, std::vector<char>* data) {
+  assorted::UniformRandom rnd(1234);
+  data->resize(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    if (i % 48U < 32U) {
+      (*data)[i] = static_cast<char>(i % 48U);
+    } else {
+      (*data)[i] = static_cast<char>(rnd.next_uint32());
+    }
+  }
+}
+
+void fill_random(uint32_t size, std::vector<char>* data) {
+  assorted::UniformRandom rnd(5678);
+  data->resize(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    (*data)[i] = static_cast<char>(rnd.next_uint32());
+  }
+}
+
+void test_round_trip(const std::vector<char>& original, uint32_t* compressed_size) {
+  const uint32_t size = original.size();
+  std::vector<char> compressed(size * 2U + 64U);
+  *compressed_size = compress_log_block(
+    &original[0],
+    size,
+    &compressed[0],
+    compressed.size());
+  ASSERT_GT(*compressed_size, 0U);
+
+  std::vector<char> decompressed(size + 1U);
+  EXPECT_TRUE(decompress_log_block(&compressed[0], *compressed_size, &decompressed[0], size));
+  EXPECT_EQ(0, std::memcmp(&original[0], &decompressed[0], size));
+  // a wrong original size is detected
+  EXPECT_FALSE(decompress_log_block(&compressed[0], *compressed_size, &decompressed[0], size - 8U));
+}
+
+TEST(LogCompressionTest, RoundTrip) {
+  std::vector<char> data;
+  fill_log_like(kBlockSize, &data);
+  uint32_t compressed_size;
+  test_round_trip(data, &compressed_size);
+  EXPECT_LT(compressed_size, kBlockSize / 2U);
+}
+
+TEST(LogCompressionTest, RoundTripSmall) {
+  for (uint32_t size = 8; size <= 256U; size += 8U) {
+    std::vector<char> data;
+    fill_log_like(size, &data);
+    uint32_t compressed_size;
+    test_round_trip(data, &compressed_size);
+  }
+}
+
+TEST(LogCompressionTest, Incompressible) {
+  std::vector<char> data;
+  fill_random(kBlockSize, &data);
+  uint32_t compressed_size;
+  test_round_trip(data, &compressed_size);
+  EXPECT_GE(compressed_size, kBlockSize);
+
+  // The logger gives a capacity smaller than the original, so this should just give up.
+  std::vector<char> compressed(kBlockSize);
+  EXPECT_EQ(0U, compress_log_block(&data[0], kBlockSize, &compressed[0], kBlockSize - 32U));
+}
+
+TEST(LogCompressionTest, Corrupted) {
+  std::vector<char> data;
+  fill_log_like(kBlockSize, &data);
+  std::vector<char> compressed(kBlockSize);
+  uint32_t compressed_size = compress_log_block(
+    &data[0],
+    kBlockSize,
+    &compressed[0],
+    kBlockSize);
+  ASSERT_GT(compressed_size, 0U);
+
+  // Whatever garbage is given, decompression must not go out of the buffers.
+  assorted::UniformRandom rnd(91011);
+  std::vector<char> decompressed(kBlockSize);
+  for (uint32_t i = 0; i < 1000U; ++i) {
+    std::vector<char> garbage(compressed.begin(), compressed.begin() + compressed_size);
+    garbage[rnd.uniform_within(0, compressed_size - 1U)] = static_cast<char>(rnd.next_uint32());
+    decompress_log_block(&garbage[0], compressed_size, &decompressed[0], kBlockSize);
+  }
+  EXPECT_FALSE(decompress_log_block(&compressed[0], compressed_size / 2U, &decompressed[0],
+    kBlockSize));
+}
+
+}  // namespace log
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(LogCompressionTest, foedus.log);
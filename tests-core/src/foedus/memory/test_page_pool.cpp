@@ -60,7 +60,7 @@ void verify_full_pool(PagePool* pool) {
   pool->release(chunk2.size(), &chunk2);
 }
 
-void test_construct(bool with_mprotect) {
+void test_construct(bool with_mprotect, uint16_t shards = 1) {
   const uint64_t kPoolSize = 1ULL << 21;
   AlignedMemory block_memory;
   block_memory.alloc(kPageSize, kAlignment, AlignedMemory::kNumaAllocOnnode, 0);
@@ -71,7 +71,7 @@ void test_construct(bool with_mprotect) {
   EXPECT_TRUE(pool_memory.get_block() != nullptr);
 
   PagePool pool;
-  pool.attach(block, pool_memory.get_block(), kPoolSize, true, with_mprotect);
+  pool.attach(block, pool_memory.get_block(), kPoolSize, true, with_mprotect, shards);
   COERCE_ERROR(pool.initialize());
   EXPECT_EQ(kPoolSize, pool.get_memory_size());
 
@@ -88,7 +88,7 @@ void test_construct(bool with_mprotect) {
   COERCE_ERROR(pool.uninitialize());
 }
 
-void test_grab_release(bool with_mprotect) {
+void test_grab_release(bool with_mprotect, uint16_t shards = 1) {
   // pool size less than one full PagePoolOffsetChunk (note: a few pages spent for free-pool pages)
   const uint64_t kPoolSize = kPageSize * sizeof(PagePoolOffsetChunk) / sizeof(PagePoolOffset);
   AlignedMemory block_memory;
@@ -98,7 +98,7 @@ void test_grab_release(bool with_mprotect) {
   pool_memory.alloc(kPoolSize, kAlignment, AlignedMemory::kNumaAllocOnnode, 0);
 
   PagePool pool;
-  pool.attach(block, pool_memory.get_block(), kPoolSize, true, with_mprotect);
+  pool.attach(block, pool_memory.get_block(), kPoolSize, true, with_mprotect, shards);
   COERCE_ERROR(pool.initialize());
   EXPECT_EQ(kPoolSize, pool.get_memory_size());
 
@@ -178,6 +178,9 @@ TEST(PagePoolTest, ConstructMprotect) { test_construct(true); }
 TEST(PagePoolTest, GrabRelease)         { test_grab_release(false); }
 TEST(PagePoolTest, GrabReleaseMprotect) { test_grab_release(true); }
 
+TEST(PagePoolTest, ConstructSharded)    { test_construct(false, 4); }
+TEST(PagePoolTest, GrabReleaseSharded)  { test_grab_release(false, 4); }
+
 TEST(PagePoolTest, GrabReleaseWithEpoch)          { test_grab_release_with_epoch(false); }
 TEST(PagePoolTest, GrabReleaseWithEpochMprotect)  { test_grab_release_with_epoch(true); }
 
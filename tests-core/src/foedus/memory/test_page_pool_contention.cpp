@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <stdint.h>
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "foedus/test_common.hpp"
+#include "foedus/assorted/atomic_fences.hpp"
+#include "foedus/debugging/stop_watch.hpp"
+#include "foedus/memory/aligned_memory.hpp"
+#include "foedus/memory/page_pool.hpp"
+#include "foedus/memory/page_pool_pimpl.hpp"
+#include "foedus/storage/page.hpp"
+#include "foedus/thread/rendezvous_impl.hpp"
+
+/**
+ * @file test_page_pool_contention.cpp
+ * A micro benchmark of grab()/release() on one page pool from many threads, which emulates
+ * private page pools that keep draining under split-heavy inserts.
+ * Compare the throughput printed by Unsharded and Sharded.
+ */
+namespace foedus {
+namespace memory {
+DEFINE_TEST_CASE_PACKAGE(PagePoolContentionTest, foedus.memory);
+
+const uint64_t kPageSize = sizeof(storage::Page);
+const uint64_t kPoolSize = 1ULL << 26;
+const uint32_t kThreads = 8;
+const uint32_t kIterations = 3000;
+/** Small enough to frequently come back to the pool, like NumaCoreMemory does. */
+const uint32_t kPagesPerGrab = 64;
+
+void contention_worker(PagePool* pool, thread::Rendezvous* start_rendezvous) {
+  PagePoolOffsetChunk chunk;
+  start_rendezvous->wait();
+  for (uint32_t i = 0; i < kIterations; ++i) {
+    EXPECT_EQ(kErrorCodeOk, pool->grab(kPagesPerGrab, &chunk));
+    EXPECT_EQ(kPagesPerGrab, chunk.size());
+    pool->release(chunk.size(), &chunk);
+    EXPECT_EQ(0, chunk.size());
+  }
+}
+
+void test_contention(uint16_t shards) {
+  AlignedMemory block_memory;
+  block_memory.alloc(kPageSize, kPageSize, AlignedMemory::kNumaAllocOnnode, 0);
+  PagePoolControlBlock* block = reinterpret_cast<PagePoolControlBlock*>(block_memory.get_block());
+  AlignedMemory pool_memory;
+  pool_memory.alloc(kPoolSize, kPageSize, AlignedMemory::kNumaAllocOnnode, 0);
+
+  PagePool pool;
+  pool.attach(block, pool_memory.get_block(), kPoolSize, true, false, shards);
+  COERCE_ERROR(pool.initialize());
+
+  thread::Rendezvous start_rendezvous;
+  assorted::memory_fence_release();
+  std::vector< std::thread > threads;
+  for (uint32_t i = 0; i < kThreads; ++i) {
+    threads.emplace_back(std::thread(contention_worker, &pool, &start_rendezvous));
+  }
+
+  debugging::StopWatch watch;
+  start_rendezvous.signal();
+  for (auto& t : threads) {
+    t.join();
+  }
+  watch.stop();
+
+  const uint64_t exchanges = static_cast<uint64_t>(kThreads) * kIterations * 2U;
+  std::cout << "shards=" << shards << ", threads=" << kThreads << ": " << exchanges
+    << " chunk exchanges in " << watch.elapsed_us() << "us ("
+    << (exchanges * 1000.0 / watch.elapsed_us()) << " exchanges/ms)" << std::endl;
+
+  PagePool::Stat stat = pool.get_stat();
+  EXPECT_EQ(0, stat.allocated_pages_);
+  COERCE_ERROR(pool.uninitialize());
+}
+
+TEST(PagePoolContentionTest, Unsharded)  { test_contention(1); }
+TEST(PagePoolContentionTest, Sharded)    { test_contention(kThreads); }
+
+}  // namespace memory
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(PagePoolContentionTest, foedus.memory);
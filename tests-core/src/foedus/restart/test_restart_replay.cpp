@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <gtest/gtest.h>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/epoch.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/snapshot/snapshot_manager.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/array/array_metadata.hpp"
+#include "foedus/storage/array/array_storage.hpp"
+#include "foedus/storage/hash/hash_metadata.hpp"
+#include "foedus/storage/hash/hash_storage.hpp"
+#include "foedus/storage/masstree/masstree_metadata.hpp"
+#include "foedus/storage/masstree/masstree_storage.hpp"
+#include "foedus/thread/thread.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/xct/xct_manager.hpp"
+
+/**
+ * @file test_restart_replay.cpp
+ * Testcases for RestartOptions::replay_logs_.
+ * Data operations are not snapshotted before restart, so they must be recovered by log replay.
+ */
+namespace foedus {
+namespace restart {
+DEFINE_TEST_CASE_PACKAGE(RestartReplayTest, foedus.restart);
+
+const uint32_t kRecords = 200;
+const uint64_t kOverwritten = 5;
+const uint64_t kDeleted = 7;
+const uint64_t kIncremented = 11;
+const uint64_t kIncrements = 10;
+
+ErrorStack array_write_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  Engine* engine = context->get_engine();
+  storage::array::ArrayStorage array = engine->get_storage_manager()->get_array("test");
+  xct::XctManager* xct_manager = engine->get_xct_manager();
+  Epoch commit_epoch;
+  for (uint64_t i = 0; i < kRecords; ++i) {
+    CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+    uint64_t data = i * 3;
+    CHECK_ERROR(array.overwrite_record(context, i, &data, 0, sizeof(data)));
+    CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  }
+  for (uint64_t i = 0; i < kIncrements; ++i) {
+    CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+    uint64_t value = 2;
+    CHECK_ERROR(array.increment_record<uint64_t>(context, kIncremented, &value, 8));
+    CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  }
+  CHECK_ERROR(xct_manager->wait_for_commit(commit_epoch));
+  return kRetOk;
+}
+
+ErrorStack array_verify_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  Engine* engine = context->get_engine();
+  storage::array::ArrayStorage array = engine->get_storage_manager()->get_array("test");
+  xct::XctManager* xct_manager = engine->get_xct_manager();
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  for (uint64_t i = 0; i < kRecords; ++i) {
+    uint64_t data = 0;
+    uint64_t incremented = 0;
+    CHECK_ERROR(array.get_record_primitive<uint64_t>(context, i, &data, 0));
+    CHECK_ERROR(array.get_record_primitive<uint64_t>(context, i, &incremented, 8));
+    EXPECT_EQ(i * 3, data) << i;
+    EXPECT_EQ(i == kIncremented ? kIncrements * 2U : 0U, incremented) << i;
+  }
+  Epoch commit_epoch;
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  return kRetOk;
+}
+
+template <typename STORAGE>
+ErrorStack keyed_write(thread::Thread* context, STORAGE storage) {
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  Epoch commit_epoch;
+  for (uint64_t i = 0; i < kRecords; ++i) {
+    CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+    uint64_t data = i * 3;
+    CHECK_ERROR(storage.insert_record(context, &i, sizeof(i), &data, sizeof(data)));
+    CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  }
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  uint64_t key = kOverwritten;
+  uint64_t data = 777;
+  CHECK_ERROR(storage.overwrite_record(context, &key, sizeof(key), &data, 0, sizeof(data)));
+  key = kDeleted;
+  CHECK_ERROR(storage.delete_record(context, &key, sizeof(key)));
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  CHECK_ERROR(xct_manager->wait_for_commit(commit_epoch));
+  return kRetOk;
+}
+
+template <typename STORAGE>
+ErrorStack keyed_verify(thread::Thread* context, STORAGE storage, bool check_deleted) {
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  for (uint64_t i = 0; i < kRecords; ++i) {
+    uint64_t data = 0;
+    uint16_t capacity = sizeof(data);
+    ErrorCode ret = storage.get_record(context, &i, sizeof(i), &data, &capacity, true);
+    if (i == kDeleted) {
+      if (check_deleted) {
+        EXPECT_EQ(kErrorCodeStrKeyNotFound, ret);
+      }
+    } else {
+      EXPECT_EQ(kErrorCodeOk, ret) << i;
+      EXPECT_EQ(i == kOverwritten ? 777U : i * 3, data) << i;
+    }
+  }
+  Epoch commit_epoch;
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  return kRetOk;
+}
+
+ErrorStack masstree_write_task(const proc::ProcArguments& args) {
+  return keyed_write(args.context_, args.engine_->get_storage_manager()->get_masstree("test"));
+}
+ErrorStack masstree_verify_task(const proc::ProcArguments& args) {
+  storage::StorageManager* stm = args.engine_->get_storage_manager();
+  return keyed_verify(args.context_, stm->get_masstree("test"), true);
+}
+ErrorStack hash_write_task(const proc::ProcArguments& args) {
+  return keyed_write(args.context_, args.engine_->get_storage_manager()->get_hash("test"));
+}
+ErrorStack hash_verify_task(const proc::ProcArguments& args) {
+  // HashStorage::get_record() so far doesn't check the deleted flag. Skip the deleted key.
+  storage::StorageManager* stm = args.engine_->get_storage_manager();
+  return keyed_verify(args.context_, stm->get_hash("test"), false);
+}
+
+void register_procs(Engine* engine) {
+  proc::ProcManager* procm = engine->get_proc_manager();
+  procm->pre_register(proc::ProcAndName("array_write_task", array_write_task));
+  procm->pre_register(proc::ProcAndName("array_verify_task", array_verify_task));
+  procm->pre_register(proc::ProcAndName("masstree_write_task", masstree_write_task));
+  procm->pre_register(proc::ProcAndName("masstree_verify_task", masstree_verify_task));
+  procm->pre_register(proc::ProcAndName("hash_write_task", hash_write_task));
+  procm->pre_register(proc::ProcAndName("hash_verify_task", hash_verify_task));
+}
+
+void test_replay(
+  storage::Metadata* meta,
+  const char* write_task,
+  const char* verify_task,
+  bool compress_logs = false,
+  uint16_t writers_per_logger = 0) {
+  EngineOptions options = get_tiny_options();
+  options.restart_.replay_logs_ = true;
+  options.log_.compress_logs_ = compress_logs;
+  options.log_.writers_per_logger_ = writers_per_logger;
+  {
+    Engine engine(options);
+    register_procs(&engine);
+    COERCE_ERROR(engine.initialize());
+    {
+      UninitializeGuard guard(&engine);
+      Epoch commit_epoch;
+      COERCE_ERROR(engine.get_storage_manager()->create_storage(meta, &commit_epoch));
+      COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous(write_task));
+      COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous(verify_task));
+      COERCE_ERROR(engine.uninitialize());
+    }
+  }
+
+  // Restart twice. Replay must not write the logs again, so the second one sees the same logs.
+  for (int i = 0; i < 2; ++i) {
+    Engine engine(options);
+    register_procs(&engine);
+    COERCE_ERROR(engine.initialize());
+    {
+      UninitializeGuard guard(&engine);
+      EXPECT_FALSE(engine.get_snapshot_manager()->get_snapshot_epoch().is_valid());
+      COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous(verify_task));
+      COERCE_ERROR(engine.uninitialize());
+    }
+  }
+  cleanup_test(options);
+}
+
+TEST(RestartReplayTest, Array) {
+  storage::array::ArrayMetadata meta("test", 16, kRecords);
+  test_replay(&meta, "array_write_task", "array_verify_task");
+}
+TEST(RestartReplayTest, Masstree) {
+  storage::masstree::MasstreeMetadata meta("test");
+  test_replay(&meta, "masstree_write_task", "masstree_verify_task");
+}
+TEST(RestartReplayTest, Hash) {
+  storage::hash::HashMetadata meta("test", 8);
+  test_replay(&meta, "hash_write_task", "hash_verify_task");
+}
+TEST(RestartReplayTest, MasstreeCompressed) {
+  storage::masstree::MasstreeMetadata meta("test");
+  test_replay(&meta, "masstree_write_task", "masstree_verify_task", true);
+}
+TEST(RestartReplayTest, HashCompressed) {
+  storage::hash::HashMetadata meta("test", 8);
+  test_replay(&meta, "hash_write_task", "hash_verify_task", true);
+}
+TEST(RestartReplayTest, MasstreeWriters) {
+  storage::masstree::MasstreeMetadata meta("test");
+  test_replay(&meta, "masstree_write_task", "masstree_verify_task", false, 2);
+}
+
+}  // namespace restart
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(RestartReplayTest, foedus.restart);
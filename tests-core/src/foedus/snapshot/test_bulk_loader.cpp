@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/assorted/endianness.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/snapshot/snapshot_manager.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/hash/hash_bulk_loader.hpp"
+#include "foedus/storage/hash/hash_metadata.hpp"
+#include "foedus/storage/hash/hash_storage.hpp"
+#include "foedus/storage/masstree/masstree_bulk_loader.hpp"
+#include "foedus/storage/masstree/masstree_metadata.hpp"
+#include "foedus/storage/masstree/masstree_storage.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/xct/xct_manager.hpp"
+
+/**
+ * @file test_bulk_loader.cpp
+ * Bulk-loads masstree/hash storages and reads them back, also after restart.
+ */
+namespace foedus {
+namespace snapshot {
+DEFINE_TEST_CASE_PACKAGE(BulkLoaderTest, foedus.snapshot);
+const uint32_t kRecords = 1024;
+const storage::StorageName kName("test");
+
+/** Same as test_snapshot_masstree.cpp. Next layers for the same first slice. */
+std::string make_varlen_key(uint64_t rec) {
+  char buffer[8];
+  assorted::write_bigendian<uint64_t>(static_cast<uint64_t>(rec % 17U), buffer);
+  return std::string(buffer, sizeof(buffer)) + std::to_string(rec);
+}
+
+ErrorStack verify_masstree_normalized_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::masstree::MasstreeStorage masstree(args.engine_, kName);
+  ASSERT_ND(masstree.exists());
+  xct::XctManager* xct_manager = args.engine_->get_xct_manager();
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+  for (uint64_t rec = 0; rec < kRecords; ++rec) {
+    storage::masstree::KeySlice slice = storage::masstree::normalize_primitive<uint64_t>(rec);
+    uint64_t data;
+    uint16_t capacity = sizeof(data);
+    ErrorCode ret = masstree.get_record_normalized(context, slice, &data, &capacity, true);
+    EXPECT_EQ(kErrorCodeOk, ret) << rec;
+    EXPECT_EQ(rec, data) << rec;
+    EXPECT_EQ(sizeof(data), capacity) << rec;
+  }
+  Epoch commit_epoch;
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  return kRetOk;
+}
+
+ErrorStack verify_masstree_varlen_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::masstree::MasstreeStorage masstree(args.engine_, kName);
+  ASSERT_ND(masstree.exists());
+  xct::XctManager* xct_manager = args.engine_->get_xct_manager();
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+  for (uint64_t rec = 0; rec < kRecords; ++rec) {
+    std::string key = make_varlen_key(rec);
+    uint64_t data;
+    uint16_t capacity = sizeof(data);
+    ErrorCode ret = masstree.get_record(context, key.data(), key.size(), &data, &capacity, true);
+    EXPECT_EQ(kErrorCodeOk, ret) << rec;
+    EXPECT_EQ(rec, data) << rec;
+    EXPECT_EQ(sizeof(data), capacity) << rec;
+  }
+  Epoch commit_epoch;
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  return kRetOk;
+}
+
+ErrorStack verify_hash_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::hash::HashStorage hash(args.engine_, kName);
+  ASSERT_ND(hash.exists());
+  xct::XctManager* xct_manager = args.engine_->get_xct_manager();
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+  for (uint64_t rec = 0; rec < kRecords; ++rec) {
+    uint64_t data;
+    uint16_t capacity = sizeof(data);
+    ErrorCode ret = hash.get_record<uint64_t>(context, rec, &data, &capacity, true);
+    EXPECT_EQ(kErrorCodeOk, ret) << rec;
+    EXPECT_EQ(rec, data) << rec;
+    EXPECT_EQ(sizeof(data), capacity) << rec;
+  }
+  Epoch commit_epoch;
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  return kRetOk;
+}
+
+ErrorStack insert_masstree_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::masstree::MasstreeStorage masstree(args.engine_, kName);
+  xct::XctManager* xct_manager = args.engine_->get_xct_manager();
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+  uint64_t rec = 1;
+  WRAP_ERROR_CODE(masstree.insert_record_normalized(context, rec, &rec, sizeof(rec)));
+  Epoch commit_epoch;
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  WRAP_ERROR_CODE(xct_manager->wait_for_commit(commit_epoch));
+  return kRetOk;
+}
+
+ErrorStack load_masstree_normalized(Engine* engine) {
+  storage::masstree::MasstreeStorage masstree(engine, kName);
+  storage::masstree::MasstreeBulkLoader loader(engine, masstree.get_id());
+  CHECK_ERROR(loader.open());
+  for (uint64_t rec = 0; rec < kRecords; ++rec) {
+    storage::masstree::KeySlice slice = storage::masstree::normalize_primitive<uint64_t>(rec);
+    WRAP_ERROR_CODE(loader.append_normalized(slice, &rec, sizeof(rec)));
+  }
+  EXPECT_EQ(kRecords, loader.get_record_count());
+  CHECK_ERROR(loader.commit());
+  EXPECT_FALSE(loader.is_opened());
+  return kRetOk;
+}
+
+ErrorStack load_masstree_varlen(Engine* engine) {
+  std::vector< std::pair<std::string, uint64_t> > records;
+  for (uint64_t rec = 0; rec < kRecords; ++rec) {
+    records.emplace_back(make_varlen_key(rec), rec);
+  }
+  std::sort(records.begin(), records.end());
+
+  storage::masstree::MasstreeStorage masstree(engine, kName);
+  storage::masstree::MasstreeBulkLoader loader(engine, masstree.get_id());
+  CHECK_ERROR(loader.open());
+  for (const auto& record : records) {
+    WRAP_ERROR_CODE(loader.append(
+      record.first.data(),
+      record.first.size(),
+      &record.second,
+      sizeof(record.second)));
+  }
+  CHECK_ERROR(loader.commit());
+  return kRetOk;
+}
+
+ErrorStack load_hash(Engine* engine) {
+  storage::hash::HashStorage hash(engine, kName);
+  storage::hash::HashBulkLoader loader(engine, hash.get_id());
+  std::vector< std::pair<storage::hash::HashBin, uint64_t> > records;
+  for (uint64_t rec = 0; rec < kRecords; ++rec) {
+    records.emplace_back(loader.get_bin(&rec, sizeof(rec)), rec);
+  }
+  std::sort(records.begin(), records.end());
+
+  CHECK_ERROR(loader.open());
+  for (const auto& record : records) {
+    WRAP_ERROR_CODE(loader.append(
+      &record.second,
+      sizeof(record.second),
+      &record.second,
+      sizeof(record.second)));
+  }
+  CHECK_ERROR(loader.commit());
+  return kRetOk;
+}
+
+enum StorageType {
+  kMasstreeNormalized,
+  kMasstreeVarlen,
+  kHash1Lv,
+  kHash2Lv,
+};
+
+void test_run(StorageType type) {
+  EngineOptions options = get_tiny_options();
+  proc::ProcName verify_name;
+  if (type == kMasstreeNormalized) {
+    verify_name = "verify_masstree_normalized_task";
+  } else if (type == kMasstreeVarlen) {
+    verify_name = "verify_masstree_varlen_task";
+  } else {
+    verify_name = "verify_hash_task";
+  }
+
+  {
+    Engine engine(options);
+    engine.get_proc_manager()->pre_register(
+      "verify_masstree_normalized_task",
+      verify_masstree_normalized_task);
+    engine.get_proc_manager()->pre_register(
+      "verify_masstree_varlen_task",
+      verify_masstree_varlen_task);
+    engine.get_proc_manager()->pre_register("verify_hash_task", verify_hash_task);
+    COERCE_ERROR(engine.initialize());
+    {
+      UninitializeGuard guard(&engine);
+      Epoch commit_epoch;
+      if (type == kMasstreeNormalized || type == kMasstreeVarlen) {
+        storage::masstree::MasstreeStorage out;
+        storage::masstree::MasstreeMetadata meta(kName);
+        COERCE_ERROR(engine.get_storage_manager()->create_masstree(&meta, &out, &commit_epoch));
+        if (type == kMasstreeNormalized) {
+          COERCE_ERROR(load_masstree_normalized(&engine));
+        } else {
+          COERCE_ERROR(load_masstree_varlen(&engine));
+        }
+      } else {
+        storage::hash::HashStorage out;
+        storage::hash::HashMetadata meta(kName, type == kHash1Lv ? 7 : 12);
+        COERCE_ERROR(engine.get_storage_manager()->create_hash(&meta, &out, &commit_epoch));
+        COERCE_ERROR(load_hash(&engine));
+      }
+      COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous(verify_name));
+      COERCE_ERROR(engine.uninitialize());
+    }
+  }
+  {
+    Engine engine(options);
+    engine.get_proc_manager()->pre_register(
+      "verify_masstree_normalized_task",
+      verify_masstree_normalized_task);
+    engine.get_proc_manager()->pre_register(
+      "verify_masstree_varlen_task",
+      verify_masstree_varlen_task);
+    engine.get_proc_manager()->pre_register("verify_hash_task", verify_hash_task);
+    COERCE_ERROR(engine.initialize());
+    {
+      UninitializeGuard guard(&engine);
+      COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous(verify_name));
+      COERCE_ERROR(engine.uninitialize());
+    }
+  }
+  cleanup_test(options);
+}
+
+TEST(BulkLoaderTest, MasstreeNormalized) { test_run(kMasstreeNormalized); }
+TEST(BulkLoaderTest, MasstreeVarlen) { test_run(kMasstreeVarlen); }
+TEST(BulkLoaderTest, Hash1Lv) { test_run(kHash1Lv); }
+TEST(BulkLoaderTest, Hash2Lv) { test_run(kHash2Lv); }
+
+TEST(BulkLoaderTest, TwoLoaders) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register(
+    "verify_masstree_normalized_task",
+    verify_masstree_normalized_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    Epoch commit_epoch;
+    storage::masstree::MasstreeStorage first;
+    storage::masstree::MasstreeMetadata first_meta(kName);
+    COERCE_ERROR(engine.get_storage_manager()->create_masstree(
+      &first_meta,
+      &first,
+      &commit_epoch));
+    storage::masstree::MasstreeStorage second;
+    storage::masstree::MasstreeMetadata second_meta("test2");
+    COERCE_ERROR(engine.get_storage_manager()->create_masstree(
+      &second_meta,
+      &second,
+      &commit_epoch));
+
+    // This thread holds both loaders. commit(true) on the first would never return.
+    storage::masstree::MasstreeBulkLoader second_loader(&engine, second.get_id());
+    storage::masstree::MasstreeBulkLoader first_loader(&engine, first.get_id());
+    COERCE_ERROR(second_loader.open());
+    COERCE_ERROR(first_loader.open());
+    for (uint64_t rec = 0; rec < kRecords; ++rec) {
+      storage::masstree::KeySlice slice = storage::masstree::normalize_primitive<uint64_t>(rec);
+      EXPECT_EQ(kErrorCodeOk, second_loader.append_normalized(slice, &rec, sizeof(rec)));
+      EXPECT_EQ(kErrorCodeOk, first_loader.append_normalized(slice, &rec, sizeof(rec)));
+    }
+    COERCE_ERROR(second_loader.commit(false));
+    EXPECT_FALSE(second_loader.is_opened());
+    COERCE_ERROR(first_loader.commit());
+    EXPECT_FALSE(first_loader.is_opened());
+
+    EXPECT_NE(0, second.get_metadata()->root_snapshot_page_id_);
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous(
+      "verify_masstree_normalized_task"));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+TEST(BulkLoaderTest, Errors) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("insert_masstree_task", insert_masstree_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    storage::masstree::MasstreeStorage out;
+    Epoch commit_epoch;
+    storage::masstree::MasstreeMetadata meta(kName);
+    COERCE_ERROR(engine.get_storage_manager()->create_masstree(&meta, &out, &commit_epoch));
+
+    {
+      storage::masstree::MasstreeBulkLoader loader(&engine, out.get_id());
+      COERCE_ERROR(loader.open());
+      uint64_t rec = 2;
+      EXPECT_EQ(kErrorCodeOk, loader.append_normalized(rec, &rec, sizeof(rec)));
+      rec = 1;
+      ErrorCode ret = loader.append_normalized(rec, &rec, sizeof(rec));
+      EXPECT_EQ(kErrorCodeSnapshotBulkLoadUnsorted, ret);
+      rec = 2;
+      ret = loader.append_normalized(rec, &rec, sizeof(rec));
+      EXPECT_EQ(kErrorCodeSnapshotBulkLoadUnsorted, ret);
+      COERCE_ERROR(loader.abort());
+    }
+
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("insert_masstree_task"));
+    {
+      storage::masstree::MasstreeBulkLoader loader(&engine, out.get_id());
+      ErrorStack ret = loader.open();
+      EXPECT_TRUE(ret.is_error());
+      EXPECT_EQ(kErrorCodeSnapshotBulkLoadNotEmpty, ret.get_error_code());
+      EXPECT_FALSE(loader.is_opened());
+    }
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+}  // namespace snapshot
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(BulkLoaderTest, foedus.snapshot);
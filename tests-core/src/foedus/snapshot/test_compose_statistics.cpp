@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <gtest/gtest.h>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/snapshot/log_reducer_ref.hpp"
+#include "foedus/snapshot/snapshot_manager.hpp"
+#include "foedus/storage/composer.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/masstree/masstree_metadata.hpp"
+#include "foedus/storage/masstree/masstree_storage.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/xct/xct_manager.hpp"
+
+/**
+ * @file test_compose_statistics.cpp
+ * Checks that a snapshot after a few modifications rewrites only the pages on their paths
+ * and reuses the other pages of the previous snapshot.
+ */
+namespace foedus {
+namespace snapshot {
+DEFINE_TEST_CASE_PACKAGE(ComposeStatisticsTest, foedus.snapshot);
+const uint32_t kRecords = 1 << 13;
+const uint32_t kRecordsPerXct = 1024;
+const uint32_t kModifiedRecords = 4;
+const storage::StorageName kName("test");
+
+ErrorStack insert_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::masstree::MasstreeStorage masstree(args.engine_, kName);
+  ASSERT_ND(masstree.exists());
+  xct::XctManager* xct_manager = args.engine_->get_xct_manager();
+  Epoch commit_epoch;
+  for (uint32_t i = 0; i < kRecords / kRecordsPerXct; ++i) {
+    WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+    for (uint32_t j = 0; j < kRecordsPerXct; ++j) {
+      uint64_t rec = i * kRecordsPerXct + j;
+      storage::masstree::KeySlice slice = storage::masstree::normalize_primitive<uint64_t>(rec);
+      WRAP_ERROR_CODE(masstree.insert_record_normalized(context, slice, &rec, sizeof(rec)));
+    }
+    WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  }
+  WRAP_ERROR_CODE(xct_manager->wait_for_commit(commit_epoch));
+  return kRetOk;
+}
+
+ErrorStack modify_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::masstree::MasstreeStorage masstree(args.engine_, kName);
+  ASSERT_ND(masstree.exists());
+  xct::XctManager* xct_manager = args.engine_->get_xct_manager();
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+  // a few keys spread over the key range
+  for (uint32_t i = 0; i < kModifiedRecords; ++i) {
+    uint64_t rec = i * (kRecords / kModifiedRecords);
+    storage::masstree::KeySlice slice = storage::masstree::normalize_primitive<uint64_t>(rec);
+    uint64_t data = rec + 1U;
+    WRAP_ERROR_CODE(masstree.overwrite_record_primitive_normalized<uint64_t>(
+      context,
+      slice,
+      data,
+      0));
+  }
+  Epoch commit_epoch;
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  WRAP_ERROR_CODE(xct_manager->wait_for_commit(commit_epoch));
+  return kRetOk;
+}
+
+/** Sum of the statistics of all reducers in the last snapshot. */
+storage::ComposeStatistics get_reducers_statistics(Engine* engine) {
+  storage::ComposeStatistics statistics;
+  statistics.clear();
+  for (uint16_t node = 0; node < engine->get_options().thread_.group_count_; ++node) {
+    statistics.add(LogReducerRef(engine, node).get_compose_statistics());
+  }
+  return statistics;
+}
+
+TEST(ComposeStatisticsTest, MasstreeReuse) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("insert_task", insert_task);
+  engine.get_proc_manager()->pre_register("modify_task", modify_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    storage::masstree::MasstreeStorage out;
+    Epoch commit_epoch;
+    storage::masstree::MasstreeMetadata meta(kName);
+    COERCE_ERROR(engine.get_storage_manager()->create_masstree(&meta, &out, &commit_epoch));
+
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("insert_task"));
+    engine.get_snapshot_manager()->trigger_snapshot_immediate(true);
+    storage::ComposeStatistics first = get_reducers_statistics(&engine);
+    EXPECT_GT(first.pages_written_, 0U);
+
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("modify_task"));
+    engine.get_snapshot_manager()->trigger_snapshot_immediate(true);
+    storage::ComposeStatistics second = get_reducers_statistics(&engine);
+    EXPECT_GT(second.pages_written_, 0U);
+    EXPECT_GT(second.pages_reused_, 0U);
+    // Only the pages on the paths to the modified records are written again.
+    EXPECT_LT(second.pages_written_ * 10U, first.pages_written_) << second;
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+}  // namespace snapshot
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(ComposeStatisticsTest, foedus.snapshot);
@@ -227,9 +227,15 @@ void test_run(
   const proc::ProcName& proc_name,
   bool multiple_loggers,
   bool multiple_partitions,
-  bool three_levels = false) {
+  bool three_levels = false,
+  bool compress_logs = false,
+  uint16_t writers_per_logger = 0,
+  bool pipeline_root_construction = true) {
   uint16_t payload = three_levels ? kThreeLevelPayload : kTwoLevelPayload;
   EngineOptions options = get_tiny_options();
+  options.log_.compress_logs_ = compress_logs;
+  options.log_.writers_per_logger_ = writers_per_logger;
+  options.snapshot_.pipeline_root_construction_ = pipeline_root_construction;
   if (multiple_partitions) {
     options.thread_.thread_count_per_group_ = 1;
     options.thread_.group_count_ = 2;
@@ -336,6 +342,33 @@ TEST(SnapshotArrayTest, HolesOneLogger3Lv) { test_run(kHoles, false, false, true
 TEST(SnapshotArrayTest, HolesTwoLoggers3Lv) { test_run(kHoles, true, false, true); }
 TEST(SnapshotArrayTest, HolesTwoPartitions3Lv) { test_run(kHoles, true, true, true); }
 
+TEST(SnapshotArrayTest, OverwritesOneLoggerCompressed) {
+  test_run(kOv, false, false, false, true);
+}
+TEST(SnapshotArrayTest, IncrementsTwoLoggersCompressed) {
+  test_run(kInc, true, false, false, true);
+}
+TEST(SnapshotArrayTest, OverwritesTwoPartitions3LvCompressed) {
+  test_run(kOv, true, true, true, true);
+}
+
+TEST(SnapshotArrayTest, OverwritesOneLoggerWriters) {
+  test_run(kOv, false, false, false, false, 2);
+}
+TEST(SnapshotArrayTest, IncrementsTwoLoggersWriters) {
+  test_run(kInc, true, false, false, false, 3);
+}
+TEST(SnapshotArrayTest, HolesTwoPartitionsCompressedWriters) {
+  test_run(kHoles, true, true, false, true, 2);
+}
+
+TEST(SnapshotArrayTest, TwoArraysTwoPartitionsNotPipelined) {
+  test_run(kTwo, true, true, false, false, 0, false);
+}
+TEST(SnapshotArrayTest, TwoArraysTwoPartitions3LvNotPipelined) {
+  test_run(kTwo, true, true, true, false, 0, false);
+}
+
 }  // namespace snapshot
 }  // namespace foedus
 
@@ -31,8 +31,10 @@
 #include "foedus/storage/array/array_route.hpp"
 #include "foedus/storage/array/array_storage.hpp"
 #include "foedus/storage/array/array_storage_pimpl.hpp"
+#include "foedus/thread/impersonate_session.hpp"
 #include "foedus/thread/thread.hpp"
 #include "foedus/thread/thread_pool.hpp"
+#include "foedus/xct/xct.hpp"
 #include "foedus/xct/xct_manager.hpp"
 
 namespace foedus {
@@ -243,6 +245,153 @@ TEST(ArrayBasicTest, CreateAndReadWrite) {
   cleanup_test(options);
 }
 
+ErrorStack read_own_writes_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  ArrayStorage array = context->get_engine()->get_storage_manager()->get_array("test5");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  Epoch commit_epoch;
+
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  uint64_t buf[2];
+  buf[0] = 123;
+  buf[1] = 456;
+  CHECK_ERROR(array.overwrite_record(context, 3, buf));
+  // repeated overwrites within the first one are coalesced into its log
+  CHECK_ERROR(array.overwrite_record_primitive<uint64_t>(context, 3, 789, 8));
+  CHECK_ERROR(array.overwrite_record_primitive<uint64_t>(context, 3, 790, 8));
+  EXPECT_EQ(1U, context->get_current_xct().get_write_set_size());
+  buf[0] = 0;
+  buf[1] = 0;
+  CHECK_ERROR(array.get_record(context, 3, buf));
+  EXPECT_EQ(123U, buf[0]);
+  EXPECT_EQ(790U, buf[1]);
+  uint64_t value = 0;
+  CHECK_ERROR(array.get_record_primitive<uint64_t>(context, 3, &value, 8));
+  EXPECT_EQ(790U, value);
+
+  // increments are applied on top of the pending writes
+  CHECK_ERROR(array.increment_record_oneshot<uint64_t>(context, 3, 10, 0));
+  value = 5;
+  CHECK_ERROR(array.increment_record<uint64_t>(context, 3, &value, 8));
+  EXPECT_EQ(795U, value);
+  const void* payload = nullptr;
+  CHECK_ERROR(array.get_record_payload(context, 3, &payload));
+  EXPECT_EQ(133U, reinterpret_cast<const uint64_t*>(payload)[0]);
+  EXPECT_EQ(795U, reinterpret_cast<const uint64_t*>(payload)[1]);
+
+  // other records are not affected
+  CHECK_ERROR(array.get_record(context, 4, buf));
+  EXPECT_EQ(0U, buf[0]);
+  EXPECT_EQ(0U, buf[1]);
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  CHECK_ERROR(array.get_record(context, 3, buf));
+  EXPECT_EQ(133U, buf[0]);
+  EXPECT_EQ(795U, buf[1]);
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  CHECK_ERROR(xct_manager->wait_for_commit(commit_epoch));
+  return foedus::kRetOk;
+}
+
+TEST(ArrayBasicTest, ReadOwnWrites) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("read_own_writes_task", read_own_writes_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    ArrayMetadata meta("test5", 16, 100);
+    ArrayStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_array(&meta, &storage, &epoch));
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("read_own_writes_task"));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+const uint16_t kStripes = 4;
+const uint32_t kStripedThreads = 4;
+const uint32_t kStripedXcts = 100;
+
+ErrorStack striped_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  ArrayStorage array = context->get_engine()->get_storage_manager()->get_array("test6");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  Epoch commit_epoch;
+  for (uint32_t i = 0; i < kStripedXcts; ++i) {
+    while (true) {
+      CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+      // one striped counter spread over [10, 14), and one hot counter with just one stripe
+      CHECK_ERROR(array.increment_record_striped<uint64_t>(context, 10, 1, 0, kStripes));
+      CHECK_ERROR(array.increment_record_striped<uint64_t>(context, 20, 2, 8, 1));
+      ErrorCode ret = xct_manager->precommit_xct(context, &commit_epoch);
+      if (ret == kErrorCodeOk) {
+        break;
+      }
+      EXPECT_EQ(kErrorCodeXctRaceAbort, ret);
+    }
+  }
+  CHECK_ERROR(xct_manager->wait_for_commit(commit_epoch));
+  return foedus::kRetOk;
+}
+
+ErrorStack striped_verify_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  ArrayStorage array = context->get_engine()->get_storage_manager()->get_array("test6");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  Epoch commit_epoch;
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  uint64_t value = 0;
+  CHECK_ERROR(array.get_record_primitive_striped<uint64_t>(context, 10, &value, 0, kStripes));
+  EXPECT_EQ(kStripedThreads * kStripedXcts, value);
+  CHECK_ERROR(array.get_record_primitive_striped<uint64_t>(context, 20, &value, 8, 1));
+  EXPECT_EQ(kStripedThreads * kStripedXcts * 2U, value);
+  // each thread had its own stripe
+  for (uint16_t i = 0; i < kStripes; ++i) {
+    CHECK_ERROR(array.get_record_primitive<uint64_t>(context, 10 + i, &value, 0));
+    EXPECT_EQ(kStripedXcts, value) << i;
+  }
+  EXPECT_EQ(
+    kErrorCodeInvalidParameter,
+    array.get_record_primitive_striped<uint64_t>(context, 98, &value, 0, kStripes));
+  EXPECT_EQ(
+    kErrorCodeInvalidParameter,
+    array.increment_record_striped<uint64_t>(context, 10, 1, 0, 0));
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  return foedus::kRetOk;
+}
+
+TEST(ArrayBasicTest, StripedCounter) {
+  EngineOptions options = get_tiny_options();
+  options.thread_.thread_count_per_group_ = kStripedThreads;
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("striped_task", striped_task);
+  engine.get_proc_manager()->pre_register("striped_verify_task", striped_verify_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    ArrayMetadata meta("test6", 16, 100);
+    ArrayStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_array(&meta, &storage, &epoch));
+    std::vector<thread::ImpersonateSession> sessions;
+    for (uint32_t i = 0; i < kStripedThreads; ++i) {
+      thread::ImpersonateSession session;
+      EXPECT_TRUE(engine.get_thread_pool()->impersonate("striped_task", nullptr, 0, &session));
+      sessions.emplace_back(std::move(session));
+    }
+    for (uint32_t i = 0; i < kStripedThreads; ++i) {
+      COERCE_ERROR(sessions[i].get_result());
+      sessions[i].release();
+    }
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("striped_verify_task"));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
 }  // namespace array
 }  // namespace storage
 }  // namespace foedus
@@ -328,6 +328,103 @@ void test_expand(bool update_case) {
   cleanup_test(options);
 }
 
+ErrorStack batch_read_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  HashStorage hash = context->get_engine()->get_storage_manager()->get_hash("ggg");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  Epoch commit_epoch;
+
+  // insert only even keys so that the batch below contains both hits and misses.
+  // more than kBatchMax keys to also test chunking.
+  const uint16_t kKeys = 50;
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  for (uint64_t k = 0; k < kKeys; k += 2) {
+    uint64_t data = k * 1000ULL;
+    CHECK_ERROR(hash.insert_record(context, &k, sizeof(k), &data, sizeof(data)));
+  }
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+
+  uint64_t keys[kKeys];
+  const void* key_batch[kKeys];
+  uint16_t key_length_batch[kKeys];
+  uint64_t payloads[kKeys];
+  void* payload_batch[kKeys];
+  uint16_t capacity_batch[kKeys];
+  ErrorCode result_batch[kKeys];
+  for (uint16_t i = 0; i < kKeys; ++i) {
+    keys[i] = i;
+    key_batch[i] = keys + i;
+    key_length_batch[i] = sizeof(uint64_t);
+    payloads[i] = 0;
+    payload_batch[i] = payloads + i;
+    capacity_batch[i] = sizeof(uint64_t);
+  }
+
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  CHECK_ERROR(hash.get_record_batch(
+    context,
+    kKeys,
+    key_batch,
+    key_length_batch,
+    payload_batch,
+    capacity_batch,
+    true,
+    result_batch));
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  for (uint16_t i = 0; i < kKeys; ++i) {
+    if (i % 2 == 0) {
+      EXPECT_EQ(kErrorCodeOk, result_batch[i]) << i;
+      EXPECT_EQ(sizeof(uint64_t), capacity_batch[i]) << i;
+      EXPECT_EQ(i * 1000ULL, payloads[i]) << i;
+    } else {
+      EXPECT_EQ(kErrorCodeStrKeyNotFound, result_batch[i]) << i;
+    }
+  }
+
+  uint32_t primitives[kKeys];
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  CHECK_ERROR(hash.get_record_primitive_batch<uint32_t>(
+    context,
+    0,
+    kKeys,
+    key_batch,
+    key_length_batch,
+    primitives,
+    true,
+    result_batch));
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  for (uint16_t i = 0; i < kKeys; ++i) {
+    if (i % 2 == 0) {
+      EXPECT_EQ(kErrorCodeOk, result_batch[i]) << i;
+      EXPECT_EQ(static_cast<uint32_t>(i * 1000U), primitives[i]) << i;
+    } else {
+      EXPECT_EQ(kErrorCodeStrKeyNotFound, result_batch[i]) << i;
+    }
+  }
+
+  CHECK_ERROR(xct_manager->wait_for_commit(commit_epoch));
+  return foedus::kRetOk;
+}
+
+TEST(HashBasicTest, GetRecordBatch) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("batch_read_task", batch_read_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    HashMetadata meta("ggg", 8);
+    HashStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_hash(&meta, &storage, &epoch));
+    EXPECT_TRUE(storage.exists());
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("batch_read_task"));
+    COERCE_ERROR(storage.verify_single_thread(&engine));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
 TEST(HashBasicTest, ExpandInsert) { test_expand(false); }
 TEST(HashBasicTest, ExpandUpdate) { test_expand(true); }
 // TASK(Hideaki): we don't have multi-thread cases here. it's not a "basic" test.
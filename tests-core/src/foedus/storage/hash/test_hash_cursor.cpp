@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/epoch.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/hash/hash_cursor.hpp"
+#include "foedus/storage/hash/hash_metadata.hpp"
+#include "foedus/storage/hash/hash_storage.hpp"
+#include "foedus/thread/thread.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/xct/xct_manager.hpp"
+
+namespace foedus {
+namespace storage {
+namespace hash {
+DEFINE_TEST_CASE_PACKAGE(HashCursorTest, foedus.storage.hash);
+
+const uint64_t kRecords = 300;
+const uint64_t kInsertsPerXct = 50;
+
+/** Input of scan_task */
+struct ScanInput {
+  /** Scan the storage in this many partitions, each in its own transaction */
+  uint16_t  partitions_;
+  /** Whether we deleted keys that are multiples of 3 */
+  bool      deleted_;
+};
+
+ErrorStack insert_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  HashStorage hash = context->get_engine()->get_storage_manager()->get_hash("ggg");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  Epoch commit_epoch;
+  for (uint64_t from = 0; from < kRecords; from += kInsertsPerXct) {
+    CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+    for (uint64_t key = from; key < from + kInsertsPerXct; ++key) {
+      uint64_t data = key * 3ULL;
+      CHECK_ERROR(hash.insert_record(context, &key, sizeof(key), &data, sizeof(data)));
+    }
+    CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  }
+  CHECK_ERROR(xct_manager->wait_for_commit(commit_epoch));
+  return kRetOk;
+}
+
+ErrorStack delete_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  HashStorage hash = context->get_engine()->get_storage_manager()->get_hash("ggg");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  Epoch commit_epoch;
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  for (uint64_t key = 0; key < kRecords; key += 3U) {
+    CHECK_ERROR(hash.delete_record(context, &key, sizeof(key)));
+  }
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  CHECK_ERROR(xct_manager->wait_for_commit(commit_epoch));
+  return kRetOk;
+}
+
+ErrorStack scan_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  HashStorage hash = context->get_engine()->get_storage_manager()->get_hash("ggg");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  ASSERT_ND(args.input_len_ == sizeof(ScanInput));
+  const ScanInput* input = reinterpret_cast<const ScanInput*>(args.input_buffer_);
+
+  std::vector<bool> seen(kRecords, false);
+  uint64_t count = 0;
+  HashBin prev_bin = 0;
+  Epoch commit_epoch;
+  for (uint16_t partition = 0; partition < input->partitions_; ++partition) {
+    HashBinRange range = HashCursor::get_partition(
+      hash.get_bin_count(),
+      input->partitions_,
+      partition);
+    CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+    HashCursor cursor(hash, context);
+    WRAP_ERROR_CODE(cursor.open(range.begin_, range.end_));
+    while (cursor.is_valid_record()) {
+      EXPECT_TRUE(range.contains(cursor.get_bin()));
+      EXPECT_GE(cursor.get_bin(), prev_bin);
+      prev_bin = cursor.get_bin();
+      EXPECT_EQ(sizeof(uint64_t), cursor.get_key_length());
+      EXPECT_EQ(sizeof(uint64_t), cursor.get_payload_length());
+      uint64_t key;
+      uint64_t data;
+      std::memcpy(&key, cursor.get_key(), sizeof(key));
+      std::memcpy(&data, cursor.get_payload(), sizeof(data));
+      EXPECT_LT(key, kRecords);
+      if (key < kRecords) {
+        EXPECT_FALSE(seen[key]) << key;
+        seen[key] = true;
+      }
+      EXPECT_EQ(key * 3ULL, data) << key;
+      EXPECT_EQ(cursor.get_hash() >> (64U - hash.get_bin_bits()), cursor.get_bin());
+      if (input->deleted_) {
+        EXPECT_NE(0, key % 3U) << key;
+      }
+      ++count;
+      WRAP_ERROR_CODE(cursor.next());
+    }
+    CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  }
+
+  uint64_t expected = 0;
+  for (uint64_t key = 0; key < kRecords; ++key) {
+    if (!input->deleted_ || key % 3U != 0) {
+      ++expected;
+      EXPECT_TRUE(seen[key]) << key;
+    }
+  }
+  EXPECT_EQ(expected, count);
+  CHECK_ERROR(xct_manager->wait_for_commit(commit_epoch));
+  return kRetOk;
+}
+
+ErrorStack empty_scan_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  HashStorage hash = context->get_engine()->get_storage_manager()->get_hash("ggg");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  Epoch commit_epoch;
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  HashCursor cursor(hash, context);
+  WRAP_ERROR_CODE(cursor.open());
+  EXPECT_FALSE(cursor.is_valid_record());
+
+  // an empty range, too
+  WRAP_ERROR_CODE(cursor.open(3, 3));
+  EXPECT_FALSE(cursor.is_valid_record());
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  CHECK_ERROR(xct_manager->wait_for_commit(commit_epoch));
+  return kRetOk;
+}
+
+void run_test(uint8_t bin_bits, uint16_t partitions, bool with_delete) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("insert_task", insert_task);
+  engine.get_proc_manager()->pre_register("delete_task", delete_task);
+  engine.get_proc_manager()->pre_register("scan_task", scan_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    HashMetadata meta("ggg", bin_bits);
+    HashStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_hash(&meta, &storage, &epoch));
+    EXPECT_TRUE(storage.exists());
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("insert_task"));
+    ScanInput input;
+    input.partitions_ = partitions;
+    input.deleted_ = false;
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous(
+      "scan_task",
+      &input,
+      sizeof(input)));
+    if (with_delete) {
+      COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("delete_task"));
+      input.deleted_ = true;
+      COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous(
+        "scan_task",
+        &input,
+        sizeof(input)));
+    }
+    COERCE_ERROR(storage.verify_single_thread(&engine));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+TEST(HashCursorTest, Empty) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("empty_scan_task", empty_scan_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    HashMetadata meta("ggg", 10);
+    HashStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_hash(&meta, &storage, &epoch));
+    EXPECT_TRUE(storage.exists());
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("empty_scan_task"));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+// 1024 bins, thus 2 levels of intermediate pages
+TEST(HashCursorTest, Full)        { run_test(10, 1, false); }
+// only 2 bins, thus each bin has a few data pages
+TEST(HashCursorTest, FewBins)     { run_test(1, 1, false); }
+TEST(HashCursorTest, Partitioned) { run_test(10, 4, false); }
+TEST(HashCursorTest, Deleted)     { run_test(8, 1, true); }
+TEST(HashCursorTest, FewBinsDeleted) { run_test(1, 2, true); }
+
+}  // namespace hash
+}  // namespace storage
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(HashCursorTest, foedus.storage.hash);
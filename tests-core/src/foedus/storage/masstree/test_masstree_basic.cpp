@@ -20,17 +20,21 @@
 #include <cstring>
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "foedus/engine.hpp"
 #include "foedus/engine_options.hpp"
 #include "foedus/epoch.hpp"
 #include "foedus/test_common.hpp"
+#include "foedus/assorted/endianness.hpp"
 #include "foedus/assorted/uniform_random.hpp"
 #include "foedus/proc/proc_manager.hpp"
 #include "foedus/storage/storage_manager.hpp"
 #include "foedus/storage/hash/hash_hashinate.hpp"
 #include "foedus/storage/masstree/masstree_metadata.hpp"
 #include "foedus/storage/masstree/masstree_storage.hpp"
+#include "foedus/thread/impersonate_session.hpp"
 #include "foedus/thread/thread.hpp"
 #include "foedus/thread/thread_pool.hpp"
 #include "foedus/xct/xct_manager.hpp"
@@ -349,6 +353,129 @@ TEST(MasstreeBasicTest, NextLayer) {
   cleanup_test(options);
 }
 
+ErrorStack batch_read_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  MasstreeStorage masstree = context->get_engine()->get_storage_manager()->get_masstree("ggg");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  Epoch commit_epoch;
+
+  // Enough records to cause splits. Only even keys exist.
+  const uint16_t kRecords = 500;
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+  for (uint16_t i = 0; i < kRecords; ++i) {
+    uint64_t data = i * 3ULL;
+    WRAP_ERROR_CODE(masstree.insert_record_normalized(context, i * 2, &data, sizeof(data)));
+  }
+  // Long keys that share the first slice go to the next layer.
+  char long_keys[20][16];
+  for (uint16_t i = 0; i < 20; ++i) {
+    std::memset(long_keys[i], 42, sizeof(long_keys[i]));
+    long_keys[i][12] = i;
+    if (i % 2 == 0) {
+      uint64_t data = i * 7ULL;
+      WRAP_ERROR_CODE(masstree.insert_record(context, long_keys[i], 16, &data, sizeof(data)));
+    }
+  }
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+
+  // Read them in batches larger than kBatchMax
+  const uint16_t kBatch = 50;
+  KeySlice slices[kBatch];
+  uint64_t datas[kBatch];
+  void* payloads[kBatch];
+  PayloadLength capacities[kBatch];
+  ErrorCode results[kBatch];
+  for (uint16_t i = 0; i < kBatch; ++i) {
+    slices[i] = i * 17;  // odd ones are misses
+    payloads[i] = datas + i;
+    capacities[i] = sizeof(uint64_t);
+  }
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+  WRAP_ERROR_CODE(masstree.get_record_normalized_batch(
+    context, kBatch, slices, payloads, capacities, true, results));
+  for (uint16_t i = 0; i < kBatch; ++i) {
+    if (i % 2 == 0) {
+      EXPECT_EQ(kErrorCodeOk, results[i]) << i;
+      EXPECT_EQ(sizeof(uint64_t), capacities[i]) << i;
+      EXPECT_EQ(i * 17ULL / 2ULL * 3ULL, datas[i]) << i;
+    } else {
+      EXPECT_EQ(kErrorCodeStrKeyNotFound, results[i]) << i;
+    }
+  }
+
+  std::memset(datas, 0, sizeof(datas));
+  WRAP_ERROR_CODE(masstree.get_record_primitive_normalized_batch<uint64_t>(
+    context, 0, kBatch, slices, datas, true, results));
+  for (uint16_t i = 0; i < kBatch; ++i) {
+    if (i % 2 == 0) {
+      EXPECT_EQ(kErrorCodeOk, results[i]) << i;
+      EXPECT_EQ(i * 17ULL / 2ULL * 3ULL, datas[i]) << i;
+    } else {
+      EXPECT_EQ(kErrorCodeStrKeyNotFound, results[i]) << i;
+    }
+  }
+
+  // Mix of long keys, 8-byte keys, and short keys
+  const void* keys[kBatch];
+  KeyLength key_lengths[kBatch];
+  char be_keys[kBatch][8];
+  for (uint16_t i = 0; i < kBatch; ++i) {
+    if (i < 20) {
+      keys[i] = long_keys[i];
+      key_lengths[i] = 16;
+    } else {
+      assorted::write_bigendian<uint64_t>(i * 2, be_keys[i]);
+      keys[i] = be_keys[i];
+      key_lengths[i] = (i == kBatch - 1) ? 5 : 8;
+    }
+    capacities[i] = sizeof(uint64_t);
+  }
+  WRAP_ERROR_CODE(masstree.get_record_batch(
+    context, kBatch, keys, key_lengths, payloads, capacities, true, results));
+  for (uint16_t i = 0; i < kBatch; ++i) {
+    if (i < 20 && i % 2 != 0) {
+      EXPECT_EQ(kErrorCodeStrKeyNotFound, results[i]) << i;
+    } else if (i < 20) {
+      EXPECT_EQ(kErrorCodeOk, results[i]) << i;
+      EXPECT_EQ(i * 7ULL, datas[i]) << i;
+    } else if (i == kBatch - 1) {
+      EXPECT_EQ(kErrorCodeStrKeyNotFound, results[i]) << i;
+    } else {
+      EXPECT_EQ(kErrorCodeOk, results[i]) << i;
+      EXPECT_EQ(i * 3ULL, datas[i]) << i;
+    }
+  }
+
+  // too small buffer is reported per key
+  capacities[20] = 4;
+  WRAP_ERROR_CODE(masstree.get_record_batch(
+    context, 21, keys, key_lengths, payloads, capacities, true, results));
+  EXPECT_EQ(kErrorCodeOk, results[18]);
+  EXPECT_EQ(kErrorCodeStrTooSmallPayloadBuffer, results[20]);
+  EXPECT_EQ(sizeof(uint64_t), capacities[20]);
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  WRAP_ERROR_CODE(xct_manager->wait_for_commit(commit_epoch));
+  return foedus::kRetOk;
+}
+
+TEST(MasstreeBasicTest, GetRecordBatch) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("batch_read_task", batch_read_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    MasstreeMetadata meta("ggg");
+    MasstreeStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_masstree(&meta, &storage, &epoch));
+    EXPECT_TRUE(storage.exists());
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("batch_read_task"));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
 TEST(MasstreeBasicTest, CreateAndDrop) {
   EngineOptions options = get_tiny_options();
   Engine engine(options);
@@ -537,8 +664,140 @@ TEST(MasstreeBasicTest, ExpandInsertNormalized) { test_expand(false, true, false
 TEST(MasstreeBasicTest, ExpandUpdate) { test_expand(true, false, false); }
 TEST(MasstreeBasicTest, ExpandUpdateNextLayer) { test_expand(true, false, true); }
 TEST(MasstreeBasicTest, ExpandUpdateNormalized) { test_expand(true, true, false); }
-// TASK(Hideaki): we don't have multi-thread cases here. it's not a "basic" test.
-// no multi-key cases either.
+ErrorStack striped_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  MasstreeStorage masstree = context->get_engine()->get_storage_manager()->get_masstree("ggg");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  const KeySlice kKey = 12345;
+  const uint16_t kStripes = 4;
+  Epoch commit_epoch;
+  uint64_t value = 0;
+
+  // no stripe exists yet. it's just zero.
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+  WRAP_ERROR_CODE(masstree.get_record_primitive_normalized_striped<uint64_t>(
+    context, kKey, &value, 8, kStripes));
+  EXPECT_EQ(0U, value);
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+
+  // the first increment inserts the stripe, later ones update it
+  for (uint64_t i = 1; i <= 10U; ++i) {
+    WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+    WRAP_ERROR_CODE(masstree.increment_record_normalized_striped<uint64_t>(
+      context, kKey, i, 8, kStripes));
+    WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  }
+
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+  WRAP_ERROR_CODE(masstree.get_record_primitive_normalized_striped<uint64_t>(
+    context, kKey, &value, 8, kStripes));
+  EXPECT_EQ(55U, value);
+  EXPECT_EQ(
+    kErrorCodeInvalidParameter,
+    masstree.get_record_primitive_normalized_striped<uint64_t>(context, kKey, &value, 8, 0));
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  WRAP_ERROR_CODE(xct_manager->wait_for_commit(commit_epoch));
+  return foedus::kRetOk;
+}
+
+TEST(MasstreeBasicTest, StripedCounter) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("striped_task", striped_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    MasstreeMetadata meta("ggg");
+    MasstreeStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_masstree(&meta, &storage, &epoch));
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("striped_task"));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+// more threads than stripes, so threads race to insert the same stripe.
+const uint16_t kContendedStripes = 2;
+const uint32_t kContendedThreads = 4;
+const uint32_t kContendedXcts = 100;
+
+ErrorStack striped_contended_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  MasstreeStorage masstree = context->get_engine()->get_storage_manager()->get_masstree("ggg");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  Epoch commit_epoch;
+  for (uint32_t i = 0; i < kContendedXcts; ++i) {
+    while (true) {
+      WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+      ErrorCode ret = masstree.increment_record_normalized_striped<uint64_t>(
+        context, 12345, 1, 8, kContendedStripes);
+      if (ret == kErrorCodeOk) {
+        ret = xct_manager->precommit_xct(context, &commit_epoch);
+        if (ret == kErrorCodeOk) {
+          break;
+        }
+      } else {
+        WRAP_ERROR_CODE(xct_manager->abort_xct(context));
+      }
+      EXPECT_EQ(kErrorCodeXctRaceAbort, ret);
+    }
+  }
+  WRAP_ERROR_CODE(xct_manager->wait_for_commit(commit_epoch));
+  return foedus::kRetOk;
+}
+
+ErrorStack striped_contended_verify_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  MasstreeStorage masstree = context->get_engine()->get_storage_manager()->get_masstree("ggg");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  Epoch commit_epoch;
+  uint64_t value = 0;
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+  WRAP_ERROR_CODE(masstree.get_record_primitive_normalized_striped<uint64_t>(
+    context, 12345, &value, 8, kContendedStripes));
+  EXPECT_EQ(kContendedThreads * kContendedXcts, value);
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  return foedus::kRetOk;
+}
+
+TEST(MasstreeBasicTest, StripedCounterContended) {
+  EngineOptions options = get_tiny_options();
+  options.thread_.thread_count_per_group_ = kContendedThreads;
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("striped_contended_task", striped_contended_task);
+  engine.get_proc_manager()->pre_register(
+    "striped_contended_verify_task",
+    striped_contended_verify_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    MasstreeMetadata meta("ggg");
+    MasstreeStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_masstree(&meta, &storage, &epoch));
+    std::vector<thread::ImpersonateSession> sessions;
+    for (uint32_t i = 0; i < kContendedThreads; ++i) {
+      thread::ImpersonateSession session;
+      EXPECT_TRUE(engine.get_thread_pool()->impersonate(
+        "striped_contended_task",
+        nullptr,
+        0,
+        &session));
+      sessions.emplace_back(std::move(session));
+    }
+    for (uint32_t i = 0; i < kContendedThreads; ++i) {
+      COERCE_ERROR(sessions[i].get_result());
+      sessions[i].release();
+    }
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous(
+      "striped_contended_verify_task"));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+// TASK(Hideaki): no multi-key cases here.
 
 }  // namespace masstree
 }  // namespace storage
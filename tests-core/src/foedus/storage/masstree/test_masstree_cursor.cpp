@@ -21,17 +21,20 @@
 #include <iostream>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "foedus/engine.hpp"
 #include "foedus/engine_options.hpp"
 #include "foedus/epoch.hpp"
 #include "foedus/test_common.hpp"
+#include "foedus/assorted/endianness.hpp"
 #include "foedus/assorted/uniform_random.hpp"
 #include "foedus/proc/proc_manager.hpp"
 #include "foedus/storage/storage_manager.hpp"
 #include "foedus/storage/masstree/masstree_cursor.hpp"
 #include "foedus/storage/masstree/masstree_metadata.hpp"
 #include "foedus/storage/masstree/masstree_storage.hpp"
+#include "foedus/thread/impersonate_session.hpp"
 #include "foedus/thread/thread.hpp"
 #include "foedus/thread/thread_pool.hpp"
 #include "foedus/xct/xct_manager.hpp"
@@ -152,6 +155,153 @@ TEST(MasstreeCursorTest, OnePage) {
   cleanup_test(options);
 }
 
+const uint32_t kPartitionRecords = 4000;
+const KeySlice kPartitionKeyStride = 17;
+const uint32_t kPartitionThreads = 4;
+
+/** Every 10th record also has a 16-byte key in the next layer. */
+uint32_t get_expected_partition_records(KeySlice from, KeySlice to) {
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < kPartitionRecords; ++i) {
+    KeySlice slice = i * kPartitionKeyStride;
+    if (slice >= from && slice < to) {
+      count += (i % 10U == 0) ? 2U : 1U;
+    }
+  }
+  return count;
+}
+
+ErrorStack partition_insert_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  MasstreeStorage masstree = context->get_engine()->get_storage_manager()->get_masstree("test2");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  Epoch commit_epoch;
+  for (uint32_t i = 0; i < kPartitionRecords; ++i) {
+    if (i % 100U == 0) {
+      WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+    }
+    KeySlice key_be[2];
+    key_be[0] = assorted::htobe<KeySlice>(i * kPartitionKeyStride);
+    key_be[1] = assorted::htobe<KeySlice>(i);
+    WRAP_ERROR_CODE(masstree.insert_record(context, key_be, sizeof(KeySlice), &i, sizeof(i)));
+    if (i % 10U == 0) {
+      WRAP_ERROR_CODE(masstree.insert_record(context, key_be, sizeof(key_be), &i, sizeof(i)));
+    }
+    if (i % 100U == 99U) {
+      WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+    }
+  }
+  WRAP_ERROR_CODE(xct_manager->wait_for_commit(commit_epoch));
+  return foedus::kRetOk;
+}
+
+struct PartitionScanInput {
+  MasstreeStorage::ScanPartitions partitions_;
+  uint16_t partition_;
+};
+
+ErrorStack partition_scan_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  MasstreeStorage masstree = context->get_engine()->get_storage_manager()->get_masstree("test2");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  ASSERT_ND(args.input_len_ == sizeof(PartitionScanInput));
+  const PartitionScanInput* input = reinterpret_cast<const PartitionScanInput*>(args.input_buffer_);
+  const KeySlice low = input->partitions_.boundaries_[input->partition_];
+  const KeySlice high = input->partitions_.boundaries_[input->partition_ + 1U];
+
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, xct::kSerializable));
+  MasstreeCursor cursor(masstree, context);
+  WRAP_ERROR_CODE(cursor.open_partition(input->partitions_, input->partition_));
+  uint32_t count = 0;
+  while (cursor.is_valid_record()) {
+    KeySlice key_be[2];
+    EXPECT_TRUE(cursor.get_key_length() == sizeof(KeySlice)
+      || cursor.get_key_length() == sizeof(key_be));
+    cursor.copy_combined_key(reinterpret_cast<char*>(key_be));
+    KeySlice slice = assorted::read_bigendian<KeySlice>(key_be);
+    EXPECT_GE(slice, low);
+    EXPECT_LT(slice, high);
+    EXPECT_EQ(0U, slice % kPartitionKeyStride);
+    uint32_t payload;
+    EXPECT_EQ(sizeof(payload), cursor.get_payload_length());
+    std::memcpy(&payload, cursor.get_payload(), sizeof(payload));
+    EXPECT_EQ(slice / kPartitionKeyStride, payload);
+    ++count;
+    WRAP_ERROR_CODE(cursor.next());
+  }
+  Epoch commit_epoch;
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  ASSERT_ND(args.output_buffer_size_ >= sizeof(count));
+  std::memcpy(args.output_buffer_, &count, sizeof(count));
+  *args.output_used_ = sizeof(count);
+  return foedus::kRetOk;
+}
+
+void test_partitioned(KeySlice from, KeySlice to) {
+  EngineOptions options = get_tiny_options();
+  options.memory_.page_pool_size_mb_per_node_ = 16;
+  options.thread_.thread_count_per_group_ = kPartitionThreads;
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("partition_insert_task", partition_insert_task);
+  engine.get_proc_manager()->pre_register("partition_scan_task", partition_scan_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    MasstreeMetadata meta("test2");
+    MasstreeStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_masstree(&meta, &storage, &epoch));
+    EXPECT_TRUE(storage.exists());
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("partition_insert_task"));
+
+    PartitionScanInput input;
+    COERCE_ERROR_CODE(storage.partition_for_scan(
+      &engine,
+      from,
+      to,
+      kPartitionThreads,
+      &input.partitions_));
+    // a few thousand records span many border pages, so we should get all partitions.
+    EXPECT_EQ(kPartitionThreads, input.partitions_.count_);
+    EXPECT_EQ(from, input.partitions_.boundaries_[0]);
+    EXPECT_EQ(to, input.partitions_.boundaries_[input.partitions_.count_]);
+    for (uint16_t i = 0; i < input.partitions_.count_; ++i) {
+      EXPECT_LT(input.partitions_.boundaries_[i], input.partitions_.boundaries_[i + 1U]);
+    }
+
+    std::vector<thread::ImpersonateSession> sessions;
+    for (uint16_t i = 0; i < input.partitions_.count_; ++i) {
+      input.partition_ = i;
+      thread::ImpersonateSession session;
+      EXPECT_TRUE(engine.get_thread_pool()->impersonate(
+        "partition_scan_task",
+        &input,
+        sizeof(input),
+        &session));
+      sessions.emplace_back(std::move(session));
+    }
+    uint32_t total = 0;
+    for (uint16_t i = 0; i < sessions.size(); ++i) {
+      COERCE_ERROR(sessions[i].get_result());
+      uint32_t count;
+      EXPECT_EQ(sizeof(count), sessions[i].get_output_size());
+      sessions[i].get_output(&count);
+      // each partition should have some records, though not exactly the same number
+      EXPECT_GT(count, 0U) << i;
+      total += count;
+      sessions[i].release();
+    }
+    EXPECT_EQ(get_expected_partition_records(from, to), total);
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+TEST(MasstreeCursorTest, Partitioned) { test_partitioned(kInfimumSlice, kSupremumSlice); }
+TEST(MasstreeCursorTest, PartitionedRange) {
+  test_partitioned(kPartitionKeyStride * 1000U + 5U, kPartitionKeyStride * 3000U);
+}
+
 TEST(MasstreeCursorTest, OneLayer) {
   // TODO(Hideaki) write testcases!
 }
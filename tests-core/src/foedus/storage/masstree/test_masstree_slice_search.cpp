@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <stdint.h>
+#include <gtest/gtest.h>
+
+#include "foedus/test_common.hpp"
+#include "foedus/assorted/uniform_random.hpp"
+#include "foedus/storage/masstree/masstree_id.hpp"
+#include "foedus/storage/masstree/masstree_slice_search.hpp"
+
+/**
+ * @file test_masstree_slice_search.cpp
+ * Compares the SIMD slice search with the scalar loop.
+ * find_key() etc in MasstreeBorderPage are tested in other masstree testcases.
+ */
+namespace foedus {
+namespace storage {
+namespace masstree {
+DEFINE_TEST_CASE_PACKAGE(MasstreeSliceSearchTest, foedus.storage.masstree);
+
+/** Slices with a few distinct values so that we have many matches. +1 for overrun check. */
+void fill_slices(uint32_t seed, uint32_t distinct, KeySlice* slices) {
+  assorted::UniformRandom rnd(seed);
+  for (SlotIndex i = 0; i < kBorderPageMaxSlots; ++i) {
+    slices[i] = rnd.uniform_within(0, distinct - 1U) * 0x0101010101010101ULL;
+  }
+  slices[kBorderPageMaxSlots] = 0;
+}
+
+TEST(MasstreeSliceSearchTest, CompareSlices) {
+  KeySlice slices[kSliceSearchWidth];
+  for (SlotIndex i = 0; i < kSliceSearchWidth; ++i) {
+    slices[i] = i % 2U == 0 ? 42U : (42ULL << 32);  // same lower/upper halves must not match
+  }
+  uint32_t expected = 0;
+  for (SlotIndex i = 0; i < kSliceSearchWidth; i += 2U) {
+    expected |= 1U << i;
+  }
+  EXPECT_EQ(expected, compare_slices(slices, 42U));
+  EXPECT_EQ(expected << 1, compare_slices(slices, 42ULL << 32));
+  EXPECT_EQ(0U, compare_slices(slices, 43U));
+}
+
+TEST(MasstreeSliceSearchTest, CompareWithScalar) {
+  KeySlice slices[kBorderPageMaxSlots + 1U];
+  for (uint32_t distinct = 1; distinct <= 128U; distinct *= 2U) {
+    fill_slices(distinct, distinct, slices);
+    for (uint32_t from = 0; from <= kBorderPageMaxSlots; from += 3U) {
+      for (uint32_t to = from; to <= kBorderPageMaxSlots; ++to) {
+        for (KeySlice value = 0; value <= distinct; ++value) {
+          const KeySlice slice = value * 0x0101010101010101ULL;
+          EXPECT_EQ(
+            find_slice_scalar(slices, from, to, slice),
+            find_slice(slices, from, to, slice)) << from << "-" << to << ":" << slice;
+        }
+      }
+    }
+  }
+}
+
+TEST(MasstreeSliceSearchTest, NoOverrun) {
+  KeySlice slices[kBorderPageMaxSlots + 1U];
+  fill_slices(1234, 4, slices);
+  const KeySlice kGuard = 0xDEADBEEFULL;
+  slices[kBorderPageMaxSlots] = kGuard;
+  for (uint32_t to = 0; to <= kBorderPageMaxSlots; ++to) {
+    const KeySlice original = slices[to];
+    slices[to] = kGuard;  // must not be found because it's at to
+    EXPECT_EQ(to, find_slice(slices, 0, to, kGuard));
+    slices[to] = original;
+  }
+}
+
+}  // namespace masstree
+}  // namespace storage
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(MasstreeSliceSearchTest, foedus.storage.masstree);
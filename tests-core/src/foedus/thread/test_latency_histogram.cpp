@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <iostream>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/epoch.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/array/array_metadata.hpp"
+#include "foedus/storage/array/array_storage.hpp"
+#include "foedus/thread/latency_histogram.hpp"
+#include "foedus/thread/thread.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/xct/xct_manager.hpp"
+
+namespace foedus {
+namespace thread {
+DEFINE_TEST_CASE_PACKAGE(LatencyHistogramTest, foedus.thread);
+
+TEST(LatencyHistogramTest, Buckets) {
+  for (uint64_t value = 0; value < 100000ULL; ++value) {
+    uint32_t bucket = LatencyHistogram::to_bucket(value);
+    ASSERT_LT(bucket, static_cast<uint32_t>(LatencyHistogram::kBucketCount)) << value;
+    ASSERT_LE(LatencyHistogram::get_bucket_floor(bucket), value) << value;
+    ASSERT_GT(LatencyHistogram::get_bucket_floor(bucket + 1U), value) << value;
+  }
+  // buckets are contiguous
+  for (uint32_t bucket = 0; bucket + 1U < LatencyHistogram::kBucketCount; ++bucket) {
+    uint64_t floor = LatencyHistogram::get_bucket_floor(bucket);
+    EXPECT_EQ(bucket, LatencyHistogram::to_bucket(floor));
+    EXPECT_EQ(bucket + 1U, LatencyHistogram::to_bucket(LatencyHistogram::get_bucket_floor(
+      bucket + 1U)));
+  }
+  // too large values go to the last bucket
+  EXPECT_EQ(LatencyHistogram::kBucketCount - 1U, LatencyHistogram::to_bucket(0xFFFFFFFFFFFFULL));
+}
+
+TEST(LatencyHistogramTest, Percentile) {
+  LatencyHistogram histogram;
+  histogram.reset();
+  EXPECT_EQ(0U, histogram.get_percentile(99));
+  for (uint64_t i = 1; i <= 1000U; ++i) {
+    histogram.record(i);
+  }
+  EXPECT_EQ(1000U, histogram.count_);
+  EXPECT_EQ(1000U, histogram.max_);
+  EXPECT_DOUBLE_EQ(500.5, histogram.get_average());
+  // upper bounds within 25% error
+  uint64_t p50 = histogram.get_percentile(50);
+  EXPECT_GE(p50, 500U);
+  EXPECT_LE(p50, 625U);
+  uint64_t p99 = histogram.get_percentile(99);
+  EXPECT_GE(p99, 990U);
+  EXPECT_LE(p99, 1000U);  // never larger than max
+  EXPECT_EQ(1000U, histogram.get_percentile(100));
+  EXPECT_EQ(1U, histogram.get_percentile(0));
+}
+
+TEST(LatencyHistogramTest, Merge) {
+  ThreadLatencyHistograms a;
+  ThreadLatencyHistograms b;
+  a.reset();
+  b.reset();
+  for (uint32_t i = 0; i < 99U; ++i) {
+    a.record(kLatencyPhaseVerify, 10);
+  }
+  b.record(kLatencyPhaseVerify, 1000000);
+  b.record(kLatencyPhaseApply, 5);
+  a.add(b);
+  const LatencyHistogram& verify = a.get(kLatencyPhaseVerify);
+  EXPECT_EQ(100U, verify.count_);
+  EXPECT_EQ(1000000U, verify.max_);
+  EXPECT_GE(verify.get_percentile(99), 10U);
+  EXPECT_LT(verify.get_percentile(99), 100U);
+  EXPECT_EQ(1000000U, verify.get_percentile(99.9));
+  EXPECT_EQ(1U, a.get(kLatencyPhaseApply).count_);
+  EXPECT_EQ(0U, a.get(kLatencyPhaseUserBody).count_);
+}
+
+const uint32_t kTransactions = 10;
+
+ErrorStack array_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::array::ArrayStorage array
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  char buf[16];
+  std::memset(buf, 0, sizeof(buf));
+  context->get_latency_histograms()->reset();
+
+  Epoch commit_epoch;
+  for (uint32_t i = 0; i < kTransactions; ++i) {
+    CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+    CHECK_ERROR(array.get_record(context, i, buf));
+    CHECK_ERROR(array.overwrite_record(context, i + 1U, buf));
+    CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  }
+  // one read-only transaction
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  CHECK_ERROR(array.get_record(context, 0, buf));
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+
+  CHECK_ERROR(xct_manager->wait_for_commit(context, commit_epoch));
+  return foedus::kRetOk;
+}
+
+TEST(LatencyHistogramTest, Transactions) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("array_task", array_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    storage::array::ArrayMetadata meta("test", 16, 100);
+    storage::array::ArrayStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_array(&meta, &storage, &epoch));
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("array_task"));
+
+    ThreadLatencyHistograms sum;
+    engine.get_thread_pool()->get_latency_histograms_sum(&sum);
+    std::cout << sum << std::endl;
+    EXPECT_EQ(kTransactions + 1U, sum.get(kLatencyPhaseUserBody).count_);
+    EXPECT_EQ(kTransactions, sum.get(kLatencyPhasePrecommitLock).count_);
+    EXPECT_EQ(kTransactions + 1U, sum.get(kLatencyPhaseVerify).count_);
+    EXPECT_EQ(kTransactions, sum.get(kLatencyPhaseApply).count_);
+    EXPECT_EQ(1U, sum.get(kLatencyPhaseWaitForCommit).count_);
+    EXPECT_GT(sum.get(kLatencyPhaseUserBody).max_, 0U);
+    EXPECT_GT(sum.get(kLatencyPhaseWaitForCommit).max_, 0U);
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+}  // namespace thread
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(LatencyHistogramTest, foedus.thread);
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <stdint.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/thread/task_queue.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/thread/thread_ref.hpp"
+
+namespace foedus {
+namespace thread {
+DEFINE_TEST_CASE_PACKAGE(TaskQueueTest, foedus.thread);
+
+ErrorStack double_task(const proc::ProcArguments& args) {
+  EXPECT_EQ(sizeof(uint64_t), args.input_len_);
+  uint64_t value = *reinterpret_cast<const uint64_t*>(args.input_buffer_);
+  value *= 2U;
+  std::memcpy(args.output_buffer_, &value, sizeof(value));
+  *args.output_used_ = sizeof(value);
+  return kRetOk;
+}
+
+ErrorStack error_task(const proc::ProcArguments& /*args*/) {
+  return ERROR_STACK(kErrorCodeInvalidParameter);
+}
+
+TEST(TaskQueueTest, SubmitMany) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("double_task", double_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    ThreadRef* thread = engine.get_thread_pool()->get_thread_ref(0);
+    TaskQueue* queue = thread->get_task_queue();
+    // submit more than the capacity in a few rounds, retrieving all of them each round
+    const uint32_t kRounds = 5;
+    const uint32_t kTasksPerRound = TaskQueue::kCapacity;
+    for (uint32_t round = 0; round < kRounds; ++round) {
+      std::vector<TaskTicket> tickets;
+      for (uint64_t i = 0; i < kTasksPerRound; ++i) {
+        uint64_t input = round * kTasksPerRound + i;
+        TaskTicket ticket;
+        EXPECT_EQ(kErrorCodeOk, thread->submit_task(
+          "double_task",
+          &input,
+          sizeof(input),
+          &ticket,
+          i + 1U == kTasksPerRound));
+        tickets.push_back(ticket);
+      }
+      // the queue is full until we retrieve something
+      TaskTicket dummy;
+      uint64_t input = 0;
+      EXPECT_EQ(kErrorCodeThrTaskQueueFull, thread->submit_task(
+        "double_task",
+        &input,
+        sizeof(input),
+        &dummy));
+      for (uint64_t i = 0; i < kTasksPerRound; ++i) {
+        EXPECT_EQ(kErrorCodeOk, queue->wait_for_completion(tickets[i], -1));
+        EXPECT_TRUE(queue->is_completed(tickets[i]));
+        uint64_t output = 0;
+        uint32_t output_len = 0;
+        EXPECT_EQ(kErrorCodeOk, queue->retrieve(tickets[i], &output, sizeof(output), &output_len));
+        EXPECT_EQ(sizeof(output), output_len);
+        EXPECT_EQ((round * kTasksPerRound + i) * 2U, output);
+      }
+    }
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+TEST(TaskQueueTest, Errors) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("error_task", error_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    ThreadRef* thread = engine.get_thread_pool()->get_thread_ref(0);
+    TaskQueue* queue = thread->get_task_queue();
+    TaskTicket ticket;
+    char large_input[TaskQueueEntry::kInputSize + 1];
+    std::memset(large_input, 0, sizeof(large_input));
+    EXPECT_EQ(kErrorCodeThrTaskInputTooLarge, thread->submit_task(
+      "error_task",
+      large_input,
+      sizeof(large_input),
+      &ticket));
+
+    uint32_t output_len;
+    EXPECT_EQ(kErrorCodeOk, thread->submit_task("error_task", nullptr, 0, &ticket));
+    EXPECT_EQ(kErrorCodeOk, queue->wait_for_completion(ticket, -1));
+    EXPECT_EQ(kErrorCodeInvalidParameter, queue->retrieve(ticket, nullptr, 0, &output_len));
+    EXPECT_EQ(0U, output_len);
+
+    EXPECT_EQ(kErrorCodeOk, thread->submit_task("no_such_task", nullptr, 0, &ticket));
+    EXPECT_EQ(kErrorCodeOk, queue->wait_for_completion(ticket, -1));
+    EXPECT_EQ(kErrorCodeProcNotFound, queue->retrieve(ticket, nullptr, 0, &output_len));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+TEST(TaskQueueTest, Stop) {
+  // No worker here. We play the worker by calling stop().
+  std::vector<uint64_t> memory(sizeof(TaskQueue) / sizeof(uint64_t) + 1U);
+  TaskQueue* queue = reinterpret_cast<TaskQueue*>(&memory[0]);
+  queue->initialize();
+  proc::ProcName proc_name("double_task");
+  TaskTicket tickets[2];
+  uint64_t input = 42;
+  EXPECT_EQ(kErrorCodeOk, queue->submit(proc_name, &input, sizeof(input), tickets));
+  EXPECT_EQ(kErrorCodeOk, queue->submit(proc_name, &input, sizeof(input), tickets + 1));
+  EXPECT_EQ(kErrorCodeTimeout, queue->wait_for_completion(tickets[0], 1000));
+
+  // a client waiting forever must wake up when the worker stops
+  std::thread waiter([queue, &tickets]{
+    ErrorCode ret = queue->wait_for_completion(tickets[0], -1);
+    EXPECT_TRUE(ret == kErrorCodeOk || ret == kErrorCodeBeingShutdown) << get_error_name(ret);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  queue->stop();
+  waiter.join();
+  EXPECT_TRUE(queue->is_stopped());
+
+  for (uint32_t i = 0; i < 2U; ++i) {
+    EXPECT_TRUE(queue->is_completed(tickets[i]));
+    EXPECT_EQ(kErrorCodeOk, queue->wait_for_completion(tickets[i], -1));
+    uint32_t output_len = 1;
+    EXPECT_EQ(kErrorCodeBeingShutdown, queue->retrieve(tickets[i], nullptr, 0, &output_len));
+    EXPECT_EQ(0U, output_len);
+  }
+  TaskTicket ticket;
+  EXPECT_EQ(kErrorCodeBeingShutdown, queue->submit(proc_name, &input, sizeof(input), &ticket));
+}
+
+}  // namespace thread
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(TaskQueueTest, foedus.thread);
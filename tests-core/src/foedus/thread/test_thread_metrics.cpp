@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <iostream>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/epoch.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/assorted/cacheline.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/array/array_metadata.hpp"
+#include "foedus/storage/array/array_storage.hpp"
+#include "foedus/storage/masstree/masstree_metadata.hpp"
+#include "foedus/storage/masstree/masstree_storage.hpp"
+#include "foedus/thread/thread.hpp"
+#include "foedus/thread/thread_metrics.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/thread/thread_ref.hpp"
+#include "foedus/xct/xct_manager.hpp"
+
+namespace foedus {
+namespace thread {
+DEFINE_TEST_CASE_PACKAGE(ThreadMetricsTest, foedus.thread);
+
+TEST(ThreadMetricsTest, Layout) {
+  EXPECT_EQ(0, sizeof(ThreadMetrics) % assorted::kCachelineSize);
+  ThreadMetrics a;
+  ThreadMetrics b;
+  a.reset();
+  b.reset();
+  a.commits_ = 3;
+  a.log_bytes_ = 100;
+  b.commits_ = 4;
+  b.log_bytes_ = 20;
+  b.race_aborts_ = 1;
+  b.explicit_aborts_ = 2;
+  a.add(b);
+  EXPECT_EQ(7U, a.commits_);
+  EXPECT_EQ(120U, a.log_bytes_);
+  EXPECT_EQ(3U, a.get_total_aborts());
+  EXPECT_EQ(4U, b.commits_);
+}
+
+ErrorStack array_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::array::ArrayStorage array
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  char buf[16];
+  std::memset(buf, 0, sizeof(buf));
+  context->get_metrics()->reset();
+
+  // read-only
+  Epoch commit_epoch;
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  CHECK_ERROR(array.get_record(context, 3, buf));
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+
+  // read-write
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  CHECK_ERROR(array.get_record(context, 4, buf));
+  CHECK_ERROR(array.overwrite_record(context, 5, buf));
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+
+  // explicit abort
+  CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+  CHECK_ERROR(array.overwrite_record(context, 6, buf));
+  CHECK_ERROR(xct_manager->abort_xct(context));
+
+  CHECK_ERROR(xct_manager->wait_for_commit(commit_epoch));
+  return foedus::kRetOk;
+}
+
+TEST(ThreadMetricsTest, Transactions) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("array_task", array_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    storage::array::ArrayMetadata meta("test", 16, 100);
+    storage::array::ArrayStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_array(&meta, &storage, &epoch));
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("array_task"));
+
+    ThreadMetrics sum;
+    engine.get_thread_pool()->get_metrics_sum(&sum);
+    EXPECT_EQ(2U, sum.commits_);
+    EXPECT_EQ(1U, sum.read_only_commits_);
+    EXPECT_EQ(1U, sum.explicit_aborts_);
+    EXPECT_EQ(0U, sum.race_aborts_);
+    EXPECT_EQ(0U, sum.lock_aborts_);
+    EXPECT_EQ(1U, sum.get_total_aborts());
+    EXPECT_EQ(2U, sum.read_set_total_);
+    EXPECT_EQ(1U, sum.write_set_total_);
+    EXPECT_GT(sum.log_bytes_, 0U);
+    std::cout << sum << std::endl;
+
+    // The same values are visible via ThreadRef, which is what other SOCs see.
+    ThreadMetrics sum_refs;
+    sum_refs.reset();
+    for (ThreadGroupId group = 0; group < options.thread_.group_count_; ++group) {
+      engine.get_thread_pool()->get_group_ref(group)->add_metrics(&sum_refs);
+    }
+    EXPECT_EQ(sum.commits_, sum_refs.commits_);
+    EXPECT_EQ(sum.log_bytes_, sum_refs.log_bytes_);
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+const uint32_t kSplitRecords = 1000;
+
+ErrorStack masstree_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::masstree::MasstreeStorage masstree
+    = context->get_engine()->get_storage_manager()->get_masstree("test");
+  xct::XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  char buf[200];
+  std::memset(buf, 0, sizeof(buf));
+  Epoch commit_epoch;
+  for (uint32_t i = 0; i < kSplitRecords; ++i) {
+    CHECK_ERROR(xct_manager->begin_xct(context, xct::kSerializable));
+    CHECK_ERROR(masstree.insert_record_normalized(context, i, buf, sizeof(buf)));
+    CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  }
+  CHECK_ERROR(xct_manager->wait_for_commit(commit_epoch));
+  return foedus::kRetOk;
+}
+
+TEST(ThreadMetricsTest, PageSplits) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("masstree_task", masstree_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    storage::masstree::MasstreeMetadata meta("test");
+    storage::masstree::MasstreeStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_masstree(&meta, &storage, &epoch));
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("masstree_task"));
+
+    ThreadMetrics sum;
+    engine.get_thread_pool()->get_metrics_sum(&sum);
+    EXPECT_EQ(kSplitRecords, sum.commits_);
+    EXPECT_EQ(kSplitRecords, sum.write_set_total_);
+    EXPECT_EQ(0U, sum.get_total_aborts());
+    // 200 bytes payloads. a border page holds much fewer than 1000 of them.
+    EXPECT_GT(sum.page_splits_, 0U);
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+}  // namespace thread
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(ThreadMetricsTest, foedus.thread);
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <stdint.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/epoch.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/array/array_metadata.hpp"
+#include "foedus/storage/array/array_storage.hpp"
+#include "foedus/thread/thread.hpp"
+#include "foedus/thread/thread_metrics.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/xct/abort_report.hpp"
+#include "foedus/xct/abort_sample.hpp"
+#include "foedus/xct/xct_manager.hpp"
+
+namespace foedus {
+namespace xct {
+DEFINE_TEST_CASE_PACKAGE(XctAbortReportTest, foedus.xct);
+
+TEST(XctAbortReportTest, Ring) {
+  AbortSampleRing ring;
+  ring.initialize();
+  EXPECT_EQ(0U, ring.get_count());
+  EXPECT_TRUE(ring.should_sample(3));
+  EXPECT_FALSE(ring.should_sample(3));
+  EXPECT_FALSE(ring.should_sample(3));
+  EXPECT_TRUE(ring.should_sample(3));
+  EXPECT_TRUE(ring.should_sample(1));
+  EXPECT_TRUE(ring.should_sample(1));
+
+  for (uint32_t i = 0; i < AbortSampleRing::kCapacity + 10U; ++i) {
+    AbortSample* sample = ring.next_sample();
+    sample->record_address_ = i;
+  }
+  EXPECT_EQ(static_cast<uint32_t>(AbortSampleRing::kCapacity), ring.get_count());
+  EXPECT_EQ(AbortSampleRing::kCapacity + 10U, ring.total_samples_);
+  // the oldest ones are overwritten
+  EXPECT_EQ(AbortSampleRing::kCapacity, ring.samples_[0].record_address_);
+  EXPECT_EQ(10U, ring.samples_[10].record_address_);
+}
+
+const uint64_t kHotRecord = 3;
+const uint64_t kOtherRecord = 5;
+
+/** 0: reader started, 1: reader read the record, 2: writer committed */
+std::atomic<int> progress;
+
+void wait_progress(int value) {
+  while (progress.load() < value) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+ErrorStack reader_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::array::ArrayStorage array
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  char buf[16];
+  std::memset(buf, 0, sizeof(buf));
+  CHECK_ERROR(xct_manager->begin_xct(context, kSerializable));
+  CHECK_ERROR(array.get_record(context, kHotRecord, buf));
+  CHECK_ERROR(array.overwrite_record(context, kOtherRecord, buf));
+  progress.store(1);
+  wait_progress(2);
+
+  Epoch commit_epoch;
+  ErrorCode ret = xct_manager->precommit_xct(context, &commit_epoch);
+  EXPECT_EQ(kErrorCodeXctRaceAbort, ret);
+  EXPECT_FALSE(context->is_running_xct());
+  EXPECT_EQ(1U, context->get_abort_samples()->get_count());
+  return kRetOk;
+}
+
+ErrorStack writer_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::array::ArrayStorage array
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  char buf[16];
+  std::memset(buf, 1, sizeof(buf));
+  wait_progress(1);
+  CHECK_ERROR(xct_manager->begin_xct(context, kSerializable));
+  CHECK_ERROR(array.overwrite_record(context, kHotRecord, buf));
+  Epoch commit_epoch;
+  CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+  progress.store(2);
+  return kRetOk;
+}
+
+TEST(XctAbortReportTest, HotRecord) {
+  EngineOptions options = get_tiny_options();
+  options.thread_.thread_count_per_group_ = 2;
+  options.xct_.abort_sampling_interval_ = 1;
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("reader_task", reader_task);
+  engine.get_proc_manager()->pre_register("writer_task", writer_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    storage::array::ArrayMetadata meta("test", 16, 100);
+    storage::array::ArrayStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_array(&meta, &storage, &epoch));
+
+    progress.store(0);
+    thread::ImpersonateSession reader;
+    thread::ImpersonateSession writer;
+    EXPECT_TRUE(engine.get_thread_pool()->impersonate("reader_task", nullptr, 0, &reader));
+    EXPECT_TRUE(engine.get_thread_pool()->impersonate("writer_task", nullptr, 0, &writer));
+    COERCE_ERROR(writer.get_result());
+    COERCE_ERROR(reader.get_result());
+    writer.release();
+    reader.release();
+
+    AbortReport report(&engine);
+    report.collect(5);
+    std::cout << report << std::endl;
+    EXPECT_EQ(1U, report.get_sample_count());
+    EXPECT_EQ(1U, report.get_cause_count(kAbortCauseReadVerify));
+    EXPECT_EQ(0U, report.get_cause_count(kAbortCauseLock));
+    ASSERT_EQ(1U, report.get_hot_records().size());
+    const AbortHotspot& record = report.get_hot_records()[0];
+    EXPECT_EQ(storage.get_id(), record.storage_id_);
+    EXPECT_EQ(1U, record.count_);
+    EXPECT_NE(0U, record.record_address_);
+    EXPECT_NE(0U, record.page_id_);
+    ASSERT_EQ(1U, report.get_hot_pages().size());
+    EXPECT_EQ(record.page_id_, report.get_hot_pages()[0].page_id_);
+    EXPECT_EQ(0U, report.get_hot_pages()[0].record_address_);
+
+    thread::ThreadMetrics sum;
+    engine.get_thread_pool()->get_metrics_sum(&sum);
+    EXPECT_EQ(1U, sum.race_aborts_);
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+}  // namespace xct
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(XctAbortReportTest, foedus.xct);
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <stdint.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/epoch.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/array/array_metadata.hpp"
+#include "foedus/storage/array/array_storage.hpp"
+#include "foedus/thread/thread.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/xct/xct_manager.hpp"
+#include "foedus/xct/xct_manager_pimpl.hpp"
+
+namespace foedus {
+namespace xct {
+DEFINE_TEST_CASE_PACKAGE(XctAdaptiveEpochTest, foedus.xct);
+
+TEST(XctAdaptiveEpochTest, Policy) {
+  // halves with waiters
+  EXPECT_EQ(10000U, XctManagerPimpl::adapt_epoch_interval(20000, true, 1000, 100000));
+  EXPECT_EQ(1000U, XctManagerPimpl::adapt_epoch_interval(1500, true, 1000, 100000));
+  // slowly lengthens without waiters
+  EXPECT_EQ(25001U, XctManagerPimpl::adapt_epoch_interval(20000, false, 1000, 100000));
+  EXPECT_EQ(100000U, XctManagerPimpl::adapt_epoch_interval(90000, false, 1000, 100000));
+  // can grow from zero
+  EXPECT_EQ(1U, XctManagerPimpl::adapt_epoch_interval(0, false, 0, 100000));
+}
+
+ErrorStack commit_wait_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  storage::array::ArrayStorage storage
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  const uint64_t initial_interval_us = xct_manager->get_epoch_chime_stat().current_interval_us_;
+  for (uint32_t i = 0; i < 20U; ++i) {
+    CHECK_ERROR(xct_manager->begin_xct(context, kSerializable));
+    uint64_t data = i;
+    CHECK_ERROR(storage.overwrite_record(context, i % 4U, &data));
+    Epoch commit_epoch;
+    CHECK_ERROR(xct_manager->precommit_xct(context, &commit_epoch));
+    CHECK_ERROR(xct_manager->wait_for_commit(commit_epoch));
+  }
+  EpochChimeStat stat = xct_manager->get_epoch_chime_stat();
+  EXPECT_GT(stat.total_commit_waits_, 0U);
+  EXPECT_GT(stat.epochs_advanced_, 0U);
+  EXPECT_GE(stat.total_epoch_duration_us_, stat.max_epoch_duration_us_);
+  EXPECT_EQ(0U, stat.current_commit_waiters_);
+  if (context->get_engine()->get_options().xct_.adaptive_epoch_interval_) {
+    EXPECT_LT(stat.current_interval_us_, initial_interval_us);
+  } else {
+    EXPECT_EQ(initial_interval_us, stat.current_interval_us_);
+  }
+  return kRetOk;
+}
+
+void run_commit_wait_test(bool adaptive) {
+  EngineOptions options = get_tiny_options();
+  options.xct_.epoch_advance_interval_ms_ = 20;
+  options.xct_.adaptive_epoch_interval_ = adaptive;
+  options.xct_.min_epoch_advance_interval_ms_ = 1;
+  options.xct_.max_epoch_advance_interval_ms_ = 50;
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("commit_wait_task", commit_wait_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    storage::array::ArrayMetadata meta("test", sizeof(uint64_t), 4);
+    storage::array::ArrayStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_array(&meta, &storage, &epoch));
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("commit_wait_task"));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+TEST(XctAdaptiveEpochTest, ShortenWithWaiters) { run_commit_wait_test(true); }
+TEST(XctAdaptiveEpochTest, FixedWithWaiters) { run_commit_wait_test(false); }
+
+TEST(XctAdaptiveEpochTest, LengthenWithoutWaiters) {
+  EngineOptions options = get_tiny_options();
+  options.xct_.epoch_advance_interval_ms_ = 2;
+  options.xct_.adaptive_epoch_interval_ = true;
+  options.xct_.min_epoch_advance_interval_ms_ = 1;
+  options.xct_.max_epoch_advance_interval_ms_ = 10;
+  Engine engine(options);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    // no one waits for commit, so the interval should reach the max in ~50ms.
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EpochChimeStat stat = engine.get_xct_manager()->get_epoch_chime_stat();
+    EXPECT_EQ(10000U, stat.current_interval_us_);
+    EXPECT_GT(stat.epochs_advanced_, 5U);
+    EXPECT_EQ(0U, stat.current_commit_waiters_);
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+}  // namespace xct
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(XctAdaptiveEpochTest, foedus.xct);
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <stdint.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/epoch.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/log/log_manager.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/array/array_metadata.hpp"
+#include "foedus/storage/array/array_storage.hpp"
+#include "foedus/thread/thread.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/xct/durable_callback_queue.hpp"
+#include "foedus/xct/xct.hpp"
+#include "foedus/xct/xct_manager.hpp"
+
+namespace foedus {
+namespace xct {
+DEFINE_TEST_CASE_PACKAGE(XctDurableCallbackTest, foedus.xct);
+
+const uint64_t kRecords = 16;
+
+/** Shared by the callbacks of one task */
+struct CallbackState {
+  Engine*   engine_;
+  uint32_t  invoked_;
+  Epoch     last_epoch_;
+};
+
+void durable_callback(Epoch commit_epoch, void* user_data) {
+  CallbackState* state = reinterpret_cast<CallbackState*>(user_data);
+  // never invoked before it becomes durable
+  if (commit_epoch.is_valid()) {
+    EXPECT_LE(commit_epoch, state->engine_->get_log_manager()->get_durable_global_epoch());
+  }
+  ++state->invoked_;
+  state->last_epoch_ = commit_epoch;
+}
+
+/** Process-wide counter for callbacks whose task has already returned */
+std::atomic<uint32_t> orphan_invoked(0);
+void orphan_callback(Epoch /*commit_epoch*/, void* /*user_data*/) {
+  ++orphan_invoked;
+}
+
+ErrorStack commit_async(
+  thread::Thread* context,
+  storage::array::ArrayStorage* storage,
+  uint64_t i,
+  DurableCallback callback,
+  void* user_data) {
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  CHECK_ERROR(xct_manager->begin_xct(context, kSerializable));
+  uint64_t data = i;
+  CHECK_ERROR(storage->overwrite_record(context, i % kRecords, &data));
+  Epoch commit_epoch;
+  CHECK_ERROR(xct_manager->precommit_xct_async(context, callback, user_data, &commit_epoch));
+  EXPECT_TRUE(commit_epoch.is_valid());
+  return kRetOk;
+}
+
+ErrorStack basic_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  storage::array::ArrayStorage storage
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  DurableCallbackQueue* queue = context->get_current_xct().get_durable_callback_queue();
+  CallbackState state = { context->get_engine(), 0, Epoch() };
+  const uint32_t kXcts = 100;
+  const uint64_t waits_before = xct_manager->get_epoch_chime_stat().total_commit_waits_;
+  for (uint32_t i = 0; i < kXcts; ++i) {
+    CHECK_ERROR(commit_async(context, &storage, i, durable_callback, &state));
+    EXPECT_EQ(kXcts, state.invoked_ + queue->get_count());
+  }
+  // each async commit counts as a commit wait for the adaptive epoch interval
+  EXPECT_GE(xct_manager->get_epoch_chime_stat().total_commit_waits_, waits_before + kXcts);
+  WRAP_ERROR_CODE(xct_manager->wait_for_durable_callbacks(context));
+  EXPECT_TRUE(queue->is_empty());
+  EXPECT_EQ(kXcts, state.invoked_);
+  EXPECT_TRUE(state.last_epoch_.is_valid());
+  EXPECT_EQ(0U, xct_manager->invoke_durable_callbacks(context));
+  return kRetOk;
+}
+
+ErrorStack read_only_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  storage::array::ArrayStorage storage
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  CallbackState state = { context->get_engine(), 0, Epoch() };
+  for (uint32_t i = 0; i < 10U; ++i) {
+    CHECK_ERROR(xct_manager->begin_xct(context, kSerializable));
+    uint64_t data;
+    CHECK_ERROR(storage.get_record(context, i % kRecords, &data));
+    Epoch commit_epoch;
+    CHECK_ERROR(xct_manager->precommit_xct_async(
+      context,
+      durable_callback,
+      &state,
+      &commit_epoch));
+  }
+  WRAP_ERROR_CODE(xct_manager->wait_for_durable_callbacks(context));
+  EXPECT_EQ(10U, state.invoked_);
+  return kRetOk;
+}
+
+ErrorStack overflow_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  storage::array::ArrayStorage storage
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  DurableCallbackQueue* queue = context->get_current_xct().get_durable_callback_queue();
+  CallbackState state = { context->get_engine(), 0, Epoch() };
+  const uint32_t kXcts = DurableCallbackQueue::kCapacity * 2U + 10U;
+  for (uint32_t i = 0; i < kXcts; ++i) {
+    CHECK_ERROR(commit_async(context, &storage, i, durable_callback, &state));
+    EXPECT_LE(queue->get_count(), DurableCallbackQueue::kCapacity);
+  }
+  WRAP_ERROR_CODE(xct_manager->wait_for_durable_callbacks(context));
+  EXPECT_EQ(kXcts, state.invoked_);
+  return kRetOk;
+}
+
+ErrorStack orphan_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  storage::array::ArrayStorage storage
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  for (uint32_t i = 0; i < 20U; ++i) {
+    CHECK_ERROR(commit_async(context, &storage, i, orphan_callback, nullptr));
+  }
+  // returns without waiting. the thread should wait for them before it finishes the task.
+  return kRetOk;
+}
+
+void run_test(const char* proc_name) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("basic_task", basic_task);
+  engine.get_proc_manager()->pre_register("read_only_task", read_only_task);
+  engine.get_proc_manager()->pre_register("overflow_task", overflow_task);
+  engine.get_proc_manager()->pre_register("orphan_task", orphan_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    storage::array::ArrayMetadata meta("test", sizeof(uint64_t), kRecords);
+    storage::array::ArrayStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_array(&meta, &storage, &epoch));
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous(proc_name));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+TEST(XctDurableCallbackTest, Basic) { run_test("basic_task"); }
+TEST(XctDurableCallbackTest, ReadOnly) { run_test("read_only_task"); }
+TEST(XctDurableCallbackTest, Overflow) { run_test("overflow_task"); }
+TEST(XctDurableCallbackTest, Orphan) {
+  orphan_invoked = 0;
+  run_test("orphan_task");
+  EXPECT_EQ(20U, orphan_invoked.load());
+}
+
+}  // namespace xct
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(XctDurableCallbackTest, foedus.xct);
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <stdint.h>
+#include <gtest/gtest.h>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/epoch.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/snapshot/snapshot_manager.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/array/array_metadata.hpp"
+#include "foedus/storage/array/array_storage.hpp"
+#include "foedus/thread/impersonate_session.hpp"
+#include "foedus/thread/thread.hpp"
+#include "foedus/thread/thread_metrics.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/xct/xct_manager.hpp"
+#include "foedus/xct/xct_options.hpp"
+
+namespace foedus {
+namespace xct {
+DEFINE_TEST_CASE_PACKAGE(XctReadOnlyFallbackTest, foedus.xct);
+
+const uint64_t kRecords = 16;
+
+/** Input of write_task, also what read_task expects to read. */
+struct WriteInput {
+  uint64_t  value_;
+};
+
+/** Output of read_task */
+struct ReadOutput {
+  uint64_t  value_;
+  bool      fell_back_;
+};
+
+/** user_data of the bodies */
+struct ReadState {
+  storage::array::ArrayStorage* storage_;
+  uint64_t  sum_;
+  uint32_t  invoked_;
+};
+
+ErrorCode read_all_body(thread::Thread* context, void* user_data) {
+  ReadState* state = reinterpret_cast<ReadState*>(user_data);
+  ++state->invoked_;
+  state->sum_ = 0;
+  for (uint64_t i = 0; i < kRecords; ++i) {
+    uint64_t data;
+    CHECK_ERROR_CODE(state->storage_->get_record_primitive<uint64_t>(context, i, &data, 0));
+    state->sum_ += data;
+  }
+  return kErrorCodeOk;
+}
+
+ErrorCode write_body(thread::Thread* context, void* user_data) {
+  ReadState* state = reinterpret_cast<ReadState*>(user_data);
+  ++state->invoked_;
+  return state->storage_->overwrite_record_primitive<uint64_t>(context, 0, 123, 0);
+}
+
+ErrorStack write_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  storage::array::ArrayStorage storage
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  ASSERT_ND(args.input_len_ == sizeof(WriteInput));
+  const WriteInput* input = reinterpret_cast<const WriteInput*>(args.input_buffer_);
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, kSerializable));
+  for (uint64_t i = 0; i < kRecords; ++i) {
+    WRAP_ERROR_CODE(storage.overwrite_record_primitive<uint64_t>(context, i, input->value_, 0));
+  }
+  Epoch commit_epoch;
+  WRAP_ERROR_CODE(xct_manager->precommit_xct(context, &commit_epoch));
+  WRAP_ERROR_CODE(xct_manager->wait_for_commit(commit_epoch));
+  return kRetOk;
+}
+
+/** Reads all records and outputs the value each record had. */
+ErrorStack read_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  storage::array::ArrayStorage storage
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  thread::ThreadMetrics* metrics = context->get_metrics();
+  const uint64_t fallbacks_before = metrics->readonly_snapshot_fallbacks_;
+  ReadState state = { &storage, 0, 0 };
+  Epoch serialization_epoch;
+  WRAP_ERROR_CODE(xct_manager->run_readonly_xct(
+    context,
+    read_all_body,
+    &state,
+    &serialization_epoch));
+  EXPECT_EQ(1U, state.invoked_);
+  EXPECT_TRUE(serialization_epoch.is_valid());
+  EXPECT_FALSE(context->is_running_xct());
+
+  Epoch snapshot_epoch = context->get_engine()->get_snapshot_manager()->get_snapshot_epoch();
+  const bool fell_back = metrics->readonly_snapshot_fallbacks_ != fallbacks_before;
+  if (fell_back) {
+    EXPECT_EQ(fallbacks_before + 1U, metrics->readonly_snapshot_fallbacks_);
+    EXPECT_EQ(snapshot_epoch, serialization_epoch);
+  }
+  ReadOutput output = { state.sum_ / kRecords, fell_back };
+  EXPECT_EQ(output.value_ * kRecords, state.sum_);
+  ASSERT_ND(args.output_buffer_size_ >= sizeof(output));
+  *reinterpret_cast<ReadOutput*>(args.output_buffer_) = output;
+  *args.output_used_ = sizeof(output);
+  return kRetOk;
+}
+
+ErrorStack wrote_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  storage::array::ArrayStorage storage
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  ReadState state = { &storage, 0, 0 };
+  Epoch serialization_epoch;
+  EXPECT_EQ(
+    kErrorCodeXctReadOnlyBodyWrote,
+    xct_manager->run_readonly_xct(context, write_body, &state, &serialization_epoch));
+  EXPECT_EQ(1U, state.invoked_);
+  EXPECT_FALSE(context->is_running_xct());
+
+  // the write must not be applied
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, kSerializable));
+  uint64_t data;
+  WRAP_ERROR_CODE(storage.get_record_primitive<uint64_t>(context, 0, &data, 0));
+  EXPECT_EQ(0U, data);
+  WRAP_ERROR_CODE(xct_manager->abort_xct(context));
+  return kRetOk;
+}
+
+/** Writes value to all records, optionally followed by a snapshot. */
+void write_all(Engine* engine, uint64_t value, bool take_snapshot) {
+  WriteInput input = { value };
+  COERCE_ERROR(engine->get_thread_pool()->impersonate_synchronous(
+    "write_task",
+    &input,
+    sizeof(input)));
+  if (take_snapshot) {
+    engine->get_snapshot_manager()->trigger_snapshot_immediate(true);
+  }
+}
+
+ReadOutput read_all(Engine* engine) {
+  thread::ImpersonateSession session;
+  EXPECT_TRUE(engine->get_thread_pool()->impersonate("read_task", nullptr, 0, &session));
+  COERCE_ERROR(session.get_result());
+  ReadOutput output;
+  session.get_output(&output);
+  session.release();
+  return output;
+}
+
+void run_test(
+  uint16_t serializable_attempts,
+  bool take_snapshot,
+  uint64_t expected,
+  bool expect_fallback) {
+  EngineOptions options = get_tiny_options();
+  options.xct_.readonly_serializable_attempts_ = serializable_attempts;
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("write_task", write_task);
+  engine.get_proc_manager()->pre_register("read_task", read_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    storage::array::ArrayMetadata meta("test", sizeof(uint64_t), kRecords);
+    storage::array::ArrayStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_array(&meta, &storage, &epoch));
+    write_all(&engine, 1U, take_snapshot);
+    write_all(&engine, 2U, false);
+    ReadOutput output = read_all(&engine);
+    EXPECT_EQ(expected, output.value_);
+    EXPECT_EQ(expect_fallback, output.fell_back_);
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+TEST(XctReadOnlyFallbackTest, Serializable) {
+  run_test(XctOptions::kDefaultReadOnlySerializableAttempts, true, 2U, false);
+}
+// the second write is not in the snapshot yet
+TEST(XctReadOnlyFallbackTest, Snapshot) { run_test(0, true, 1U, true); }
+// no snapshot to fall back to
+TEST(XctReadOnlyFallbackTest, NoSnapshot) { run_test(0, false, 2U, false); }
+
+// the storage is created after the latest snapshot, so it has only volatile pages
+TEST(XctReadOnlyFallbackTest, NewStorage) {
+  EngineOptions options = get_tiny_options();
+  options.xct_.readonly_serializable_attempts_ = 0;
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("write_task", write_task);
+  engine.get_proc_manager()->pre_register("read_task", read_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    storage::array::ArrayMetadata old_meta("old", sizeof(uint64_t), kRecords);
+    storage::array::ArrayStorage old_storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_array(&old_meta, &old_storage, &epoch));
+    engine.get_snapshot_manager()->trigger_snapshot_immediate(true);
+    EXPECT_TRUE(engine.get_snapshot_manager()->get_snapshot_epoch().is_valid());
+
+    storage::array::ArrayMetadata meta("test", sizeof(uint64_t), kRecords);
+    storage::array::ArrayStorage storage;
+    COERCE_ERROR(engine.get_storage_manager()->create_array(&meta, &storage, &epoch));
+    write_all(&engine, 1U, false);
+    write_all(&engine, 2U, false);
+    ReadOutput output = read_all(&engine);
+    EXPECT_EQ(2U, output.value_);
+    EXPECT_FALSE(output.fell_back_);  // it must not claim it's serialized at the snapshot
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+TEST(XctReadOnlyFallbackTest, BodyWrote) {
+  EngineOptions options = get_tiny_options();
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("wrote_task", wrote_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    storage::array::ArrayMetadata meta("test", sizeof(uint64_t), kRecords);
+    storage::array::ArrayStorage storage;
+    Epoch epoch;
+    COERCE_ERROR(engine.get_storage_manager()->create_array(&meta, &storage, &epoch));
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("wrote_task"));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+}  // namespace xct
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(XctReadOnlyFallbackTest, foedus.xct);
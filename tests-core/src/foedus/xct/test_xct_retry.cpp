@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2014-2015, Hewlett-Packard Development Company, LP.
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details. You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * HP designates this particular file as subject to the "Classpath" exception
+ * as provided by HP in the LICENSE.txt file that accompanied this code.
+ */
+#include <stdint.h>
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <vector>
+
+#include "foedus/engine.hpp"
+#include "foedus/engine_options.hpp"
+#include "foedus/epoch.hpp"
+#include "foedus/test_common.hpp"
+#include "foedus/proc/proc_manager.hpp"
+#include "foedus/storage/storage_manager.hpp"
+#include "foedus/storage/array/array_metadata.hpp"
+#include "foedus/storage/array/array_storage.hpp"
+#include "foedus/thread/impersonate_session.hpp"
+#include "foedus/thread/thread.hpp"
+#include "foedus/thread/thread_metrics.hpp"
+#include "foedus/thread/thread_pool.hpp"
+#include "foedus/xct/retry_backoff.hpp"
+#include "foedus/xct/xct.hpp"
+#include "foedus/xct/xct_manager.hpp"
+#include "foedus/xct/xct_options.hpp"
+
+namespace foedus {
+namespace xct {
+DEFINE_TEST_CASE_PACKAGE(XctRetryTest, foedus.xct);
+
+const uint32_t kThreads = 4;
+const uint32_t kXctsPerThread = 200;
+
+TEST(XctRetryTest, Classify) {
+  EXPECT_EQ(kAbortClassNone, classify_abort(kErrorCodeOk));
+  EXPECT_EQ(kAbortClassRace, classify_abort(kErrorCodeXctRaceAbort));
+  EXPECT_EQ(kAbortClassLock, classify_abort(kErrorCodeXctLockAbort));
+  EXPECT_EQ(kAbortClassSetOverflow, classify_abort(kErrorCodeXctReadSetOverflow));
+  EXPECT_EQ(kAbortClassSetOverflow, classify_abort(kErrorCodeXctPointerSetOverflow));
+  EXPECT_EQ(kAbortClassOther, classify_abort(kErrorCodeXctUserAbort));
+  EXPECT_EQ(kAbortClassOther, classify_abort(kErrorCodeMemoryNoFreePages));
+  EXPECT_TRUE(is_retryable_abort(kAbortClassRace));
+  EXPECT_TRUE(is_retryable_abort(kAbortClassLock));
+  EXPECT_FALSE(is_retryable_abort(kAbortClassNone));
+  EXPECT_FALSE(is_retryable_abort(kAbortClassSetOverflow));
+  EXPECT_FALSE(is_retryable_abort(kAbortClassOther));
+}
+
+TEST(XctRetryTest, Backoff) {
+  RetryBackoff backoff;
+  backoff.init(123, 1ULL << 12);
+  EXPECT_EQ(0U, backoff.get_level());
+  const uint64_t kMin = RetryBackoff::kMinBackoffCycles;
+  for (uint32_t i = 0; i < 100U; ++i) {
+    EXPECT_LT(backoff.next_backoff_cycles(), kMin);
+  }
+  for (uint32_t i = 0; i < 3U; ++i) {
+    backoff.on_abort();
+  }
+  EXPECT_EQ(3U, backoff.get_level());
+  for (uint32_t i = 0; i < 100U; ++i) {
+    EXPECT_LT(backoff.next_backoff_cycles(), kMin << 3);
+  }
+  // capped by the maximum
+  for (uint32_t i = 0; i < 100U; ++i) {
+    backoff.on_abort();
+  }
+  EXPECT_EQ(static_cast<uint32_t>(RetryBackoff::kMaxLevel), backoff.get_level());
+  for (uint32_t i = 0; i < 100U; ++i) {
+    EXPECT_LT(backoff.next_backoff_cycles(), 1ULL << 12);
+  }
+  // commits lower the level one by one
+  backoff.on_commit();
+  EXPECT_EQ(RetryBackoff::kMaxLevel - 1U, backoff.get_level());
+  for (uint32_t i = 0; i < 100U; ++i) {
+    backoff.on_commit();
+  }
+  EXPECT_EQ(0U, backoff.get_level());
+
+  backoff.set_max_backoff_cycles(0);
+  backoff.on_abort();
+  EXPECT_EQ(0U, backoff.next_backoff_cycles());
+  EXPECT_EQ(0U, backoff.backoff());
+}
+
+/** user_data of the bodies */
+struct BodyState {
+  storage::array::ArrayStorage* storage_;
+  ErrorCode error_;
+  uint32_t  invoked_;
+};
+
+/** Read-modify-write on one hot record. */
+ErrorCode increment_body(thread::Thread* context, void* user_data) {
+  BodyState* state = reinterpret_cast<BodyState*>(user_data);
+  ++state->invoked_;
+  uint64_t data;
+  CHECK_ERROR_CODE(state->storage_->get_record_primitive<uint64_t>(context, 0, &data, 0));
+  return state->storage_->overwrite_record_primitive<uint64_t>(context, 0, data + 1U, 0);
+}
+
+/** Writes something, then fails with state->error_. */
+ErrorCode failing_body(thread::Thread* context, void* user_data) {
+  BodyState* state = reinterpret_cast<BodyState*>(user_data);
+  ++state->invoked_;
+  CHECK_ERROR_CODE(state->storage_->overwrite_record_primitive<uint64_t>(context, 1, 42, 0));
+  return state->error_;
+}
+
+ErrorStack increment_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  storage::array::ArrayStorage storage
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  BodyState state = { &storage, kErrorCodeOk, 0 };
+  Epoch commit_epoch;
+  for (uint32_t i = 0; i < kXctsPerThread; ++i) {
+    WRAP_ERROR_CODE(xct_manager->run_xct_with_retry(
+      context,
+      kSerializable,
+      increment_body,
+      &state,
+      &commit_epoch));
+    EXPECT_FALSE(context->is_running_xct());
+    // the RLL is consumed by the committed retry
+    EXPECT_TRUE(context->get_current_xct().get_retrospective_lock_list()->is_empty());
+  }
+  EXPECT_GE(state.invoked_, kXctsPerThread);
+  WRAP_ERROR_CODE(xct_manager->wait_for_commit(commit_epoch));
+  return kRetOk;
+}
+
+ErrorStack verify_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  storage::array::ArrayStorage storage
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  WRAP_ERROR_CODE(xct_manager->begin_xct(context, kSerializable));
+  uint64_t data;
+  WRAP_ERROR_CODE(storage.get_record_primitive<uint64_t>(context, 0, &data, 0));
+  EXPECT_EQ(kThreads * kXctsPerThread, data);
+  WRAP_ERROR_CODE(xct_manager->abort_xct(context));
+  return kRetOk;
+}
+
+ErrorStack failing_task(const proc::ProcArguments& args) {
+  thread::Thread* context = args.context_;
+  XctManager* xct_manager = context->get_engine()->get_xct_manager();
+  storage::array::ArrayStorage storage
+    = context->get_engine()->get_storage_manager()->get_array("test");
+  const uint32_t max_attempts = context->get_engine()->get_options().xct_.max_retry_attempts_;
+  thread::ThreadMetrics* metrics = context->get_metrics();
+  Epoch commit_epoch;
+
+  // not retryable. invoked only once.
+  BodyState state = { &storage, kErrorCodeXctUserAbort, 0 };
+  uint64_t retries_before = metrics->retries_;
+  EXPECT_EQ(
+    kErrorCodeXctUserAbort,
+    xct_manager->run_xct_with_retry(context, kSerializable, failing_body, &state, &commit_epoch));
+  EXPECT_EQ(1U, state.invoked_);
+  EXPECT_EQ(retries_before, metrics->retries_);
+  EXPECT_FALSE(context->is_running_xct());
+  EXPECT_TRUE(context->get_current_xct().get_retrospective_lock_list()->is_empty());
+
+  // retryable, but gives up after max_retry_attempts_.
+  state.error_ = kErrorCodeXctRaceAbort;
+  state.invoked_ = 0;
+  retries_before = metrics->retries_;
+  EXPECT_EQ(
+    kErrorCodeXctRaceAbort,
+    xct_manager->run_xct_with_retry(context, kSerializable, failing_body, &state, &commit_epoch));
+  EXPECT_EQ(max_attempts, state.invoked_);
+  EXPECT_EQ(retries_before + max_attempts - 1U, metrics->retries_);
+  EXPECT_FALSE(context->is_running_xct());
+  EXPECT_TRUE(context->get_current_xct().get_retrospective_lock_list()->is_empty());
+  EXPECT_EQ(max_attempts - 1U, context->get_current_xct().get_retry_backoff()->get_level());
+  return kRetOk;
+}
+
+void create_array(Engine* engine) {
+  storage::array::ArrayMetadata meta("test", sizeof(uint64_t), 16);
+  storage::array::ArrayStorage storage;
+  Epoch epoch;
+  COERCE_ERROR(engine->get_storage_manager()->create_array(&meta, &storage, &epoch));
+}
+
+TEST(XctRetryTest, Contended) {
+  EngineOptions options = get_tiny_options();
+  options.thread_.thread_count_per_group_ = kThreads;
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("increment_task", increment_task);
+  engine.get_proc_manager()->pre_register("verify_task", verify_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    create_array(&engine);
+    std::vector<thread::ImpersonateSession> sessions;
+    for (uint32_t i = 0; i < kThreads; ++i) {
+      thread::ImpersonateSession session;
+      EXPECT_TRUE(engine.get_thread_pool()->impersonate("increment_task", nullptr, 0, &session));
+      sessions.emplace_back(std::move(session));
+    }
+    for (uint32_t i = 0; i < kThreads; ++i) {
+      COERCE_ERROR(sessions[i].get_result());
+      sessions[i].release();
+    }
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("verify_task"));
+
+    thread::ThreadMetrics metrics;
+    engine.get_thread_pool()->get_metrics_sum(&metrics);
+    std::cout << metrics << std::endl;
+    EXPECT_GE(metrics.commits_, kThreads * kXctsPerThread);
+    if (metrics.retries_ == 0) {
+      EXPECT_EQ(0U, metrics.retry_backoff_cycles_);
+    }
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+TEST(XctRetryTest, GiveUp) {
+  EngineOptions options = get_tiny_options();
+  options.xct_.max_retry_attempts_ = 5;
+  Engine engine(options);
+  engine.get_proc_manager()->pre_register("failing_task", failing_task);
+  COERCE_ERROR(engine.initialize());
+  {
+    UninitializeGuard guard(&engine);
+    create_array(&engine);
+    COERCE_ERROR(engine.get_thread_pool()->impersonate_synchronous("failing_task"));
+    COERCE_ERROR(engine.uninitialize());
+  }
+  cleanup_test(options);
+}
+
+}  // namespace xct
+}  // namespace foedus
+
+TEST_MAIN_CAPTURE_SIGNALS(XctRetryTest, foedus.xct);